@@ -31,10 +31,14 @@
 #include "osi/include/osi.h"  // UNUSED_ATTR
 #include "stack/include/l2c_api.h"
 #include "stack/include/port_api.h"
+#include "stack/include/sdp_api.h"
+#include "types/bluetooth/uuid.h"
 #include "types/raw_address.h"
 
 #include <base/logging.h>
 
+using bluetooth::Uuid;
+
 /*****************************************************************************
  *  Constants
  ****************************************************************************/
@@ -325,8 +329,9 @@ void bta_ag_open_fail(tBTA_AG_SCB* p_scb, const tBTA_AG_DATA& data) {
  * Returns          void
  *
  ******************************************************************************/
-void bta_ag_rfc_fail(tBTA_AG_SCB* p_scb, UNUSED_ATTR const tBTA_AG_DATA& data) {
+void bta_ag_rfc_fail(tBTA_AG_SCB* p_scb, const tBTA_AG_DATA& data) {
   RawAddress peer_addr = p_scb->peer_addr;
+  uint8_t conn_service = p_scb->conn_service;
   /* reinitialize stuff */
   p_scb->conn_handle = 0;
   p_scb->conn_service = 0;
@@ -339,6 +344,20 @@ void bta_ag_rfc_fail(tBTA_AG_SCB* p_scb, UNUSED_ATTR const tBTA_AG_DATA& data) {
   /*Clear the BD address*/
   p_scb->peer_addr = RawAddress::kEmpty;
 
+  /* A channel refused by the peer may come from a stale discovery cache
+   * entry. Page timeouts and other link failures keep the cache. */
+  if (data.rfc.port_status == PORT_INVALID_SCN) {
+    if (conn_service == BTA_AG_HFP) {
+      SDP_InvalidateDiscoveryCache(
+          peer_addr, Uuid::From16Bit(UUID_SERVCLASS_HF_HANDSFREE));
+    } else {
+      SDP_InvalidateDiscoveryCache(
+          peer_addr, Uuid::From16Bit(UUID_SERVCLASS_HEADSET_HS));
+      SDP_InvalidateDiscoveryCache(peer_addr,
+                                   Uuid::From16Bit(UUID_SERVCLASS_HEADSET));
+    }
+  }
+
   /* reopen registered servers */
   bta_ag_start_servers(p_scb, p_scb->reg_services);
 
@@ -156,6 +156,7 @@ typedef struct {
 /* data type for RFCOMM events */
 typedef struct {
   uint16_t port_handle;
+  uint32_t port_status; /* PORT result code of a closed connection */
 } tBTA_AG_RFC;
 
 /* union of all event datatypes */
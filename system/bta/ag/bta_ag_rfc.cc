@@ -152,6 +152,7 @@ static void bta_ag_mgmt_cback(uint32_t code, uint16_t port_handle,
 
   tBTA_AG_DATA data = {};
   data.rfc.port_handle = port_handle;
+  data.rfc.port_status = code;
   do_in_main_thread(
       FROM_HERE, base::Bind(&bta_ag_sm_execute_by_handle, handle, event, data));
 }
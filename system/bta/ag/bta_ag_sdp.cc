@@ -485,6 +485,8 @@ void bta_ag_do_disc(tBTA_AG_SCB* p_scb, tBTA_SERVICE_MASK service) {
   /* set up service discovery database; attr happens to be attr_list len */
   if (SDP_InitDiscoveryDb(p_scb->p_disc_db, BTA_AG_DISC_BUF_SIZE, num_uuid,
                           uuid_list, num_attr, attr_list)) {
+    /* bta_ag_rfc_fail() drops the cached record if its channel is stale */
+    p_scb->p_disc_db->use_cache = true;
     if (SDP_ServiceSearchAttributeRequest(
             p_scb->peer_addr, p_scb->p_disc_db,
             bta_ag_sdp_cback_tbl[bta_ag_scb_to_idx(p_scb) - 1])) {
@@ -40,6 +40,7 @@
 #include "btif/include/btif_av_co.h"
 #include "btif/include/btif_config.h"
 #include "btif/include/btif_storage.h"
+#include "common/time_util.h"
 #include "device/include/interop.h"
 #include "main/shim/dumpsys.h"
 #include "osi/include/allocator.h"
@@ -284,6 +285,77 @@ void bta_av_st_rc_timer(tBTA_AV_SCB* p_scb, UNUSED_ATTR tBTA_AV_DATA* p_data) {
   }
 }
 
+/*******************************************************************************
+ *
+ * Function         bta_av_cached_getcap_cfm
+ *
+ * Description      Complete the capability request of the current stream
+ *                  endpoint, whose capabilities were found in the cache, as
+ *                  an AVDTP confirmation would.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void bta_av_cached_getcap_cfm(tBTA_AV_SCB* p_scb) {
+  APPL_TRACE_DEBUG("%s: peer %s seid:%d served from the capability cache",
+                   __func__, p_scb->PeerAddress().ToString().c_str(),
+                   p_scb->sep_info[p_scb->sep_info_idx].seid);
+
+  tBTA_AV_STR_MSG* p_msg =
+      (tBTA_AV_STR_MSG*)osi_calloc(sizeof(tBTA_AV_STR_MSG));
+  p_msg->hdr.event = BTA_AV_STR_GETCAP_OK_EVT;
+  p_msg->hdr.layer_specific = p_scb->hndl;
+  p_msg->bd_addr = p_scb->PeerAddress();
+  p_msg->scb_index = p_scb->hdi;
+  p_msg->avdt_event = AVDT_GETCAP_CFM_EVT;
+  bta_sys_sendmsg(p_msg);
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_av_cap_cache_save
+ *
+ * Description      Cache the capabilities of the current stream endpoint if
+ *                  they were received from the peer for an endpoint found by
+ *                  the stream discovery.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void bta_av_cap_cache_save(tBTA_AV_SCB* p_scb) {
+  if (!p_scb->seps_discovered || p_scb->cap_cached ||
+      p_scb->peer_cap.num_codec == 0) {
+    return;
+  }
+
+  bool get_all_cap = (p_scb->AvdtpVersion() >= AVDT_VERSION_1_3) &&
+                     (A2DP_GetAvdtpVersion() >= AVDT_VERSION_1_3);
+  bta_av_cap_cache_store(p_scb->PeerAddress(), p_scb->sep_info,
+                         p_scb->num_seps,
+                         p_scb->sep_info[p_scb->sep_info_idx].seid,
+                         get_all_cap, p_scb->peer_cap);
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_av_setup_latency_end
+ *
+ * Description      Account the time elapsed since |*p_start_ms| to |phase|
+ *                  of the stream setup, if the phase was started.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void bta_av_setup_latency_end(tBTA_AV_SCB* p_scb,
+                                     tBTA_AV_SETUP_PHASE phase,
+                                     uint64_t* p_start_ms) {
+  if (*p_start_ms == 0) return;
+  uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
+  bta_av_setup_latency_record(phase, p_scb->caps_from_cache,
+                              now_ms - *p_start_ms);
+  *p_start_ms = 0;
+}
+
 /*******************************************************************************
  *
  * Function         bta_av_next_getcap
@@ -315,8 +387,19 @@ static bool bta_av_next_getcap(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
       /* we got a stream; get its capabilities */
       bool get_all_cap = (p_scb->AvdtpVersion() >= AVDT_VERSION_1_3) &&
                          (A2DP_GetAvdtpVersion() >= AVDT_VERSION_1_3);
-      AVDT_GetCapReq(p_scb->PeerAddress(), p_scb->hdi, p_scb->sep_info[i].seid,
-                     &p_scb->peer_cap, &bta_av_proc_stream_evt, get_all_cap);
+      p_scb->cap_cached =
+          p_scb->seps_discovered &&
+          bta_av_cap_cache_lookup(p_scb->PeerAddress(), p_scb->sep_info,
+                                  p_scb->num_seps, p_scb->sep_info[i].seid,
+                                  get_all_cap, &p_scb->peer_cap);
+      if (p_scb->cap_cached) {
+        p_scb->caps_from_cache = true;
+        bta_av_cached_getcap_cfm(p_scb);
+      } else {
+        AVDT_GetCapReq(p_scb->PeerAddress(), p_scb->hdi,
+                       p_scb->sep_info[i].seid, &p_scb->peer_cap,
+                       &bta_av_proc_stream_evt, get_all_cap);
+      }
       sent_cmd = true;
       break;
     }
@@ -739,6 +822,10 @@ void bta_av_do_disc_a2dp(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
                    bta_av_cb.audio_open_cnt);
 
   memcpy(&(p_scb->open_api), &(p_data->api_open), sizeof(tBTA_AV_API_OPEN));
+  /* the open is resumed here after a role switch */
+  if (p_scb->open_start_ms == 0) {
+    p_scb->open_start_ms = bluetooth::common::time_get_os_boottime_ms();
+  }
 
   switch (p_data->api_open.switch_res) {
     case BTA_AV_RS_NONE:
@@ -1125,6 +1212,8 @@ void bta_av_setconfig_rsp(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
       return;
     }
 
+    /* the endpoints below come from the callout, not from a discovery */
+    p_scb->seps_discovered = false;
     for (i = 1; i < num; i++) {
       APPL_TRACE_DEBUG("%s: sep_info[%d] SEID: %d", __func__, i, p_seid[i - 1]);
       /* initialize the sep_info[] to get capabilities */
@@ -1192,6 +1281,8 @@ void bta_av_str_opened(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
 
   p_scb->l2c_bufs = 0;
   p_scb->p_cos->open(p_scb->hndl, p_scb->PeerAddress(), p_scb->stream_mtu);
+  bta_av_setup_latency_end(p_scb, BTA_AV_SETUP_PHASE_OPEN,
+                           &p_scb->open_start_ms);
 
   {
     /* TODO check if other audio channel is open.
@@ -1429,6 +1520,9 @@ void bta_av_disc_results(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
   if (p_scb->num_seps > 0) {
     /* initialize index into discovery results */
     p_scb->sep_info_idx = 0;
+    p_scb->seps_discovered = true;
+    p_scb->caps_from_cache = false;
+    p_scb->getcap_start_ms = bluetooth::common::time_get_os_boottime_ms();
 
     /* get the capabilities of the first available stream */
     bta_av_next_getcap(p_scb, p_data);
@@ -1478,6 +1572,9 @@ void bta_av_disc_res_as_acp(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
   if (p_scb->num_seps > 0) {
     /* initialize index into discovery results */
     p_scb->sep_info_idx = 0;
+    p_scb->seps_discovered = true;
+    p_scb->caps_from_cache = false;
+    p_scb->getcap_start_ms = bluetooth::common::time_get_os_boottime_ms();
 
     /* get the capabilities of the first available stream */
     bta_av_next_getcap(p_scb, p_data);
@@ -1512,6 +1609,8 @@ void bta_av_save_caps(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
   APPL_TRACE_DEBUG("%s: codec: %s", __func__,
                    A2DP_CodecInfoString(p_scb->peer_cap.codec_info).c_str());
 
+  bta_av_cap_cache_save(p_scb);
+
   cfg = p_scb->peer_cap;
   /* let application know the capability of the SNK */
   if (p_scb->p_cos->getcfg(p_scb->hndl, p_scb->PeerAddress(), cfg.codec_info,
@@ -1543,6 +1642,8 @@ void bta_av_save_caps(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
     APPL_TRACE_DEBUG("%s: getcap_done: num_seps:%d sep_info_idx:%d wait:0x%x",
                      __func__, p_scb->num_seps, p_scb->sep_info_idx,
                      p_scb->wait);
+    bta_av_setup_latency_end(p_scb, BTA_AV_SETUP_PHASE_GETCAP,
+                             &p_scb->getcap_start_ms);
     p_scb->wait &= ~(BTA_AV_WAIT_ACP_CAPS_ON | BTA_AV_WAIT_ACP_CAPS_STARTED);
     if (old_wait & BTA_AV_WAIT_ACP_CAPS_STARTED) {
       bta_av_start_ok(p_scb, NULL);
@@ -1595,6 +1696,12 @@ void bta_av_open_failed(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
   APPL_TRACE_ERROR("%s: peer_addr=%s", __func__,
                    p_scb->PeerAddress().ToString().c_str());
   p_scb->open_status = BTA_AV_FAIL_STREAM;
+  p_scb->getcap_start_ms = 0;
+  p_scb->open_start_ms = 0;
+  /* query the capabilities again on the next attempt */
+  if (p_scb->caps_from_cache) {
+    bta_av_cap_cache_invalidate(p_scb->PeerAddress());
+  }
   bta_av_cco_close(p_scb, p_data);
 
   /* check whether there is already an opened audio or video connection with the
@@ -1669,6 +1776,8 @@ void bta_av_getcap_results(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
   APPL_TRACE_DEBUG("%s: codec: %s", __func__,
                    A2DP_CodecInfoString(p_scb->cfg.codec_info).c_str());
 
+  bta_av_cap_cache_save(p_scb);
+
   /* if codec present and we get a codec configuration */
   if ((p_scb->peer_cap.num_codec != 0) && (media_type == p_scb->media_type) &&
       (p_scb->p_cos->getcfg(p_scb->hndl, p_scb->PeerAddress(), cfg.codec_info,
@@ -1680,6 +1789,8 @@ void bta_av_getcap_results(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
 
     /* save copy of codec configuration */
     p_scb->cfg = cfg;
+    bta_av_setup_latency_end(p_scb, BTA_AV_SETUP_PHASE_GETCAP,
+                             &p_scb->getcap_start_ms);
 
     APPL_TRACE_DEBUG("%s: result: sep_info_idx=%d", __func__,
                      p_scb->sep_info_idx);
@@ -1861,8 +1972,11 @@ void bta_av_do_start(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
     LOG_ERROR("%s: AVDT_StartReq failed for peer %s result:%d", __func__,
               p_scb->PeerAddress().ToString().c_str(), result);
     bta_av_start_failed(p_scb, p_data);
-  } else if (p_data) {
-    bta_av_set_use_latency_mode(p_scb, p_data->do_start.use_latency_mode);
+  } else {
+    p_scb->start_req_ms = bluetooth::common::time_get_os_boottime_ms();
+    if (p_data) {
+      bta_av_set_use_latency_mode(p_scb, p_data->do_start.use_latency_mode);
+    }
   }
   LOG_INFO(
       "%s: peer %s start requested: sco_occupied:%s role:0x%x "
@@ -2245,6 +2359,7 @@ void bta_av_start_ok(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
     p_scb->wait &= ~BTA_AV_WAIT_ROLE_SW_BITS;
     if (p_data->hdr.offset == BTA_AV_RS_FAIL) {
       bta_sys_idle(BTA_ID_AV, bta_av_cb.audio_open_cnt, p_scb->PeerAddress());
+      p_scb->start_req_ms = 0;
       tBTA_AV_START start;
       start.chnl = p_scb->chnl;
       start.status = BTA_AV_FAIL_ROLE;
@@ -2348,6 +2463,9 @@ void bta_av_start_ok(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
                      p_scb->PeerAddress().ToString().c_str(), suspend,
                      p_scb->role, initiator);
 
+    bta_av_setup_latency_end(p_scb, BTA_AV_SETUP_PHASE_START,
+                             &p_scb->start_req_ms);
+
     tBTA_AV_START start;
     start.suspending = suspend;
     start.initiator = initiator;
@@ -2396,6 +2514,7 @@ void bta_av_start_failed(tBTA_AV_SCB* p_scb, UNUSED_ATTR tBTA_AV_DATA* p_data) {
 
   BTM_unblock_role_switch_and_sniff_mode_for(p_scb->PeerAddress());
   p_scb->sco_suspend = false;
+  p_scb->start_req_ms = 0;
 }
 
 /*******************************************************************************
@@ -2416,6 +2535,9 @@ void bta_av_str_closed(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
       __func__, p_scb->PeerAddress().ToString().c_str(), p_scb->hndl,
       p_scb->open_status, p_scb->chnl, p_scb->co_started);
 
+  p_scb->open_start_ms = 0;
+  p_scb->start_req_ms = 0;
+
   BTM_unblock_role_switch_and_sniff_mode_for(p_scb->PeerAddress());
   if (bta_av_cb.audio_open_cnt <= 1) {
     BTM_default_unblock_role_switch();
@@ -2609,6 +2731,11 @@ void bta_av_rcfg_failed(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
                    p_scb->num_recfg, bta_av_cb.conn_lcb,
                    p_scb->PeerAddress().ToString().c_str());
 
+  /* query the capabilities again on the next attempt */
+  if (p_scb->caps_from_cache) {
+    bta_av_cap_cache_invalidate(p_scb->PeerAddress());
+  }
+
   if (p_scb->num_recfg > BTA_AV_RECONFIG_RETRY) {
     bta_av_cco_close(p_scb, p_data);
     /* report failure */
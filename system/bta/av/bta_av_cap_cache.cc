@@ -0,0 +1,316 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "bt_bta_av"
+
+/******************************************************************************
+ *
+ *  This file contains the capability cache of the peer stream endpoints.
+ *  The AVDTP Get (All) Capabilities results of a bonded device are kept in
+ *  the config, next to the bond, so that reconnecting to an unchanged device
+ *  does not query every stream endpoint again.
+ *
+ *  Cached capabilities are only used if the stream endpoints discovered on
+ *  the connection are still the ones they were saved with, and if they are
+ *  not older than kBtifConfigBlobMaxAgeSeconds. The stream setup drops them
+ *  when a stream configured from them fails to open.
+ *
+ *  This file also keeps the latency statistics of the A2DP stream setup.
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "bta/av/bta_av_int.h"
+#include "btif/include/btif_config.h"
+#include "btif/include/btif_config_blob.h"
+#include "main/shim/dumpsys.h"
+#include "osi/include/log.h"
+#include "stack/include/avdt_api.h"
+#include "stack/include/btm_api.h"
+#include "types/raw_address.h"
+
+namespace {
+
+constexpr uint8_t kCacheFormat = 1;
+
+struct CachedSep {
+  uint8_t seid;
+  AvdtpSepConfig cap;
+};
+
+struct CachedCaps {
+  bool get_all_cap = false;
+  uint64_t stored_at = 0;  // Seconds since the epoch
+  // Stream endpoints discovered when the capabilities were read, as
+  // (seid, tsep, media_type) triplets
+  std::vector<uint8_t> seps;
+  std::vector<CachedSep> caps;
+};
+
+struct CacheStatistics {
+  size_t hits = 0;
+  size_t misses = 0;
+  size_t stores = 0;
+  size_t invalidations = 0;
+};
+
+struct PhaseStatistics {
+  size_t count = 0;
+  uint64_t total_ms = 0;
+  uint64_t max_ms = 0;
+};
+
+CacheStatistics cache_statistics;
+
+// Statistics by phase, then by whether capabilities came from the cache
+PhaseStatistics phase_statistics[BTA_AV_SETUP_PHASE_MAX][2];
+
+std::vector<uint8_t> discovered_seps(const tAVDT_SEP_INFO* sep_info,
+                                     uint8_t num_seps) {
+  std::vector<uint8_t> seps;
+  for (uint8_t i = 0; i < num_seps; i++) {
+    seps.push_back(sep_info[i].seid);
+    seps.push_back(sep_info[i].tsep);
+    seps.push_back(sep_info[i].media_type);
+  }
+  return seps;
+}
+
+bool parse_caps(const std::vector<uint8_t>& blob, CachedCaps* cached) {
+  BtifConfigBlobReader reader(blob);
+  uint8_t format, get_all_cap, num_seps, num_caps;
+  if (!reader.u8(&format) || format != kCacheFormat ||
+      !reader.u8(&get_all_cap) || !reader.u64(&cached->stored_at) ||
+      !reader.u8(&num_seps)) {
+    return false;
+  }
+  cached->get_all_cap = get_all_cap != 0;
+  cached->seps.resize(num_seps * 3);
+  if (!reader.bytes(cached->seps.size(), cached->seps.data()) ||
+      !reader.u8(&num_caps)) {
+    return false;
+  }
+
+  for (uint8_t i = 0; i < num_caps; i++) {
+    CachedSep sep;
+    AvdtpSepConfig& cap = sep.cap;
+    if (!reader.u8(&sep.seid) || !reader.u8(&cap.num_codec) ||
+        !reader.u8(&cap.num_protect) || !reader.u16(&cap.psc_mask) ||
+        !reader.u8(&cap.recov_type) || !reader.u8(&cap.recov_mrws) ||
+        !reader.u8(&cap.recov_mnmp) || !reader.u8(&cap.hdrcmp_mask) ||
+        !reader.bytes(AVDT_CODEC_SIZE, cap.codec_info) ||
+        !reader.bytes(AVDT_PROTECT_SIZE, cap.protect_info)) {
+      return false;
+    }
+    cached->caps.push_back(sep);
+  }
+  return reader.done();
+}
+
+std::vector<uint8_t> serialize_caps(const CachedCaps& cached) {
+  std::vector<uint8_t> blob;
+  BtifConfigBlobWriter writer(blob);
+  writer.u8(kCacheFormat);
+  writer.u8(cached.get_all_cap ? 1 : 0);
+  writer.u64(cached.stored_at);
+  writer.u8(cached.seps.size() / 3);
+  writer.bytes(cached.seps);
+  writer.u8(cached.caps.size());
+  for (const CachedSep& sep : cached.caps) {
+    const AvdtpSepConfig& cap = sep.cap;
+    writer.u8(sep.seid);
+    writer.u8(cap.num_codec);
+    writer.u8(cap.num_protect);
+    writer.u16(cap.psc_mask);
+    writer.u8(cap.recov_type);
+    writer.u8(cap.recov_mrws);
+    writer.u8(cap.recov_mnmp);
+    writer.u8(cap.hdrcmp_mask);
+    writer.bytes(cap.codec_info, AVDT_CODEC_SIZE);
+    writer.bytes(cap.protect_info, AVDT_PROTECT_SIZE);
+  }
+  return blob;
+}
+
+}  // namespace
+
+/*******************************************************************************
+ *
+ * Function         bta_av_cap_cache_lookup
+ *
+ * Description      Look up the cached capabilities of the stream endpoint
+ *                  |seid| of |peer_address|. |sep_info| holds the |num_seps|
+ *                  stream endpoints discovered on the current connection,
+ *                  which must be the ones the capabilities were read with.
+ *
+ * Returns          true and fills |p_cap| if the capabilities are cached.
+ *
+ ******************************************************************************/
+bool bta_av_cap_cache_lookup(const RawAddress& peer_address,
+                             const tAVDT_SEP_INFO* sep_info, uint8_t num_seps,
+                             uint8_t seid, bool get_all_cap,
+                             AvdtpSepConfig* p_cap) {
+  CachedCaps cached;
+  const std::vector<uint8_t> blob = btif_config_get_blob(
+      peer_address.ToString(), BT_CONFIG_KEY_AVDTP_SEP_CAPABILITIES);
+  if (blob.empty() || !parse_caps(blob, &cached) ||
+      cached.get_all_cap != get_all_cap ||
+      cached.seps != discovered_seps(sep_info, num_seps) ||
+      btif_config_blob_is_expired(cached.stored_at, btif_config_blob_now())) {
+    cache_statistics.misses++;
+    return false;
+  }
+
+  for (const CachedSep& sep : cached.caps) {
+    if (sep.seid == seid) {
+      *p_cap = sep.cap;
+      cache_statistics.hits++;
+      return true;
+    }
+  }
+  cache_statistics.misses++;
+  return false;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_av_cap_cache_store
+ *
+ * Description      Cache the capabilities of the stream endpoint |seid| of
+ *                  |peer_address|, if the device is bonded. The capabilities
+ *                  cached with other discovery results are dropped.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void bta_av_cap_cache_store(const RawAddress& peer_address,
+                            const tAVDT_SEP_INFO* sep_info, uint8_t num_seps,
+                            uint8_t seid, bool get_all_cap,
+                            const AvdtpSepConfig& cap) {
+  if (!btm_sec_is_a_bonded_dev(peer_address)) return;
+
+  const std::string bdstr = peer_address.ToString();
+  const std::vector<uint8_t> blob =
+      btif_config_get_blob(bdstr, BT_CONFIG_KEY_AVDTP_SEP_CAPABILITIES);
+  const std::vector<uint8_t> seps = discovered_seps(sep_info, num_seps);
+  const uint64_t now = btif_config_blob_now();
+  CachedCaps cached;
+  if (blob.empty() || !parse_caps(blob, &cached) ||
+      cached.get_all_cap != get_all_cap || cached.seps != seps ||
+      btif_config_blob_is_expired(cached.stored_at, now)) {
+    cached = CachedCaps{
+        .get_all_cap = get_all_cap,
+        .stored_at = now,
+        .seps = seps,
+    };
+  }
+
+  auto existing =
+      std::find_if(cached.caps.begin(), cached.caps.end(),
+                   [seid](const CachedSep& sep) { return sep.seid == seid; });
+  if (existing != cached.caps.end()) {
+    existing->cap = cap;
+  } else {
+    cached.caps.push_back(CachedSep{.seid = seid, .cap = cap});
+  }
+
+  const std::vector<uint8_t> updated = serialize_caps(cached);
+  if (updated == blob) return;
+  if (btif_config_set_bin(bdstr, BT_CONFIG_KEY_AVDTP_SEP_CAPABILITIES,
+                          updated.data(), updated.size())) {
+    btif_config_save();
+    cache_statistics.stores++;
+  }
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_av_cap_cache_invalidate
+ *
+ * Description      Drop the stream endpoint capabilities cached for a device.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void bta_av_cap_cache_invalidate(const RawAddress& peer_address) {
+  const std::string bdstr = peer_address.ToString();
+  if (!btif_config_exist(bdstr, BT_CONFIG_KEY_AVDTP_SEP_CAPABILITIES)) return;
+
+  LOG_INFO("%s: dropping cached capabilities of %s", __func__,
+           PRIVATE_ADDRESS(peer_address));
+  btif_config_remove(bdstr, BT_CONFIG_KEY_AVDTP_SEP_CAPABILITIES);
+  cache_statistics.invalidations++;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_av_setup_latency_record
+ *
+ * Description      Account |duration_ms| spent in a phase of the stream
+ *                  setup. |from_cache| tells whether the capabilities of the
+ *                  peer came from the capability cache.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void bta_av_setup_latency_record(tBTA_AV_SETUP_PHASE phase, bool from_cache,
+                                 uint64_t duration_ms) {
+  if (phase >= BTA_AV_SETUP_PHASE_MAX) return;
+  PhaseStatistics& stats = phase_statistics[phase][from_cache ? 1 : 0];
+  stats.count++;
+  stats.total_ms += duration_ms;
+  stats.max_ms = std::max(stats.max_ms, duration_ms);
+}
+
+static const char* bta_av_setup_phase_text(int phase) {
+  switch (phase) {
+    case BTA_AV_SETUP_PHASE_GETCAP:
+      return "get_capabilities";
+    case BTA_AV_SETUP_PHASE_OPEN:
+      return "open";
+    case BTA_AV_SETUP_PHASE_START:
+      return "start";
+    default:
+      return "unknown";
+  }
+}
+
+void bta_av_cap_cache_dump(int fd) {
+  dprintf(fd, "\nBTA AV Stream Setup:\n");
+  dprintf(fd,
+          "  Capability cache hits: %zu misses: %zu stores: %zu "
+          "invalidations: %zu\n",
+          cache_statistics.hits, cache_statistics.misses,
+          cache_statistics.stores, cache_statistics.invalidations);
+  for (int phase = 0; phase < BTA_AV_SETUP_PHASE_MAX; phase++) {
+    for (int from_cache = 0; from_cache < 2; from_cache++) {
+      const PhaseStatistics& stats = phase_statistics[phase][from_cache];
+      if (stats.count == 0) continue;
+      dprintf(fd,
+              "  %s%s: count: %zu average_ms: %llu max_ms: %llu\n",
+              bta_av_setup_phase_text(phase),
+              from_cache ? " (cached capabilities)" : "", stats.count,
+              static_cast<unsigned long long>(stats.total_ms / stats.count),
+              static_cast<unsigned long long>(stats.max_ms));
+    }
+  }
+}
@@ -495,6 +495,14 @@ typedef union {
 #define BTA_AV_COLL_API_CALLED \
   0x02 /* API open was called while incoming timer is running */
 
+/* Phases of the stream setup whose latency is measured */
+typedef enum {
+  BTA_AV_SETUP_PHASE_GETCAP, /* first capability request to codec selected */
+  BTA_AV_SETUP_PHASE_OPEN,   /* open request to stream opened */
+  BTA_AV_SETUP_PHASE_START,  /* stream start request to stream started */
+  BTA_AV_SETUP_PHASE_MAX,
+} tBTA_AV_SETUP_PHASE;
+
 /* type for AV stream control block */
 // TODO: This should be renamed and changed to a proper class
 struct tBTA_AV_SCB final {
@@ -554,6 +562,13 @@ struct tBTA_AV_SCB final {
   uint8_t q_tag; /* identify the associated q_info union member */
   bool no_rtp_header; /* true if add no RTP header */
   uint16_t uuid_int; /*intended UUID of Initiator to connect to */
+  bool seps_discovered; /* true if sep_info holds AVDTP discovery results */
+  bool cap_cached;   /* true if the current peer_cap came from the cache */
+  bool caps_from_cache; /* true if any capability of this setup came from the
+                           capability cache */
+  uint64_t getcap_start_ms; /* when the capabilities were first requested */
+  uint64_t open_start_ms;   /* when the stream open was requested */
+  uint64_t start_req_ms;    /* when the stream start was requested */
 
   /**
    * Called to setup the state when connected to a peer.
@@ -771,6 +786,20 @@ extern void bta_av_proc_stream_evt(uint8_t handle, const RawAddress& bd_addr,
                                    uint8_t event, tAVDT_CTRL* p_data,
                                    uint8_t scb_index);
 
+/* capability cache functions */
+extern bool bta_av_cap_cache_lookup(const RawAddress& peer_address,
+                                    const tAVDT_SEP_INFO* sep_info,
+                                    uint8_t num_seps, uint8_t seid,
+                                    bool get_all_cap, AvdtpSepConfig* p_cap);
+extern void bta_av_cap_cache_store(const RawAddress& peer_address,
+                                   const tAVDT_SEP_INFO* sep_info,
+                                   uint8_t num_seps, uint8_t seid,
+                                   bool get_all_cap, const AvdtpSepConfig& cap);
+extern void bta_av_cap_cache_invalidate(const RawAddress& peer_address);
+extern void bta_av_setup_latency_record(tBTA_AV_SETUP_PHASE phase,
+                                        bool from_cache, uint64_t duration_ms);
+extern void bta_av_cap_cache_dump(int fd);
+
 /* ssm action functions */
 extern void bta_av_do_disc_a2dp(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data);
 extern void bta_av_cleanup(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data);
@@ -1405,6 +1405,8 @@ const char* bta_av_evt_code(uint16_t evt_code) {
 }
 
 void bta_debug_av_dump(int fd) {
+  bta_av_cap_cache_dump(fd);
+
   if (appl_trace_level < BT_TRACE_LEVEL_DEBUG) return;
 
   dprintf(fd, "\nBTA AV State:\n");
@@ -22,8 +22,11 @@
 #include <hardware/bt_csis.h>
 #include <hardware/bt_gatt_types.h>
 
+#include <chrono>
 #include <list>
+#include <map>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "advertise_data_parser.h"
@@ -69,6 +72,9 @@ class CsisClientImpl;
 CsisClientImpl* instance;
 DeviceGroupsCallbacks* device_group_callbacks;
 
+/* Number of resolved RSIs remembered between advertising reports */
+constexpr size_t kMaxCachedRsi = 256;
+
 /**
  * -----------------------------------------------------------------------------
  * Coordinated Set Service - Client role
@@ -160,7 +166,10 @@ class CsisClientImpl : public CsisClient {
       device = FindDeviceByAddress(address);
     }
 
-    if (!csis_group->IsDeviceInTheGroup(device)) csis_group->AddDevice(device);
+    if (!csis_group->IsDeviceInTheGroup(device)) {
+      csis_group->AddDevice(device);
+      CheckSetCompleted(csis_group);
+    }
 
     return csis_group;
   }
@@ -623,6 +632,7 @@ class CsisClientImpl : public CsisClient {
         auto csis_group = AssignCsisGroup(addr, gid, true, Uuid::kEmpty);
         csis_group->SetDesiredSize(size);
         csis_group->SetSirk(sirk);
+        rsi_cache_.clear();
 
         // TODO: Save it for later, so we won't have to read it using GATT
         group_rank_map[gid] = rank;
@@ -691,8 +701,13 @@ class CsisClientImpl : public CsisClient {
              << "    current lock state: "
              << static_cast<int>(g->GetCurrentLockState()) << "\n"
              << "    target lock state: "
-             << static_cast<int>(g->GetTargetLockState()) << "\n"
-             << "    devices: \n";
+             << static_cast<int>(g->GetTargetLockState()) << "\n";
+      auto completion_time = set_completion_time_.find(g->GetGroupId());
+      if (completion_time != set_completion_time_.end()) {
+        stream << "    set completion time: "
+               << completion_time->second.count() << " ms\n";
+      }
+      stream << "    devices: \n";
       for (auto& device : devices_) {
         if (!g->IsDeviceInTheGroup(device)) continue;
 
@@ -756,6 +771,23 @@ class CsisClientImpl : public CsisClient {
     }
   }
 
+  /* Logs how long it took to find all members since discovery started */
+  void CheckSetCompleted(const std::shared_ptr<CsisGroup>& csis_group) {
+    if (!csis_group->IsGroupComplete()) return;
+
+    auto it = set_discovery_start_.find(csis_group->GetGroupId());
+    if (it == set_discovery_start_.end()) return;
+
+    auto completion_time =
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - it->second);
+    set_discovery_start_.erase(it);
+    set_completion_time_[csis_group->GetGroupId()] = completion_time;
+    LOG_INFO("Group id: %d with %d members completed in %lld ms",
+             csis_group->GetGroupId(), csis_group->GetCurrentSize(),
+             static_cast<long long>(completion_time.count()));
+  }
+
   std::shared_ptr<CsisDevice> FindDeviceByAddress(
       const RawAddress& addr) const {
     auto it = find_if(devices_.cbegin(), devices_.cend(),
@@ -778,6 +810,8 @@ class CsisClientImpl : public CsisClient {
     for (auto it = csis_groups_.begin(); it != csis_groups_.end(); it++) {
       if ((*it)->GetGroupId() == group_id) {
         csis_groups_.erase(it);
+        rsi_cache_.clear();
+        set_discovery_start_.erase(group_id);
         return;
       }
     }
@@ -1151,6 +1185,52 @@ class CsisClientImpl : public CsisClient {
     return true;
   }
 
+  /* Returns the id of the group each RSI resolves to, or kGroupUnknown.
+   * RSIs not seen before are checked against every known SIRK in one batch
+   * per SIRK, and the result is cached since members keep advertising the
+   * same RSI until it is regenerated.
+   */
+  std::vector<int> ResolveRsis(const std::vector<RawAddress>& all_rsi) {
+    std::vector<int> rsi_groups(all_rsi.size(),
+                                bluetooth::groups::kGroupUnknown);
+    std::vector<RawAddress> unresolved;
+    for (const auto& rsi : all_rsi) {
+      if (rsi_cache_.count(rsi) == 0 &&
+          std::find(unresolved.begin(), unresolved.end(), rsi) ==
+              unresolved.end()) {
+        unresolved.push_back(rsi);
+      }
+    }
+
+    if (!unresolved.empty()) {
+      if (rsi_cache_.size() + unresolved.size() > kMaxCachedRsi) {
+        rsi_cache_.clear();
+      }
+      for (const auto& rsi : unresolved) {
+        rsi_cache_[rsi] = bluetooth::groups::kGroupUnknown;
+      }
+
+      for (const auto& group : csis_groups_) {
+        if (!group->IsSirkAvailable()) continue;
+
+        auto matches =
+            CsisGroup::match_rsis_to_sirk(unresolved, group->GetSirk());
+        for (size_t i = 0; i < unresolved.size(); i++) {
+          int& group_id = rsi_cache_[unresolved[i]];
+          if (matches[i] && group_id == bluetooth::groups::kGroupUnknown) {
+            group_id = group->GetGroupId();
+          }
+        }
+      }
+    }
+
+    for (size_t i = 0; i < all_rsi.size(); i++) {
+      auto it = rsi_cache_.find(all_rsi[i]);
+      if (it != rsi_cache_.end()) rsi_groups[i] = it->second;
+    }
+    return rsi_groups;
+  }
+
   std::vector<RawAddress> GetAllRsiFromAdvertising(
       const tBTA_DM_INQ_RES* result) {
     const uint8_t* p_service_data = result->p_eir;
@@ -1188,11 +1268,11 @@ class CsisClientImpl : public CsisClient {
       return;
     }
 
-    auto discovered_group_rsi = std::find_if(
-        all_rsi.cbegin(), all_rsi.cend(), [&csis_group](const auto& rsi) {
-          return csis_group->IsRsiMatching(rsi);
-        });
-    if (discovered_group_rsi != all_rsi.cend()) {
+    auto rsi_groups = ResolveRsis(all_rsi);
+    auto discovered_group_rsi =
+        std::find(rsi_groups.cbegin(), rsi_groups.cend(),
+                  csis_group->GetGroupId());
+    if (discovered_group_rsi != rsi_groups.cend()) {
       DLOG(INFO) << "Found set member " << result->bd_addr;
       callbacks_->OnSetMemberAvailable(result->bd_addr,
                                        csis_group->GetGroupId());
@@ -1249,12 +1329,20 @@ class CsisClientImpl : public CsisClient {
 
   void CheckForGroupInInqDb(const std::shared_ptr<CsisGroup>& csis_group) {
     // Check if last inquiry already found devices with RSI matching this group
+    std::vector<tBTM_INQ_INFO*> inq_entries;
+    std::vector<RawAddress> all_rsi;
     for (tBTM_INQ_INFO* inq_ent = BTM_InqDbFirst(); inq_ent != nullptr;
          inq_ent = BTM_InqDbNext(inq_ent)) {
-      RawAddress rsi = inq_ent->results.ble_ad_rsi;
-      if (!csis_group->IsRsiMatching(rsi)) continue;
+      if (inq_ent->results.ble_ad_rsi.IsEmpty()) continue;
+      inq_entries.push_back(inq_ent);
+      all_rsi.push_back(inq_ent->results.ble_ad_rsi);
+    }
+
+    auto rsi_groups = ResolveRsis(all_rsi);
+    for (size_t i = 0; i < inq_entries.size(); i++) {
+      if (rsi_groups[i] != csis_group->GetGroupId()) continue;
 
-      RawAddress address = inq_ent->results.remote_bd_addr;
+      RawAddress address = inq_entries[i]->results.remote_bd_addr;
       auto device = FindDeviceByAddress(address);
       if (device && csis_group->IsDeviceInTheGroup(device)) {
         // InqDb will also contain existing devices, already in group - skip
@@ -1270,6 +1358,8 @@ class CsisClientImpl : public CsisClient {
   }
 
   void CsisActiveDiscovery(std::shared_ptr<CsisGroup> csis_group) {
+    set_discovery_start_.emplace(csis_group->GetGroupId(),
+                                 std::chrono::steady_clock::now());
     CheckForGroupInInqDb(csis_group);
 
     if ((csis_group->GetDiscoveryState() !=
@@ -1299,10 +1389,12 @@ class CsisClientImpl : public CsisClient {
     auto all_rsi = GetAllRsiFromAdvertising(result);
     if (all_rsi.empty()) return;
 
+    auto rsi_groups = ResolveRsis(all_rsi);
+
     /* Notify all the groups this device belongs to. */
     for (auto& group : csis_groups_) {
-      for (auto& rsi : all_rsi) {
-        if (group->IsRsiMatching(rsi)) {
+      for (int rsi_group_id : rsi_groups) {
+        if (rsi_group_id == group->GetGroupId()) {
           LOG_INFO("Device %s match to group id %d",
                    result->bd_addr.ToString().c_str(), group->GetGroupId());
           if (group->GetDesiredSize() > 0 &&
@@ -1444,9 +1536,11 @@ class CsisClientImpl : public CsisClient {
       csis_group->AddDevice(device);
       /* Let's update csis instance group id */
       csis_instance->SetGroupId(group_id);
+      CheckSetCompleted(csis_group);
     }
 
     csis_group->SetSirk(received_sirk);
+    rsi_cache_.clear();
     device->is_gatt_service_valid = true;
     btif_storage_update_csis_info(device->addr);
 
@@ -1977,6 +2071,10 @@ class CsisClientImpl : public CsisClient {
   std::list<std::shared_ptr<CsisGroup>> csis_groups_;
   DeviceGroups* dev_groups_;
   int discovering_group_ = -1;
+  /* RSI -> group id it resolved to, or kGroupUnknown */
+  std::unordered_map<RawAddress, int> rsi_cache_;
+  std::map<int, std::chrono::steady_clock::time_point> set_discovery_start_;
+  std::map<int, std::chrono::milliseconds> set_completion_time_;
 };
 
 class DeviceGroupsCallbacksImpl : public DeviceGroupsCallbacks {
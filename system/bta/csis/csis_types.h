@@ -321,6 +321,7 @@ class CsisGroup {
   }
   bool IsRsiMatching(const RawAddress& rsi) const { return is_rsi_match_sirk(rsi, GetSirk()); }
   bool IsSirkBelongsToGroup(Octet16 sirk) const { return (sirk_available_ && sirk_ == sirk); }
+  bool IsSirkAvailable(void) const { return sirk_available_; }
   Octet16 GetSirk(void) const { return sirk_; }
   void SetSirk(Octet16& sirk) {
     if (sirk_available_) {
@@ -474,6 +475,26 @@ class CsisGroup {
     return false;
   }
 
+  /* Same as is_rsi_match_sirk() for a whole batch of |rsis|. The AES key
+   * schedule for |sirk| is expanded once for all of them. */
+  static std::vector<bool> match_rsis_to_sirk(const std::vector<RawAddress>& rsis, const Octet16& sirk) {
+    std::vector<Octet16> prands(rsis.size());
+    for (size_t i = 0; i < rsis.size(); i++) {
+      prands[i].fill(0);
+      prands[i][0] = rsis[i].address[2];
+      prands[i][1] = rsis[i].address[1];
+      prands[i][2] = rsis[i].address[0];
+    }
+
+    std::vector<Octet16> hashes = crypto_toolbox::aes_128(sirk, prands);
+    std::vector<bool> matches(rsis.size());
+    for (size_t i = 0; i < rsis.size(); i++) {
+      matches[i] = hashes[i][0] == rsis[i].address[5] && hashes[i][1] == rsis[i].address[4] &&
+                   hashes[i][2] == rsis[i].address[3];
+    }
+    return matches;
+  }
+
  private:
   int group_id_;
   Octet16 sirk_ = {0};
@@ -286,6 +286,7 @@ void bta_dm_enable(tBTA_DM_SEC_CBACK* p_sec_cback) {
  ******************************************************************************/
 void bta_dm_init_cb(void) {
   bta_dm_cb = {};
+  bta_dm_name_init();
   bta_dm_cb.disable_timer = alarm_new("bta_dm.disable_timer");
   bta_dm_cb.switch_delay_timer = alarm_new("bta_dm.switch_delay_timer");
   for (size_t i = 0; i < BTA_DM_NUM_PM_TIMER; i++) {
@@ -317,6 +318,7 @@ void bta_dm_deinit_cb(void) {
       alarm_free(bta_dm_cb.pm_timer[i].timer[j]);
     }
   }
+  bta_dm_name_cleanup();
   bta_dm_cb = {};
 }
 
@@ -974,6 +976,7 @@ static bool bta_dm_read_remote_device_name(const RawAddress& bd_addr,
 
   if (btm_status == BTM_CMD_STARTED) {
     APPL_TRACE_DEBUG("%s: BTM_ReadRemoteDeviceName is started", __func__);
+    bta_dm_name_request_started(bd_addr);
 
     return (true);
   } else if (btm_status == BTM_BUSY) {
@@ -1741,6 +1744,14 @@ static void bta_dm_discover_device(const RawAddress& remote_bd_addr) {
               PRIVATE_ADDRESS(remote_bd_addr));
     bta_dm_search_cb.name_discover_done = true;
   }
+  // A name resolved by an earlier inquiry, or carried complete in the EIR,
+  // makes the remote name request redundant
+  if (!bta_dm_search_cb.name_discover_done &&
+      bta_dm_name_lookup(remote_bd_addr, bta_dm_search_cb.peer_name)) {
+    LOG_DEBUG("Remote name cached skipping read remote name peer:%s",
+              PRIVATE_ADDRESS(remote_bd_addr));
+    bta_dm_search_cb.name_discover_done = true;
+  }
 
   /* if name discovery is not done and application needs remote name */
   if ((!bta_dm_search_cb.name_discover_done) &&
@@ -1897,6 +1908,10 @@ static void bta_dm_inq_results_cb(tBTM_INQ_RESULTS* p_inq, const uint8_t* p_eir,
      copy that to the inquiry data base*/
     if (result.inq_res.remt_name_not_required)
       p_inq_info->appl_knows_rem_name = true;
+
+    /* a complete name in the EIR is as good as a remote name request */
+    if (bta_dm_name_process_eir(p_inq->remote_bd_addr, p_eir, eir_len))
+      p_inq_info->appl_knows_rem_name = true;
   }
 }
 
@@ -2014,6 +2029,10 @@ static void bta_dm_remname_cback(void* p) {
     }
   }
 
+  bta_dm_name_request_complete(bta_dm_search_cb.peer_bdaddr,
+                               p_remote_name->hci_status,
+                               p_remote_name->remote_bd_name);
+
   /* remote name discovery is done but it could be failed */
   bta_dm_search_cb.name_discover_done = true;
   strlcpy((char*)bta_dm_search_cb.peer_name,
@@ -3458,6 +3477,10 @@ static void bta_dm_observe_results_cb(tBTM_INQ_RESULTS* p_inq,
      copy that to the inquiry data base*/
     if (result.inq_res.remt_name_not_required)
       p_inq_info->appl_knows_rem_name = true;
+
+    /* a complete name in the EIR is as good as a remote name request */
+    if (bta_dm_name_process_eir(p_inq->remote_bd_addr, p_eir, eir_len))
+      p_inq_info->appl_knows_rem_name = true;
   }
 }
 
@@ -3509,6 +3532,10 @@ static void bta_dm_opportunistic_observe_results_cb(tBTM_INQ_RESULTS* p_inq,
      copy that to the inquiry data base*/
     if (result.inq_res.remt_name_not_required)
       p_inq_info->appl_knows_rem_name = true;
+
+    /* a complete name in the EIR is as good as a remote name request */
+    if (bta_dm_name_process_eir(p_inq->remote_bd_addr, p_eir, eir_len))
+      p_inq_info->appl_knows_rem_name = true;
   }
 }
 
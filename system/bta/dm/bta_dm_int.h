@@ -553,6 +553,16 @@ extern void bta_dm_ci_rmt_oob_act(std::unique_ptr<tBTA_DM_CI_RMT_OOB> msg);
 extern void bta_dm_init_pm(void);
 extern void bta_dm_disable_pm(void);
 
+extern void bta_dm_name_init(void);
+extern void bta_dm_name_cleanup(void);
+extern bool bta_dm_name_process_eir(const RawAddress& bd_addr,
+                                    const uint8_t* p_eir, uint16_t eir_len);
+extern bool bta_dm_name_lookup(const RawAddress& bd_addr, BD_NAME bd_name);
+extern void bta_dm_name_request_started(const RawAddress& bd_addr);
+extern void bta_dm_name_request_complete(const RawAddress& bd_addr,
+                                         tHCI_STATUS hci_status,
+                                         const BD_NAME bd_name);
+
 extern uint8_t bta_dm_get_av_count(void);
 extern void bta_dm_search_start(tBTA_DM_MSG* p_data);
 extern void bta_dm_search_cancel();
@@ -0,0 +1,300 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/******************************************************************************
+ *
+ *  This file contains the remote name resolution bookkeeping used by the
+ *  device manager search state machine: a bounded cache of resolved names
+ *  that survives across inquiries and per-device resolution timing.
+ *
+ ******************************************************************************/
+
+#define LOG_TAG "bt_bta_dm"
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <list>
+#include <unordered_map>
+
+#include "bta/dm/bta_dm_int.h"
+#include "main/shim/dumpsys.h"
+#include "osi/include/compat.h"
+#include "osi/include/log.h"
+#include "stack/include/advertise_data_parser.h"
+#include "stack/include/bt_name.h"
+#include "stack/include/hci_error_code.h"
+#include "stack/include/hcidefs.h"
+#include "types/raw_address.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/* Maximum number of names remembered across inquiries */
+constexpr size_t kMaxCachedNames = 256;
+/* Names not refreshed within this period are resolved again */
+constexpr std::chrono::minutes kCachedNameLifetime{30};
+/* Number of per-device resolution records kept for dumpsys */
+constexpr size_t kMaxResolutionHistory = 32;
+
+enum class NameSource : uint8_t { kRemoteNameRequest, kEir };
+
+struct CachedName {
+  RawAddress bd_addr;
+  BD_NAME bd_name;
+  NameSource source;
+  Clock::time_point updated;
+};
+
+struct ResolutionRecord {
+  RawAddress bd_addr;
+  tHCI_STATUS hci_status;
+  uint64_t duration_ms;
+};
+
+struct NameResolutionStats {
+  size_t requests_started{0};
+  size_t requests_succeeded{0};
+  size_t requests_failed{0};
+  size_t eir_names{0};
+  size_t cache_hits{0};
+  uint64_t total_duration_ms{0};
+  uint64_t max_duration_ms{0};
+};
+
+class NameResolver {
+ public:
+  bool Lookup(const RawAddress& bd_addr, BD_NAME bd_name) {
+    auto it = index_.find(bd_addr);
+    if (it == index_.end()) return false;
+
+    if (Clock::now() - it->second->updated > kCachedNameLifetime) {
+      lru_.erase(it->second);
+      index_.erase(it);
+      return false;
+    }
+
+    /* Move to the front of the LRU list */
+    lru_.splice(lru_.begin(), lru_, it->second);
+    strlcpy((char*)bd_name, (const char*)it->second->bd_name, BD_NAME_LEN + 1);
+    stats_.cache_hits++;
+    return true;
+  }
+
+  void Update(const RawAddress& bd_addr, const uint8_t* p_name, size_t len,
+              NameSource source) {
+    if (len == 0) return;
+    if (len > BD_NAME_LEN) len = BD_NAME_LEN;
+
+    auto it = index_.find(bd_addr);
+    if (it != index_.end()) {
+      lru_.splice(lru_.begin(), lru_, it->second);
+    } else {
+      if (lru_.size() >= kMaxCachedNames) {
+        index_.erase(lru_.back().bd_addr);
+        lru_.pop_back();
+      }
+      lru_.push_front({.bd_addr = bd_addr});
+      index_[bd_addr] = lru_.begin();
+    }
+
+    CachedName& entry = lru_.front();
+    memcpy(entry.bd_name, p_name, len);
+    entry.bd_name[len] = 0;
+    entry.source = source;
+    entry.updated = Clock::now();
+  }
+
+  void OnEirName() { stats_.eir_names++; }
+
+  void RequestStarted(const RawAddress& bd_addr) {
+    pending_[bd_addr] = Clock::now();
+    stats_.requests_started++;
+  }
+
+  void RequestComplete(const RawAddress& bd_addr, tHCI_STATUS hci_status,
+                       const BD_NAME bd_name) {
+    auto it = pending_.find(bd_addr);
+    if (it == pending_.end()) return;
+
+    uint64_t duration_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() -
+                                                              it->second)
+            .count();
+    pending_.erase(it);
+
+    if (hci_status == HCI_SUCCESS && bd_name[0] != 0) {
+      stats_.requests_succeeded++;
+      Update(bd_addr, bd_name, strnlen((const char*)bd_name, BD_NAME_LEN),
+             NameSource::kRemoteNameRequest);
+    } else {
+      stats_.requests_failed++;
+    }
+    stats_.total_duration_ms += duration_ms;
+    if (duration_ms > stats_.max_duration_ms)
+      stats_.max_duration_ms = duration_ms;
+
+    if (history_.size() >= kMaxResolutionHistory) history_.pop_front();
+    history_.push_back({bd_addr, hci_status, duration_ms});
+
+    LOG_DEBUG("Remote name resolution peer:%s status:%s took %llu ms",
+              PRIVATE_ADDRESS(bd_addr), hci_error_code_text(hci_status).c_str(),
+              static_cast<unsigned long long>(duration_ms));
+  }
+
+  void Clear() {
+    lru_.clear();
+    index_.clear();
+    pending_.clear();
+    history_.clear();
+    stats_ = {};
+  }
+
+  void Dump(int fd) const {
+#define DUMPSYS_TAG "shim::legacy::bta::dm::name"
+    LOG_DUMPSYS_TITLE(fd, DUMPSYS_TAG);
+    size_t completed = stats_.requests_succeeded + stats_.requests_failed;
+    LOG_DUMPSYS(fd,
+                "Requests started:%zu succeeded:%zu failed:%zu "
+                "eir_names:%zu cache_hits:%zu cached:%zu",
+                stats_.requests_started, stats_.requests_succeeded,
+                stats_.requests_failed, stats_.eir_names, stats_.cache_hits,
+                lru_.size());
+    LOG_DUMPSYS(fd, "Resolution time avg:%llu ms max:%llu ms",
+                static_cast<unsigned long long>(
+                    completed ? stats_.total_duration_ms / completed : 0),
+                static_cast<unsigned long long>(stats_.max_duration_ms));
+    LOG_DUMPSYS(fd, "Recent resolutions:");
+    for (const auto& record : history_) {
+      LOG_DUMPSYS(fd, "  peer:%s status:%s duration:%llu ms",
+                  PRIVATE_ADDRESS(record.bd_addr),
+                  hci_error_code_text(record.hci_status).c_str(),
+                  static_cast<unsigned long long>(record.duration_ms));
+    }
+#undef DUMPSYS_TAG
+  }
+
+ private:
+  std::list<CachedName> lru_;
+  std::unordered_map<RawAddress, std::list<CachedName>::iterator> index_;
+  std::unordered_map<RawAddress, Clock::time_point> pending_;
+  std::deque<ResolutionRecord> history_;
+  NameResolutionStats stats_;
+};
+
+NameResolver name_resolver;
+
+}  // namespace
+
+/*******************************************************************************
+ *
+ * Function         bta_dm_name_init
+ *
+ * Description      Clears the remote name cache and registers its dumpsys
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void bta_dm_name_init(void) {
+  name_resolver.Clear();
+  bluetooth::shim::RegisterDumpsysFunction(
+      static_cast<const void*>(&name_resolver),
+      [](int fd) { name_resolver.Dump(fd); });
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_dm_name_cleanup
+ *
+ * Description      Releases the remote name cache
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void bta_dm_name_cleanup(void) {
+  bluetooth::shim::UnregisterDumpsysFunction(
+      static_cast<const void*>(&name_resolver));
+  name_resolver.Clear();
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_dm_name_process_eir
+ *
+ * Description      Caches the complete local name carried in the extended
+ *                  inquiry response, if any. A shortened name does not make
+ *                  the remote name request redundant and is ignored.
+ *
+ * Returns          true if the EIR carried a complete local name
+ *
+ ******************************************************************************/
+bool bta_dm_name_process_eir(const RawAddress& bd_addr, const uint8_t* p_eir,
+                             uint16_t eir_len) {
+  if (p_eir == nullptr || eir_len == 0) return false;
+
+  uint8_t name_len = 0;
+  const uint8_t* p_name = AdvertiseDataParser::GetFieldByType(
+      p_eir, eir_len, HCI_EIR_COMPLETE_LOCAL_NAME_TYPE, &name_len);
+  if (p_name == nullptr || name_len == 0) return false;
+
+  name_resolver.Update(bd_addr, p_name, name_len, NameSource::kEir);
+  name_resolver.OnEirName();
+  return true;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_dm_name_lookup
+ *
+ * Description      Looks up a previously resolved name for the device
+ *
+ * Returns          true and fills bd_name if a fresh name is cached
+ *
+ ******************************************************************************/
+bool bta_dm_name_lookup(const RawAddress& bd_addr, BD_NAME bd_name) {
+  return name_resolver.Lookup(bd_addr, bd_name);
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_dm_name_request_started
+ *
+ * Description      Records the start of a remote name request
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void bta_dm_name_request_started(const RawAddress& bd_addr) {
+  name_resolver.RequestStarted(bd_addr);
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_dm_name_request_complete
+ *
+ * Description      Records the outcome of a remote name request and caches
+ *                  the name on success
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void bta_dm_name_request_complete(const RawAddress& bd_addr,
+                                  tHCI_STATUS hci_status,
+                                  const BD_NAME bd_name) {
+  name_resolver.RequestComplete(bd_addr, hci_status, bd_name);
+}
@@ -938,11 +938,15 @@ void bta_gattc_read_multi(tBTA_GATTC_CLCB* p_clcb,
 
   read_param.read_multiple.num_handles = p_data->api_read_multi.num_attr;
   read_param.read_multiple.auth_req = p_data->api_read_multi.auth_req;
+  read_param.read_multiple.variable_len = p_data->api_read_multi.variable_len;
   memcpy(&read_param.read_multiple.handles, p_data->api_read_multi.handles,
          sizeof(uint16_t) * p_data->api_read_multi.num_attr);
 
+  tGATT_READ_TYPE read_type = p_data->api_read_multi.variable_len
+                                  ? GATT_READ_MULTIPLE_VAR_LEN
+                                  : GATT_READ_MULTIPLE;
   tGATT_STATUS status =
-      GATTC_Read(p_clcb->bta_conn_id, GATT_READ_MULTIPLE, &read_param);
+      GATTC_Read(p_clcb->bta_conn_id, read_type, &read_param);
   /* read fail */
   if (status != GATT_SUCCESS) {
     /* Dequeue the data, if it was enqueued */
@@ -1037,6 +1041,26 @@ static void bta_gattc_read_cmpl(tBTA_GATTC_CLCB* p_clcb,
   }
 }
 
+/** read multiple complete */
+static void bta_gattc_read_multi_cmpl(tBTA_GATTC_CLCB* p_clcb,
+                                      const tBTA_GATTC_OP_CMPL* p_data) {
+  GATT_READ_MULTI_OP_CB cb = p_clcb->p_q_cmd->api_read_multi.read_cb;
+  void* my_cb_data = p_clcb->p_q_cmd->api_read_multi.read_cb_data;
+
+  tBTA_GATTC_MULTI handles;
+  handles.num_attr = p_clcb->p_q_cmd->api_read_multi.num_attr;
+  memcpy(handles.handles, p_clcb->p_q_cmd->api_read_multi.handles,
+         sizeof(uint16_t) * handles.num_attr);
+
+  osi_free_and_reset((void**)&p_clcb->p_q_cmd);
+
+  if (cb) {
+    cb(p_clcb->bta_conn_id, p_data->status, handles,
+       p_data->p_cmpl->att_value.len, p_data->p_cmpl->att_value.value,
+       my_cb_data);
+  }
+}
+
 /** write complete */
 static void bta_gattc_write_cmpl(tBTA_GATTC_CLCB* p_clcb,
                                  const tBTA_GATTC_OP_CMPL* p_data) {
@@ -1131,8 +1155,13 @@ void bta_gattc_op_cmpl(tBTA_GATTC_CLCB* p_clcb, const tBTA_GATTC_DATA* p_data) {
       return;
   }
 
-  if (p_clcb->p_q_cmd->hdr.event !=
-      bta_gattc_opcode_to_int_evt[op - GATTC_OPTYPE_READ]) {
+  /* read multiple completes as a read */
+  const bool is_read_multi =
+      op == GATTC_OPTYPE_READ &&
+      p_clcb->p_q_cmd->hdr.event == BTA_GATTC_API_READ_MULTI_EVT;
+  if (!is_read_multi &&
+      p_clcb->p_q_cmd->hdr.event !=
+          bta_gattc_opcode_to_int_evt[op - GATTC_OPTYPE_READ]) {
     uint8_t mapped_op =
         p_clcb->p_q_cmd->hdr.event - BTA_GATTC_API_READ_EVT + GATTC_OPTYPE_READ;
     if (mapped_op > GATTC_OPTYPE_INDICATION) mapped_op = 0;
@@ -1156,7 +1185,10 @@ void bta_gattc_op_cmpl(tBTA_GATTC_CLCB* p_clcb, const tBTA_GATTC_DATA* p_data) {
   }
 
   /* service handle change void the response, discard it */
-  if (op == GATTC_OPTYPE_READ)
+  if (is_read_multi)
+    bta_gattc_read_multi_cmpl(p_clcb, &p_data->op_cmpl);
+
+  else if (op == GATTC_OPTYPE_READ)
     bta_gattc_read_cmpl(p_clcb, &p_data->op_cmpl);
 
   else if (op == GATTC_OPTYPE_WRITE)
@@ -1232,6 +1264,7 @@ static void bta_gattc_deregister_cmpl(tBTA_GATTC_RCB* p_clreg) {
   memset(&cb_data, 0, sizeof(tBTA_GATTC));
 
   GATT_Deregister(p_clreg->client_if);
+  bta_gattc_cb.notif_index.RemoveClient(client_if);
   memset(p_clreg, 0, sizeof(tBTA_GATTC_RCB));
 
   cb_data.reg_oper.client_if = client_if;
@@ -1405,7 +1438,8 @@ static bool bta_gattc_process_srvc_chg_ind(uint16_t conn_id,
 /** process all non-service change indication/notification */
 static void bta_gattc_proc_other_indication(tBTA_GATTC_CLCB* p_clcb, uint8_t op,
                                             tGATT_CL_COMPLETE* p_data,
-                                            tBTA_GATTC_NOTIFY* p_notify) {
+                                            tBTA_GATTC* p_bta_gattc) {
+  tBTA_GATTC_NOTIFY* p_notify = &p_bta_gattc->notify;
   VLOG(1) << __func__
           << StringPrintf(
                  ": check p_data->att_value.handle=%d p_data->handle=%d",
@@ -1419,9 +1453,7 @@ static void bta_gattc_proc_other_indication(tBTA_GATTC_CLCB* p_clcb, uint8_t op,
   p_notify->conn_id = p_clcb->bta_conn_id;
 
   if (p_clcb->p_rcb->p_cback) {
-    tBTA_GATTC bta_gattc;
-    bta_gattc.notify = *p_notify;
-    (*p_clcb->p_rcb->p_cback)(BTA_GATTC_NOTIF_EVT, &bta_gattc);
+    (*p_clcb->p_rcb->p_cback)(BTA_GATTC_NOTIF_EVT, p_bta_gattc);
   }
 }
 
@@ -1429,7 +1461,9 @@ static void bta_gattc_proc_other_indication(tBTA_GATTC_CLCB* p_clcb, uint8_t op,
 static void bta_gattc_process_indicate(uint16_t conn_id, tGATTC_OPTYPE op,
                                        tGATT_CL_COMPLETE* p_data) {
   uint16_t handle = p_data->att_value.handle;
-  tBTA_GATTC_NOTIFY notify;
+  /* the event is built in place, it is not copied again for the callback */
+  tBTA_GATTC bta_gattc;
+  tBTA_GATTC_NOTIFY& notify = bta_gattc.notify;
   RawAddress remote_bda;
   tGATT_IF gatt_if;
   tBT_TRANSPORT transport;
@@ -1441,6 +1475,14 @@ static void bta_gattc_process_indicate(uint16_t conn_id, tGATTC_OPTYPE op,
     return;
   }
 
+  /* Every client gets every notification of the link: drop the ones this
+   * client did not register for before looking anything else up. The Service
+   * Changed characteristic is indicated, never notified. */
+  if (op == GATTC_OPTYPE_NOTIFICATION &&
+      !bta_gattc_cb.notif_index.Contains(gatt_if, remote_bda, handle)) {
+    return;
+  }
+
   tBTA_GATTC_RCB* p_clrcb = bta_gattc_cl_get_regcb(gatt_if);
   if (p_clrcb == NULL) {
     LOG(ERROR) << __func__ << ": indication/notif for unregistered app";
@@ -1462,8 +1504,9 @@ static void bta_gattc_process_indicate(uint16_t conn_id, tGATTC_OPTYPE op,
   notify.handle = handle;
   notify.cid = p_data->cid;
 
-  /* if service change indication/notification, don't forward to application */
-  if (bta_gattc_process_srvc_chg_ind(conn_id, p_clrcb, p_srcb, p_clcb, &notify,
+  /* if service change indication, don't forward to application */
+  if (op == GATTC_OPTYPE_INDICATION &&
+      bta_gattc_process_srvc_chg_ind(conn_id, p_clrcb, p_srcb, p_clcb, &notify,
                                      &p_data->att_value))
     return;
 
@@ -1485,7 +1528,7 @@ static void bta_gattc_process_indicate(uint16_t conn_id, tGATTC_OPTYPE op,
     }
 
     if (p_clcb != NULL)
-      bta_gattc_proc_other_indication(p_clcb, op, p_data, &notify);
+      bta_gattc_proc_other_indication(p_clcb, op, p_data, &bta_gattc);
   }
   /* no one intersted and need ack? */
   else if (op == GATTC_OPTYPE_INDICATION) {
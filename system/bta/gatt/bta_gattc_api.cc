@@ -452,12 +452,15 @@ void BTA_GATTC_ReadCharDescr(uint16_t conn_id, uint16_t handle,
  *
  * Parameters       conn_id - connectino ID.
  *                    p_read_multi - pointer to the read multiple parameter.
+ *                    variable_len - use Read Multiple Variable Length.
+ *                    callback - called with the concatenated values.
  *
  * Returns          None
  *
  ******************************************************************************/
 void BTA_GATTC_ReadMultiple(uint16_t conn_id, tBTA_GATTC_MULTI* p_read_multi,
-                            tGATT_AUTH_REQ auth_req) {
+                            bool variable_len, tGATT_AUTH_REQ auth_req,
+                            GATT_READ_MULTI_OP_CB callback, void* cb_data) {
   tBTA_GATTC_API_READ_MULTI* p_buf =
       (tBTA_GATTC_API_READ_MULTI*)osi_calloc(sizeof(tBTA_GATTC_API_READ_MULTI));
 
@@ -465,6 +468,9 @@ void BTA_GATTC_ReadMultiple(uint16_t conn_id, tBTA_GATTC_MULTI* p_read_multi,
   p_buf->hdr.layer_specific = conn_id;
   p_buf->auth_req = auth_req;
   p_buf->num_attr = p_read_multi->num_attr;
+  p_buf->variable_len = variable_len;
+  p_buf->read_cb = callback;
+  p_buf->read_cb_data = cb_data;
 
   if (p_buf->num_attr > 0)
     memcpy(p_buf->handles, p_read_multi->handles,
@@ -644,7 +650,8 @@ void BTA_GATTC_SendIndConfirm(uint16_t conn_id, uint16_t cid) {
  * Function         BTA_GATTC_RegisterForNotifications
  *
  * Description      This function is called to register for notification of a
- *                  service.
+ *                  service. Must be called on the main thread, which looks
+ *                  the registrations up for every notification.
  *
  * Parameters       client_if - client interface.
  *                  bda - target GATT server.
@@ -686,6 +693,7 @@ tGATT_STATUS BTA_GATTC_RegisterForNotifications(tGATT_IF client_if,
           p_clreg->notif_reg[i].remote_bda = bda;
 
           p_clreg->notif_reg[i].handle = handle;
+          bta_gattc_cb.notif_index.Add(client_if, bda, handle);
           status = GATT_SUCCESS;
           break;
         }
@@ -707,7 +715,7 @@ tGATT_STATUS BTA_GATTC_RegisterForNotifications(tGATT_IF client_if,
  * Function         BTA_GATTC_DeregisterForNotifications
  *
  * Description      This function is called to de-register for notification of a
- *                  service.
+ *                  service. Must be called on the main thread.
  *
  * Parameters       client_if - client interface.
  *                  remote_bda - target GATT server.
@@ -737,6 +745,7 @@ tGATT_STATUS BTA_GATTC_DeregisterForNotifications(tGATT_IF client_if,
         p_clreg->notif_reg[i].handle == handle) {
       VLOG(1) << __func__ << " deregistered bd_addr=" << bda;
       memset(&p_clreg->notif_reg[i], 0, sizeof(tBTA_GATTC_NOTIF_REG));
+      bta_gattc_cb.notif_index.Remove(client_if, bda, handle);
       return GATT_SUCCESS;
     }
   }
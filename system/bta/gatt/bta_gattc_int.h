@@ -26,6 +26,7 @@
 
 #include <cstdint>
 #include <deque>
+#include <unordered_map>
 
 #include "bt_target.h"  // Must be first to define build configuration
 #include "bta/gatt/database.h"
@@ -161,6 +162,9 @@ typedef struct {
   tGATT_AUTH_REQ auth_req;
   uint8_t num_attr;
   uint16_t handles[GATT_MAX_READ_MULTI_HANDLES];
+  bool variable_len;
+  GATT_READ_MULTI_OP_CB read_cb;
+  void* read_cb_data;
 } tBTA_GATTC_API_READ_MULTI;
 
 typedef struct {
@@ -300,6 +304,31 @@ typedef struct {
 
 } tBTA_GATTC_BG_TCK;
 
+/* Index of the clients registered for the notifications of each handle of
+ * each server. It mirrors the in_use entries of the notif_reg arrays of the
+ * clients, so that a notification is matched with its subscribers in one
+ * lookup rather than by walking the registrations of every client.
+ */
+class BtaGattcNotifIndex {
+ public:
+  void Add(tGATT_IF client_if, const RawAddress& bda, uint16_t handle);
+  void Remove(tGATT_IF client_if, const RawAddress& bda, uint16_t handle);
+
+  /* Removes every registration of the client */
+  void RemoveClient(tGATT_IF client_if);
+
+  bool Contains(tGATT_IF client_if, const RawAddress& bda,
+                uint16_t handle) const;
+
+  size_t Size() const { return clients_.size(); }
+
+ private:
+  /* The 48 bit address and the 16 bit handle make up a 64 bit key */
+  static uint64_t Key(const RawAddress& bda, uint16_t handle);
+
+  std::unordered_map<uint64_t, tBTA_GATTC_CIF_MASK> clients_;
+};
+
 typedef struct {
   bool in_use;
   RawAddress remote_bda;
@@ -321,6 +350,8 @@ typedef struct {
 
   tBTA_GATTC_CLCB clcb[BTA_GATTC_CLCB_MAX];
   tBTA_GATTC_SERV known_server[BTA_GATTC_KNOWN_SR_MAX];
+
+  BtaGattcNotifIndex notif_index;
 } tBTA_GATTC_CB;
 
 /*****************************************************************************
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdint>
+
+#include "bta/gatt/bta_gattc_int.h"
+#include "types/raw_address.h"
+
+namespace {
+
+constexpr size_t kNumClientBits = sizeof(tBTA_GATTC_CIF_MASK) * 8;
+
+/* Client interfaces start at 1, as in the background connection masks */
+bool client_bit(tGATT_IF client_if, tBTA_GATTC_CIF_MASK* bit) {
+  if (client_if == 0 || client_if > kNumClientBits) return false;
+  *bit = static_cast<tBTA_GATTC_CIF_MASK>(1u << (client_if - 1));
+  return true;
+}
+
+}  // namespace
+
+uint64_t BtaGattcNotifIndex::Key(const RawAddress& bda, uint16_t handle) {
+  uint64_t key = 0;
+  for (uint8_t byte : bda.address) key = (key << 8) | byte;
+  return (key << 16) | handle;
+}
+
+void BtaGattcNotifIndex::Add(tGATT_IF client_if, const RawAddress& bda,
+                             uint16_t handle) {
+  tBTA_GATTC_CIF_MASK bit;
+  if (!client_bit(client_if, &bit)) return;
+  clients_[Key(bda, handle)] |= bit;
+}
+
+void BtaGattcNotifIndex::Remove(tGATT_IF client_if, const RawAddress& bda,
+                                uint16_t handle) {
+  tBTA_GATTC_CIF_MASK bit;
+  if (!client_bit(client_if, &bit)) return;
+  auto it = clients_.find(Key(bda, handle));
+  if (it == clients_.end()) return;
+  it->second &= ~bit;
+  if (it->second == 0) clients_.erase(it);
+}
+
+void BtaGattcNotifIndex::RemoveClient(tGATT_IF client_if) {
+  tBTA_GATTC_CIF_MASK bit;
+  if (!client_bit(client_if, &bit)) return;
+  for (auto it = clients_.begin(); it != clients_.end();) {
+    it->second &= ~bit;
+    if (it->second == 0) {
+      it = clients_.erase(it);
+    } else {
+      it++;
+    }
+  }
+}
+
+bool BtaGattcNotifIndex::Contains(tGATT_IF client_if, const RawAddress& bda,
+                                  uint16_t handle) const {
+  tBTA_GATTC_CIF_MASK bit;
+  if (!client_bit(client_if, &bit)) return false;
+  auto it = clients_.find(Key(bda, handle));
+  return it != clients_.end() && (it->second & bit) != 0;
+}
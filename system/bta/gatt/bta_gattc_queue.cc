@@ -16,14 +16,24 @@
 
 #include "bta_gatt_queue.h"
 
+#include <base/logging.h>
+
+#include <algorithm>
 #include <list>
+#include <sstream>
 #include <unordered_map>
-#include <unordered_set>
 
+#include "common/time_util.h"
 #include "osi/include/allocator.h"
-
-#include <base/logging.h>
-
+#include "osi/include/log.h"
+#include "stack/eatt/eatt.h"
+#include "stack/include/bt_types.h"
+#include "stack/include/gattdefs.h"
+#include "types/bluetooth/uuid.h"
+#include "types/raw_address.h"
+
+using bluetooth::Uuid;
+using bluetooth::eatt::EattExtension;
 using gatt_operation = BtaGattQueue::gatt_operation;
 
 constexpr uint8_t GATT_READ_CHAR = 1;
@@ -32,17 +42,58 @@ constexpr uint8_t GATT_WRITE_CHAR = 3;
 constexpr uint8_t GATT_WRITE_DESC = 4;
 constexpr uint8_t GATT_CONFIG_MTU = 5;
 
+static const char* gatt_op_type_text[] = {
+    "", "read_char", "read_desc", "write_char", "write_desc", "config_mtu"};
+
+/* Requests handed to BTA at once, BTA queues them until they are sent */
+constexpr uint8_t kMaxPipelinedOps = 8;
+
 struct gatt_read_op_data {
   GATT_READ_OP_CB cb;
   void* cb_data;
 };
 
+/* Reads sent in one Read Multiple Variable Length request */
+struct gatt_read_multi_op_data {
+  std::vector<gatt_operation> ops;
+};
+
 std::unordered_map<uint16_t, std::list<gatt_operation>>
     BtaGattQueue::gatt_op_queue;
-std::unordered_set<uint16_t> BtaGattQueue::gatt_op_queue_executing;
+std::unordered_map<uint16_t, BtaGattQueue::gatt_conn_state>
+    BtaGattQueue::gatt_op_queue_executing;
+
+/* Time operations waited in the queue, by operation type */
+struct gatt_wait_stats {
+  uint64_t count;
+  uint64_t total_ms;
+  uint64_t max_ms;
+};
+static gatt_wait_stats wait_stats[GATT_CONFIG_MTU + 1];
+static uint64_t reads_batched = 0;
+static uint64_t read_multi_requests = 0;
+static uint64_t reads_retried = 0;
+static uint64_t ops_pipelined = 0;
+
+/* Error codes of an ATT Error Response, as opposed to local failures */
+static bool is_att_error(tGATT_STATUS status) {
+  return status >= GATT_INVALID_HANDLE && status <= GATT_VALUE_NOT_ALLOWED;
+}
+
+static void record_wait(const gatt_operation& op, uint64_t now_ms) {
+  uint64_t wait_ms = now_ms - op.enqueued_ms;
+  gatt_wait_stats& stats = wait_stats[op.type];
+  stats.count++;
+  stats.total_ms += wait_ms;
+  stats.max_ms = std::max(stats.max_ms, wait_ms);
+}
 
 void BtaGattQueue::mark_as_not_executing(uint16_t conn_id) {
-  gatt_op_queue_executing.erase(conn_id);
+  auto state = gatt_op_queue_executing.find(conn_id);
+  if (state == gatt_op_queue_executing.end()) return;
+  /* completions of requests sent before Clean() can come afterwards */
+  if (state->second.in_flight > 0) state->second.in_flight--;
+  if (state->second.in_flight == 0) state->second.pipelining = false;
 }
 
 void BtaGattQueue::gatt_read_op_finished(uint16_t conn_id, tGATT_STATUS status,
@@ -63,6 +114,83 @@ void BtaGattQueue::gatt_read_op_finished(uint16_t conn_id, tGATT_STATUS status,
   }
 }
 
+void BtaGattQueue::gatt_read_multi_op_finished(uint16_t conn_id,
+                                               tGATT_STATUS status,
+                                               const tBTA_GATTC_MULTI& handles,
+                                               uint16_t len, uint8_t* value,
+                                               void* data) {
+  gatt_read_multi_op_data* tmp = (gatt_read_multi_op_data*)data;
+
+  /* The connection is cleaned up on disconnection, while GATT ends its
+   * request: its reads must fail, not be sent again on a stale conn_id. */
+  auto state = gatt_op_queue_executing.find(conn_id);
+  bool connected = state != gatt_op_queue_executing.end();
+  if (connected && status == GATT_REQ_NOT_SUPPORTED) {
+    state->second.read_multi_unsupported = true;
+  }
+
+  /* Each value comes with its length. The response is cut at the MTU: the
+   * reads which did not fit, or all of them on an error response of the
+   * server, are sent again alone. Any other error fails them all. */
+  bool retry = connected && (status == GATT_SUCCESS || is_att_error(status));
+  tGATT_STATUS failure = (status == GATT_SUCCESS) ? GATT_ERROR : status;
+
+  struct read_result {
+    gatt_operation* op;
+    tGATT_STATUS status;
+    uint8_t* value;
+    uint16_t len;
+  };
+  std::vector<read_result> results;
+  std::list<gatt_operation> retries;
+  uint8_t* p = value;
+  uint16_t remaining = (status == GATT_SUCCESS) ? len : 0;
+  for (gatt_operation& op : tmp->ops) {
+    if (remaining >= 2) {
+      uint16_t value_len;
+      STREAM_TO_UINT16(value_len, p);
+      remaining -= 2;
+      if (value_len <= remaining) {
+        results.push_back({.op = &op,
+                           .status = GATT_SUCCESS,
+                           .value = p,
+                           .len = value_len});
+        p += value_len;
+        remaining -= value_len;
+        continue;
+      }
+      remaining = 0;
+    }
+    if (retry) {
+      op.no_batch = true;
+      retries.push_back(std::move(op));
+    } else {
+      results.push_back(
+          {.op = &op, .status = failure, .value = nullptr, .len = 0});
+    }
+  }
+
+  if (!retries.empty()) {
+    LOG_INFO("conn_id=0x%04x, status=0x%02x, retrying %zu of %d reads",
+             conn_id, status, retries.size(), handles.num_attr);
+    reads_retried += retries.size();
+    std::list<gatt_operation>& gatt_ops = gatt_op_queue[conn_id];
+    gatt_ops.splice(gatt_ops.begin(), retries);
+  }
+
+  mark_as_not_executing(conn_id);
+  gatt_execute_next_op(conn_id);
+
+  for (const read_result& result : results) {
+    if (result.op->read_cb) {
+      result.op->read_cb(conn_id, result.status, result.op->handle, result.len,
+                         result.value, result.op->read_cb_data);
+    }
+  }
+
+  delete tmp;
+}
+
 struct gatt_write_op_data {
   GATT_WRITE_OP_CB cb;
   void* cb_data;
@@ -109,30 +237,65 @@ void BtaGattQueue::gatt_configure_mtu_op_finished(uint16_t conn_id,
   }
 }
 
-void BtaGattQueue::gatt_execute_next_op(uint16_t conn_id) {
-  APPL_TRACE_DEBUG("%s: conn_id=0x%x", __func__, conn_id);
-  if (gatt_op_queue.empty()) {
-    APPL_TRACE_DEBUG("%s: op queue is empty", __func__);
-    return;
-  }
+/* Write Commands have no response to wait for, and CCC writes do not depend on
+ * each other: BTA can be given several of them at once. */
+bool BtaGattQueue::is_pipelinable(uint16_t conn_id, const gatt_operation& op) {
+  if (op.type == GATT_WRITE_CHAR) return op.write_type == GATT_WRITE_NO_RSP;
+  if (op.type != GATT_WRITE_DESC) return false;
 
-  auto map_ptr = gatt_op_queue.find(conn_id);
-  if (map_ptr == gatt_op_queue.end() || map_ptr->second.empty()) {
-    APPL_TRACE_DEBUG("%s: no more operations queued for conn_id %d", __func__,
-                     conn_id);
-    return;
+  const gatt::Descriptor* p_desc = BTA_GATTC_GetDescriptor(conn_id, op.handle);
+  return p_desc != nullptr &&
+         p_desc->uuid == Uuid::From16Bit(GATT_UUID_CHAR_CLIENT_CONFIG);
+}
+
+/* Sends the reads at the front of the queue in one request, if there are at
+ * least two and the server supports it */
+bool BtaGattQueue::gatt_batch_reads(uint16_t conn_id,
+                                    std::list<gatt_operation>& gatt_ops) {
+  auto is_batchable = [](const gatt_operation& op) {
+    return (op.type == GATT_READ_CHAR || op.type == GATT_READ_DESC) &&
+           !op.no_batch;
+  };
+
+  auto it = gatt_ops.begin();
+  size_t num_reads = 0;
+  while (it != gatt_ops.end() && num_reads < GATT_MAX_READ_MULTI_HANDLES &&
+         is_batchable(*it)) {
+    it++;
+    num_reads++;
   }
+  if (num_reads < 2) return false;
 
-  if (gatt_op_queue_executing.count(conn_id)) {
-    APPL_TRACE_DEBUG("%s: can't enqueue next op, already executing", __func__);
-    return;
+  if (gatt_op_queue_executing[conn_id].read_multi_unsupported) return false;
+
+  tGATT_IF gatt_if;
+  RawAddress remote_bda;
+  tBT_TRANSPORT transport;
+  if (!GATT_GetConnectionInfor(conn_id, &gatt_if, remote_bda, &transport) ||
+      !EattExtension::GetInstance()->IsEattSupportedByPeer(remote_bda)) {
+    return false;
   }
 
-  gatt_op_queue_executing.insert(conn_id);
+  gatt_read_multi_op_data* data = new gatt_read_multi_op_data();
+  tBTA_GATTC_MULTI read_multi{};
+  uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
+  for (size_t i = 0; i < num_reads; i++) {
+    gatt_operation& op = gatt_ops.front();
+    record_wait(op, now_ms);
+    read_multi.handles[read_multi.num_attr++] = op.handle;
+    data->ops.push_back(std::move(op));
+    gatt_ops.pop_front();
+  }
 
-  std::list<gatt_operation>& gatt_ops = map_ptr->second;
+  reads_batched += num_reads;
+  read_multi_requests++;
+  BTA_GATTC_ReadMultiple(conn_id, &read_multi, true /* variable_len */,
+                         GATT_AUTH_REQ_NONE, gatt_read_multi_op_finished, data);
+  return true;
+}
 
-  gatt_operation& op = gatt_ops.front();
+void BtaGattQueue::gatt_issue_op(uint16_t conn_id, gatt_operation& op) {
+  record_wait(op, bluetooth::common::time_get_os_boottime_ms());
 
   if (op.type == GATT_READ_CHAR) {
     gatt_read_op_data* data =
@@ -175,8 +338,51 @@ void BtaGattQueue::gatt_execute_next_op(uint16_t conn_id) {
                                                           (op.value[1] << 8)),
                            gatt_configure_mtu_op_finished, data);
   }
+}
 
-  gatt_ops.pop_front();
+void BtaGattQueue::gatt_execute_next_op(uint16_t conn_id) {
+  APPL_TRACE_DEBUG("%s: conn_id=0x%x", __func__, conn_id);
+  if (gatt_op_queue.empty()) {
+    APPL_TRACE_DEBUG("%s: op queue is empty", __func__);
+    return;
+  }
+
+  auto map_ptr = gatt_op_queue.find(conn_id);
+  if (map_ptr == gatt_op_queue.end() || map_ptr->second.empty()) {
+    APPL_TRACE_DEBUG("%s: no more operations queued for conn_id %d", __func__,
+                     conn_id);
+    return;
+  }
+
+  std::list<gatt_operation>& gatt_ops = map_ptr->second;
+  gatt_conn_state& state = gatt_op_queue_executing[conn_id];
+
+  if (state.in_flight > 0 &&
+      (!state.pipelining || state.in_flight >= kMaxPipelinedOps ||
+       !is_pipelinable(conn_id, gatt_ops.front()))) {
+    APPL_TRACE_DEBUG("%s: can't enqueue next op, already executing", __func__);
+    return;
+  }
+
+  if (state.in_flight == 0 && gatt_batch_reads(conn_id, gatt_ops)) {
+    state.in_flight++;
+    return;
+  }
+
+  do {
+    if (state.in_flight > 0) ops_pipelined++;
+    state.pipelining = is_pipelinable(conn_id, gatt_ops.front());
+    state.in_flight++;
+    gatt_issue_op(conn_id, gatt_ops.front());
+    gatt_ops.pop_front();
+  } while (state.pipelining && state.in_flight < kMaxPipelinedOps &&
+           !gatt_ops.empty() && is_pipelinable(conn_id, gatt_ops.front()));
+}
+
+void BtaGattQueue::enqueue(uint16_t conn_id, gatt_operation op) {
+  op.enqueued_ms = bluetooth::common::time_get_os_boottime_ms();
+  gatt_op_queue[conn_id].push_back(std::move(op));
+  gatt_execute_next_op(conn_id);
 }
 
 void BtaGattQueue::Clean(uint16_t conn_id) {
@@ -186,53 +392,70 @@ void BtaGattQueue::Clean(uint16_t conn_id) {
 
 void BtaGattQueue::ReadCharacteristic(uint16_t conn_id, uint16_t handle,
                                       GATT_READ_OP_CB cb, void* cb_data) {
-  gatt_op_queue[conn_id].push_back({.type = GATT_READ_CHAR,
-                                    .handle = handle,
-                                    .read_cb = cb,
-                                    .read_cb_data = cb_data});
-  gatt_execute_next_op(conn_id);
+  enqueue(conn_id, {.type = GATT_READ_CHAR,
+                    .handle = handle,
+                    .read_cb = cb,
+                    .read_cb_data = cb_data});
 }
 
 void BtaGattQueue::ReadDescriptor(uint16_t conn_id, uint16_t handle,
                                   GATT_READ_OP_CB cb, void* cb_data) {
-  gatt_op_queue[conn_id].push_back({.type = GATT_READ_DESC,
-                                    .handle = handle,
-                                    .read_cb = cb,
-                                    .read_cb_data = cb_data});
-  gatt_execute_next_op(conn_id);
+  enqueue(conn_id, {.type = GATT_READ_DESC,
+                    .handle = handle,
+                    .read_cb = cb,
+                    .read_cb_data = cb_data});
 }
 
 void BtaGattQueue::WriteCharacteristic(uint16_t conn_id, uint16_t handle,
                                        std::vector<uint8_t> value,
                                        tGATT_WRITE_TYPE write_type,
                                        GATT_WRITE_OP_CB cb, void* cb_data) {
-  gatt_op_queue[conn_id].push_back({.type = GATT_WRITE_CHAR,
-                                    .handle = handle,
-                                    .write_cb = cb,
-                                    .write_cb_data = cb_data,
-                                    .write_type = write_type,
-                                    .value = std::move(value)});
-  gatt_execute_next_op(conn_id);
+  enqueue(conn_id, {.type = GATT_WRITE_CHAR,
+                    .handle = handle,
+                    .write_cb = cb,
+                    .write_cb_data = cb_data,
+                    .write_type = write_type,
+                    .value = std::move(value)});
 }
 
 void BtaGattQueue::WriteDescriptor(uint16_t conn_id, uint16_t handle,
                                    std::vector<uint8_t> value,
                                    tGATT_WRITE_TYPE write_type,
                                    GATT_WRITE_OP_CB cb, void* cb_data) {
-  gatt_op_queue[conn_id].push_back({.type = GATT_WRITE_DESC,
-                                    .handle = handle,
-                                    .write_cb = cb,
-                                    .write_cb_data = cb_data,
-                                    .write_type = write_type,
-                                    .value = std::move(value)});
-  gatt_execute_next_op(conn_id);
+  enqueue(conn_id, {.type = GATT_WRITE_DESC,
+                    .handle = handle,
+                    .write_cb = cb,
+                    .write_cb_data = cb_data,
+                    .write_type = write_type,
+                    .value = std::move(value)});
 }
 
 void BtaGattQueue::ConfigureMtu(uint16_t conn_id, uint16_t mtu) {
   LOG(INFO) << __func__ << ", mtu: " << static_cast<int>(mtu);
   std::vector<uint8_t> value = {static_cast<uint8_t>(mtu & 0xff),
                                 static_cast<uint8_t>(mtu >> 8)};
-  gatt_op_queue[conn_id].push_back({.type = GATT_CONFIG_MTU,
-                                    .value = std::move(value)});
-  gatt_execute_next_op(conn_id);
+  enqueue(conn_id, {.type = GATT_CONFIG_MTU, .value = std::move(value)});
+}
+
+void BtaGattQueue::DebugDump(int fd) {
+  std::stringstream stream;
+  size_t num_queued = 0;
+  for (const auto& [conn_id, gatt_ops] : gatt_op_queue) {
+    num_queued += gatt_ops.size();
+  }
+  stream << "BTA GATT queue:\n"
+         << "  Operations queued: " << num_queued << "\n"
+         << "  Reads batched: " << reads_batched << " in "
+         << read_multi_requests << " requests, " << reads_retried
+         << " retried alone\n"
+         << "  Operations pipelined: " << ops_pipelined << "\n"
+         << "  Queue wait time:\n";
+  for (uint8_t type = GATT_READ_CHAR; type <= GATT_CONFIG_MTU; type++) {
+    const gatt_wait_stats& stats = wait_stats[type];
+    if (stats.count == 0) continue;
+    stream << "    " << gatt_op_type_text[type] << ": count=" << stats.count
+           << " avg=" << stats.total_ms / stats.count
+           << "ms max=" << stats.max_ms << "ms\n";
+  }
+  dprintf(fd, "%s", stream.str().c_str());
 }
@@ -469,8 +469,10 @@ void bta_gattc_clear_notif_registration(tBTA_GATTC_SERV* p_srcb,
            * clear boundaries are always around service.
            */
           handle = p_clrcb->notif_reg[i].handle;
-          if (handle >= start_handle && handle <= end_handle)
+          if (handle >= start_handle && handle <= end_handle) {
             memset(&p_clrcb->notif_reg[i], 0, sizeof(tBTA_GATTC_NOTIF_REG));
+            bta_gattc_cb.notif_index.Remove(gatt_if, remote_bda, handle);
+          }
         }
       }
     }
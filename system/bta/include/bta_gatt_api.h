@@ -593,6 +593,10 @@ typedef void (*GATT_WRITE_OP_CB)(uint16_t conn_id, tGATT_STATUS status,
                                  const uint8_t* value, void* data);
 typedef void (*GATT_CONFIGURE_MTU_OP_CB)(uint16_t conn_id, tGATT_STATUS status,
                                          void* data);
+/* |value| holds the values of all |handles|, concatenated as received */
+typedef void (*GATT_READ_MULTI_OP_CB)(uint16_t conn_id, tGATT_STATUS status,
+                                      const tBTA_GATTC_MULTI& handles,
+                                      uint16_t len, uint8_t* value, void* data);
 
 /*******************************************************************************
  *
@@ -765,13 +769,18 @@ extern void BTA_GATTC_ExecuteWrite(uint16_t conn_id, bool is_execute);
  *
  * Parameters       conn_id - connectino ID.
  *                    p_read_multi - read multiple parameters.
+ *                    variable_len - use Read Multiple Variable Length, which
+ *                                   prefixes each value with its length.
+ *                    callback - called with the concatenated values.
  *
  * Returns          None
  *
  ******************************************************************************/
 extern void BTA_GATTC_ReadMultiple(uint16_t conn_id,
                                    tBTA_GATTC_MULTI* p_read_multi,
-                                   tGATT_AUTH_REQ auth_req);
+                                   bool variable_len, tGATT_AUTH_REQ auth_req,
+                                   GATT_READ_MULTI_OP_CB callback,
+                                   void* cb_data);
 
 /*******************************************************************************
  *
@@ -32,6 +32,12 @@
  *
  * If you decide to use those methods in your app, make sure to not mix it with
  * existing BTA_GATTC_* API.
+ *
+ * Consecutive reads are batched into one Read Multiple Variable Length request
+ * when the server supports EATT, which mandates it. Write Commands and Client
+ * Characteristic Configuration writes are handed to BTA without waiting for
+ * the previous one to complete, BTA sends them back to back. Those can no
+ * longer be removed by Clean().
  */
 class BtaGattQueue {
  public:
@@ -49,6 +55,7 @@ class BtaGattQueue {
                               tGATT_WRITE_TYPE write_type, GATT_WRITE_OP_CB cb,
                               void* cb_data);
   static void ConfigureMtu(uint16_t conn_id, uint16_t mtu);
+  static void DebugDump(int fd);
 
   /* Holds pending GATT operations */
   struct gatt_operation {
@@ -64,14 +71,38 @@ class BtaGattQueue {
     /* write-specific fields */
     tGATT_WRITE_TYPE write_type;
     std::vector<uint8_t> value;
+
+    /* set when a batched read has to be retried alone */
+    bool no_batch;
+    uint64_t enqueued_ms;
   };
 
  private:
+  /* Per connection execution state */
+  struct gatt_conn_state {
+    /* requests handed to BTA and not completed yet */
+    uint8_t in_flight;
+    /* whether the requests in flight can be followed by more */
+    bool pipelining;
+    /* the server rejected Read Multiple Variable Length */
+    bool read_multi_unsupported;
+  };
+
+  static void enqueue(uint16_t conn_id, gatt_operation op);
   static void mark_as_not_executing(uint16_t conn_id);
   static void gatt_execute_next_op(uint16_t conn_id);
+  static void gatt_issue_op(uint16_t conn_id, gatt_operation& op);
+  static bool gatt_batch_reads(uint16_t conn_id,
+                               std::list<gatt_operation>& gatt_ops);
+  static bool is_pipelinable(uint16_t conn_id, const gatt_operation& op);
   static void gatt_read_op_finished(uint16_t conn_id, tGATT_STATUS status,
                                     uint16_t handle, uint16_t len,
                                     uint8_t* value, void* data);
+  static void gatt_read_multi_op_finished(uint16_t conn_id,
+                                          tGATT_STATUS status,
+                                          const tBTA_GATTC_MULTI& handles,
+                                          uint16_t len, uint8_t* value,
+                                          void* data);
   static void gatt_write_op_finished(uint16_t conn_id, tGATT_STATUS status,
                                      uint16_t handle, uint16_t len,
                                      const uint8_t* value, void* data);
@@ -80,6 +111,6 @@ class BtaGattQueue {
 
   // maps connection id to operations waiting for execution
   static std::unordered_map<uint16_t, std::list<gatt_operation>> gatt_op_queue;
-  // contain connection ids that currently execute operations
-  static std::unordered_set<uint16_t> gatt_op_queue_executing;
+  // maps connection id to its execution state
+  static std::unordered_map<uint16_t, gatt_conn_state> gatt_op_queue_executing;
 };
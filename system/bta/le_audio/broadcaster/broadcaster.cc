@@ -19,6 +19,7 @@
 
 #include "bta/include/bta_le_audio_api.h"
 #include "bta/include/bta_le_audio_broadcaster_api.h"
+#include "bta/le_audio/broadcaster/encoder_worker_pool.h"
 #include "bta/le_audio/broadcaster/state_machine.h"
 #include "bta/le_audio/le_audio_types.h"
 #include "bta/le_audio/le_audio_utils.h"
@@ -46,7 +47,9 @@ using le_audio::broadcaster::BroadcastCodecWrapper;
 using le_audio::broadcaster::BroadcastQosConfig;
 using le_audio::broadcaster::BroadcastStateMachine;
 using le_audio::broadcaster::BroadcastStateMachineConfig;
+using le_audio::broadcaster::EncoderWorkerPool;
 using le_audio::broadcaster::IBroadcastStateMachineCallbacks;
+using le_audio::broadcaster::SduDeadlineMonitor;
 using le_audio::types::AudioContexts;
 using le_audio::types::CodecLocation;
 using le_audio::types::kLeAudioCodingFormatLC3;
@@ -59,6 +62,11 @@ namespace {
 class LeAudioBroadcasterImpl;
 LeAudioBroadcasterImpl* instance;
 
+/* Upper bound on the encoding threads helping the audio thread */
+constexpr size_t kMaxEncoderWorkers = 3;
+constexpr char kEncoderWorkersProperty[] =
+    "persist.bluetooth.leaudio.broadcast.encoder_workers";
+
 /* Class definitions */
 
 /* LeAudioBroadcasterImpl class represents main implementation class for le
@@ -116,10 +124,13 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
     broadcasts_.clear();
     callbacks_ = nullptr;
 
+    /* Stop the audio data path first, as the encoders are used from the
+     * audio thread until it is stopped. */
     if (le_audio_source_hal_client_) {
       le_audio_source_hal_client_->Stop();
       le_audio_source_hal_client_.reset();
     }
+    audio_receiver_.ReleaseEncoders();
   }
 
   void Stop() {
@@ -607,6 +618,7 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
       auto& broadcast = broadcast_pair.second;
       if (broadcast) stream << *broadcast;
     }
+    audio_receiver_.Dump(stream);
 
     dprintf(fd, "%s", stream.str().c_str());
   }
@@ -758,6 +770,36 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
         encoders_.emplace_back(
             lc3_setup_encoder(dt_us, sr_hz, 0, encoders_mem_.back().get()));
       }
+
+      /* The audio thread encodes one channel itself, spread the others */
+      const int32_t max_workers =
+          osi_property_get_int32(kEncoderWorkersProperty, kMaxEncoderWorkers);
+      size_t num_workers = 0;
+      if (max_workers > 0 && encoders_.size() > 1) {
+        num_workers = std::min<size_t>(max_workers, encoders_.size() - 1);
+      }
+      if (!encoder_pool_ || encoder_pool_->GetNumWorkers() != num_workers) {
+        encoder_pool_.reset();
+        if (num_workers > 0) {
+          LOG_INFO("Using %zu encoder workers for %zu channels", num_workers,
+                   encoders_.size());
+          encoder_pool_ = std::make_unique<EncoderWorkerPool>(num_workers);
+        }
+      }
+
+      deadline_monitor_.Reset(std::chrono::microseconds(dt_us));
+    }
+
+    void ReleaseEncoders() {
+      encoder_pool_.reset();
+      encoders_.clear();
+      encoders_mem_.clear();
+    }
+
+    void Dump(std::stringstream& stream) const {
+      stream << "    Encoder workers: "
+             << (encoder_pool_ ? encoder_pool_->GetNumWorkers() : 0) << "\n";
+      deadline_monitor_.Dump(stream);
     }
 
     const BroadcastCodecWrapper& getCurrentCodecConfig(void) const {
@@ -784,7 +826,8 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
 
     static void sendBroadcastData(
         const std::unique_ptr<BroadcastStateMachine>& broadcast,
-        std::vector<std::vector<uint8_t>>& encoded_channels) {
+        std::vector<std::vector<uint8_t>>& encoded_channels,
+        SduDeadlineMonitor& deadline_monitor) {
       auto const& config = broadcast->GetBigConfig();
       if (config == std::nullopt) {
         LOG_ERROR(
@@ -804,6 +847,8 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
         IsoManager::GetInstance()->SendIsoData(config->connection_handles[chan],
                                                encoded_channels[chan].data(),
                                                encoded_channels[chan].size());
+        deadline_monitor.OnSduSent(config->connection_handles[chan],
+                                   SduDeadlineMonitor::Clock::now());
       }
     }
 
@@ -816,11 +861,22 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
       const auto num_channels = codec_wrapper_.GetNumChannels();
       const auto bytes_per_sample = (codec_wrapper_.GetBitsPerSample() / 8);
 
-      /* Prepare encoded data for all channels */
-      for (uint8_t chan = 0; chan < num_channels; ++chan) {
+      deadline_monitor_.OnSduIntervalStarted(SduDeadlineMonitor::Clock::now());
+
+      /* Prepare encoded data for all channels. Each channel has its own
+       * encoder and output buffer, so they can be encoded concurrently.
+       */
+      auto encode_channel = [&](size_t chan) {
         /* TODO: Use encoder agnostic wrapper */
         encodeLc3Channel(encoders_[chan], enc_audio_buffers_[chan], data,
                          chan * bytes_per_sample, num_channels, num_channels);
+      };
+      if (encoder_pool_) {
+        encoder_pool_->RunAndWait(num_channels, encode_channel);
+      } else {
+        for (uint8_t chan = 0; chan < num_channels; ++chan) {
+          encode_channel(chan);
+        }
       }
 
       /* Currently there is no way to broadcast multiple distinct streams.
@@ -832,7 +888,7 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
         if ((broadcast->GetState() ==
              BroadcastStateMachine::State::STREAMING) &&
             !broadcast->IsMuted())
-          sendBroadcastData(broadcast, enc_audio_buffers_);
+          sendBroadcastData(broadcast, enc_audio_buffers_, deadline_monitor_);
       }
       LOG_VERBOSE("All data sent.");
     }
@@ -886,6 +942,8 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
     std::vector<lc3_encoder_t> encoders_;
     std::vector<std::unique_ptr<void, decltype(&std::free)>> encoders_mem_;
     std::vector<std::vector<uint8_t>> enc_audio_buffers_;
+    std::unique_ptr<EncoderWorkerPool> encoder_pool_;
+    SduDeadlineMonitor deadline_monitor_;
   } audio_receiver_;
 
   bluetooth::le_audio::LeAudioBroadcasterCallbacks* callbacks_;
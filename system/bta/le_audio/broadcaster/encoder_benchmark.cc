@@ -0,0 +1,113 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include "bta/le_audio/broadcaster/encoder_worker_pool.h"
+#include "embdrv/lc3/include/lc3.h"
+#include "stack/include/btm_iso_api.h"
+
+using bluetooth::hci::IsoManager;
+using le_audio::broadcaster::EncoderWorkerPool;
+using le_audio::broadcaster::SduDeadlineMonitor;
+
+namespace {
+
+constexpr int kDataIntervalUs = 10000;
+constexpr int kSampleRateHz = 48000;
+constexpr int kSamplesPerChannel = kSampleRateHz / 100;
+/* 96 kbps per BIS at 10 ms */
+constexpr size_t kSduSize = 120;
+constexpr uint16_t kFirstBisHandle = 0x0100;
+
+/* Encodes and sends one SDU interval worth of audio for |num_bis| BISes, the
+ * way the broadcaster audio path does, against the mocked ISO manager. */
+class BroadcastEncodingFixture {
+ public:
+  BroadcastEncodingFixture(size_t num_bis, size_t num_workers)
+      : num_bis_(num_bis),
+        pcm_(kSamplesPerChannel * num_bis),
+        encoded_(num_bis, std::vector<uint8_t>(kSduSize)),
+        pool_(num_workers) {
+    /* Something that is not silence, so the encoder does real work */
+    for (size_t i = 0; i < pcm_.size(); ++i) {
+      pcm_[i] = static_cast<int16_t>((i * 7919) & 0x3fff);
+    }
+
+    const auto encoder_bytes =
+        lc3_encoder_size(kDataIntervalUs, kSampleRateHz);
+    for (size_t bis = 0; bis < num_bis; ++bis) {
+      encoders_mem_.emplace_back(malloc(encoder_bytes), &std::free);
+      encoders_.push_back(lc3_setup_encoder(kDataIntervalUs, kSampleRateHz, 0,
+                                            encoders_mem_.back().get()));
+    }
+    monitor_.Reset(std::chrono::microseconds(kDataIntervalUs));
+  }
+
+  void RunInterval() {
+    monitor_.OnSduIntervalStarted(SduDeadlineMonitor::Clock::now());
+    pool_.RunAndWait(num_bis_, [this](size_t bis) {
+      lc3_encode(encoders_[bis], LC3_PCM_FORMAT_S16, pcm_.data() + bis,
+                 num_bis_, encoded_[bis].size(), encoded_[bis].data());
+    });
+    for (size_t bis = 0; bis < num_bis_; ++bis) {
+      IsoManager::GetInstance()->SendIsoData(kFirstBisHandle + bis,
+                                             encoded_[bis].data(),
+                                             encoded_[bis].size());
+      monitor_.OnSduSent(kFirstBisHandle + bis,
+                         SduDeadlineMonitor::Clock::now());
+    }
+  }
+
+  uint64_t GetLateSdus() const {
+    uint64_t late = 0;
+    for (const auto& [handle, stats] : monitor_.GetStats()) {
+      late += stats.sdus_late;
+    }
+    return late;
+  }
+
+ private:
+  size_t num_bis_;
+  std::vector<int16_t> pcm_;
+  std::vector<std::vector<uint8_t>> encoded_;
+  std::vector<lc3_encoder_t> encoders_;
+  std::vector<std::unique_ptr<void, decltype(&std::free)>> encoders_mem_;
+  EncoderWorkerPool pool_;
+  SduDeadlineMonitor monitor_;
+};
+
+/* Arguments: number of BISes, number of encoder workers */
+void BM_BroadcastEncodeAndSend(benchmark::State& state) {
+  BroadcastEncodingFixture fixture(state.range(0), state.range(1));
+  for (auto _ : state) {
+    fixture.RunInterval();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.counters["late_sdus"] = fixture.GetLateSdus();
+}
+
+BENCHMARK(BM_BroadcastEncodeAndSend)
+    ->ArgsProduct({{1, 2, 4, 8, 16}, {0, 1, 3}})
+    ->UseRealTime();
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bta/le_audio/broadcaster/encoder_worker_pool.h"
+
+#include "osi/include/log.h"
+
+namespace le_audio {
+namespace broadcaster {
+
+void SduDeadlineMonitor::Reset(std::chrono::microseconds sdu_interval) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  sdu_interval_ = sdu_interval;
+  stats_.clear();
+}
+
+void SduDeadlineMonitor::OnSduIntervalStarted(Clock::time_point now) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  interval_start_ = now;
+}
+
+void SduDeadlineMonitor::OnSduSent(uint16_t bis_conn_hdl,
+                                   Clock::time_point now) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+      now - interval_start_);
+
+  auto& stats = stats_[bis_conn_hdl];
+  stats.sdus_sent++;
+  if (latency > stats.max_latency) stats.max_latency = latency;
+
+  if (sdu_interval_.count() == 0 || latency <= sdu_interval_) return;
+
+  /* Log the first late SDU and then every 100th, not to flood the log from
+   * the audio thread when the system is overloaded. */
+  if (stats.sdus_late++ % 100 == 0) {
+    LOG_WARN("BIS handle=0x%04x SDU sent %lld us after its interval started",
+             bis_conn_hdl, static_cast<long long>(latency.count()));
+  }
+}
+
+std::map<uint16_t, SduDeadlineMonitor::BisStats> SduDeadlineMonitor::GetStats()
+    const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+void SduDeadlineMonitor::Dump(std::stringstream& stream) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  stream << "    SDU interval: " << sdu_interval_.count() << " us\n";
+  for (const auto& [bis_conn_hdl, stats] : stats_) {
+    stream << "      BIS handle: 0x" << std::hex << bis_conn_hdl << std::dec
+           << " sent: " << stats.sdus_sent << " late: " << stats.sdus_late
+           << " max latency: " << stats.max_latency.count() << " us\n";
+  }
+}
+
+}  // namespace broadcaster
+}  // namespace le_audio
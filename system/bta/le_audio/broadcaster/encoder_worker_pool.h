@@ -0,0 +1,68 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <sstream>
+
+#include "gd/common/worker_pool.h"
+
+namespace le_audio {
+namespace broadcaster {
+
+/* Threads encoding the BIS channels of one SDU interval in parallel. The
+ * calling (audio) thread takes part in the work, and RunAndWait() returns
+ * only once every channel of the interval is encoded, so the results can be
+ * sent in order right after.
+ */
+using EncoderWorkerPool = bluetooth::common::WorkerPool;
+
+/* Tracks, per BIS, whether the SDUs were handed to the ISO manager within
+ * the SDU interval they were produced for. An SDU sent later than one
+ * interval after its PCM data arrived is late and will be flushed or
+ * queued behind the next one by the controller.
+ */
+class SduDeadlineMonitor {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  struct BisStats {
+    uint64_t sdus_sent = 0;
+    uint64_t sdus_late = 0;
+    std::chrono::microseconds max_latency{0};
+  };
+
+  void Reset(std::chrono::microseconds sdu_interval);
+  void OnSduIntervalStarted(Clock::time_point now);
+  void OnSduSent(uint16_t bis_conn_hdl, Clock::time_point now);
+
+  /* Returns a snapshot, as the audio thread keeps updating the statistics */
+  std::map<uint16_t, BisStats> GetStats() const;
+  void Dump(std::stringstream& stream) const;
+
+ private:
+  mutable std::mutex mutex_;
+  std::chrono::microseconds sdu_interval_{0};
+  Clock::time_point interval_start_;
+  std::map<uint16_t, BisStats> stats_;
+};
+
+}  // namespace broadcaster
+}  // namespace le_audio
@@ -0,0 +1,54 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bta/le_audio/broadcaster/encoder_worker_pool.h"
+
+#include <gtest/gtest.h>
+
+using namespace std::chrono_literals;
+
+namespace le_audio {
+namespace broadcaster {
+namespace {
+
+TEST(SduDeadlineMonitorTest, counts_late_sdus_per_bis) {
+  SduDeadlineMonitor monitor;
+  monitor.Reset(10ms);
+  auto now = SduDeadlineMonitor::Clock::now();
+
+  monitor.OnSduIntervalStarted(now);
+  monitor.OnSduSent(0x0010, now + 2ms);
+  monitor.OnSduSent(0x0011, now + 12ms);
+
+  monitor.OnSduIntervalStarted(now + 10ms);
+  monitor.OnSduSent(0x0010, now + 11ms);
+  monitor.OnSduSent(0x0011, now + 15ms);
+
+  const auto& stats = monitor.GetStats();
+  ASSERT_EQ(2u, stats.at(0x0010).sdus_sent);
+  ASSERT_EQ(0u, stats.at(0x0010).sdus_late);
+  ASSERT_EQ(2000us, stats.at(0x0010).max_latency);
+  ASSERT_EQ(2u, stats.at(0x0011).sdus_sent);
+  ASSERT_EQ(1u, stats.at(0x0011).sdus_late);
+  ASSERT_EQ(12000us, stats.at(0x0011).max_latency);
+
+  monitor.Reset(10ms);
+  ASSERT_TRUE(monitor.GetStats().empty());
+}
+
+}  // namespace
+}  // namespace broadcaster
+}  // namespace le_audio
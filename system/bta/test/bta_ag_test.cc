@@ -0,0 +1,176 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "bta/ag/bta_ag_act.cc"
+#include "types/bluetooth/uuid.h"
+#include "types/raw_address.h"
+
+uint8_t appl_trace_level = 0;
+void LogMsg(uint32_t trace_set_mask, const char* fmt_str, ...) {}
+
+namespace {
+
+const RawAddress kPeer({0x11, 0x22, 0x33, 0x44, 0x55, 0x66});
+
+std::vector<std::pair<RawAddress, Uuid>> invalidated;
+std::vector<tBTA_AG_STATUS> open_status;
+
+void ag_cback(tBTA_AG_EVT event, tBTA_AG* p_data) {
+  if (event == BTA_AG_OPEN_EVT) open_status.push_back(p_data->open.status);
+}
+
+}  // namespace
+
+const tBTA_AG_DATA tBTA_AG_DATA::kEmpty = {};
+tBTA_AG_CB bta_ag_cb;
+const tBTA_AG_CFG* p_bta_ag_cfg = nullptr;
+const tBTA_AG_AT_CMD* bta_ag_at_tbl[BTA_AG_NUM_IDX] = {};
+
+void SDP_InvalidateDiscoveryCache(const RawAddress& bd_addr,
+                                  const bluetooth::Uuid& uuid) {
+  invalidated.emplace_back(bd_addr, uuid);
+}
+bool SDP_CancelServiceSearch(const tSDP_DISCOVERY_DB* p_db) { return true; }
+bool L2CA_SetIdleTimeoutByBdAddr(const RawAddress& bd_addr, uint16_t timeout,
+                                 tBT_TRANSPORT transport) {
+  return true;
+}
+int PORT_CheckConnection(uint16_t handle, RawAddress* bd_addr,
+                         uint16_t* p_lcid) {
+  return PORT_SUCCESS;
+}
+bool PORT_IsOpening(RawAddress* bd_addr) { return false; }
+int PORT_ReadData(uint16_t handle, char* p_data, uint16_t max_len,
+                  uint16_t* p_len) {
+  return PORT_SUCCESS;
+}
+int RFCOMM_RemoveConnection(uint16_t handle) { return PORT_SUCCESS; }
+int RFCOMM_RemoveServer(uint16_t handle) { return PORT_SUCCESS; }
+bool btif_config_get_bin(const std::string& section, const std::string& key,
+                         uint8_t* value, size_t* length) {
+  return false;
+}
+void bta_ag_api_set_active_device(const RawAddress& active_device_addr) {}
+void bta_ag_at_err_cback(tBTA_AG_SCB* p_scb, bool unknown, const char* p_arg) {
+}
+void bta_ag_at_hfp_cback(tBTA_AG_SCB* p_scb, uint16_t cmd, uint8_t arg_type,
+                         char* p_arg, char* p_end, int16_t int_arg) {}
+void bta_ag_at_hsp_cback(tBTA_AG_SCB* p_scb, uint16_t cmd, uint8_t arg_type,
+                         char* p_arg, char* p_end, int16_t int_arg) {}
+void bta_ag_at_init(tBTA_AG_AT_CB* p_cb) {}
+void bta_ag_at_parse(tBTA_AG_AT_CB* p_cb, char* p_buf, uint16_t len) {}
+void bta_ag_at_reinit(tBTA_AG_AT_CB* p_cb) {}
+void bta_ag_close_servers(tBTA_AG_SCB* p_scb, tBTA_SERVICE_MASK services) {}
+void bta_ag_collision_cback(tBTA_SYS_CONN_STATUS status, uint8_t id,
+                            uint8_t app_id, const RawAddress& peer_addr) {}
+void bta_ag_create_records(tBTA_AG_SCB* p_scb, const tBTA_AG_DATA& data) {}
+void bta_ag_del_records(tBTA_AG_SCB* p_scb) {}
+void bta_ag_do_disc(tBTA_AG_SCB* p_scb, tBTA_SERVICE_MASK service) {}
+void bta_ag_free_db(tBTA_AG_SCB* p_scb, const tBTA_AG_DATA& data) {}
+const RawAddress& bta_ag_get_active_device() { return RawAddress::kEmpty; }
+bool bta_ag_inband_enabled(tBTA_AG_SCB* p_scb) { return false; }
+bool bta_ag_is_server_closed(tBTA_AG_SCB* p_scb) { return true; }
+void bta_ag_resume_open(tBTA_AG_SCB* p_scb) {}
+void bta_ag_rfc_do_close(tBTA_AG_SCB* p_scb, const tBTA_AG_DATA& data) {}
+void bta_ag_scb_dealloc(tBTA_AG_SCB* p_scb) {}
+uint16_t bta_ag_scb_to_idx(tBTA_AG_SCB* p_scb) { return 1; }
+bool bta_ag_sco_is_open(tBTA_AG_SCB* p_scb) { return false; }
+void bta_ag_sco_open(tBTA_AG_SCB* p_scb, const tBTA_AG_DATA& data) {}
+void bta_ag_sco_shutdown(tBTA_AG_SCB* p_scb, const tBTA_AG_DATA& data) {}
+bool bta_ag_sdp_find_attr(tBTA_AG_SCB* p_scb, tBTA_SERVICE_MASK service) {
+  return true;
+}
+void bta_ag_send_call_inds(tBTA_AG_SCB* p_scb, tBTA_AG_RES result) {}
+void bta_ag_send_ring(tBTA_AG_SCB* p_scb, const tBTA_AG_DATA& data) {}
+uint8_t bta_ag_service_to_idx(tBTA_SERVICE_MASK services) { return 0; }
+void bta_ag_sm_execute(tBTA_AG_SCB* p_scb, uint16_t event,
+                       const tBTA_AG_DATA& data) {}
+void bta_ag_start_servers(tBTA_AG_SCB* p_scb, tBTA_SERVICE_MASK services) {}
+void bta_clear_active_device() {}
+void bta_dm_pm_active(const RawAddress& peer_addr) {}
+void bta_sys_busy(uint8_t id, uint8_t app_id, const RawAddress& peer_addr) {}
+void bta_sys_conn_close(uint8_t id, uint8_t app_id,
+                        const RawAddress& peer_addr) {}
+void bta_sys_conn_open(uint8_t id, uint8_t app_id,
+                       const RawAddress& peer_addr) {}
+void bta_sys_idle(uint8_t id, uint8_t app_id, const RawAddress& peer_addr) {}
+void bta_sys_sco_open(uint8_t id, uint8_t app_id,
+                      const RawAddress& peer_addr) {}
+void bta_sys_sco_unuse(uint8_t id, uint8_t app_id,
+                       const RawAddress& peer_addr) {}
+void bta_sys_sco_use(uint8_t id, uint8_t app_id, const RawAddress& peer_addr) {
+}
+void bta_sys_start_timer(alarm_t* alarm, uint64_t interval_ms, uint16_t event,
+                         uint16_t layer_specific) {}
+
+class BtaAgRfcFailTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    invalidated.clear();
+    open_status.clear();
+    bta_ag_cb = {};
+    bta_ag_cb.p_cback = ag_cback;
+    scb_ = {};
+    scb_.in_use = true;
+    scb_.peer_addr = kPeer;
+    scb_.conn_handle = 1;
+  }
+
+  void RfcFail(uint32_t port_status) {
+    tBTA_AG_DATA data = {};
+    data.rfc.port_handle = scb_.conn_handle;
+    data.rfc.port_status = port_status;
+    bta_ag_rfc_fail(&scb_, data);
+  }
+
+  tBTA_AG_SCB scb_;
+};
+
+TEST_F(BtaAgRfcFailTest, page_timeout_keeps_the_discovery_cache) {
+  scb_.conn_service = BTA_AG_HFP;
+  // Page timeouts and other link failures are reported as start failures
+  RfcFail(PORT_START_FAILED);
+
+  ASSERT_TRUE(invalidated.empty());
+  ASSERT_EQ(1u, open_status.size());
+  ASSERT_EQ(BTA_AG_FAIL_RFCOMM, open_status[0]);
+  ASSERT_EQ(RawAddress::kEmpty, scb_.peer_addr);
+}
+
+TEST_F(BtaAgRfcFailTest, refused_channel_drops_the_hfp_search) {
+  scb_.conn_service = BTA_AG_HFP;
+  RfcFail(PORT_INVALID_SCN);
+
+  ASSERT_EQ(1u, invalidated.size());
+  ASSERT_EQ(kPeer, invalidated[0].first);
+  ASSERT_EQ(Uuid::From16Bit(UUID_SERVCLASS_HF_HANDSFREE),
+            invalidated[0].second);
+}
+
+TEST_F(BtaAgRfcFailTest, refused_channel_drops_the_hsp_searches) {
+  scb_.conn_service = BTA_AG_HSP;
+  RfcFail(PORT_INVALID_SCN);
+
+  ASSERT_EQ(2u, invalidated.size());
+  ASSERT_EQ(Uuid::From16Bit(UUID_SERVCLASS_HEADSET_HS), invalidated[0].second);
+  ASSERT_EQ(Uuid::From16Bit(UUID_SERVCLASS_HEADSET), invalidated[1].second);
+}
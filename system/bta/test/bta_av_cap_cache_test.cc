@@ -0,0 +1,166 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "bta/av/bta_av_int.h"
+#include "btif/include/btif_config.h"
+#include "stack/include/avdt_api.h"
+#include "types/raw_address.h"
+
+uint8_t appl_trace_level = 0;
+void LogMsg(uint32_t trace_set_mask, const char* fmt_str, ...) {}
+
+namespace {
+
+std::map<std::string, std::vector<uint8_t>> config;
+size_t num_saves = 0;
+bool bonded = false;
+
+const RawAddress kPeer({0x11, 0x22, 0x33, 0x44, 0x55, 0x66});
+
+}  // namespace
+
+bool btif_config_exist(const std::string& section, const std::string& key) {
+  return config.count(section + key) != 0;
+}
+
+size_t btif_config_get_bin_length(const std::string& section,
+                                  const std::string& key) {
+  auto it = config.find(section + key);
+  return it == config.end() ? 0 : it->second.size();
+}
+
+bool btif_config_get_bin(const std::string& section, const std::string& key,
+                         uint8_t* value, size_t* length) {
+  auto it = config.find(section + key);
+  if (it == config.end() || *length < it->second.size()) return false;
+  std::copy(it->second.begin(), it->second.end(), value);
+  *length = it->second.size();
+  return true;
+}
+
+bool btif_config_set_bin(const std::string& section, const std::string& key,
+                         const uint8_t* value, size_t length) {
+  config[section + key].assign(value, value + length);
+  return true;
+}
+
+bool btif_config_remove(const std::string& section, const std::string& key) {
+  return config.erase(section + key) != 0;
+}
+
+void btif_config_save(void) { num_saves++; }
+
+bool btm_sec_is_a_bonded_dev(const RawAddress& bda) { return bonded; }
+
+class BtaAvCapCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    config.clear();
+    num_saves = 0;
+    bonded = true;
+
+    seps_[0] = {.seid = 1,
+                .media_type = AVDT_MEDIA_TYPE_AUDIO,
+                .tsep = AVDT_TSEP_SNK};
+    seps_[1] = {.seid = 2,
+                .media_type = AVDT_MEDIA_TYPE_AUDIO,
+                .tsep = AVDT_TSEP_SNK};
+
+    sbc_.num_codec = 1;
+    sbc_.psc_mask = AVDT_PSC_TRANS | AVDT_PSC_DELAY_RPT;
+    const uint8_t sbc_caps[] = {0x06, 0x00, 0x00, 0xff, 0xff, 0x02, 0x35};
+    std::copy(std::begin(sbc_caps), std::end(sbc_caps), sbc_.codec_info);
+
+    aac_ = sbc_;
+    aac_.codec_info[2] = 0x02;
+  }
+
+  tAVDT_SEP_INFO seps_[2] = {};
+  AvdtpSepConfig sbc_;
+  AvdtpSepConfig aac_;
+};
+
+TEST_F(BtaAvCapCacheTest, stored_capabilities_are_found) {
+  AvdtpSepConfig cap;
+  ASSERT_FALSE(bta_av_cap_cache_lookup(kPeer, seps_, 2, 1, true, &cap));
+
+  bta_av_cap_cache_store(kPeer, seps_, 2, 1, true, sbc_);
+  bta_av_cap_cache_store(kPeer, seps_, 2, 2, true, aac_);
+  ASSERT_EQ(2u, num_saves);
+
+  ASSERT_TRUE(bta_av_cap_cache_lookup(kPeer, seps_, 2, 1, true, &cap));
+  ASSERT_EQ(0, memcmp(cap.codec_info, sbc_.codec_info, AVDT_CODEC_SIZE));
+  ASSERT_EQ(sbc_.psc_mask, cap.psc_mask);
+  ASSERT_TRUE(bta_av_cap_cache_lookup(kPeer, seps_, 2, 2, true, &cap));
+  ASSERT_EQ(0, memcmp(cap.codec_info, aac_.codec_info, AVDT_CODEC_SIZE));
+  ASSERT_FALSE(bta_av_cap_cache_lookup(kPeer, seps_, 2, 3, true, &cap));
+
+  // Unchanged capabilities are not written again
+  bta_av_cap_cache_store(kPeer, seps_, 2, 1, true, sbc_);
+  ASSERT_EQ(2u, num_saves);
+}
+
+TEST_F(BtaAvCapCacheTest, only_bonded_devices_are_cached) {
+  bonded = false;
+  bta_av_cap_cache_store(kPeer, seps_, 2, 1, true, sbc_);
+
+  AvdtpSepConfig cap;
+  ASSERT_FALSE(bta_av_cap_cache_lookup(kPeer, seps_, 2, 1, true, &cap));
+  ASSERT_EQ(0u, num_saves);
+}
+
+TEST_F(BtaAvCapCacheTest, changed_discovery_results_miss) {
+  bta_av_cap_cache_store(kPeer, seps_, 2, 1, true, sbc_);
+
+  AvdtpSepConfig cap;
+  // Endpoint removed
+  ASSERT_FALSE(bta_av_cap_cache_lookup(kPeer, seps_, 1, 1, true, &cap));
+  // Other capability request
+  ASSERT_FALSE(bta_av_cap_cache_lookup(kPeer, seps_, 2, 1, false, &cap));
+  // Endpoint changed type
+  seps_[1].tsep = AVDT_TSEP_SRC;
+  ASSERT_FALSE(bta_av_cap_cache_lookup(kPeer, seps_, 2, 1, true, &cap));
+
+  // Storing with the new results drops the capabilities of the old ones
+  bta_av_cap_cache_store(kPeer, seps_, 2, 2, true, aac_);
+  seps_[1].tsep = AVDT_TSEP_SNK;
+  ASSERT_FALSE(bta_av_cap_cache_lookup(kPeer, seps_, 2, 1, true, &cap));
+}
+
+TEST_F(BtaAvCapCacheTest, invalidate) {
+  bta_av_cap_cache_store(kPeer, seps_, 2, 1, true, sbc_);
+  bta_av_cap_cache_invalidate(kPeer);
+
+  AvdtpSepConfig cap;
+  ASSERT_FALSE(bta_av_cap_cache_lookup(kPeer, seps_, 2, 1, true, &cap));
+  ASSERT_FALSE(btif_config_exist(kPeer.ToString(),
+                                 BT_CONFIG_KEY_AVDTP_SEP_CAPABILITIES));
+}
+
+TEST_F(BtaAvCapCacheTest, corrupted_cache_misses) {
+  bta_av_cap_cache_store(kPeer, seps_, 2, 1, true, sbc_);
+  config[kPeer.ToString() + BT_CONFIG_KEY_AVDTP_SEP_CAPABILITIES].pop_back();
+
+  AvdtpSepConfig cap;
+  ASSERT_FALSE(bta_av_cap_cache_lookup(kPeer, seps_, 2, 1, true, &cap));
+}
@@ -29,6 +29,7 @@
 #include "common/message_loop_thread.h"
 #include "osi/include/compat.h"
 #include "stack/include/btm_status.h"
+#include "stack/include/hcidefs.h"
 #include "test/common/main_handler.h"
 #include "test/mock/mock_osi_alarm.h"
 #include "test/mock/mock_osi_allocator.h"
@@ -474,3 +475,69 @@ TEST_F(BtaDmTest, bta_dm_remname_cback__HCI_ERR_CONNECTION_EXISTS) {
   ASSERT_EQ(1, mock_function_count_map["BTM_SecDeleteRmtNameNotifyCallback"]);
   ASSERT_TRUE(bta_dm_search_cb.name_discover_done);
 }
+
+TEST_F(BtaDmTest, bta_dm_name_process_eir__complete_name) {
+  const uint8_t eir[] = {
+      0x02, HCI_EIR_FLAGS_TYPE, 0x06,
+      0x05, HCI_EIR_COMPLETE_LOCAL_NAME_TYPE, 'N', 'a', 'm', 'e',
+  };
+  ASSERT_TRUE(bta_dm_name_process_eir(kRawAddress, eir, sizeof(eir)));
+
+  BD_NAME bd_name = {};
+  ASSERT_TRUE(bta_dm_name_lookup(kRawAddress, bd_name));
+  ASSERT_STREQ("Name", reinterpret_cast<char*>(bd_name));
+  ASSERT_FALSE(bta_dm_name_lookup(kRawAddress2, bd_name));
+}
+
+TEST_F(BtaDmTest, bta_dm_name_process_eir__shortened_name) {
+  const uint8_t eir[] = {
+      0x03, HCI_EIR_SHORTENED_LOCAL_NAME_TYPE, 'N', 'a',
+  };
+  ASSERT_FALSE(bta_dm_name_process_eir(kRawAddress, eir, sizeof(eir)));
+
+  BD_NAME bd_name = {};
+  ASSERT_FALSE(bta_dm_name_lookup(kRawAddress, bd_name));
+}
+
+TEST_F(BtaDmTest, bta_dm_name_request_complete) {
+  BD_NAME bd_name = {};
+  strlcpy(reinterpret_cast<char*>(bd_name), kRemoteName, sizeof(bd_name));
+
+  // Failed requests are not cached
+  bta_dm_name_request_started(kRawAddress);
+  bta_dm_name_request_complete(kRawAddress, HCI_ERR_PAGE_TIMEOUT, bd_name);
+  BD_NAME cached = {};
+  ASSERT_FALSE(bta_dm_name_lookup(kRawAddress, cached));
+
+  // Completions without a matching request are ignored
+  bta_dm_name_request_complete(kRawAddress2, HCI_SUCCESS, bd_name);
+  ASSERT_FALSE(bta_dm_name_lookup(kRawAddress2, cached));
+
+  bta_dm_name_request_started(kRawAddress);
+  bta_dm_name_request_complete(kRawAddress, HCI_SUCCESS, bd_name);
+  ASSERT_TRUE(bta_dm_name_lookup(kRawAddress, cached));
+  ASSERT_STREQ(kRemoteName, reinterpret_cast<char*>(cached));
+}
+
+TEST_F(BtaDmTest, bta_dm_name_cache_evicts_least_recently_used) {
+  BD_NAME bd_name = {};
+  strlcpy(reinterpret_cast<char*>(bd_name), kRemoteName, sizeof(bd_name));
+  BD_NAME cached = {};
+
+  const RawAddress first({0x00, 0x11, 0x22, 0x33, 0x44, 0x55});
+  bta_dm_name_request_started(first);
+  bta_dm_name_request_complete(first, HCI_SUCCESS, bd_name);
+  bta_dm_name_request_started(kRawAddress);
+  bta_dm_name_request_complete(kRawAddress, HCI_SUCCESS, bd_name);
+
+  // Fill the cache well beyond its capacity while keeping one entry in use
+  for (uint16_t i = 0; i < 1024; i++) {
+    RawAddress bd_addr({0x00, 0x00, 0x00, 0x00, static_cast<uint8_t>(i >> 8),
+                        static_cast<uint8_t>(i)});
+    bta_dm_name_request_started(bd_addr);
+    bta_dm_name_request_complete(bd_addr, HCI_SUCCESS, bd_name);
+    ASSERT_TRUE(bta_dm_name_lookup(kRawAddress, cached));
+  }
+
+  ASSERT_FALSE(bta_dm_name_lookup(first, cached));
+}
@@ -0,0 +1,392 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "bta/gatt/database.h"
+#include "bta/include/bta_gatt_api.h"
+#include "bta/include/bta_gatt_queue.h"
+#include "stack/include/gattdefs.h"
+#include "stack/eatt/eatt.h"
+#include "types/bluetooth/uuid.h"
+#include "types/raw_address.h"
+
+uint8_t appl_trace_level = 0;
+void LogMsg(uint32_t trace_set_mask, const char* fmt_str, ...) {}
+
+namespace {
+
+constexpr uint16_t kConnId = 0x0005;
+constexpr uint16_t kCccHandle = 0x0020;
+constexpr uint16_t kOtherDescHandle = 0x0021;
+
+/* Requests the queue handed to BTA, and their completion callbacks */
+struct read_request {
+  uint16_t handle;
+  GATT_READ_OP_CB cb;
+  void* cb_data;
+};
+struct read_multi_request {
+  tBTA_GATTC_MULTI handles;
+  GATT_READ_MULTI_OP_CB cb;
+  void* cb_data;
+};
+struct write_request {
+  uint16_t handle;
+  tGATT_WRITE_TYPE write_type;
+  GATT_WRITE_OP_CB cb;
+  void* cb_data;
+};
+
+std::vector<read_request> reads;
+std::vector<read_multi_request> read_multis;
+std::vector<write_request> writes;
+bool eatt_supported = false;
+
+const gatt::Descriptor kCcc = {
+    .handle = kCccHandle,
+    .uuid = bluetooth::Uuid::From16Bit(GATT_UUID_CHAR_CLIENT_CONFIG),
+};
+const gatt::Descriptor kOtherDesc = {
+    .handle = kOtherDescHandle,
+    .uuid = bluetooth::Uuid::From16Bit(GATT_UUID_CHAR_DESCRIPTION),
+};
+
+/* Values received by the application */
+std::map<uint16_t, std::vector<uint8_t>> read_values;
+std::map<uint16_t, tGATT_STATUS> read_statuses;
+std::vector<uint16_t> written_handles;
+
+void read_cb(uint16_t conn_id, tGATT_STATUS status, uint16_t handle,
+             uint16_t len, uint8_t* value, void* data) {
+  read_statuses[handle] = status;
+  read_values[handle] = std::vector<uint8_t>(value, value + len);
+}
+
+void write_cb(uint16_t conn_id, tGATT_STATUS status, uint16_t handle,
+              uint16_t len, const uint8_t* value, void* data) {
+  written_handles.push_back(handle);
+}
+
+}  // namespace
+
+void BTA_GATTC_ReadCharacteristic(uint16_t conn_id, uint16_t handle,
+                                  tGATT_AUTH_REQ auth_req,
+                                  GATT_READ_OP_CB callback, void* cb_data) {
+  reads.push_back({handle, callback, cb_data});
+}
+void BTA_GATTC_ReadCharDescr(uint16_t conn_id, uint16_t handle,
+                             tGATT_AUTH_REQ auth_req, GATT_READ_OP_CB callback,
+                             void* cb_data) {
+  reads.push_back({handle, callback, cb_data});
+}
+void BTA_GATTC_ReadMultiple(uint16_t conn_id, tBTA_GATTC_MULTI* p_read_multi,
+                            bool variable_len, tGATT_AUTH_REQ auth_req,
+                            GATT_READ_MULTI_OP_CB callback, void* cb_data) {
+  EXPECT_TRUE(variable_len);
+  read_multis.push_back({*p_read_multi, callback, cb_data});
+}
+void BTA_GATTC_WriteCharValue(uint16_t conn_id, uint16_t handle,
+                              tGATT_WRITE_TYPE write_type,
+                              std::vector<uint8_t> value,
+                              tGATT_AUTH_REQ auth_req,
+                              GATT_WRITE_OP_CB callback, void* cb_data) {
+  writes.push_back({handle, write_type, callback, cb_data});
+}
+void BTA_GATTC_WriteCharDescr(uint16_t conn_id, uint16_t handle,
+                              std::vector<uint8_t> value,
+                              tGATT_AUTH_REQ auth_req,
+                              GATT_WRITE_OP_CB callback, void* cb_data) {
+  writes.push_back({handle, GATT_WRITE, callback, cb_data});
+}
+void BTA_GATTC_ConfigureMTU(uint16_t conn_id, uint16_t mtu,
+                            GATT_CONFIGURE_MTU_OP_CB callback, void* cb_data) {}
+const gatt::Descriptor* BTA_GATTC_GetDescriptor(uint16_t conn_id,
+                                                uint16_t handle) {
+  if (handle == kCccHandle) return &kCcc;
+  if (handle == kOtherDescHandle) return &kOtherDesc;
+  return nullptr;
+}
+bool GATT_GetConnectionInfor(uint16_t conn_id, tGATT_IF* p_gatt_if,
+                             RawAddress& bd_addr, tBT_TRANSPORT* p_transport) {
+  bd_addr = RawAddress::kAny;
+  *p_transport = BT_TRANSPORT_LE;
+  return true;
+}
+
+namespace bluetooth {
+namespace eatt {
+
+struct EattExtension::impl {};
+
+EattExtension::EattExtension() = default;
+EattExtension::~EattExtension() = default;
+bool EattExtension::IsEattSupportedByPeer(const RawAddress& bd_addr) {
+  return eatt_supported;
+}
+void EattExtension::Connect(const RawAddress& bd_addr) {}
+void EattExtension::Disconnect(const RawAddress& bd_addr, uint16_t cid) {}
+void EattExtension::Reconfigure(const RawAddress& bd_addr, uint16_t cid,
+                                uint16_t mtu) {}
+void EattExtension::ReconfigureAll(const RawAddress& bd_addr, uint16_t mtu) {}
+EattChannel* EattExtension::FindEattChannelByCid(const RawAddress& bd_addr,
+                                                 uint16_t cid) {
+  return nullptr;
+}
+EattChannel* EattExtension::FindEattChannelByTransId(const RawAddress& bd_addr,
+                                                     uint32_t trans_id) {
+  return nullptr;
+}
+bool EattExtension::IsIndicationPending(const RawAddress& bd_addr,
+                                        uint16_t indication_handle) {
+  return false;
+}
+EattChannel* EattExtension::GetChannelAvailableForIndication(
+    const RawAddress& bd_addr) {
+  return nullptr;
+}
+void EattExtension::FreeGattResources(const RawAddress& bd_addr) {}
+bool EattExtension::IsOutstandingMsgInSendQueue(const RawAddress& bd_addr) {
+  return false;
+}
+EattChannel* EattExtension::GetChannelWithQueuedDataToSend(
+    const RawAddress& bd_addr) {
+  return nullptr;
+}
+EattChannel* EattExtension::GetChannelAvailableForClientRequest(
+    const RawAddress& bd_addr) {
+  return nullptr;
+}
+void EattExtension::StartIndicationConfirmationTimer(const RawAddress& bd_addr,
+                                                     uint16_t cid) {}
+void EattExtension::StopIndicationConfirmationTimer(const RawAddress& bd_addr,
+                                                    uint16_t cid) {}
+void EattExtension::StartAppIndicationTimer(const RawAddress& bd_addr,
+                                            uint16_t cid) {}
+void EattExtension::StopAppIndicationTimer(const RawAddress& bd_addr,
+                                           uint16_t cid) {}
+
+}  // namespace eatt
+}  // namespace bluetooth
+
+class BtaGattQueueTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    reads.clear();
+    read_multis.clear();
+    writes.clear();
+    read_values.clear();
+    read_statuses.clear();
+    written_handles.clear();
+    eatt_supported = false;
+  }
+
+  void TearDown() override { BtaGattQueue::Clean(kConnId); }
+
+  void CompleteRead(size_t i, std::vector<uint8_t> value) {
+    read_request request = reads[i];
+    request.cb(kConnId, GATT_SUCCESS, request.handle, value.size(),
+               value.data(), request.cb_data);
+  }
+
+  void CompleteReadMulti(size_t i, tGATT_STATUS status,
+                         std::vector<uint8_t> value) {
+    read_multi_request request = read_multis[i];
+    request.cb(kConnId, status, request.handles, value.size(), value.data(),
+               request.cb_data);
+  }
+
+  void CompleteWrite(size_t i) {
+    write_request request = writes[i];
+    request.cb(kConnId, GATT_SUCCESS, request.handle, 0, nullptr,
+               request.cb_data);
+  }
+};
+
+TEST_F(BtaGattQueueTest, reads_are_serialized_without_eatt) {
+  BtaGattQueue::ReadCharacteristic(kConnId, 0x0010, read_cb, nullptr);
+  BtaGattQueue::ReadCharacteristic(kConnId, 0x0011, read_cb, nullptr);
+  BtaGattQueue::ReadCharacteristic(kConnId, 0x0012, read_cb, nullptr);
+  ASSERT_EQ(1u, reads.size());
+
+  CompleteRead(0, {0x01});
+  ASSERT_EQ(2u, reads.size());
+  ASSERT_EQ(0x0011, reads[1].handle);
+  ASSERT_TRUE(read_multis.empty());
+  ASSERT_EQ(std::vector<uint8_t>({0x01}), read_values[0x0010]);
+}
+
+TEST_F(BtaGattQueueTest, reads_are_batched_with_eatt) {
+  eatt_supported = true;
+  BtaGattQueue::ReadCharacteristic(kConnId, 0x0010, read_cb, nullptr);
+  BtaGattQueue::ReadCharacteristic(kConnId, 0x0011, read_cb, nullptr);
+  BtaGattQueue::ReadDescriptor(kConnId, 0x0012, read_cb, nullptr);
+  BtaGattQueue::ReadCharacteristic(kConnId, 0x0013, read_cb, nullptr);
+  ASSERT_EQ(1u, reads.size());
+
+  CompleteRead(0, {0x01});
+  ASSERT_EQ(1u, reads.size());
+  ASSERT_EQ(1u, read_multis.size());
+  ASSERT_EQ(3, read_multis[0].handles.num_attr);
+  ASSERT_EQ(0x0011, read_multis[0].handles.handles[0]);
+  ASSERT_EQ(0x0013, read_multis[0].handles.handles[2]);
+
+  CompleteReadMulti(0, GATT_SUCCESS,
+                    {0x01, 0x00, 0xaa, 0x00, 0x00, 0x02, 0x00, 0xbb, 0xcc});
+  ASSERT_EQ(std::vector<uint8_t>({0xaa}), read_values[0x0011]);
+  ASSERT_EQ(std::vector<uint8_t>(), read_values[0x0012]);
+  ASSERT_EQ(std::vector<uint8_t>({0xbb, 0xcc}), read_values[0x0013]);
+  ASSERT_EQ(1u, reads.size());
+}
+
+TEST_F(BtaGattQueueTest, truncated_batch_values_are_read_alone) {
+  eatt_supported = true;
+  BtaGattQueue::ReadCharacteristic(kConnId, 0x0010, read_cb, nullptr);
+  BtaGattQueue::ReadCharacteristic(kConnId, 0x0011, read_cb, nullptr);
+  BtaGattQueue::ReadCharacteristic(kConnId, 0x0012, read_cb, nullptr);
+  BtaGattQueue::ReadCharacteristic(kConnId, 0x0013, read_cb, nullptr);
+  CompleteRead(0, {0x01});
+  ASSERT_EQ(1u, read_multis.size());
+
+  // The value of 0x0012 is 4 bytes long, only 1 fit in the response
+  CompleteReadMulti(0, GATT_SUCCESS, {0x01, 0x00, 0xaa, 0x04, 0x00, 0xbb});
+  ASSERT_EQ(std::vector<uint8_t>({0xaa}), read_values[0x0011]);
+  ASSERT_EQ(0u, read_values.count(0x0012));
+  ASSERT_EQ(2u, reads.size());
+  ASSERT_EQ(0x0012, reads[1].handle);
+
+  CompleteRead(1, {0xbb, 0xbc, 0xbd, 0xbe});
+  ASSERT_EQ(3u, reads.size());
+  ASSERT_EQ(0x0013, reads[2].handle);
+  ASSERT_EQ(1u, read_multis.size());
+}
+
+TEST_F(BtaGattQueueTest, unsupported_batch_is_not_retried) {
+  eatt_supported = true;
+  BtaGattQueue::ReadCharacteristic(kConnId, 0x0010, read_cb, nullptr);
+  BtaGattQueue::ReadCharacteristic(kConnId, 0x0011, read_cb, nullptr);
+  BtaGattQueue::ReadCharacteristic(kConnId, 0x0012, read_cb, nullptr);
+  CompleteRead(0, {0x01});
+  ASSERT_EQ(1u, read_multis.size());
+
+  CompleteReadMulti(0, GATT_REQ_NOT_SUPPORTED, {});
+  ASSERT_EQ(0u, read_statuses.count(0x0011));
+  ASSERT_EQ(2u, reads.size());
+  ASSERT_EQ(0x0011, reads[1].handle);
+
+  BtaGattQueue::ReadCharacteristic(kConnId, 0x0013, read_cb, nullptr);
+  CompleteRead(1, {0x02});
+  CompleteRead(2, {0x03});
+  ASSERT_EQ(4u, reads.size());
+  ASSERT_EQ(1u, read_multis.size());
+}
+
+TEST_F(BtaGattQueueTest, failed_batch_is_not_retried) {
+  eatt_supported = true;
+  BtaGattQueue::ReadCharacteristic(kConnId, 0x0010, read_cb, nullptr);
+  BtaGattQueue::ReadCharacteristic(kConnId, 0x0011, read_cb, nullptr);
+  BtaGattQueue::ReadCharacteristic(kConnId, 0x0012, read_cb, nullptr);
+  BtaGattQueue::ReadCharacteristic(kConnId, 0x0013, read_cb, nullptr);
+  CompleteRead(0, {0x01});
+  ASSERT_EQ(1u, read_multis.size());
+
+  CompleteReadMulti(0, GATT_ERROR, {});
+  ASSERT_EQ(GATT_ERROR, read_statuses[0x0011]);
+  ASSERT_EQ(GATT_ERROR, read_statuses[0x0012]);
+  ASSERT_EQ(GATT_ERROR, read_statuses[0x0013]);
+  ASSERT_EQ(1u, reads.size());
+  ASSERT_EQ(1u, read_multis.size());
+}
+
+TEST_F(BtaGattQueueTest, batch_completed_after_clean_fails) {
+  eatt_supported = true;
+  BtaGattQueue::ReadCharacteristic(kConnId, 0x0010, read_cb, nullptr);
+  BtaGattQueue::ReadCharacteristic(kConnId, 0x0011, read_cb, nullptr);
+  BtaGattQueue::ReadCharacteristic(kConnId, 0x0012, read_cb, nullptr);
+  CompleteRead(0, {0x01});
+  ASSERT_EQ(1u, read_multis.size());
+
+  // Link loss: the queue is cleaned, then GATT ends the request. Even a
+  // response which would have been retried fails the reads.
+  BtaGattQueue::Clean(kConnId);
+  CompleteReadMulti(0, GATT_REQ_NOT_SUPPORTED, {});
+  ASSERT_EQ(GATT_REQ_NOT_SUPPORTED, read_statuses[0x0011]);
+  ASSERT_EQ(GATT_REQ_NOT_SUPPORTED, read_statuses[0x0012]);
+  ASSERT_EQ(1u, reads.size());
+
+  // No state was left behind for the next connection with this conn_id
+  BtaGattQueue::ReadCharacteristic(kConnId, 0x0014, read_cb, nullptr);
+  BtaGattQueue::ReadCharacteristic(kConnId, 0x0015, read_cb, nullptr);
+  BtaGattQueue::ReadCharacteristic(kConnId, 0x0016, read_cb, nullptr);
+  ASSERT_EQ(2u, reads.size());
+  CompleteRead(1, {0x02});
+  ASSERT_EQ(2u, read_multis.size());
+}
+
+TEST_F(BtaGattQueueTest, write_commands_are_pipelined) {
+  BtaGattQueue::WriteCharacteristic(kConnId, 0x0030, {0x01},
+                                    GATT_WRITE_NO_RSP, write_cb, nullptr);
+  BtaGattQueue::WriteCharacteristic(kConnId, 0x0031, {0x02},
+                                    GATT_WRITE_NO_RSP, write_cb, nullptr);
+  BtaGattQueue::WriteCharacteristic(kConnId, 0x0032, {0x03}, GATT_WRITE,
+                                    write_cb, nullptr);
+  BtaGattQueue::WriteCharacteristic(kConnId, 0x0033, {0x04},
+                                    GATT_WRITE_NO_RSP, write_cb, nullptr);
+  ASSERT_EQ(2u, writes.size());
+
+  // The write request waits for both commands
+  CompleteWrite(0);
+  ASSERT_EQ(2u, writes.size());
+  CompleteWrite(1);
+  ASSERT_EQ(3u, writes.size());
+  ASSERT_EQ(0x0032, writes[2].handle);
+
+  CompleteWrite(2);
+  ASSERT_EQ(4u, writes.size());
+  ASSERT_EQ(std::vector<uint16_t>({0x0030, 0x0031, 0x0032}), written_handles);
+}
+
+TEST_F(BtaGattQueueTest, ccc_writes_are_pipelined) {
+  BtaGattQueue::WriteDescriptor(kConnId, kCccHandle, {0x01, 0x00}, GATT_WRITE,
+                                write_cb, nullptr);
+  BtaGattQueue::WriteDescriptor(kConnId, kCccHandle, {0x02, 0x00}, GATT_WRITE,
+                                write_cb, nullptr);
+  BtaGattQueue::WriteDescriptor(kConnId, kOtherDescHandle, {0x00}, GATT_WRITE,
+                                write_cb, nullptr);
+  ASSERT_EQ(2u, writes.size());
+
+  CompleteWrite(0);
+  CompleteWrite(1);
+  ASSERT_EQ(3u, writes.size());
+  ASSERT_EQ(kOtherDescHandle, writes[2].handle);
+}
+
+TEST_F(BtaGattQueueTest, clean_drops_queued_operations) {
+  BtaGattQueue::ReadCharacteristic(kConnId, 0x0010, read_cb, nullptr);
+  BtaGattQueue::ReadCharacteristic(kConnId, 0x0011, read_cb, nullptr);
+  BtaGattQueue::Clean(kConnId);
+
+  CompleteRead(0, {0x01});
+  ASSERT_EQ(1u, reads.size());
+  ASSERT_EQ(std::vector<uint8_t>({0x01}), read_values[0x0010]);
+
+  BtaGattQueue::ReadCharacteristic(kConnId, 0x0012, read_cb, nullptr);
+  ASSERT_EQ(2u, reads.size());
+}
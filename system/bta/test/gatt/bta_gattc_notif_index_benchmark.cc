@@ -0,0 +1,119 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "bta/gatt/bta_gattc_int.h"
+#include "types/raw_address.h"
+
+using ::benchmark::State;
+
+namespace {
+
+constexpr size_t kNumNotifications = 10000;
+constexpr uint16_t kFirstHandle = 0x0010;
+
+const RawAddress kServer({0x00, 0x11, 0x22, 0x33, 0x44, 0x55});
+
+// Every client registers |num_handles| characteristics of the server, the
+// server notifies all of them in random order. GATT hands each notification
+// to every client of the link, which looks up its own registrations.
+struct Setup {
+  std::vector<std::unique_ptr<tBTA_GATTC_RCB>> clients;
+  BtaGattcNotifIndex index;
+  std::vector<uint16_t> notifications;
+
+  Setup(size_t num_clients, size_t num_handles) {
+    for (size_t i = 0; i < num_clients; i++) {
+      auto p_clreg = std::make_unique<tBTA_GATTC_RCB>();
+      p_clreg->client_if = i + 1;
+      for (size_t j = 0; j < num_handles; j++) {
+        // Each client registers for its own characteristics
+        uint16_t handle = kFirstHandle + i * num_handles + j;
+        p_clreg->notif_reg[j].in_use = true;
+        p_clreg->notif_reg[j].remote_bda = kServer;
+        p_clreg->notif_reg[j].handle = handle;
+        index.Add(p_clreg->client_if, kServer, handle);
+      }
+      clients.push_back(std::move(p_clreg));
+    }
+    std::mt19937 rng(num_clients * num_handles);
+    std::uniform_int_distribution<uint16_t> pick(
+        kFirstHandle, kFirstHandle + num_clients * num_handles - 1);
+    notifications.resize(kNumNotifications);
+    for (auto& handle : notifications) handle = pick(rng);
+  }
+};
+
+// The registration walk every notification went through before the index,
+// kept as the baseline.
+bool LinearFind(const tBTA_GATTC_RCB* p_clreg, const RawAddress& bda,
+                uint16_t handle) {
+  for (size_t i = 0; i < BTA_GATTC_NOTIF_REG_MAX; i++) {
+    if (p_clreg->notif_reg[i].in_use &&
+        p_clreg->notif_reg[i].remote_bda == bda &&
+        p_clreg->notif_reg[i].handle == handle &&
+        !p_clreg->notif_reg[i].app_disconnected) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void BM_NotificationLinear(State& state) {
+  Setup setup(state.range(0), state.range(1));
+  for (auto _ : state) {
+    for (uint16_t handle : setup.notifications) {
+      for (const auto& p_clreg : setup.clients) {
+        benchmark::DoNotOptimize(LinearFind(p_clreg.get(), kServer, handle));
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * setup.notifications.size());
+}
+
+void BM_NotificationIndexed(State& state) {
+  Setup setup(state.range(0), state.range(1));
+  for (auto _ : state) {
+    for (uint16_t handle : setup.notifications) {
+      for (const auto& p_clreg : setup.clients) {
+        benchmark::DoNotOptimize(
+            setup.index.Contains(p_clreg->client_if, kServer, handle));
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * setup.notifications.size());
+}
+
+// Number of clients x characteristics registered by each client
+void NotificationArgs(benchmark::internal::Benchmark* b) {
+  for (int num_clients : {1, 4, 16}) {
+    for (int num_handles : {4, 32, BTA_GATTC_NOTIF_REG_MAX}) {
+      b->Args({num_clients, num_handles});
+    }
+  }
+}
+
+}  // namespace
+
+BENCHMARK(BM_NotificationLinear)->Apply(NotificationArgs);
+BENCHMARK(BM_NotificationIndexed)->Apply(NotificationArgs);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,69 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "bta/gatt/bta_gattc_int.h"
+#include "types/raw_address.h"
+
+namespace {
+
+const RawAddress kAddress1({0x11, 0x22, 0x33, 0x44, 0x55, 0x66});
+const RawAddress kAddress2({0x66, 0x55, 0x44, 0x33, 0x22, 0x11});
+
+}  // namespace
+
+class BtaGattcNotifIndexTest : public ::testing::Test {
+ protected:
+  BtaGattcNotifIndex index_;
+};
+
+TEST_F(BtaGattcNotifIndexTest, add_and_remove) {
+  index_.Add(1, kAddress1, 0x0010);
+  EXPECT_TRUE(index_.Contains(1, kAddress1, 0x0010));
+  EXPECT_FALSE(index_.Contains(2, kAddress1, 0x0010));
+  EXPECT_FALSE(index_.Contains(1, kAddress1, 0x0011));
+  EXPECT_FALSE(index_.Contains(1, kAddress2, 0x0010));
+
+  index_.Add(2, kAddress1, 0x0010);
+  EXPECT_EQ(1u, index_.Size());
+
+  index_.Remove(1, kAddress1, 0x0010);
+  EXPECT_FALSE(index_.Contains(1, kAddress1, 0x0010));
+  EXPECT_TRUE(index_.Contains(2, kAddress1, 0x0010));
+
+  index_.Remove(2, kAddress1, 0x0010);
+  EXPECT_EQ(0u, index_.Size());
+}
+
+TEST_F(BtaGattcNotifIndexTest, remove_client) {
+  index_.Add(1, kAddress1, 0x0010);
+  index_.Add(1, kAddress2, 0x0020);
+  index_.Add(3, kAddress2, 0x0020);
+
+  index_.RemoveClient(1);
+  EXPECT_FALSE(index_.Contains(1, kAddress1, 0x0010));
+  EXPECT_FALSE(index_.Contains(1, kAddress2, 0x0020));
+  EXPECT_TRUE(index_.Contains(3, kAddress2, 0x0020));
+  EXPECT_EQ(1u, index_.Size());
+}
+
+TEST_F(BtaGattcNotifIndexTest, invalid_client_if) {
+  index_.Add(0, kAddress1, 0x0010);
+  index_.Add(sizeof(tBTA_GATTC_CIF_MASK) * 8 + 1, kAddress1, 0x0010);
+  EXPECT_EQ(0u, index_.Size());
+  EXPECT_FALSE(index_.Contains(0, kAddress1, 0x0010));
+}
@@ -98,7 +98,8 @@ class BtaAvCoPeer {
         uuid_to_connect(0),
         bta_av_handle_(0),
         codecs_(nullptr),
-        content_protect_active_(false) {
+        content_protect_active_(false),
+        sink_table_valid_(false) {
     Reset(0);
   }
 
@@ -135,6 +136,24 @@ class BtaAvCoPeer {
     content_protect_active_ = cp_active;
   }
 
+  /**
+   * Get the supported peer Sinks of a Source codec. The table of the peer
+   * Sinks by codec is computed on first use after the supported Sinks
+   * changed.
+   *
+   * @param codec_index the Source codec index to look up
+   * @return the indexes into sinks[] of the peer Sinks for the codec, in the
+   * order they were received
+   */
+  const std::vector<uint8_t>& SinksForCodec(
+      btav_a2dp_codec_index_t codec_index);
+
+  /**
+   * Invalidate the table of the peer Sinks by codec. Must be called when
+   * the supported Sinks change.
+   */
+  void InvalidateSinkTable() { sink_table_valid_ = false; }
+
   RawAddress addr;                                // Peer address
   BtaAvCoSep sinks[BTAV_A2DP_CODEC_INDEX_MAX];    // Supported sinks
   BtaAvCoSep sources[BTAV_A2DP_CODEC_INDEX_MAX];  // Supported sources
@@ -158,6 +177,9 @@ class BtaAvCoPeer {
   tBTA_AV_HNDL bta_av_handle_;   // BTA AV handle to use
   A2dpCodecs* codecs_;           // Locally supported codecs
   bool content_protect_active_;  // True if Content Protect is active
+  // Indexes into sinks[] by Source codec index
+  std::vector<uint8_t> sink_table_[BTAV_A2DP_CODEC_INDEX_MAX];
+  bool sink_table_valid_;  // True if sink_table_ matches sinks[]
 };
 
 class BtaAvCo {
@@ -750,6 +772,23 @@ void BtaAvCoPeer::Reset(tBTA_AV_HNDL bta_av_handle) {
   delete codecs_;
   codecs_ = nullptr;
   content_protect_active_ = false;
+  InvalidateSinkTable();
+}
+
+const std::vector<uint8_t>& BtaAvCoPeer::SinksForCodec(
+    btav_a2dp_codec_index_t codec_index) {
+  if (!sink_table_valid_) {
+    for (auto& sinks_for_codec : sink_table_) sinks_for_codec.clear();
+    for (size_t index = 0; index < num_sup_sinks; index++) {
+      btav_a2dp_codec_index_t peer_codec_index =
+          A2DP_SourceCodecIndex(sinks[index].codec_caps);
+      if (peer_codec_index < BTAV_A2DP_CODEC_INDEX_MAX) {
+        sink_table_[peer_codec_index].push_back(index);
+      }
+    }
+    sink_table_valid_ = true;
+  }
+  return sink_table_[codec_index];
 }
 
 void BtaAvCo::Init(
@@ -906,6 +945,7 @@ void BtaAvCo::ProcessDiscoveryResult(tBTA_AV_HNDL bta_av_handle,
   p_peer->num_rx_sources = 0;
   p_peer->num_sup_sinks = 0;
   p_peer->num_sup_sources = 0;
+  p_peer->InvalidateSinkTable();
   if (uuid_local == UUID_SERVCLASS_AUDIO_SINK) {
     p_peer->uuid_to_connect = UUID_SERVCLASS_AUDIO_SOURCE;
   } else if (uuid_local == UUID_SERVCLASS_AUDIO_SOURCE) {
@@ -955,6 +995,7 @@ tA2DP_STATUS BtaAvCo::ProcessSourceGetConfig(
       p_sink->seid = seid;
       p_sink->num_protect = *p_num_protect;
       memcpy(p_sink->protect_info, p_protect_info, AVDT_CP_INFO_LEN);
+      p_peer->InvalidateSinkTable();
     } else {
       APPL_TRACE_ERROR("%s: peer %s : no more room for Sink info", __func__,
                        p_peer->addr.ToString().c_str());
@@ -1857,13 +1898,8 @@ BtaAvCoSep* BtaAvCo::FindPeerSink(BtaAvCoPeer* p_peer,
   }
 
   // Find the peer Sink for the codec
-  for (size_t index = 0; index < p_peer->num_sup_sinks; index++) {
+  for (uint8_t index : p_peer->SinksForCodec(codec_index)) {
     BtaAvCoSep* p_sink = &p_peer->sinks[index];
-    btav_a2dp_codec_index_t peer_codec_index =
-        A2DP_SourceCodecIndex(p_sink->codec_caps);
-    if (peer_codec_index != codec_index) {
-      continue;
-    }
     if (!AudioSepHasContentProtection(p_sink)) {
       APPL_TRACE_DEBUG(
           "%s: peer Sink for codec %s does not support "
@@ -38,6 +38,10 @@ static const std::string BT_CONFIG_KEY_SDP_DI_HW_VERSION =
     "SdpDiHardwareVersion";
 static const std::string BT_CONFIG_KEY_SDP_DI_VENDOR_ID_SRC =
     "SdpDiVendorIdSource";
+static const std::string BT_CONFIG_KEY_SDP_DISCOVERY_CACHE =
+    "SdpDiscoveryCache";
+static const std::string BT_CONFIG_KEY_AVDTP_SEP_CAPABILITIES =
+    "AvdtpSepCapabilities";
 
 static const std::string BT_CONFIG_KEY_REMOTE_VER_MFCT = "Manufacturer";
 static const std::string BT_CONFIG_KEY_REMOTE_VER_VER = "LmpVer";
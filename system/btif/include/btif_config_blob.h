@@ -0,0 +1,146 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+/******************************************************************************
+ *
+ *  Helpers of the caches keeping what was learned from a bonded device in a
+ *  binary config value next to its bond: little endian fields of the value
+ *  and the age after which a cached value is no longer trusted.
+ *
+ ******************************************************************************/
+
+#include <string.h>
+#include <time.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "btif/include/btif_config.h"
+
+// Age after which cached values are refetched from the device, in seconds
+constexpr uint64_t kBtifConfigBlobMaxAgeSeconds = 7 * 24 * 60 * 60;
+
+class BtifConfigBlobWriter {
+ public:
+  explicit BtifConfigBlobWriter(std::vector<uint8_t>& data) : data_(data) {}
+
+  void u8(uint8_t value) { data_.push_back(value); }
+
+  void u16(uint16_t value) {
+    u8(value & 0xff);
+    u8(value >> 8);
+  }
+
+  void u32(uint32_t value) {
+    u16(value & 0xffff);
+    u16(value >> 16);
+  }
+
+  void u64(uint64_t value) {
+    u32(value & 0xffffffff);
+    u32(value >> 32);
+  }
+
+  void bytes(const uint8_t* value, size_t len) {
+    data_.insert(data_.end(), value, value + len);
+  }
+
+  void bytes(const std::vector<uint8_t>& value) {
+    data_.insert(data_.end(), value.begin(), value.end());
+  }
+
+ private:
+  std::vector<uint8_t>& data_;
+};
+
+// Every read fails once the value is exhausted
+class BtifConfigBlobReader {
+ public:
+  explicit BtifConfigBlobReader(const std::vector<uint8_t>& data)
+      : data_(data) {}
+
+  bool u8(uint8_t* value) {
+    if (pos_ + 1 > data_.size()) return false;
+    *value = data_[pos_++];
+    return true;
+  }
+
+  bool u16(uint16_t* value) {
+    uint8_t lo, hi;
+    if (!u8(&lo) || !u8(&hi)) return false;
+    *value = lo | (hi << 8);
+    return true;
+  }
+
+  bool u32(uint32_t* value) {
+    uint16_t lo, hi;
+    if (!u16(&lo) || !u16(&hi)) return false;
+    *value = lo | (static_cast<uint32_t>(hi) << 16);
+    return true;
+  }
+
+  bool u64(uint64_t* value) {
+    uint32_t lo, hi;
+    if (!u32(&lo) || !u32(&hi)) return false;
+    *value = lo | (static_cast<uint64_t>(hi) << 32);
+    return true;
+  }
+
+  bool bytes(size_t len, uint8_t* value) {
+    if (pos_ + len > data_.size()) return false;
+    memcpy(value, data_.data() + pos_, len);
+    pos_ += len;
+    return true;
+  }
+
+  bool bytes(size_t len, std::vector<uint8_t>* value) {
+    if (pos_ + len > data_.size()) return false;
+    value->assign(data_.begin() + pos_, data_.begin() + pos_ + len);
+    pos_ += len;
+    return true;
+  }
+
+  bool done() const { return pos_ == data_.size(); }
+
+ private:
+  const std::vector<uint8_t>& data_;
+  size_t pos_ = 0;
+};
+
+// The binary value of |key| in |section|, empty if there is none
+inline std::vector<uint8_t> btif_config_get_blob(const std::string& section,
+                                                 const std::string& key) {
+  size_t len = btif_config_get_bin_length(section, key);
+  if (len == 0) return {};
+
+  std::vector<uint8_t> blob(len);
+  if (!btif_config_get_bin(section, key, blob.data(), &len)) return {};
+  blob.resize(len);
+  return blob;
+}
+
+// Timestamp of a cached value, in seconds since the epoch
+inline uint64_t btif_config_blob_now() {
+  return static_cast<uint64_t>(time(nullptr));
+}
+
+// A value stored in the future comes from a clock that was since set back
+inline bool btif_config_blob_is_expired(uint64_t stored_at, uint64_t now) {
+  return stored_at > now || now - stored_at > kBtifConfigBlobMaxAgeSeconds;
+}
@@ -51,6 +51,7 @@
 #include "audio_hal_interface/a2dp_encoding.h"
 #include "bt_utils.h"
 #include "bta/include/bta_csis_api.h"
+#include "bta/include/bta_gatt_queue.h"
 #include "bta/include/bta_has_api.h"
 #include "bta/include/bta_hearing_aid_api.h"
 #include "bta/include/bta_hf_client_api.h"
@@ -453,6 +454,7 @@ static void dump(int fd, const char** arguments) {
   VolumeControl::DebugDump(fd);
 #endif
   connection_manager::dump(fd);
+  BtaGattQueue::DebugDump(fd);
   bluetooth::bqr::DebugDump(fd);
   bluetooth::shim::Dump(fd, arguments);
 }
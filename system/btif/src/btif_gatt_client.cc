@@ -581,8 +581,8 @@ static void btif_gattc_reg_for_notification_impl(tGATT_IF client_if,
       BTA_GATTC_RegisterForNotifications(client_if, bda, handle);
 
   // TODO(jpawlowski): conn_id is currently unused
-  HAL_CBACK(bt_gatt_callbacks, client->register_for_notification_cb,
-            /* conn_id */ 0, 1, status, handle);
+  CLI_CBACK_IN_JNI(register_for_notification_cb, /* conn_id */ 0, 1, status,
+                   handle);
 }
 
 bt_status_t btif_gattc_reg_for_notification(int client_if,
@@ -590,7 +590,9 @@ bt_status_t btif_gattc_reg_for_notification(int client_if,
                                             uint16_t handle) {
   CHECK_BTGATT_INIT();
 
-  return do_in_jni_thread(
+  // The registrations are looked up on the main thread for every notification
+  return do_in_main_thread(
+      FROM_HERE,
       Bind(base::IgnoreResult(&btif_gattc_reg_for_notification_impl), client_if,
            bd_addr, handle));
 }
@@ -602,8 +604,8 @@ static void btif_gattc_dereg_for_notification_impl(tGATT_IF client_if,
       BTA_GATTC_DeregisterForNotifications(client_if, bda, handle);
 
   // TODO(jpawlowski): conn_id is currently unused
-  HAL_CBACK(bt_gatt_callbacks, client->register_for_notification_cb,
-            /* conn_id */ 0, 0, status, handle);
+  CLI_CBACK_IN_JNI(register_for_notification_cb, /* conn_id */ 0, 0, status,
+                   handle);
 }
 
 bt_status_t btif_gattc_dereg_for_notification(int client_if,
@@ -611,7 +613,8 @@ bt_status_t btif_gattc_dereg_for_notification(int client_if,
                                               uint16_t handle) {
   CHECK_BTGATT_INIT();
 
-  return do_in_jni_thread(
+  return do_in_main_thread(
+      FROM_HERE,
       Bind(base::IgnoreResult(&btif_gattc_dereg_for_notification_impl),
            client_if, bd_addr, handle));
 }
@@ -904,6 +904,12 @@ bt_status_t btif_storage_remove_bonded_device(
   if (btif_config_exist(bdstr, BTIF_STORAGE_KEY_GATT_SERVER_SUPPORTED)) {
     ret &= btif_config_remove(bdstr, BTIF_STORAGE_KEY_GATT_SERVER_SUPPORTED);
   }
+  if (btif_config_exist(bdstr, BT_CONFIG_KEY_SDP_DISCOVERY_CACHE)) {
+    ret &= btif_config_remove(bdstr, BT_CONFIG_KEY_SDP_DISCOVERY_CACHE);
+  }
+  if (btif_config_exist(bdstr, BT_CONFIG_KEY_AVDTP_SEP_CAPABILITIES)) {
+    ret &= btif_config_remove(bdstr, BT_CONFIG_KEY_AVDTP_SEP_CAPABILITIES);
+  }
 
   /* write bonded info immediately */
   btif_config_flush();
@@ -23,6 +23,11 @@
 #include <base/logging.h>
 #include <string.h>  // For memcmp
 
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #include "btcore/include/module.h"
 #include "check.h"
 #include "device/include/interop_database.h"
@@ -37,15 +42,44 @@
 
 static list_t* interop_list = NULL;
 
+// Bitmask of the workarounds matching a device, one bit per feature.
+typedef uint64_t interop_feature_mask_t;
+static_assert(INTEROP_DISABLE_ROBUST_CACHING < 64,
+              "interop_feature_mask_t is too small for interop_feature_t");
+
+// Maximum number of devices and names for which the matching workarounds
+// are cached. The caches are cleared when full, a lookup is only repeated
+// for the devices still in use.
+static const size_t kInteropCacheSize = 64;
+
+// Guards the dynamic database and the caches below, the lookups are made
+// from several threads.
+static std::mutex interop_cache_mutex;
+static std::unordered_map<RawAddress, interop_feature_mask_t>
+    interop_addr_cache;
+static std::unordered_map<std::string, interop_feature_mask_t>
+    interop_name_cache;
+// Entries of the fixed database indexed by OUI, all of them match at least
+// the first three bytes of the address.
+static std::unordered_map<uint32_t, std::vector<const interop_addr_entry_t*>>
+    interop_oui_index;
+
 static const char* interop_feature_string_(const interop_feature_t feature);
 static void interop_free_entry_(void* data);
 static void interop_lazy_init_(void);
-static bool interop_match_fixed_(const interop_feature_t feature,
-                                 const RawAddress* addr);
-static bool interop_match_dynamic_(const interop_feature_t feature,
-                                   const RawAddress* addr);
-static bool interop_match_range_(const interop_feature_t feature,
-                                 const RawAddress* addr);
+static void interop_cache_clear_(void);
+static interop_feature_mask_t interop_addr_features_(const RawAddress* addr);
+static interop_feature_mask_t interop_name_features_(const char* name);
+static interop_feature_mask_t interop_match_fixed_(const RawAddress* addr);
+static interop_feature_mask_t interop_match_dynamic_(const RawAddress* addr);
+static interop_feature_mask_t interop_match_range_(const RawAddress* addr);
+
+static interop_feature_mask_t interop_feature_bit_(
+    const interop_feature_t feature) {
+  // Dynamic entries may hold features unknown to this version.
+  if (feature >= 64) return 0;
+  return interop_feature_mask_t{1} << feature;
+}
 
 // Interface functions
 
@@ -53,9 +87,7 @@ bool interop_match_addr(const interop_feature_t feature,
                         const RawAddress* addr) {
   CHECK(addr);
 
-  if (interop_match_fixed_(feature, addr) ||
-      interop_match_dynamic_(feature, addr) ||
-      interop_match_range_(feature, addr)) {
+  if (interop_addr_features_(addr) & interop_feature_bit_(feature)) {
     LOG_INFO("%s() Device %s is a match for interop workaround %s.", __func__,
              addr->ToString().c_str(), interop_feature_string_(feature));
     return true;
@@ -67,17 +99,10 @@ bool interop_match_addr(const interop_feature_t feature,
 bool interop_match_name(const interop_feature_t feature, const char* name) {
   CHECK(name);
 
-  const size_t db_size =
-      sizeof(interop_name_database) / sizeof(interop_name_entry_t);
-  for (size_t i = 0; i != db_size; ++i) {
-    if (feature == interop_name_database[i].feature &&
-        strlen(name) >= interop_name_database[i].length &&
-        strncmp(name, interop_name_database[i].name,
-                interop_name_database[i].length) == 0) {
-      LOG_INFO("%s() Device %s is a match for interop workaround %s.", __func__,
-               name, interop_feature_string_(feature));
-      return true;
-    }
+  if (interop_name_features_(name) & interop_feature_bit_(feature)) {
+    LOG_INFO("%s() Device %s is a match for interop workaround %s.", __func__,
+             name, interop_feature_string_(feature));
+    return true;
   }
 
   return false;
@@ -95,19 +120,25 @@ void interop_database_add(uint16_t feature, const RawAddress* addr,
   entry->feature = static_cast<interop_feature_t>(feature);
   entry->length = length;
 
+  std::lock_guard<std::mutex> lock(interop_cache_mutex);
   interop_lazy_init_();
   list_append(interop_list, entry);
+  interop_cache_clear_();
 }
 
 void interop_database_clear() {
+  std::lock_guard<std::mutex> lock(interop_cache_mutex);
   if (interop_list) list_clear(interop_list);
+  interop_cache_clear_();
 }
 
 // Module life-cycle functions
 
 static future_t* interop_clean_up(void) {
+  std::lock_guard<std::mutex> lock(interop_cache_mutex);
   list_free(interop_list);
   interop_list = NULL;
+  interop_cache_clear_();
   return future_new_immediate(FUTURE_SUCCESS);
 }
 
@@ -159,55 +190,115 @@ static void interop_lazy_init_(void) {
   }
 }
 
-static bool interop_match_dynamic_(const interop_feature_t feature,
-                                   const RawAddress* addr) {
-  if (interop_list == NULL || list_length(interop_list) == 0) return false;
+// Called with interop_cache_mutex held.
+static void interop_cache_clear_(void) {
+  interop_addr_cache.clear();
+  interop_name_cache.clear();
+}
+
+// Workarounds matching |addr|, looked up in the databases on the first
+// query for the device and then served from the cache.
+static interop_feature_mask_t interop_addr_features_(const RawAddress* addr) {
+  std::lock_guard<std::mutex> lock(interop_cache_mutex);
+
+  auto it = interop_addr_cache.find(*addr);
+  if (it != interop_addr_cache.end()) return it->second;
+
+  interop_feature_mask_t features = interop_match_fixed_(addr) |
+                                    interop_match_dynamic_(addr) |
+                                    interop_match_range_(addr);
+  if (interop_addr_cache.size() >= kInteropCacheSize) {
+    interop_addr_cache.clear();
+  }
+  interop_addr_cache[*addr] = features;
+  return features;
+}
+
+static interop_feature_mask_t interop_name_features_(const char* name) {
+  std::lock_guard<std::mutex> lock(interop_cache_mutex);
+
+  auto it = interop_name_cache.find(name);
+  if (it != interop_name_cache.end()) return it->second;
+
+  interop_feature_mask_t features = 0;
+  const size_t name_length = strlen(name);
+  const size_t db_size =
+      sizeof(interop_name_database) / sizeof(interop_name_entry_t);
+  for (size_t i = 0; i != db_size; ++i) {
+    if (name_length >= interop_name_database[i].length &&
+        strncmp(name, interop_name_database[i].name,
+                interop_name_database[i].length) == 0) {
+      features |= interop_feature_bit_(interop_name_database[i].feature);
+    }
+  }
+
+  if (interop_name_cache.size() >= kInteropCacheSize) {
+    interop_name_cache.clear();
+  }
+  interop_name_cache.emplace(name, features);
+  return features;
+}
+
+static uint32_t interop_oui_(const RawAddress* addr) {
+  return (addr->address[0] << 16) | (addr->address[1] << 8) | addr->address[2];
+}
 
+static interop_feature_mask_t interop_match_dynamic_(const RawAddress* addr) {
+  if (interop_list == NULL || list_length(interop_list) == 0) return 0;
+
+  interop_feature_mask_t features = 0;
   const list_node_t* node = list_begin(interop_list);
   while (node != list_end(interop_list)) {
     interop_addr_entry_t* entry =
         static_cast<interop_addr_entry_t*>(list_node(node));
     CHECK(entry);
 
-    if (feature == entry->feature &&
-        memcmp(addr, &entry->addr, entry->length) == 0)
-      return true;
+    if (memcmp(addr, &entry->addr, entry->length) == 0)
+      features |= interop_feature_bit_(entry->feature);
 
     node = list_next(node);
   }
-  return false;
+  return features;
 }
 
-static bool interop_match_fixed_(const interop_feature_t feature,
-                                 const RawAddress* addr) {
+static interop_feature_mask_t interop_match_fixed_(const RawAddress* addr) {
   CHECK(addr);
 
-  const size_t db_size =
-      sizeof(interop_addr_database) / sizeof(interop_addr_entry_t);
-  for (size_t i = 0; i != db_size; ++i) {
-    if (feature == interop_addr_database[i].feature &&
-        memcmp(addr, &interop_addr_database[i].addr,
-               interop_addr_database[i].length) == 0) {
-      return true;
+  if (interop_oui_index.empty()) {
+    const size_t db_size =
+        sizeof(interop_addr_database) / sizeof(interop_addr_entry_t);
+    for (size_t i = 0; i != db_size; ++i) {
+      CHECK(interop_addr_database[i].length >= 3);
+      interop_oui_index[interop_oui_(&interop_addr_database[i].addr)]
+          .push_back(&interop_addr_database[i]);
     }
   }
 
-  return false;
+  auto it = interop_oui_index.find(interop_oui_(addr));
+  if (it == interop_oui_index.end()) return 0;
+
+  interop_feature_mask_t features = 0;
+  for (const interop_addr_entry_t* entry : it->second) {
+    if (memcmp(addr, &entry->addr, entry->length) == 0) {
+      features |= interop_feature_bit_(entry->feature);
+    }
+  }
+
+  return features;
 }
 
-static bool interop_match_range_(const interop_feature_t feature,
-                                 const RawAddress* addr) {
+static interop_feature_mask_t interop_match_range_(const RawAddress* addr) {
   CHECK(addr);
 
+  interop_feature_mask_t features = 0;
   const size_t db_size =
       sizeof(interop_addr_range_database) / sizeof(interop_addr_range_entry_t);
   for (size_t i = 0; i != db_size; ++i) {
-    if (feature == interop_addr_range_database[i].feature &&
-        *addr >= interop_addr_range_database[i].addr_start &&
+    if (*addr >= interop_addr_range_database[i].addr_start &&
         *addr <= interop_addr_range_database[i].addr_end) {
-      return true;
+      features |= interop_feature_bit_(interop_addr_range_database[i].feature);
     }
   }
 
-  return false;
+  return features;
 }
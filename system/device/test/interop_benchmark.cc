@@ -0,0 +1,114 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstring>
+#include <vector>
+
+#include "device/include/interop.h"
+#include "device/include/interop_database.h"
+#include "types/raw_address.h"
+
+using ::benchmark::State;
+
+namespace {
+
+constexpr interop_feature_t kFeatures[] = {
+    INTEROP_DISABLE_LE_SECURE_CONNECTIONS, INTEROP_DISABLE_ABSOLUTE_VOLUME,
+    INTEROP_DISABLE_ROLE_SWITCH,           INTEROP_DISABLE_SNIFF,
+    INTEROP_2MBPS_LINK_ONLY,               INTEROP_DISABLE_AVDTP_SUSPEND,
+};
+constexpr size_t kNumFeatures = sizeof(kFeatures) / sizeof(kFeatures[0]);
+
+// |num_devices| peers sharing the first bytes of the database entries but
+// matching none of them, so that every lookup is a miss as for most devices
+// and no match is logged.
+std::vector<RawAddress> Devices(size_t num_devices) {
+  std::vector<RawAddress> devices;
+  const size_t db_size =
+      sizeof(interop_addr_database) / sizeof(interop_addr_entry_t);
+  for (size_t i = 0; i < num_devices; i++) {
+    RawAddress bd_addr = interop_addr_database[(i * 7) % db_size].addr;
+    bd_addr.address[2] ^= 0x80;
+    bd_addr.address[4] = static_cast<uint8_t>(i >> 8);
+    bd_addr.address[5] = static_cast<uint8_t>(i);
+    devices.push_back(bd_addr);
+  }
+  return devices;
+}
+
+// The scan of the fixed database interop_match_addr() used to do on every
+// lookup, kept as the baseline.
+bool LinearMatch(const interop_feature_t feature, const RawAddress* addr) {
+  const size_t db_size =
+      sizeof(interop_addr_database) / sizeof(interop_addr_entry_t);
+  for (size_t i = 0; i != db_size; ++i) {
+    if (feature == interop_addr_database[i].feature &&
+        memcmp(addr, &interop_addr_database[i].addr,
+               interop_addr_database[i].length) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Lookups made for a few connected peers, as done during connection setup,
+// codec negotiation and AVRCP/HFP handling.
+void BM_InteropMatchAddrLinear(State& state) {
+  auto devices = Devices(state.range(0));
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(LinearMatch(kFeatures[i % kNumFeatures],
+                                         &devices[i % devices.size()]));
+    i++;
+  }
+  state.counters["lookups_per_second"] =
+      benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+}
+
+void BM_InteropMatchAddr(State& state) {
+  auto devices = Devices(state.range(0));
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(interop_match_addr(kFeatures[i % kNumFeatures],
+                                                &devices[i % devices.size()]));
+    i++;
+  }
+  state.counters["lookups_per_second"] =
+      benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+}
+
+void BM_InteropMatchName(State& state) {
+  const char* names[] = {"Pixel Buds", "Headset", "Speaker", "Watch"};
+  constexpr size_t kNumNames = sizeof(names) / sizeof(names[0]);
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        interop_match_name(kFeatures[i % kNumFeatures], names[i % kNumNames]));
+    i++;
+  }
+  state.counters["lookups_per_second"] =
+      benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_InteropMatchAddrLinear)->Arg(4)->Arg(256);
+BENCHMARK(BM_InteropMatchAddr)->Arg(4)->Arg(256);
+BENCHMARK(BM_InteropMatchName);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -105,3 +105,36 @@ TEST(InteropTest, test_range_miss) {
   ASSERT_FALSE(
       interop_match_addr(INTEROP_DISABLE_ABSOLUTE_VOLUME, &test_address));
 }
+
+TEST(InteropTest, test_dynamic_short_prefix) {
+  RawAddress test_address;
+  RawAddress::FromString("12:34:56:78:9a:bc", test_address);
+  EXPECT_FALSE(interop_match_addr(INTEROP_DISABLE_SNIFF, &test_address));
+
+  interop_database_add(INTEROP_DISABLE_SNIFF, &test_address, 1);
+  EXPECT_TRUE(interop_match_addr(INTEROP_DISABLE_SNIFF, &test_address));
+  RawAddress::FromString("12:00:00:00:00:00", test_address);
+  EXPECT_TRUE(interop_match_addr(INTEROP_DISABLE_SNIFF, &test_address));
+
+  interop_database_clear();
+  EXPECT_FALSE(interop_match_addr(INTEROP_DISABLE_SNIFF, &test_address));
+}
+
+TEST(InteropTest, test_repeated_lookups) {
+  // Look up more devices than are cached, twice, with several features for
+  // the same device.
+  for (int pass = 0; pass < 2; pass++) {
+    for (int i = 0; i < 200; i++) {
+      RawAddress test_address({0x38, 0x2c, 0x4a, 0xe6, 0x00,
+                               static_cast<uint8_t>(i)});
+      EXPECT_TRUE(interop_match_addr(INTEROP_DISABLE_LE_SECURE_CONNECTIONS,
+                                     &test_address));
+      EXPECT_TRUE(interop_match_addr(INTEROP_HID_PREF_CONN_SUP_TIMEOUT_3S,
+                                     &test_address));
+      EXPECT_FALSE(
+          interop_match_addr(INTEROP_AUTO_RETRY_PAIRING, &test_address));
+    }
+    EXPECT_TRUE(interop_match_name(INTEROP_DISABLE_AUTO_PAIRING, "BMW M3"));
+    EXPECT_FALSE(interop_match_name(INTEROP_DISABLE_SNIFF, "BMW M3"));
+  }
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/byte_ring_buffer.h"
+
+#include <algorithm>
+
+#include "os/log.h"
+
+namespace bluetooth {
+namespace common {
+
+ByteRingBuffer::ByteRingBuffer(size_t max_bytes, size_t block_size)
+    : block_size_(block_size), max_blocks_(std::max<size_t>(max_bytes / block_size, 2)) {
+  ASSERT(block_size_ > 0);
+  current_block_.reserve(block_size_);
+}
+
+void ByteRingBuffer::Push(const uint8_t* header, size_t header_size, const uint8_t* payload, size_t payload_size) {
+  size_t record_size = header_size + payload_size;
+  if (record_size > block_size_) {
+    LOG_WARN("Dropping record of %zu bytes, larger than a block of %zu bytes", record_size, block_size_);
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (current_block_.size() + record_size > block_size_) {
+    SealCurrentBlock();
+  }
+  current_block_.insert(current_block_.end(), header, header + header_size);
+  current_block_.insert(current_block_.end(), payload, payload + payload_size);
+  current_record_count_++;
+}
+
+void ByteRingBuffer::SealCurrentBlock() {
+  // Keep one block for the records being pushed.
+  while (sealed_blocks_.size() >= max_blocks_ - 1) {
+    sealed_record_count_ -= sealed_blocks_.front().record_count;
+    sealed_size_ -= sealed_blocks_.front().data->size();
+    sealed_blocks_.pop_front();
+  }
+  sealed_size_ += current_block_.size();
+  sealed_record_count_ += current_record_count_;
+  sealed_blocks_.push_back({std::make_shared<const Block>(std::move(current_block_)), current_record_count_});
+
+  current_block_ = Block();
+  current_block_.reserve(block_size_);
+  current_record_count_ = 0;
+}
+
+std::vector<std::shared_ptr<const ByteRingBuffer::Block>> ByteRingBuffer::Snapshot() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<std::shared_ptr<const Block>> blocks;
+  blocks.reserve(sealed_blocks_.size() + 1);
+  for (const auto& block : sealed_blocks_) {
+    blocks.push_back(block.data);
+  }
+  if (!current_block_.empty()) {
+    blocks.push_back(std::make_shared<const Block>(current_block_));
+  }
+  return blocks;
+}
+
+void ByteRingBuffer::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  sealed_blocks_.clear();
+  sealed_record_count_ = 0;
+  sealed_size_ = 0;
+  current_block_.clear();
+  current_record_count_ = 0;
+}
+
+size_t ByteRingBuffer::RecordCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return sealed_record_count_ + current_record_count_;
+}
+
+size_t ByteRingBuffer::Size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return sealed_size_ + current_block_.size();
+}
+
+size_t ByteRingBuffer::Capacity() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return (sealed_blocks_.size() + 1) * block_size_;
+}
+
+}  // namespace common
+}  // namespace bluetooth
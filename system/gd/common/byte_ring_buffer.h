@@ -0,0 +1,81 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace bluetooth {
+namespace common {
+
+// Ring of variable size records bounded by a number of bytes rather than a
+// number of records. Records are stored back to back in fixed size blocks, so
+// pushing a record does not allocate unless a block fills up. When the ring is
+// full the oldest block, and every record in it, is dropped.
+//
+// Full blocks are sealed and never modified again: a snapshot shares them with
+// the ring and only copies the block currently being filled.
+class ByteRingBuffer {
+ public:
+  using Block = std::vector<uint8_t>;
+
+  static constexpr size_t kDefaultBlockSize = 16 * 1024;
+
+  // |max_bytes| is rounded down to a whole number of blocks, and is at least
+  // two blocks.
+  explicit ByteRingBuffer(size_t max_bytes, size_t block_size = kDefaultBlockSize);
+
+  // Append one record made of |header| followed by |payload|. Records larger
+  // than a block are dropped.
+  void Push(const uint8_t* header, size_t header_size, const uint8_t* payload, size_t payload_size);
+
+  // Blocks holding the records currently in the ring, oldest first.
+  std::vector<std::shared_ptr<const Block>> Snapshot() const;
+
+  // Drop all the records.
+  void Clear();
+
+  // Number of records and bytes of records currently in the ring.
+  size_t RecordCount() const;
+  size_t Size() const;
+
+  // Bytes allocated for the blocks of the ring.
+  size_t Capacity() const;
+
+ private:
+  void SealCurrentBlock();
+
+  const size_t block_size_;
+  const size_t max_blocks_;
+  struct SealedBlock {
+    std::shared_ptr<const Block> data;
+    size_t record_count;
+  };
+  std::deque<SealedBlock> sealed_blocks_;
+  Block current_block_;
+  size_t current_record_count_{0};
+  size_t sealed_record_count_{0};
+  size_t sealed_size_{0};
+  mutable std::mutex mutex_;
+};
+
+}  // namespace common
+}  // namespace bluetooth
@@ -0,0 +1,118 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <malloc.h>
+
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "common/byte_ring_buffer.h"
+#include "common/circular_buffer.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace common {
+
+namespace {
+
+// Memory budget of the btsnooz log on release builds, and the packet count it
+// used to be converted to.
+constexpr size_t kMaxBytes = 256 * 1024;
+constexpr size_t kMaxPackets = kMaxBytes / 150;
+
+// Size of a btsnoop packet record header.
+constexpr size_t kHeaderSize = 25;
+
+// Payload sizes of btsnooz records: commands, events and ACL packets cut to
+// their L2CAP header.
+constexpr size_t kPayloadSizes[] = {4, 7, 14, 14, 6, 14, 32, 14};
+constexpr size_t kNumPayloadSizes = sizeof(kPayloadSizes) / sizeof(kPayloadSizes[0]);
+
+size_t AllocatedBytes() {
+  return mallinfo().uordblks;
+}
+
+void ReportMemory(State& state, size_t allocated, size_t retained) {
+  state.counters["retained_packets"] = retained;
+  state.counters["bytes_per_packet"] = retained ? static_cast<double>(allocated) / retained : 0;
+  state.counters["packets_per_second"] = benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+}
+
+}  // namespace
+
+// The btsnooz log as it used to be stored: one string per packet.
+void BM_SnoozCircularBuffer(State& state) {
+  uint8_t header[kHeaderSize] = {};
+  std::vector<uint8_t> payload(32, 0xaa);
+  size_t before = AllocatedBytes();
+  {
+    CircularBuffer<std::string> buffer(kMaxPackets);
+    size_t i = 0;
+    for (auto _ : state) {
+      std::string record(reinterpret_cast<const char*>(header), sizeof(header));
+      record.append(reinterpret_cast<const char*>(payload.data()), kPayloadSizes[i++ % kNumPayloadSizes]);
+      buffer.Push(std::move(record));
+    }
+    ReportMemory(state, AllocatedBytes() - before, std::min<size_t>(state.iterations(), kMaxPackets));
+  }
+}
+
+void BM_SnoozByteRingBuffer(State& state) {
+  uint8_t header[kHeaderSize] = {};
+  std::vector<uint8_t> payload(32, 0xaa);
+  size_t before = AllocatedBytes();
+  {
+    ByteRingBuffer buffer(kMaxBytes);
+    size_t i = 0;
+    for (auto _ : state) {
+      buffer.Push(header, sizeof(header), payload.data(), kPayloadSizes[i++ % kNumPayloadSizes]);
+    }
+    ReportMemory(state, AllocatedBytes() - before, buffer.RecordCount());
+  }
+}
+
+// Taking a copy of a full log for a dump.
+void BM_SnoozCircularBufferPull(State& state) {
+  CircularBuffer<std::string> buffer(kMaxPackets);
+  for (size_t i = 0; i < kMaxPackets; i++) {
+    buffer.Push(std::string(kHeaderSize + kPayloadSizes[i % kNumPayloadSizes], 'a'));
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(buffer.Pull());
+  }
+}
+
+void BM_SnoozByteRingBufferSnapshot(State& state) {
+  ByteRingBuffer buffer(kMaxBytes);
+  uint8_t header[kHeaderSize] = {};
+  std::vector<uint8_t> payload(32, 0xaa);
+  for (size_t i = 0; i < 2 * kMaxBytes / kHeaderSize; i++) {
+    buffer.Push(header, sizeof(header), payload.data(), kPayloadSizes[i % kNumPayloadSizes]);
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(buffer.Snapshot());
+  }
+}
+
+BENCHMARK(BM_SnoozCircularBuffer)->Iterations(100000);
+BENCHMARK(BM_SnoozByteRingBuffer)->Iterations(100000);
+BENCHMARK(BM_SnoozCircularBufferPull);
+BENCHMARK(BM_SnoozByteRingBufferSnapshot);
+
+}  // namespace common
+}  // namespace bluetooth
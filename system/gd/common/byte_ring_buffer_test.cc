@@ -0,0 +1,114 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/byte_ring_buffer.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace testing {
+
+using bluetooth::common::ByteRingBuffer;
+
+namespace {
+
+// Records of a one byte header holding the record index, followed by
+// |payload_size| bytes.
+void PushRecords(ByteRingBuffer* buffer, size_t first, size_t count, size_t payload_size) {
+  std::vector<uint8_t> payload(payload_size, 0xaa);
+  for (size_t i = first; i < first + count; i++) {
+    uint8_t header = static_cast<uint8_t>(i);
+    buffer->Push(&header, sizeof(header), payload.data(), payload.size());
+  }
+}
+
+std::vector<uint8_t> Flatten(const std::vector<std::shared_ptr<const ByteRingBuffer::Block>>& blocks) {
+  std::vector<uint8_t> bytes;
+  for (const auto& block : blocks) {
+    bytes.insert(bytes.end(), block->begin(), block->end());
+  }
+  return bytes;
+}
+
+}  // namespace
+
+TEST(ByteRingBufferTest, records_are_stored_back_to_back) {
+  ByteRingBuffer buffer(1024, 64);
+  PushRecords(&buffer, 0, 3, 2);
+
+  ASSERT_EQ(3ul, buffer.RecordCount());
+  ASSERT_EQ(9ul, buffer.Size());
+  std::vector<uint8_t> expected = {0x00, 0xaa, 0xaa, 0x01, 0xaa, 0xaa, 0x02, 0xaa, 0xaa};
+  ASSERT_EQ(expected, Flatten(buffer.Snapshot()));
+}
+
+TEST(ByteRingBufferTest, oldest_block_is_dropped_when_full) {
+  // Four blocks of four 16 byte records.
+  ByteRingBuffer buffer(256, 64);
+  PushRecords(&buffer, 0, 40, 15);
+
+  ASSERT_LE(buffer.Capacity(), 256ul);
+  ASSERT_LE(buffer.Size(), 256ul);
+  // Three sealed blocks and the current one.
+  ASSERT_EQ(16ul, buffer.RecordCount());
+
+  auto bytes = Flatten(buffer.Snapshot());
+  ASSERT_EQ(16ul * 16, bytes.size());
+  for (size_t i = 0; i < 16; i++) {
+    ASSERT_EQ(24 + i, bytes[i * 16]);
+  }
+}
+
+TEST(ByteRingBufferTest, snapshot_shares_sealed_blocks) {
+  ByteRingBuffer buffer(256, 64);
+  PushRecords(&buffer, 0, 6, 15);
+
+  auto snapshot = buffer.Snapshot();
+  ASSERT_EQ(2ul, snapshot.size());
+
+  // The snapshot is not modified by later pushes, even once its blocks are
+  // dropped from the ring.
+  PushRecords(&buffer, 6, 40, 15);
+  auto bytes = Flatten(snapshot);
+  ASSERT_EQ(6ul * 16, bytes.size());
+  for (size_t i = 0; i < 6; i++) {
+    ASSERT_EQ(i, bytes[i * 16]);
+  }
+
+  auto later = buffer.Snapshot();
+  ASSERT_NE(snapshot.front(), later.front());
+}
+
+TEST(ByteRingBufferTest, record_larger_than_block_is_dropped) {
+  ByteRingBuffer buffer(256, 64);
+  PushRecords(&buffer, 0, 1, 64);
+
+  ASSERT_EQ(0ul, buffer.RecordCount());
+  ASSERT_TRUE(buffer.Snapshot().empty());
+}
+
+TEST(ByteRingBufferTest, clear) {
+  ByteRingBuffer buffer(256, 64);
+  PushRecords(&buffer, 0, 10, 15);
+  buffer.Clear();
+
+  ASSERT_EQ(0ul, buffer.RecordCount());
+  ASSERT_EQ(0ul, buffer.Size());
+  ASSERT_TRUE(buffer.Snapshot().empty());
+}
+
+}  // namespace testing
@@ -0,0 +1,214 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/connection_timeline.h"
+
+#include <algorithm>
+
+namespace bluetooth {
+namespace common {
+
+std::string ConnectionMilestoneText(ConnectionMilestone milestone) {
+  switch (milestone) {
+    case ConnectionMilestone::CREATE_CONNECTION:
+      return "create_connection";
+    case ConnectionMilestone::CONNECTION_COMPLETE:
+      return "connection_complete";
+    case ConnectionMilestone::REMOTE_FEATURES:
+      return "remote_features";
+    case ConnectionMilestone::ENCRYPTION_CHANGE:
+      return "encryption_change";
+    case ConnectionMilestone::L2CAP_INFORMATION:
+      return "l2cap_information";
+    case ConnectionMilestone::PROFILE_CHANNEL_OPEN:
+      return "profile_channel_open";
+  }
+  return "unknown";
+}
+
+ConnectionTimeline& ConnectionTimeline::GetInstance() {
+  static ConnectionTimeline instance;
+  return instance;
+}
+
+void ConnectionTimeline::Record(const hci::Address& address, ConnectionMilestone milestone, Clock::time_point at) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto timeline = active_.find(address);
+  if (milestone == ConnectionMilestone::CREATE_CONNECTION) {
+    if (timeline != active_.end() && timeline->second.handle != kInvalidHandle) {
+      // Already connected
+      return;
+    }
+    Timeline& started = active_[address];
+    started = Timeline();
+    started.address = address;
+    started.started = at;
+    record_locked(started, milestone, at);
+    return;
+  }
+  if (timeline != active_.end()) {
+    record_locked(timeline->second, milestone, at);
+  }
+}
+
+void ConnectionTimeline::Record(uint16_t handle, ConnectionMilestone milestone, Clock::time_point at) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto address = addresses_.find(handle);
+  if (address == addresses_.end()) {
+    return;
+  }
+  auto timeline = active_.find(address->second);
+  if (timeline != active_.end()) {
+    record_locked(timeline->second, milestone, at);
+  }
+}
+
+void ConnectionTimeline::RecordConnectionComplete(
+    const hci::Address& address, uint16_t handle, bool success, Clock::time_point at) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto timeline = active_.find(address);
+  if (timeline == active_.end()) {
+    if (!success) {
+      return;
+    }
+    timeline = active_.emplace(address, Timeline()).first;
+    timeline->second.address = address;
+    timeline->second.incoming = true;
+    timeline->second.started = at;
+  } else if (timeline->second.handle != kInvalidHandle) {
+    return;
+  }
+
+  if (!success) {
+    // Failed attempts are kept out of the statistics, page timeouts would dwarf everything else
+    timeline->second.disconnected =
+        std::chrono::duration_cast<std::chrono::milliseconds>(at - timeline->second.started);
+    end_locked(address);
+    return;
+  }
+  record_locked(timeline->second, ConnectionMilestone::CONNECTION_COMPLETE, at);
+  timeline->second.handle = handle;
+  addresses_[handle] = address;
+}
+
+void ConnectionTimeline::RecordDisconnection(uint16_t handle, Clock::time_point at) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto address = addresses_.find(handle);
+  if (address == addresses_.end()) {
+    return;
+  }
+  auto timeline = active_.find(address->second);
+  if (timeline != active_.end()) {
+    timeline->second.disconnected =
+        std::chrono::duration_cast<std::chrono::milliseconds>(at - timeline->second.started);
+    end_locked(timeline->first);
+  }
+}
+
+std::vector<ConnectionTimeline::Timeline> ConnectionTimeline::GetTimelines() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<Timeline> timelines;
+  for (const auto& [address, timeline] : active_) {
+    timelines.push_back(timeline);
+  }
+  std::sort(timelines.begin(), timelines.end(), [](const Timeline& lhs, const Timeline& rhs) {
+    return lhs.started > rhs.started;
+  });
+  timelines.insert(timelines.end(), recent_.begin(), recent_.end());
+  return timelines;
+}
+
+std::vector<ConnectionTimeline::MilestoneStatistics> ConnectionTimeline::GetStatistics() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<MilestoneStatistics> statistics;
+  for (bool incoming : {false, true}) {
+    for (size_t i = 0; i < kNumConnectionMilestones; i++) {
+      const Histogram& histogram = histograms_[incoming][i];
+      if (histogram.count == 0) {
+        continue;
+      }
+      statistics.push_back(MilestoneStatistics{
+          .incoming = incoming,
+          .milestone = static_cast<ConnectionMilestone>(i),
+          .count = histogram.count,
+          .p50 = histogram.Percentile(50),
+          .p90 = histogram.Percentile(90),
+          .p99 = histogram.Percentile(99),
+          .max = histogram.max,
+      });
+    }
+  }
+  return statistics;
+}
+
+void ConnectionTimeline::Reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  active_.clear();
+  addresses_.clear();
+  recent_.clear();
+  histograms_ = {};
+}
+
+void ConnectionTimeline::record_locked(Timeline& timeline, ConnectionMilestone milestone, Clock::time_point at) {
+  auto& reached = timeline.milestones[static_cast<size_t>(milestone)];
+  if (reached.has_value()) {
+    return;
+  }
+  reached = std::max(
+      std::chrono::duration_cast<std::chrono::milliseconds>(at - timeline.started), std::chrono::milliseconds(0));
+  // The milestone starting the timeline is always reached after 0 ms
+  auto start = timeline.incoming ? ConnectionMilestone::CONNECTION_COMPLETE : ConnectionMilestone::CREATE_CONNECTION;
+  if (milestone != start) {
+    histograms_[timeline.incoming][static_cast<size_t>(milestone)].Add(*reached);
+  }
+}
+
+void ConnectionTimeline::end_locked(hci::Address address) {
+  auto timeline = active_.find(address);
+  if (timeline->second.handle != kInvalidHandle) {
+    addresses_.erase(timeline->second.handle);
+  }
+  recent_.push_front(std::move(timeline->second));
+  active_.erase(timeline);
+  if (recent_.size() > kMaxRecentTimelines) {
+    recent_.pop_back();
+  }
+}
+
+void ConnectionTimeline::Histogram::Add(std::chrono::milliseconds time) {
+  size_t bucket = 0;
+  for (auto ms = time.count(); ms > 0 && bucket < kNumBuckets - 1; ms >>= 1) {
+    bucket++;
+  }
+  buckets[bucket]++;
+  count++;
+  max = std::max(max, time);
+}
+
+std::chrono::milliseconds ConnectionTimeline::Histogram::Percentile(unsigned percent) const {
+  size_t rank = std::max<size_t>((count * percent + 99) / 100, 1);
+  size_t seen = 0;
+  for (size_t bucket = 0; bucket < kNumBuckets - 1; bucket++) {
+    seen += buckets[bucket];
+    if (seen >= rank) {
+      return std::min(std::chrono::milliseconds(1 << bucket), max);
+    }
+  }
+  return max;
+}
+
+}  // namespace common
+}  // namespace bluetooth
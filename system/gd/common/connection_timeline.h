@@ -0,0 +1,132 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "hci/address.h"
+
+namespace bluetooth {
+namespace common {
+
+// Steps of the establishment of a classic connection, in the order they usually happen
+enum class ConnectionMilestone : uint8_t {
+  CREATE_CONNECTION = 0,
+  CONNECTION_COMPLETE,
+  REMOTE_FEATURES,
+  ENCRYPTION_CHANGE,
+  L2CAP_INFORMATION,
+  PROFILE_CHANNEL_OPEN,
+};
+
+constexpr size_t kNumConnectionMilestones = static_cast<size_t>(ConnectionMilestone::PROFILE_CHANNEL_OPEN) + 1;
+
+std::string ConnectionMilestoneText(ConnectionMilestone milestone);
+
+// Records when each milestone of a connection is reached, from the layer that sees it, and aggregates the time from
+// the start of the connection to each milestone over all the connections of the same direction.
+//
+// A timeline starts with CREATE_CONNECTION for outgoing connections, or with CONNECTION_COMPLETE for incoming ones,
+// and ends at disconnection. The milestone a timeline starts with is not part of the statistics. Only the first time a
+// milestone is reached counts. Milestones are looked up by address or, once the connection completed, by handle.
+//
+// Thread safe: milestones are recorded from the gd handler as well as from the legacy stack thread.
+class ConnectionTimeline {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  static constexpr size_t kMaxRecentTimelines = 16;
+  static constexpr uint16_t kInvalidHandle = 0xffff;
+
+  struct Timeline {
+    hci::Address address;
+    uint16_t handle = kInvalidHandle;
+    bool incoming = false;
+    Clock::time_point started;
+    // Time from the start to each milestone, if it was reached
+    std::array<std::optional<std::chrono::milliseconds>, kNumConnectionMilestones> milestones;
+    std::optional<std::chrono::milliseconds> disconnected;
+  };
+
+  struct MilestoneStatistics {
+    bool incoming = false;
+    ConnectionMilestone milestone;
+    size_t count = 0;
+    // Percentiles are bounded by the power of two histogram bucket they fall in
+    std::chrono::milliseconds p50{0};
+    std::chrono::milliseconds p90{0};
+    std::chrono::milliseconds p99{0};
+    std::chrono::milliseconds max{0};
+  };
+
+  static ConnectionTimeline& GetInstance();
+
+  ConnectionTimeline() = default;
+  ConnectionTimeline(const ConnectionTimeline&) = delete;
+  ConnectionTimeline& operator=(const ConnectionTimeline&) = delete;
+
+  void Record(const hci::Address& address, ConnectionMilestone milestone, Clock::time_point at = Clock::now());
+  void Record(uint16_t handle, ConnectionMilestone milestone, Clock::time_point at = Clock::now());
+
+  // A failed connection ends its timeline, a successful one is looked up by |handle| from then on
+  void RecordConnectionComplete(
+      const hci::Address& address, uint16_t handle, bool success, Clock::time_point at = Clock::now());
+
+  void RecordDisconnection(uint16_t handle, Clock::time_point at = Clock::now());
+
+  // Connections in progress or established, then the ones which ended, most recent first
+  std::vector<Timeline> GetTimelines() const;
+
+  // Statistics of every milestone reached at least once, outgoing connections first
+  std::vector<MilestoneStatistics> GetStatistics() const;
+
+  void Reset();
+
+ private:
+  // Bucket i counts times within [2^(i-1), 2^i) milliseconds, the last one everything above
+  static constexpr size_t kNumBuckets = 18;
+
+  struct Histogram {
+    std::array<size_t, kNumBuckets> buckets{};
+    size_t count = 0;
+    std::chrono::milliseconds max{0};
+
+    void Add(std::chrono::milliseconds time);
+    std::chrono::milliseconds Percentile(unsigned percent) const;
+  };
+
+  void record_locked(Timeline& timeline, ConnectionMilestone milestone, Clock::time_point at);
+  void end_locked(hci::Address address);
+
+  mutable std::mutex mutex_;
+  std::unordered_map<hci::Address, Timeline> active_;
+  std::unordered_map<uint16_t, hci::Address> addresses_;
+  std::deque<Timeline> recent_;
+  // Indexed by Timeline::incoming, then by milestone
+  std::array<std::array<Histogram, kNumConnectionMilestones>, 2> histograms_;
+};
+
+}  // namespace common
+}  // namespace bluetooth
@@ -0,0 +1,140 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/connection_timeline.h"
+
+#include <gtest/gtest.h>
+
+namespace bluetooth {
+namespace common {
+namespace {
+
+using std::chrono::milliseconds;
+
+const hci::Address kAddress({0x01, 0x02, 0x03, 0x04, 0x05, 0x06});
+const hci::Address kOtherAddress({0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f});
+constexpr uint16_t kHandle = 0x0040;
+
+class ConnectionTimelineTest : public ::testing::Test {
+ protected:
+  ConnectionTimeline::Clock::time_point At(int ms) {
+    return start_ + milliseconds(ms);
+  }
+
+  ConnectionTimeline timeline_;
+  ConnectionTimeline::Clock::time_point start_ = ConnectionTimeline::Clock::now();
+};
+
+TEST_F(ConnectionTimelineTest, outgoing_connection) {
+  timeline_.Record(kAddress, ConnectionMilestone::CREATE_CONNECTION, At(0));
+  timeline_.RecordConnectionComplete(kAddress, kHandle, true, At(120));
+  timeline_.Record(kHandle, ConnectionMilestone::REMOTE_FEATURES, At(150));
+  timeline_.Record(kHandle, ConnectionMilestone::ENCRYPTION_CHANGE, At(300));
+  timeline_.Record(kAddress, ConnectionMilestone::PROFILE_CHANNEL_OPEN, At(420));
+  // Only the first channel counts
+  timeline_.Record(kAddress, ConnectionMilestone::PROFILE_CHANNEL_OPEN, At(500));
+
+  auto timelines = timeline_.GetTimelines();
+  ASSERT_EQ(1ul, timelines.size());
+  auto& timeline = timelines[0];
+  ASSERT_EQ(kAddress, timeline.address);
+  ASSERT_EQ(kHandle, timeline.handle);
+  ASSERT_FALSE(timeline.incoming);
+  ASSERT_EQ(milliseconds(120), timeline.milestones[static_cast<size_t>(ConnectionMilestone::CONNECTION_COMPLETE)]);
+  ASSERT_EQ(milliseconds(300), timeline.milestones[static_cast<size_t>(ConnectionMilestone::ENCRYPTION_CHANGE)]);
+  ASSERT_EQ(milliseconds(420), timeline.milestones[static_cast<size_t>(ConnectionMilestone::PROFILE_CHANNEL_OPEN)]);
+  ASSERT_FALSE(timeline.milestones[static_cast<size_t>(ConnectionMilestone::L2CAP_INFORMATION)].has_value());
+  ASSERT_FALSE(timeline.disconnected.has_value());
+}
+
+TEST_F(ConnectionTimelineTest, incoming_connection_and_disconnection) {
+  timeline_.RecordConnectionComplete(kAddress, kHandle, true, At(0));
+  timeline_.RecordDisconnection(kHandle, At(1000));
+
+  // The handle no longer refers to the connection
+  timeline_.Record(kHandle, ConnectionMilestone::REMOTE_FEATURES, At(1100));
+
+  auto timelines = timeline_.GetTimelines();
+  ASSERT_EQ(1ul, timelines.size());
+  ASSERT_TRUE(timelines[0].incoming);
+  ASSERT_EQ(milliseconds(1000), timelines[0].disconnected);
+  ASSERT_FALSE(timelines[0].milestones[static_cast<size_t>(ConnectionMilestone::REMOTE_FEATURES)].has_value());
+}
+
+TEST_F(ConnectionTimelineTest, failed_connection_is_not_in_statistics) {
+  timeline_.Record(kAddress, ConnectionMilestone::CREATE_CONNECTION, At(0));
+  timeline_.RecordConnectionComplete(kAddress, kHandle, false, At(5000));
+  // Milestones of unknown connections are dropped
+  timeline_.Record(kOtherAddress, ConnectionMilestone::REMOTE_FEATURES, At(5000));
+
+  auto timelines = timeline_.GetTimelines();
+  ASSERT_EQ(1ul, timelines.size());
+  ASSERT_EQ(milliseconds(5000), timelines[0].disconnected);
+
+  ASSERT_TRUE(timeline_.GetStatistics().empty());
+}
+
+TEST_F(ConnectionTimelineTest, percentiles) {
+  for (int i = 1; i <= 100; i++) {
+    uint16_t handle = kHandle + i;
+    hci::Address address({0x00, 0x00, 0x00, 0x00, 0x00, static_cast<uint8_t>(i)});
+    timeline_.Record(address, ConnectionMilestone::CREATE_CONNECTION, At(0));
+    timeline_.RecordConnectionComplete(address, handle, true, At(i * 10));
+    timeline_.RecordDisconnection(handle, At(2000));
+  }
+
+  auto statistics = timeline_.GetStatistics();
+  ASSERT_EQ(1ul, statistics.size());
+  auto& complete = statistics[0];
+  ASSERT_FALSE(complete.incoming);
+  ASSERT_EQ(ConnectionMilestone::CONNECTION_COMPLETE, complete.milestone);
+  ASSERT_EQ(100ul, complete.count);
+  ASSERT_EQ(milliseconds(1000), complete.max);
+  // 500 ms falls in [256, 512), 900 and 990 ms in [512, 1024) which is capped by the maximum
+  ASSERT_EQ(milliseconds(512), complete.p50);
+  ASSERT_EQ(milliseconds(1000), complete.p90);
+  ASSERT_EQ(milliseconds(1000), complete.p99);
+
+  // Only the most recent timelines are kept
+  ASSERT_EQ(ConnectionTimeline::kMaxRecentTimelines, timeline_.GetTimelines().size());
+}
+
+TEST_F(ConnectionTimelineTest, incoming_connections_have_separate_statistics) {
+  timeline_.Record(kAddress, ConnectionMilestone::CREATE_CONNECTION, At(0));
+  timeline_.RecordConnectionComplete(kAddress, kHandle, true, At(800));
+  timeline_.Record(kHandle, ConnectionMilestone::REMOTE_FEATURES, At(900));
+
+  timeline_.RecordConnectionComplete(kOtherAddress, kHandle + 1, true, At(0));
+  timeline_.Record(kHandle + 1, ConnectionMilestone::REMOTE_FEATURES, At(40));
+
+  auto statistics = timeline_.GetStatistics();
+  ASSERT_EQ(3ul, statistics.size());
+  ASSERT_FALSE(statistics[0].incoming);
+  ASSERT_EQ(ConnectionMilestone::CONNECTION_COMPLETE, statistics[0].milestone);
+  ASSERT_EQ(milliseconds(800), statistics[0].max);
+  ASSERT_FALSE(statistics[1].incoming);
+  ASSERT_EQ(ConnectionMilestone::REMOTE_FEATURES, statistics[1].milestone);
+  ASSERT_EQ(1ul, statistics[1].count);
+  ASSERT_EQ(milliseconds(900), statistics[1].max);
+  // The incoming connection starts at CONNECTION_COMPLETE, which is left out
+  ASSERT_TRUE(statistics[2].incoming);
+  ASSERT_EQ(ConnectionMilestone::REMOTE_FEATURES, statistics[2].milestone);
+  ASSERT_EQ(milliseconds(40), statistics[2].max);
+}
+
+}  // namespace
+}  // namespace common
+}  // namespace bluetooth
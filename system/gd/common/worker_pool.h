@@ -0,0 +1,149 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace bluetooth {
+namespace common {
+
+// A fixed set of threads running the jobs of one batch in parallel. The calling thread takes part in the work, and
+// RunAndWait() is a barrier: it returns once every job of the batch is done and no worker holds it any more.
+//
+// Header only, as it is shared with tools which do not link against libbt-common.
+class WorkerPool {
+ public:
+  using Job = std::function<void(size_t)>;
+
+  explicit WorkerPool(size_t num_workers) {
+    for (size_t i = 0; i < num_workers; i++) {
+      workers_.emplace_back(&WorkerPool::WorkerMain, this);
+    }
+  }
+
+  ~WorkerPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      shutdown_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  // Runs job(0) .. job(num_jobs - 1) and waits for all of them. Jobs run in index order without workers.
+  void RunAndWait(size_t num_jobs, const Job& job) {
+    if (workers_.empty() || num_jobs < 2) {
+      for (size_t i = 0; i < num_jobs; i++) {
+        job(i);
+      }
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      job_ = &job;
+      num_jobs_ = num_jobs;
+      jobs_done_ = 0;
+      next_job_ = 0;
+      generation_++;
+    }
+    work_cv_.notify_all();
+
+    size_t done = RunJobs(&job, num_jobs);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    jobs_done_ += done;
+    // Wait for the workers to leave as well, so that none of them can pick up a job of the next batch while still
+    // holding this one
+    done_cv_.wait(lock, [this] { return jobs_done_ == num_jobs_ && active_workers_ == 0; });
+    job_ = nullptr;
+    num_jobs_ = 0;
+  }
+
+  size_t GetNumWorkers() const {
+    return workers_.size();
+  }
+
+ private:
+  size_t RunJobs(const Job* job, size_t num_jobs) {
+    size_t done = 0;
+    for (size_t i = next_job_.fetch_add(1); i < num_jobs; i = next_job_.fetch_add(1)) {
+      (*job)(i);
+      done++;
+    }
+    return done;
+  }
+
+  void WorkerMain() {
+    uint64_t seen_generation = 0;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      work_cv_.wait(lock, [this, seen_generation] { return shutdown_ || generation_ != seen_generation; });
+      if (shutdown_) {
+        return;
+      }
+
+      seen_generation = generation_;
+      const Job* job = job_;
+      size_t num_jobs = num_jobs_;
+      if (job == nullptr) {
+        continue;
+      }
+
+      active_workers_++;
+      lock.unlock();
+      size_t done = RunJobs(job, num_jobs);
+      lock.lock();
+      active_workers_--;
+      jobs_done_ += done;
+
+      if (jobs_done_ == num_jobs_ && active_workers_ == 0) {
+        done_cv_.notify_one();
+      }
+    }
+  }
+
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable work_cv_;
+  std::condition_variable done_cv_;
+
+  // Guarded by mutex_
+  const Job* job_ = nullptr;
+  size_t num_jobs_ = 0;
+  size_t jobs_done_ = 0;
+  size_t active_workers_ = 0;
+  uint64_t generation_ = 0;
+  bool shutdown_ = false;
+
+  std::atomic<size_t> next_job_{0};
+};
+
+}  // namespace common
+}  // namespace bluetooth
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/worker_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <set>
+
+namespace bluetooth {
+namespace common {
+namespace {
+
+using namespace std::chrono_literals;
+
+TEST(WorkerPoolTest, runs_every_job_once) {
+  WorkerPool pool(3);
+  ASSERT_EQ(3u, pool.GetNumWorkers());
+
+  for (size_t num_jobs : {0, 1, 2, 7, 64}) {
+    std::vector<std::atomic<int>> runs(num_jobs);
+    pool.RunAndWait(num_jobs, [&runs](size_t i) { runs[i]++; });
+    for (auto& count : runs) {
+      ASSERT_EQ(1, count.load());
+    }
+  }
+}
+
+TEST(WorkerPoolTest, jobs_spread_across_threads) {
+  WorkerPool pool(2);
+  std::mutex mutex;
+  std::set<std::thread::id> threads;
+
+  // Keep each job busy long enough for the workers to join in
+  pool.RunAndWait(3, [&](size_t) {
+    std::this_thread::sleep_for(20ms);
+    std::lock_guard<std::mutex> lock(mutex);
+    threads.insert(std::this_thread::get_id());
+  });
+  ASSERT_GT(threads.size(), 1u);
+}
+
+TEST(WorkerPoolTest, without_workers_runs_in_order) {
+  WorkerPool pool(0);
+  std::vector<size_t> order;
+  pool.RunAndWait(4, [&order](size_t i) {
+    ASSERT_EQ(order.size(), i);
+    order.push_back(i);
+  });
+  ASSERT_EQ(4u, order.size());
+}
+
+TEST(WorkerPoolTest, back_to_back_batches) {
+  WorkerPool pool(3);
+  std::atomic<size_t> total{0};
+  for (int batch = 0; batch < 1000; batch++) {
+    pool.RunAndWait(4, [&total](size_t) { total++; });
+  }
+  ASSERT_EQ(4000u, total.load());
+}
+
+}  // namespace
+}  // namespace common
+}  // namespace bluetooth
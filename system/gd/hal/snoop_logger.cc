@@ -22,9 +22,7 @@
 #include <algorithm>
 #include <bitset>
 #include <chrono>
-#include <sstream>
 
-#include "common/circular_buffer.h"
 #include "common/init_flags.h"
 #include "common/strings.h"
 #include "os/fake_timer/fake_timerfd.h"
@@ -212,7 +210,7 @@ SnoopLogger::SnoopLogger(
     std::string snoop_log_path,
     std::string snooz_log_path,
     size_t max_packets_per_file,
-    size_t max_packets_per_buffer,
+    size_t max_bytes_per_buffer,
     const std::string& btsnoop_mode,
     bool qualcomm_debug_log_enabled,
     const std::chrono::milliseconds snooz_log_life_time,
@@ -220,7 +218,7 @@ SnoopLogger::SnoopLogger(
     : snoop_log_path_(std::move(snoop_log_path)),
       snooz_log_path_(std::move(snooz_log_path)),
       max_packets_per_file_(max_packets_per_file),
-      btsnooz_buffer_(max_packets_per_buffer),
+      btsnooz_buffer_(max_bytes_per_buffer),
       qualcomm_debug_log_enabled_(qualcomm_debug_log_enabled),
       snooz_log_life_time_(snooz_log_life_time),
       snooz_log_delete_alarm_interval_(snooz_log_delete_alarm_interval) {
@@ -341,16 +339,10 @@ void SnoopLogger::Capture(const HciPacket& packet, Direction direction, PacketTy
     std::lock_guard<std::recursive_mutex> lock(file_mutex_);
     if (!is_enabled_) {
       // btsnoop disabled, log in-memory btsnooz log only
-      std::stringstream ss;
       size_t included_length = get_btsnooz_packet_length_to_write(packet, type, qualcomm_debug_log_enabled_);
       header.length_captured = htonl(included_length + /* type byte */ 1);
-      if (!ss.write(reinterpret_cast<const char*>(&header), sizeof(PacketHeaderType))) {
-        LOG_ERROR("Failed to write packet header for btsnooz, error: \"%s\"", strerror(errno));
-      }
-      if (!ss.write(reinterpret_cast<const char*>(packet.data()), included_length)) {
-        LOG_ERROR("Failed to write packet payload for btsnooz, error: \"%s\"", strerror(errno));
-      }
-      btsnooz_buffer_.Push(ss.str());
+      btsnooz_buffer_.Push(
+          reinterpret_cast<const uint8_t*>(&header), sizeof(PacketHeaderType), packet.data(), included_length);
       return;
     }
     packet_counter_++;
@@ -373,7 +365,8 @@ void SnoopLogger::Capture(const HciPacket& packet, Direction direction, PacketTy
   }
 }
 
-void SnoopLogger::DumpSnoozLogToFile(const std::vector<std::string>& data) const {
+void SnoopLogger::DumpSnoozLogToFile(
+    const std::vector<std::shared_ptr<const common::ByteRingBuffer::Block>>& data) const {
   std::lock_guard<std::recursive_mutex> lock(file_mutex_);
   if (is_enabled_) {
     LOG_DEBUG("btsnoop log is enabled, skip dumping btsnooz log");
@@ -403,8 +396,9 @@ void SnoopLogger::DumpSnoozLogToFile(const std::vector<std::string>& data) const
   if (!btsnooz_ostream.write(reinterpret_cast<const char*>(&kBtSnoopFileHeader), sizeof(FileHeaderType))) {
     LOG_ALWAYS_FATAL("Unable to write file header to \"%s\", error: \"%s\"", snooz_log_path_.c_str(), strerror(errno));
   }
-  for (const auto& packet : data) {
-    if (!btsnooz_ostream.write(packet.data(), packet.size())) {
+  // Packets are stored back to back, with their headers, in the blocks.
+  for (const auto& block : data) {
+    if (!btsnooz_ostream.write(reinterpret_cast<const char*>(block->data()), block->size())) {
       LOG_ERROR("Failed to write packet payload for btsnooz, error: \"%s\"", strerror(errno));
     }
   }
@@ -440,7 +434,12 @@ void SnoopLogger::Stop() {
 
 DumpsysDataFinisher SnoopLogger::GetDumpsysData(flatbuffers::FlatBufferBuilder* builder) const {
   LOG_DEBUG("Dumping btsnooz log data to %s", snooz_log_path_.c_str());
-  DumpSnoozLogToFile(btsnooz_buffer_.Pull());
+  LOG_DEBUG(
+      "btsnooz log holds %zu packets in %zu bytes, %zu bytes allocated",
+      btsnooz_buffer_.RecordCount(),
+      btsnooz_buffer_.Size(),
+      btsnooz_buffer_.Capacity());
+  DumpSnoozLogToFile(btsnooz_buffer_.Snapshot());
   return Module::GetDumpsysData(builder);
 }
 
@@ -459,13 +458,11 @@ size_t SnoopLogger::GetMaxPacketsPerFile() {
   return max_packets_per_file;
 }
 
-size_t SnoopLogger::GetMaxPacketsPerBuffer() {
+size_t SnoopLogger::GetMaxBytesPerBuffer() {
   // We want to use at most 256 KB memory for btsnooz log for release builds
-  // and 512 KB memory for userdebug/eng builds
+  // and 1 MB memory for userdebug/eng builds
   auto is_debuggable = os::GetSystemPropertyBool(kIsDebuggableProperty, false);
-  size_t btsnooz_max_memory_usage_bytes = (is_debuggable ? 1024 : 256) * 1024;
-  // Calculate max number of packets based on max memory usage and max packet size
-  return btsnooz_max_memory_usage_bytes / kDefaultBtSnoozMaxBytesPerPacket;
+  return (is_debuggable ? 1024 : 256) * 1024;
 }
 
 std::string SnoopLogger::GetBtSnoopMode() {
@@ -509,7 +506,7 @@ const ModuleFactory SnoopLogger::Factory = ModuleFactory([]() {
       os::ParameterProvider::SnoopLogFilePath(),
       os::ParameterProvider::SnoozLogFilePath(),
       GetMaxPacketsPerFile(),
-      GetMaxPacketsPerBuffer(),
+      GetMaxBytesPerBuffer(),
       GetBtSnoopMode(),
       IsQualcommDebugLogEnabled(),
       kBtSnoozLogLifeTime,
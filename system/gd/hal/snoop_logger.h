@@ -21,7 +21,7 @@
 #include <mutex>
 #include <string>
 
-#include "common/circular_buffer.h"
+#include "common/byte_ring_buffer.h"
 #include "hal/hci_hal.h"
 #include "module.h"
 #include "os/repeating_alarm.h"
@@ -70,7 +70,8 @@ class SnoopLogger : public ::bluetooth::Module {
   // Changes to this value is only effective after restarting Bluetooth
   static size_t GetMaxPacketsPerFile();
 
-  static size_t GetMaxPacketsPerBuffer();
+  // Returns the number of bytes of memory used for the in-memory btsnooz log
+  static size_t GetMaxBytesPerBuffer();
 
   // Get snoop logger mode based on current system setup
   // Changes to this values is only effective after restarting Bluetooth
@@ -110,14 +111,14 @@ class SnoopLogger : public ::bluetooth::Module {
       std::string snoop_log_path,
       std::string snooz_log_path,
       size_t max_packets_per_file,
-      size_t max_packets_per_buffer,
+      size_t max_bytes_per_buffer,
       const std::string& btsnoop_mode,
       bool qualcomm_debug_log_enabled,
       const std::chrono::milliseconds snooz_log_life_time,
       const std::chrono::milliseconds snooz_log_delete_alarm_interval);
   void CloseCurrentSnoopLogFile();
   void OpenNextSnoopLogFile();
-  void DumpSnoozLogToFile(const std::vector<std::string>& data) const;
+  void DumpSnoozLogToFile(const std::vector<std::shared_ptr<const common::ByteRingBuffer::Block>>& data) const;
 
  private:
   std::string snoop_log_path_;
@@ -127,7 +128,7 @@ class SnoopLogger : public ::bluetooth::Module {
   bool is_filtered_ = false;
   bool is_truncated_ = false;
   size_t max_packets_per_file_;
-  common::CircularBuffer<std::string> btsnooz_buffer_;
+  common::ByteRingBuffer btsnooz_buffer_;
   bool qualcomm_debug_log_enabled_ = false;
   size_t packet_counter_ = 0;
   mutable std::recursive_mutex file_mutex_;
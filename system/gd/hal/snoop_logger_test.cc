@@ -74,7 +74,7 @@ class TestSnoopLoggerModule : public SnoopLogger {
             std::move(snoop_log_path),
             std::move(snooz_log_path),
             max_packets_per_file,
-            SnoopLogger::GetMaxPacketsPerBuffer(),
+            SnoopLogger::GetMaxBytesPerBuffer(),
             btsnoop_mode,
             qualcomm_debug_log_enabled,
             20ms,
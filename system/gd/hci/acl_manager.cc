@@ -281,6 +281,10 @@ void AclManager::WriteDefaultLinkPolicySettings(uint16_t default_link_policy_set
   CallOn(pimpl_->classic_impl_, &classic_impl::write_default_link_policy_settings, default_link_policy_settings);
 }
 
+void AclManager::ReportLeAdvertisement(AddressWithType address_with_type, int8_t rssi) {
+  CallOn(pimpl_->le_impl_, &le_impl::on_le_advertisement_report, address_with_type, rssi);
+}
+
 void AclManager::OnAdvertisingSetTerminated(ErrorCode status, uint16_t conn_handle, hci::AddressWithType adv_address) {
   if (status == ErrorCode::SUCCESS) {
     CallOn(pimpl_->le_impl_, &le_impl::UpdateLocalAddress, conn_handle, adv_address);
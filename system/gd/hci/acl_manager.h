@@ -125,6 +125,9 @@ public:
  virtual uint16_t ReadDefaultLinkPolicySettings();
  virtual void WriteDefaultLinkPolicySettings(uint16_t default_link_policy_settings);
 
+ // Feeds a connectable advertisement seen by the scanner into LE connection prediction
+ virtual void ReportLeAdvertisement(AddressWithType address_with_type, int8_t rssi);
+
  // Callback from Advertising Manager to notify the advitiser (local) address
  virtual void OnAdvertisingSetTerminated(ErrorCode status, uint16_t conn_handle, hci::AddressWithType adv_address);
 
@@ -16,9 +16,12 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <queue>
+#include <vector>
 
 #include "hci/acl_manager/acl_connection.h"
 #include "hci/address_with_type.h"
@@ -34,14 +37,6 @@ constexpr size_t kMaxQueuedPacketsPerConnection = 10;
 constexpr size_t kL2capBasicFrameHeaderSize = 4;
 
 namespace {
-class PacketViewForRecombination : public packet::PacketView<packet::kLittleEndian> {
- public:
-  PacketViewForRecombination(const PacketView& packetView) : PacketView(packetView) {}
-  void AppendPacketView(packet::PacketView<packet::kLittleEndian> to_append) {
-    Append(to_append);
-  }
-};
-
 // Per spec 5.1 Vol 2 Part B 5.3, ACL link shall carry L2CAP data. Therefore, an ACL packet shall contain L2CAP PDU.
 // This function returns the PDU size of the L2CAP data if it's a starting packet. Returns 0 if it's invalid.
 uint16_t GetL2capPduSize(AclView packet) {
@@ -61,16 +56,31 @@ struct assembler {
   AddressWithType address_with_type_;
   AclConnection::QueueDownEnd* down_end_;
   os::Handler* handler_;
-  PacketViewForRecombination recombination_stage_{
-      PacketView<packet::kLittleEndian>(std::make_shared<std::vector<uint8_t>>())};
+  // L2CAP PDU being recombined, allocated for its full size from the length in its basic header
+  std::shared_ptr<std::vector<uint8_t>> recombination_stage_;
   size_t remaining_sdu_continuation_packet_size_ = 0;
   std::shared_ptr<std::atomic_bool> enqueue_registered_ = std::make_shared<std::atomic_bool>(false);
   std::queue<packet::PacketView<packet::kLittleEndian>> incoming_queue_;
 
+  // Backpressure statistics of the connection
+  size_t delivered_pdus_ = 0;
+  size_t dropped_congested_pdus_ = 0;
+  size_t dropped_invalid_pdus_ = 0;
+  size_t max_queued_pdus_ = 0;
+
   ~assembler() {
     if (enqueue_registered_->exchange(false)) {
       down_end_->UnregisterEnqueue();
     }
+    if (dropped_congested_pdus_ != 0 || dropped_invalid_pdus_ != 0) {
+      LOG_INFO(
+          "%s delivered %zu L2CAP PDUs, dropped %zu due to congestion and %zu invalid ones, queued at most %zu",
+          address_with_type_.ToString().c_str(),
+          delivered_pdus_,
+          dropped_congested_pdus_,
+          dropped_invalid_pdus_,
+          max_queued_pdus_);
+    }
   }
 
   // Invoked from some external Queue Reactable context
@@ -97,39 +107,54 @@ struct assembler {
       return;
     }
     if (packet_boundary_flag == PacketBoundaryFlag::CONTINUING_FRAGMENT) {
-      if (remaining_sdu_continuation_packet_size_ < payload_size) {
+      if (recombination_stage_ == nullptr || remaining_sdu_continuation_packet_size_ < payload_size) {
         LOG_WARN("Remote sent unexpected L2CAP PDU. Drop the entire L2CAP PDU");
-        recombination_stage_ =
-            PacketViewForRecombination(PacketView<packet::kLittleEndian>(std::make_shared<std::vector<uint8_t>>()));
+        recombination_stage_.reset();
         remaining_sdu_continuation_packet_size_ = 0;
+        dropped_invalid_pdus_++;
         return;
       }
       remaining_sdu_continuation_packet_size_ -= payload_size;
-      recombination_stage_.AppendPacketView(payload);
+      recombination_stage_->insert(recombination_stage_->end(), payload.begin(), payload.end());
       if (remaining_sdu_continuation_packet_size_ != 0) {
         return;
-      } else {
-        payload = recombination_stage_;
-        recombination_stage_ =
-            PacketViewForRecombination(PacketView<packet::kLittleEndian>(std::make_shared<std::vector<uint8_t>>()));
       }
+      payload = PacketView<packet::kLittleEndian>(std::move(recombination_stage_));
     } else if (packet_boundary_flag == PacketBoundaryFlag::FIRST_AUTOMATICALLY_FLUSHABLE) {
-      if (recombination_stage_.size() > 0) {
+      if (recombination_stage_ != nullptr) {
         LOG_ERROR("Controller sent a starting packet without finishing previous packet. Drop previous one.");
+        recombination_stage_.reset();
+        remaining_sdu_continuation_packet_size_ = 0;
+        dropped_invalid_pdus_++;
       }
       auto l2cap_pdu_size = GetL2capPduSize(packet);
+      if (payload_size < kL2capBasicFrameHeaderSize ||
+          payload_size - kL2capBasicFrameHeaderSize > l2cap_pdu_size) {
+        LOG_WARN("Remote sent L2CAP PDU with invalid length. Drop the entire L2CAP PDU");
+        dropped_invalid_pdus_++;
+        return;
+      }
       remaining_sdu_continuation_packet_size_ = l2cap_pdu_size - (payload_size - kL2capBasicFrameHeaderSize);
       if (remaining_sdu_continuation_packet_size_ > 0) {
-        recombination_stage_ = payload;
+        // Continuation fragments are copied in place, so that the PDU is delivered as a single fragment.
+        recombination_stage_ = std::make_shared<std::vector<uint8_t>>();
+        recombination_stage_->reserve(kL2capBasicFrameHeaderSize + l2cap_pdu_size);
+        recombination_stage_->insert(recombination_stage_->end(), payload.begin(), payload.end());
         return;
       }
     }
-    if (incoming_queue_.size() > kMaxQueuedPacketsPerConnection) {
-      LOG_ERROR("Dropping packet from %s due to congestion", address_with_type_.ToString().c_str());
+    if (incoming_queue_.size() >= kMaxQueuedPacketsPerConnection) {
+      dropped_congested_pdus_++;
+      LOG_ERROR(
+          "Dropping packet from %s due to congestion, %zu dropped so far",
+          address_with_type_.ToString().c_str(),
+          dropped_congested_pdus_);
       return;
     }
 
     incoming_queue_.push(payload);
+    delivered_pdus_++;
+    max_queued_pdus_ = std::max(max_queued_pdus_, incoming_queue_.size());
     if (!enqueue_registered_->exchange(true)) {
       down_end_->RegisterEnqueue(handler_,
                                  common::Bind(&assembler::on_le_incoming_data_ready, common::Unretained(this)));
@@ -0,0 +1,155 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/acl_manager/assembler.h"
+
+#include <gtest/gtest.h>
+
+#include <future>
+
+#include "common/bind.h"
+#include "hci/hci_packets.h"
+#include "os/handler.h"
+#include "os/thread.h"
+#include "packet/bit_inserter.h"
+#include "packet/raw_builder.h"
+
+using ::bluetooth::os::Handler;
+using ::bluetooth::os::Thread;
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+namespace {
+
+constexpr uint16_t kHandle = 0x123;
+const AddressWithType kAddress(Address{{0x01, 0x02, 0x03, 0x04, 0x05, 0x06}}, AddressType::PUBLIC_DEVICE_ADDRESS);
+
+AclView MakeAcl(PacketBoundaryFlag packet_boundary_flag, std::vector<uint8_t> payload) {
+  auto builder = AclBuilder::Create(
+      kHandle,
+      packet_boundary_flag,
+      BroadcastFlag::POINT_TO_POINT,
+      std::make_unique<packet::RawBuilder>(std::move(payload)));
+  auto bytes = std::make_shared<std::vector<uint8_t>>();
+  packet::BitInserter i(*bytes);
+  builder->Serialize(i);
+  auto acl = AclView::Create(packet::PacketView<packet::kLittleEndian>(bytes));
+  EXPECT_TRUE(acl.IsValid());
+  return acl;
+}
+
+class AssemblerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    thread_ = new Thread("thread", Thread::Priority::NORMAL);
+    handler_ = new Handler(thread_);
+    assembler_ = new assembler(kAddress, queue_.GetDownEnd(), handler_);
+  }
+
+  void TearDown() override {
+    // The assembler is used and destroyed on the handler thread.
+    handler_->Post(common::BindOnce([](assembler* assembler) { delete assembler; }, assembler_));
+    sync_handler();
+    handler_->Clear();
+    delete handler_;
+    delete thread_;
+  }
+
+  void sync_handler() {
+    std::promise<void> promise;
+    auto future = promise.get_future();
+    handler_->BindOnceOn(&promise, &std::promise<void>::set_value).Invoke();
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+  }
+
+  void Receive(AclView acl) {
+    handler_->CallOn(assembler_, &assembler::on_incoming_packet, acl);
+    sync_handler();
+  }
+
+  std::vector<uint8_t> Deliver() {
+    std::promise<std::vector<uint8_t>> promise;
+    auto future = promise.get_future();
+    queue_.GetUpEnd()->RegisterDequeue(
+        handler_, common::Bind(&AssemblerTest::on_dequeue, common::Unretained(this), common::Unretained(&promise)));
+    EXPECT_EQ(future.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+    return future.get();
+  }
+
+  void on_dequeue(std::promise<std::vector<uint8_t>>* promise) {
+    queue_.GetUpEnd()->UnregisterDequeue();
+    auto packet = queue_.GetUpEnd()->TryDequeue();
+    promise->set_value(std::vector<uint8_t>(packet->begin(), packet->end()));
+  }
+
+  AclConnection::Queue queue_{10};
+  Thread* thread_;
+  Handler* handler_;
+  assembler* assembler_;
+};
+
+TEST_F(AssemblerTest, single_fragment) {
+  std::vector<uint8_t> pdu = {0x02, 0x00, 0x40, 0x00, 0xaa, 0xbb};
+  Receive(MakeAcl(PacketBoundaryFlag::FIRST_AUTOMATICALLY_FLUSHABLE, pdu));
+
+  ASSERT_EQ(pdu, Deliver());
+  ASSERT_EQ(1ul, assembler_->delivered_pdus_);
+}
+
+TEST_F(AssemblerTest, recombine_fragments) {
+  std::vector<uint8_t> pdu = {0x08, 0x00, 0x40, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08};
+  Receive(MakeAcl(PacketBoundaryFlag::FIRST_AUTOMATICALLY_FLUSHABLE, {pdu.begin(), pdu.begin() + 6}));
+  Receive(MakeAcl(PacketBoundaryFlag::CONTINUING_FRAGMENT, {pdu.begin() + 6, pdu.begin() + 9}));
+  Receive(MakeAcl(PacketBoundaryFlag::CONTINUING_FRAGMENT, {pdu.begin() + 9, pdu.end()}));
+
+  ASSERT_EQ(pdu, Deliver());
+  ASSERT_EQ(1ul, assembler_->delivered_pdus_);
+  ASSERT_EQ(0ul, assembler_->dropped_invalid_pdus_);
+}
+
+TEST_F(AssemblerTest, drop_unexpected_continuation) {
+  Receive(MakeAcl(PacketBoundaryFlag::CONTINUING_FRAGMENT, {0x01, 0x02}));
+
+  // A start of PDU before the end of the previous one drops the previous one.
+  Receive(MakeAcl(PacketBoundaryFlag::FIRST_AUTOMATICALLY_FLUSHABLE, {0x04, 0x00, 0x40, 0x00, 0x01}));
+  std::vector<uint8_t> pdu = {0x01, 0x00, 0x40, 0x00, 0xcc};
+  Receive(MakeAcl(PacketBoundaryFlag::FIRST_AUTOMATICALLY_FLUSHABLE, pdu));
+
+  // Payload longer than the L2CAP length.
+  Receive(MakeAcl(PacketBoundaryFlag::FIRST_AUTOMATICALLY_FLUSHABLE, {0x00, 0x00, 0x40, 0x00, 0x01}));
+
+  ASSERT_EQ(pdu, Deliver());
+  ASSERT_EQ(1ul, assembler_->delivered_pdus_);
+  ASSERT_EQ(3ul, assembler_->dropped_invalid_pdus_);
+}
+
+TEST_F(AssemblerTest, drop_when_congested) {
+  constexpr size_t kNumPdus = 25;
+  for (size_t i = 0; i < kNumPdus; i++) {
+    Receive(MakeAcl(PacketBoundaryFlag::FIRST_AUTOMATICALLY_FLUSHABLE, {0x01, 0x00, 0x40, 0x00, uint8_t(i)}));
+  }
+
+  // At most a queue full is held by the connection queue and by the assembler.
+  ASSERT_EQ(kNumPdus, assembler_->delivered_pdus_ + assembler_->dropped_congested_pdus_);
+  ASSERT_GE(assembler_->dropped_congested_pdus_, kNumPdus - 2 * kMaxQueuedPacketsPerConnection);
+  ASSERT_LE(assembler_->max_queued_pdus_, kMaxQueuedPacketsPerConnection);
+}
+
+}  // namespace
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
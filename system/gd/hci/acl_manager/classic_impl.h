@@ -21,8 +21,10 @@
 #include <unordered_set>
 
 #include "common/bind.h"
+#include "common/connection_timeline.h"
 #include "hci/acl_manager/assembler.h"
 #include "hci/acl_manager/event_checkers.h"
+#include "hci/acl_manager/handle_table.h"
 #include "hci/acl_manager/round_robin_scheduler.h"
 #include "hci/controller.h"
 #include "os/metrics.h"
@@ -127,12 +129,12 @@ struct classic_impl : public security::ISecurityManagerListener {
   static constexpr uint16_t kIllegalConnectionHandle = 0xffff;
   struct {
    private:
-    std::map<uint16_t, acl_connection> acl_connections_;
+    HandleTable<acl_connection> acl_connections_;
     mutable std::mutex acl_connections_guard_;
     ConnectionManagementCallbacks* find_callbacks(uint16_t handle) {
       auto connection = acl_connections_.find(handle);
-      if (connection == acl_connections_.end()) return nullptr;
-      return connection->second.connection_management_callbacks_;
+      if (connection == nullptr) return nullptr;
+      return connection->connection_management_callbacks_;
     }
     ConnectionManagementCallbacks* find_callbacks(const Address& address) {
       for (auto& connection_pair : acl_connections_) {
@@ -144,8 +146,8 @@ struct classic_impl : public security::ISecurityManagerListener {
     }
     void remove(uint16_t handle) {
       auto connection = acl_connections_.find(handle);
-      if (connection != acl_connections_.end()) {
-        connection->second.connection_management_callbacks_ = nullptr;
+      if (connection != nullptr) {
+        connection->connection_management_callbacks_ = nullptr;
         acl_connections_.erase(handle);
       }
     }
@@ -184,8 +186,8 @@ struct classic_impl : public security::ISecurityManagerListener {
     bool send_packet_upward(uint16_t handle, std::function<void(struct acl_manager::assembler* assembler)> cb) {
       std::unique_lock<std::mutex> lock(acl_connections_guard_);
       auto connection = acl_connections_.find(handle);
-      if (connection != acl_connections_.end()) cb(connection->second.assembler_);
-      return connection != acl_connections_.end();
+      if (connection != nullptr) cb(connection->assembler_);
+      return connection != nullptr;
     }
     void add(
         uint16_t handle,
@@ -194,12 +196,9 @@ struct classic_impl : public security::ISecurityManagerListener {
         os::Handler* handler,
         ConnectionManagementCallbacks* connection_management_callbacks) {
       std::unique_lock<std::mutex> lock(acl_connections_guard_);
-      auto emplace_pair = acl_connections_.emplace(
-          std::piecewise_construct,
-          std::forward_as_tuple(handle),
-          std::forward_as_tuple(remote_address, queue_end, handler));
+      auto emplace_pair = acl_connections_.try_emplace(handle, remote_address, queue_end, handler);
       ASSERT(emplace_pair.second);  // Make sure the connection is unique
-      emplace_pair.first->second.connection_management_callbacks_ = connection_management_callbacks;
+      emplace_pair.first->connection_management_callbacks_ = connection_management_callbacks;
     }
     uint16_t HACK_get_handle(const Address& address) const {
       std::unique_lock<std::mutex> lock(acl_connections_guard_);
@@ -213,10 +212,10 @@ struct classic_impl : public security::ISecurityManagerListener {
     Address get_address(uint16_t handle) const {
       std::unique_lock<std::mutex> lock(acl_connections_guard_);
       auto connection = acl_connections_.find(handle);
-      if (connection == acl_connections_.end()) {
+      if (connection == nullptr) {
         return Address::kEmpty;
       }
-      return connection->second.address_with_type_.GetAddress();
+      return connection->address_with_type_.GetAddress();
     }
     bool is_classic_link_already_connected(const Address& address) const {
       std::unique_lock<std::mutex> lock(acl_connections_guard_);
@@ -291,6 +290,7 @@ struct classic_impl : public security::ISecurityManagerListener {
     std::unique_ptr<CreateConnectionBuilder> packet = CreateConnectionBuilder::Create(
         address, packet_type, page_scan_repetition_mode, clock_offset, clock_offset_valid, allow_role_switch);
 
+    common::ConnectionTimeline::GetInstance().Record(address, common::ConnectionMilestone::CREATE_CONNECTION);
     pending_outgoing_connections_.emplace(address, std::move(packet));
     dequeue_next_connection();
   }
@@ -343,6 +343,8 @@ struct classic_impl : public security::ISecurityManagerListener {
       ConnectionCompleteView connection_complete, Role current_role, Initiator initiator) {
     auto status = connection_complete.GetStatus();
     auto address = connection_complete.GetBdAddr();
+    common::ConnectionTimeline::GetInstance().RecordConnectionComplete(
+        address, connection_complete.GetConnectionHandle(), status == ErrorCode::SUCCESS);
     if (client_callbacks_ == nullptr) {
       LOG_WARN("No client callbacks registered for connection");
       return;
@@ -422,6 +424,7 @@ struct classic_impl : public security::ISecurityManagerListener {
     bool event_also_routes_to_other_receivers = connections.crash_on_unknown_handle_;
     bluetooth::os::LogMetricBluetoothDisconnectionReasonReported(
         static_cast<uint32_t>(reason), connections.get_address(handle), handle);
+    common::ConnectionTimeline::GetInstance().RecordDisconnection(handle);
     connections.crash_on_unknown_handle_ = false;
     connections.execute(
         handle,
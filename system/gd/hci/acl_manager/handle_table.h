@@ -0,0 +1,190 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+
+// A table of connections keyed by their 12 bit HCI connection handle.
+//
+// Performance:
+//   - Look-up by handle is a single array index, with no tree walk or hashing
+//   - Iteration walks a dense vector of the connections, in insertion order until an element is erased
+//   - Memory consumption is a fixed 8KB index, plus the connections
+//   - Elements are never moved, pointers to them stay valid until they are erased
+//   - NOT THREAD SAFE
+//
+// Template:
+//   - T value
+template <typename T>
+class HandleTable {
+ public:
+  using value_type = std::pair<const uint16_t, T>;
+
+ private:
+  using Entries = std::vector<std::unique_ptr<value_type>>;
+
+  template <typename Value, typename Base>
+  class Iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Value;
+    using difference_type = std::ptrdiff_t;
+    using pointer = Value*;
+    using reference = Value&;
+
+    explicit Iterator(Base base) : base_(base) {}
+
+    reference operator*() const {
+      return **base_;
+    }
+    pointer operator->() const {
+      return base_->get();
+    }
+    Iterator& operator++() {
+      ++base_;
+      return *this;
+    }
+    Iterator operator++(int) {
+      return Iterator(base_++);
+    }
+    bool operator==(const Iterator& rhs) const {
+      return base_ == rhs.base_;
+    }
+    bool operator!=(const Iterator& rhs) const {
+      return base_ != rhs.base_;
+    }
+
+   private:
+    Base base_;
+  };
+
+ public:
+  using iterator = Iterator<value_type, typename Entries::iterator>;
+  using const_iterator = Iterator<const value_type, typename Entries::const_iterator>;
+
+  // Connection handles are 12 bits
+  static constexpr size_t kNumHandles = 0x1000;
+
+  HandleTable() {
+    positions_.fill(kNoPosition);
+  }
+
+  HandleTable(const HandleTable&) = delete;
+  HandleTable& operator=(const HandleTable&) = delete;
+
+  // Return the value of |handle|, or nullptr if there is none
+  T* find(uint16_t handle) {
+    if (handle >= kNumHandles || positions_[handle] == kNoPosition) {
+      return nullptr;
+    }
+    return &entries_[positions_[handle]]->second;
+  }
+
+  const T* find(uint16_t handle) const {
+    return const_cast<HandleTable*>(this)->find(handle);
+  }
+
+  bool contains(uint16_t handle) const {
+    return find(handle) != nullptr;
+  }
+
+  // Construct a value for |handle| in place from |args|, unless |handle| already has one.
+  // Return the value of |handle| and whether it was constructed.
+  template <class... Args>
+  std::pair<T*, bool> try_emplace(uint16_t handle, Args&&... args) {
+    if (handle >= kNumHandles) {
+      return {nullptr, false};
+    }
+    if (positions_[handle] != kNoPosition) {
+      return {&entries_[positions_[handle]]->second, false};
+    }
+    positions_[handle] = static_cast<uint16_t>(entries_.size());
+    entries_.push_back(std::make_unique<value_type>(
+        std::piecewise_construct, std::forward_as_tuple(handle), std::forward_as_tuple(std::forward<Args>(args)...)));
+    return {&entries_.back()->second, true};
+  }
+
+  // Remove the value of |handle|. The last element of the iteration order takes its place.
+  // Return whether there was a value to remove.
+  bool erase(uint16_t handle) {
+    if (handle >= kNumHandles || positions_[handle] == kNoPosition) {
+      return false;
+    }
+    uint16_t position = positions_[handle];
+    positions_[handle] = kNoPosition;
+    auto last = std::move(entries_.back());
+    entries_.pop_back();
+    if (position != entries_.size()) {
+      positions_[last->first] = position;
+      entries_[position] = std::move(last);
+    }
+    return true;
+  }
+
+  void clear() {
+    for (const auto& entry : entries_) {
+      positions_[entry->first] = kNoPosition;
+    }
+    entries_.clear();
+  }
+
+  size_t size() const {
+    return entries_.size();
+  }
+
+  bool empty() const {
+    return entries_.empty();
+  }
+
+  iterator begin() {
+    return iterator(entries_.begin());
+  }
+
+  const_iterator begin() const {
+    return const_iterator(entries_.begin());
+  }
+
+  iterator end() {
+    return iterator(entries_.end());
+  }
+
+  const_iterator end() const {
+    return const_iterator(entries_.end());
+  }
+
+ private:
+  static constexpr uint16_t kNoPosition = 0xffff;
+
+  Entries entries_;
+  // Position of the value of each handle in |entries_|
+  std::array<uint16_t, kNumHandles> positions_;
+};
+
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
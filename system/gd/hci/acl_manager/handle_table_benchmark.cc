@@ -0,0 +1,103 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "hci/acl_manager/handle_table.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+
+namespace {
+
+// Stand-in for the connection state dispatched to on each incoming ACL packet
+struct Connection {
+  uint64_t received_packets = 0;
+  uint64_t received_bytes = 0;
+};
+
+// Handles as a controller assigns them, spread over the 12 bit range
+std::vector<uint16_t> MakeHandles(size_t num_connections) {
+  std::vector<uint16_t> handles;
+  for (size_t i = 0; i < num_connections; i++) {
+    handles.push_back(static_cast<uint16_t>((0x0040 + i * 0x0101) & 0x0eff));
+  }
+  return handles;
+}
+
+// Packets interleaved from all the connections, with a few for unknown handles
+std::vector<uint16_t> MakeTraffic(const std::vector<uint16_t>& handles) {
+  std::vector<uint16_t> traffic;
+  for (size_t i = 0; i < 1024; i++) {
+    traffic.push_back(i % 64 == 63 ? 0x0eff : handles[(i * 7) % handles.size()]);
+  }
+  return traffic;
+}
+
+void ReportRate(State& state) {
+  state.counters["packets_per_second"] = benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+}
+
+}  // namespace
+
+void BM_AclDispatchMap(State& state) {
+  auto handles = MakeHandles(state.range(0));
+  std::map<uint16_t, Connection> connections;
+  for (auto handle : handles) {
+    connections[handle];
+  }
+  auto traffic = MakeTraffic(handles);
+  size_t i = 0;
+  for (auto _ : state) {
+    auto connection = connections.find(traffic[i++ % traffic.size()]);
+    if (connection != connections.end()) {
+      connection->second.received_packets++;
+      connection->second.received_bytes += 27;
+    }
+  }
+  ReportRate(state);
+}
+
+void BM_AclDispatchHandleTable(State& state) {
+  auto handles = MakeHandles(state.range(0));
+  HandleTable<Connection> connections;
+  for (auto handle : handles) {
+    connections.try_emplace(handle);
+  }
+  auto traffic = MakeTraffic(handles);
+  size_t i = 0;
+  for (auto _ : state) {
+    auto connection = connections.find(traffic[i++ % traffic.size()]);
+    if (connection != nullptr) {
+      connection->received_packets++;
+      connection->received_bytes += 27;
+    }
+  }
+  ReportRate(state);
+}
+
+BENCHMARK(BM_AclDispatchMap)->RangeMultiplier(2)->Range(1, 32);
+BENCHMARK(BM_AclDispatchHandleTable)->RangeMultiplier(2)->Range(1, 32);
+
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
@@ -0,0 +1,102 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/acl_manager/handle_table.h"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+namespace {
+
+TEST(HandleTableTest, empty) {
+  HandleTable<int> table;
+  ASSERT_TRUE(table.empty());
+  ASSERT_EQ(0ul, table.size());
+  ASSERT_EQ(nullptr, table.find(0x0001));
+  ASSERT_FALSE(table.erase(0x0001));
+  ASSERT_EQ(table.begin(), table.end());
+}
+
+TEST(HandleTableTest, emplace_and_find) {
+  HandleTable<std::string> table;
+  auto emplaced = table.try_emplace(0x0001, "first");
+  ASSERT_TRUE(emplaced.second);
+  ASSERT_EQ("first", *emplaced.first);
+  ASSERT_TRUE(table.try_emplace(0x0eff, 3, 'a').second);
+
+  ASSERT_EQ(2ul, table.size());
+  ASSERT_EQ("first", *table.find(0x0001));
+  ASSERT_EQ("aaa", *table.find(0x0eff));
+  ASSERT_FALSE(table.contains(0x0002));
+
+  // An existing value is not replaced
+  emplaced = table.try_emplace(0x0001, "second");
+  ASSERT_FALSE(emplaced.second);
+  ASSERT_EQ("first", *emplaced.first);
+}
+
+TEST(HandleTableTest, handles_out_of_range) {
+  HandleTable<int> table;
+  ASSERT_FALSE(table.try_emplace(0x1000, 1).second);
+  ASSERT_EQ(nullptr, table.find(0xffff));
+  ASSERT_FALSE(table.erase(0xffff));
+  ASSERT_TRUE(table.empty());
+}
+
+TEST(HandleTableTest, erase_keeps_other_values) {
+  HandleTable<int> table;
+  for (uint16_t handle = 1; handle <= 5; handle++) {
+    table.try_emplace(handle, handle * 10);
+  }
+  int* last = table.find(5);
+
+  ASSERT_TRUE(table.erase(2));
+  ASSERT_FALSE(table.contains(2));
+  ASSERT_EQ(4ul, table.size());
+  // The values are not moved in memory
+  ASSERT_EQ(last, table.find(5));
+
+  std::map<uint16_t, int> values;
+  for (const auto& [handle, value] : table) {
+    values[handle] = value;
+  }
+  ASSERT_EQ((std::map<uint16_t, int>{{1, 10}, {3, 30}, {4, 40}, {5, 50}}), values);
+
+  // A handle can be used again once erased
+  ASSERT_TRUE(table.try_emplace(2, 20).second);
+  ASSERT_EQ(20, *table.find(2));
+}
+
+TEST(HandleTableTest, clear) {
+  HandleTable<int> table;
+  table.try_emplace(0x0040, 1);
+  table.try_emplace(0x0041, 2);
+  table.clear();
+
+  ASSERT_TRUE(table.empty());
+  ASSERT_FALSE(table.contains(0x0040));
+  ASSERT_TRUE(table.try_emplace(0x0041, 3).second);
+}
+
+}  // namespace
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
@@ -0,0 +1,168 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/acl_manager/le_connection_predictor.h"
+
+#include <algorithm>
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+
+namespace {
+
+constexpr size_t kMaxTrackedAdvertisers = 256;
+// A device not heard from within this period is no longer assumed in range
+constexpr std::chrono::seconds kPresenceTimeout{10};
+// Shortest legal advertising interval; closer reports are the same event
+constexpr std::chrono::milliseconds kMinAdvertisingInterval{20};
+// Longest legal advertising interval; longer gaps mean the device went away
+constexpr std::chrono::milliseconds kMaxAdvertisingInterval{10240};
+// Slack added on top of the advertising interval when sizing the scan window
+constexpr std::chrono::milliseconds kScanWindowMargin{10};
+
+constexpr uint16_t kScanIntervalFast = 0x0060; /* 60 ms = 96 *0.625 */
+constexpr uint16_t kScanWindowFast = 0x0030;   /* 30 ms = 48 *0.625 */
+constexpr uint16_t kScanWindowMax = 0x0400;    /* 640 ms = 1024 *0.625 */
+
+uint16_t to_scan_units(std::chrono::milliseconds duration) {
+  return static_cast<uint16_t>(std::min<int64_t>(duration.count() * 8 / 5, UINT16_MAX));
+}
+
+}  // namespace
+
+void LeConnectionPredictor::OnAdvertisement(
+    const AddressWithType& address_with_type, int8_t rssi, Clock::time_point now) {
+  auto it = history_.find(address_with_type);
+  if (it == history_.end()) {
+    if (history_.size() >= kMaxTrackedAdvertisers) {
+      evict_oldest();
+    }
+    history_[address_with_type] = {.last_seen = now, .rssi = rssi};
+    return;
+  }
+
+  AdvertiserHistory& history = it->second;
+  history.rssi = rssi;
+  auto delta = std::chrono::duration_cast<std::chrono::milliseconds>(now - history.last_seen);
+  if (delta < kMinAdvertisingInterval) {
+    // Same advertising event seen on another channel, or its scan response
+    return;
+  }
+  history.last_seen = now;
+  if (delta > kMaxAdvertisingInterval) {
+    return;
+  }
+
+  // Missed advertisements only ever inflate the gap, so trust shorter gaps
+  // right away and let longer ones pull the estimate up slowly.
+  if (history.interval.count() == 0 || delta < history.interval) {
+    history.interval = delta;
+  } else {
+    history.interval = (history.interval * 7 + delta) / 8;
+  }
+}
+
+bool LeConnectionPredictor::IsLikelyPresent(const AddressWithType& address_with_type, Clock::time_point now) const {
+  auto it = history_.find(address_with_type);
+  return it != history_.end() && now - it->second.last_seen <= kPresenceTimeout;
+}
+
+std::optional<std::chrono::milliseconds> LeConnectionPredictor::GetAdvertisingInterval(
+    const AddressWithType& address_with_type) const {
+  auto it = history_.find(address_with_type);
+  if (it == history_.end() || it->second.interval.count() == 0) {
+    return std::nullopt;
+  }
+  return it->second.interval;
+}
+
+std::vector<AddressWithType> LeConnectionPredictor::Prioritize(
+    std::vector<AddressWithType> addresses, Clock::time_point now) const {
+  std::stable_sort(addresses.begin(), addresses.end(), [&](const AddressWithType& a, const AddressWithType& b) {
+    bool a_present = IsLikelyPresent(a, now);
+    bool b_present = IsLikelyPresent(b, now);
+    if (a_present != b_present) {
+      return a_present;
+    }
+    if (!a_present) {
+      return false;
+    }
+    return history_.at(a).rssi > history_.at(b).rssi;
+  });
+  return addresses;
+}
+
+std::optional<LeConnectionPredictor::ScanParameters> LeConnectionPredictor::GetScanParameters(
+    const std::unordered_set<AddressWithType>& targets, Clock::time_point now) const {
+  bool any_present = false;
+  std::chrono::milliseconds longest_interval{0};
+  for (const auto& address_with_type : targets) {
+    if (!IsLikelyPresent(address_with_type, now)) {
+      continue;
+    }
+    any_present = true;
+    longest_interval = std::max(longest_interval, history_.at(address_with_type).interval);
+  }
+  if (!any_present) {
+    return std::nullopt;
+  }
+  if (longest_interval.count() == 0) {
+    return ScanParameters{.scan_interval = kScanIntervalFast, .scan_window = kScanWindowFast};
+  }
+
+  uint16_t scan_window = std::clamp(to_scan_units(longest_interval + kScanWindowMargin), kScanWindowFast, kScanWindowMax);
+  return ScanParameters{.scan_interval = static_cast<uint16_t>(scan_window * 2), .scan_window = scan_window};
+}
+
+void LeConnectionPredictor::OnConnectionAttemptStarted(
+    const AddressWithType& address_with_type, Clock::time_point now) {
+  if (pending_attempts_.emplace(address_with_type, now).second) {
+    stats_.attempts++;
+  }
+}
+
+void LeConnectionPredictor::OnConnectionAttemptCancelled(const AddressWithType& address_with_type) {
+  pending_attempts_.erase(address_with_type);
+}
+
+std::optional<std::chrono::milliseconds> LeConnectionPredictor::OnConnected(
+    const AddressWithType& address_with_type, Clock::time_point now) {
+  auto it = pending_attempts_.find(address_with_type);
+  if (it == pending_attempts_.end()) {
+    return std::nullopt;
+  }
+  auto time_to_connect = std::chrono::duration_cast<std::chrono::milliseconds>(now - it->second);
+  pending_attempts_.erase(it);
+
+  stats_.connected++;
+  stats_.total_time_to_connect += time_to_connect;
+  stats_.max_time_to_connect = std::max(stats_.max_time_to_connect, time_to_connect);
+  return time_to_connect;
+}
+
+void LeConnectionPredictor::evict_oldest() {
+  auto oldest = std::min_element(history_.begin(), history_.end(), [](const auto& a, const auto& b) {
+    return a.second.last_seen < b.second.last_seen;
+  });
+  if (oldest != history_.end()) {
+    history_.erase(oldest);
+  }
+}
+
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "hci/address_with_type.h"
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+
+// Keeps a short history of advertisements seen from peripherals we want to
+// (re)connect to, and uses it to decide in which order they are programmed
+// into the filter accept list and how aggressively the initiator scans.
+class LeConnectionPredictor {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  // Scan parameters for LE Create Connection, in units of 0.625 ms
+  struct ScanParameters {
+    uint16_t scan_interval;
+    uint16_t scan_window;
+  };
+
+  struct ReconnectStats {
+    size_t attempts = 0;
+    size_t connected = 0;
+    std::chrono::milliseconds total_time_to_connect{0};
+    std::chrono::milliseconds max_time_to_connect{0};
+  };
+
+  void OnAdvertisement(const AddressWithType& address_with_type, int8_t rssi, Clock::time_point now);
+
+  // True if the device advertised recently enough to be expected in range
+  bool IsLikelyPresent(const AddressWithType& address_with_type, Clock::time_point now) const;
+
+  // Estimated advertising interval, if at least two advertisements were seen
+  std::optional<std::chrono::milliseconds> GetAdvertisingInterval(const AddressWithType& address_with_type) const;
+
+  // Orders devices so the ones most likely to connect come first: recently
+  // seen devices by descending RSSI, then the rest in their original order.
+  std::vector<AddressWithType> Prioritize(std::vector<AddressWithType> addresses, Clock::time_point now) const;
+
+  // Scan parameters whose window covers one advertising interval of every
+  // present target, or nullopt if none of the targets was seen recently.
+  std::optional<ScanParameters> GetScanParameters(
+      const std::unordered_set<AddressWithType>& targets, Clock::time_point now) const;
+
+  void OnConnectionAttemptStarted(const AddressWithType& address_with_type, Clock::time_point now);
+  void OnConnectionAttemptCancelled(const AddressWithType& address_with_type);
+  // Returns the time it took to connect if an attempt was pending
+  std::optional<std::chrono::milliseconds> OnConnected(const AddressWithType& address_with_type, Clock::time_point now);
+
+  const ReconnectStats& GetReconnectStats() const {
+    return stats_;
+  }
+
+ private:
+  struct AdvertiserHistory {
+    Clock::time_point last_seen;
+    std::chrono::milliseconds interval{0};
+    int8_t rssi;
+  };
+
+  void evict_oldest();
+
+  std::unordered_map<AddressWithType, AdvertiserHistory> history_;
+  std::unordered_map<AddressWithType, Clock::time_point> pending_attempts_;
+  ReconnectStats stats_;
+};
+
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
@@ -0,0 +1,123 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/acl_manager/le_connection_predictor.h"
+
+#include <gtest/gtest.h>
+
+using namespace std::chrono_literals;
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+namespace {
+
+const AddressWithType kDevice1({0x01, 0x02, 0x03, 0x04, 0x05, 0x06}, AddressType::PUBLIC_DEVICE_ADDRESS);
+const AddressWithType kDevice2({0x11, 0x12, 0x13, 0x14, 0x15, 0x16}, AddressType::PUBLIC_DEVICE_ADDRESS);
+const AddressWithType kDevice3({0x21, 0x22, 0x23, 0x24, 0x25, 0x26}, AddressType::RANDOM_DEVICE_ADDRESS);
+
+class LeConnectionPredictorTest : public ::testing::Test {
+ protected:
+  LeConnectionPredictor predictor_;
+  LeConnectionPredictor::Clock::time_point now_ = LeConnectionPredictor::Clock::now();
+};
+
+TEST_F(LeConnectionPredictorTest, advertising_interval_tracks_shortest_gap) {
+  predictor_.OnAdvertisement(kDevice1, -50, now_);
+  ASSERT_FALSE(predictor_.GetAdvertisingInterval(kDevice1).has_value());
+
+  predictor_.OnAdvertisement(kDevice1, -50, now_ + 200ms);
+  ASSERT_EQ(200ms, predictor_.GetAdvertisingInterval(kDevice1));
+
+  // A missed advertisement only nudges the estimate
+  predictor_.OnAdvertisement(kDevice1, -50, now_ + 600ms);
+  ASSERT_EQ(225ms, predictor_.GetAdvertisingInterval(kDevice1));
+
+  predictor_.OnAdvertisement(kDevice1, -50, now_ + 700ms);
+  ASSERT_EQ(100ms, predictor_.GetAdvertisingInterval(kDevice1));
+}
+
+TEST_F(LeConnectionPredictorTest, reports_from_same_event_are_ignored) {
+  predictor_.OnAdvertisement(kDevice1, -50, now_);
+  predictor_.OnAdvertisement(kDevice1, -50, now_ + 5ms);
+  ASSERT_FALSE(predictor_.GetAdvertisingInterval(kDevice1).has_value());
+}
+
+TEST_F(LeConnectionPredictorTest, presence_expires) {
+  predictor_.OnAdvertisement(kDevice1, -50, now_);
+  ASSERT_TRUE(predictor_.IsLikelyPresent(kDevice1, now_ + 1s));
+  ASSERT_FALSE(predictor_.IsLikelyPresent(kDevice1, now_ + 11s));
+  ASSERT_FALSE(predictor_.IsLikelyPresent(kDevice2, now_));
+}
+
+TEST_F(LeConnectionPredictorTest, prioritize_present_devices_by_rssi) {
+  predictor_.OnAdvertisement(kDevice2, -80, now_);
+  predictor_.OnAdvertisement(kDevice3, -40, now_);
+
+  auto ordered = predictor_.Prioritize({kDevice1, kDevice2, kDevice3}, now_);
+  ASSERT_EQ(3u, ordered.size());
+  ASSERT_EQ(kDevice3, ordered[0]);
+  ASSERT_EQ(kDevice2, ordered[1]);
+  ASSERT_EQ(kDevice1, ordered[2]);
+}
+
+TEST_F(LeConnectionPredictorTest, scan_parameters_cover_advertising_interval) {
+  ASSERT_FALSE(predictor_.GetScanParameters({kDevice1}, now_).has_value());
+
+  predictor_.OnAdvertisement(kDevice1, -50, now_);
+  auto parameters = predictor_.GetScanParameters({kDevice1}, now_);
+  ASSERT_TRUE(parameters.has_value());
+  ASSERT_EQ(0x0060, parameters->scan_interval);
+  ASSERT_EQ(0x0030, parameters->scan_window);
+
+  predictor_.OnAdvertisement(kDevice1, -50, now_ + 100ms);
+  parameters = predictor_.GetScanParameters({kDevice1, kDevice2}, now_ + 100ms);
+  ASSERT_TRUE(parameters.has_value());
+  // (100 ms + 10 ms margin) / 0.625 ms
+  ASSERT_EQ(176, parameters->scan_window);
+  ASSERT_EQ(352, parameters->scan_interval);
+
+  ASSERT_FALSE(predictor_.GetScanParameters({kDevice1}, now_ + 20s).has_value());
+}
+
+TEST_F(LeConnectionPredictorTest, scan_window_is_bounded) {
+  predictor_.OnAdvertisement(kDevice1, -50, now_);
+  predictor_.OnAdvertisement(kDevice1, -50, now_ + 5s);
+  auto parameters = predictor_.GetScanParameters({kDevice1}, now_ + 5s);
+  ASSERT_TRUE(parameters.has_value());
+  ASSERT_EQ(0x0400, parameters->scan_window);
+  ASSERT_EQ(0x0800, parameters->scan_interval);
+}
+
+TEST_F(LeConnectionPredictorTest, time_to_connect) {
+  predictor_.OnConnectionAttemptStarted(kDevice1, now_);
+  predictor_.OnConnectionAttemptStarted(kDevice2, now_);
+  predictor_.OnConnectionAttemptCancelled(kDevice2);
+
+  ASSERT_EQ(1500ms, predictor_.OnConnected(kDevice1, now_ + 1500ms));
+  ASSERT_FALSE(predictor_.OnConnected(kDevice2, now_ + 1500ms).has_value());
+
+  const auto& stats = predictor_.GetReconnectStats();
+  ASSERT_EQ(2u, stats.attempts);
+  ASSERT_EQ(1u, stats.connected);
+  ASSERT_EQ(1500ms, stats.total_time_to_connect);
+  ASSERT_EQ(1500ms, stats.max_time_to_connect);
+}
+
+}  // namespace
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
@@ -18,17 +18,21 @@
 
 #include <base/strings/stringprintf.h>
 
+#include <algorithm>
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <string>
 #include <unordered_set>
+#include <vector>
 
 #include "common/bind.h"
 #include "common/init_flags.h"
 #include "crypto_toolbox/crypto_toolbox.h"
 #include "hci/acl_manager/assembler.h"
+#include "hci/acl_manager/handle_table.h"
+#include "hci/acl_manager/le_connection_predictor.h"
 #include "hci/acl_manager/le_connection_management_callbacks.h"
 #include "hci/acl_manager/round_robin_scheduler.h"
 #include "hci/controller.h"
@@ -58,6 +62,8 @@ constexpr uint16_t kScanWindowCodedFast = 0x0018; /* 15 ms = 24 *0.625 */
 constexpr uint16_t kScanIntervalSlow = 0x0800;    /* 1.28 s = 2048 *0.625 */
 constexpr uint16_t kScanWindowSlow = 0x0030;      /* 30 ms = 48 *0.625 */
 constexpr std::chrono::milliseconds kCreateConnectionTimeoutMs = std::chrono::milliseconds(30 * 1000);
+constexpr std::chrono::milliseconds kConnectListBatchDelay = std::chrono::milliseconds(50);
+constexpr std::chrono::milliseconds kPredictiveRearmHoldoff = std::chrono::milliseconds(5 * 1000);
 constexpr uint8_t PHY_LE_NO_PACKET = 0x00;
 constexpr uint8_t PHY_LE_1M = 0x01;
 constexpr uint8_t PHY_LE_2M = 0x02;
@@ -120,9 +126,11 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
         controller->GetMacAddress(),
         controller->GetLeFilterAcceptListSize(),
         controller->GetLeResolvingListSize());
+    connect_list_batch_alarm_ = std::make_unique<os::Alarm>(handler_);
   }
 
   ~le_impl() {
+    connect_list_batch_alarm_.reset();
     if (address_manager_registered) {
       le_address_manager_->UnregisterSync(this);
     }
@@ -161,17 +169,17 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
   static constexpr uint16_t kIllegalConnectionHandle = 0xffff;
   struct {
    private:
-    std::map<uint16_t, le_acl_connection> le_acl_connections_;
+    HandleTable<le_acl_connection> le_acl_connections_;
     mutable std::mutex le_acl_connections_guard_;
     LeConnectionManagementCallbacks* find_callbacks(uint16_t handle) {
       auto connection = le_acl_connections_.find(handle);
-      if (connection == le_acl_connections_.end()) return nullptr;
-      return connection->second.le_connection_management_callbacks_;
+      if (connection == nullptr) return nullptr;
+      return connection->le_connection_management_callbacks_;
     }
     void remove(uint16_t handle) {
       auto connection = le_acl_connections_.find(handle);
-      if (connection != le_acl_connections_.end()) {
-        connection->second.le_connection_management_callbacks_ = nullptr;
+      if (connection != nullptr) {
+        connection->le_connection_management_callbacks_ = nullptr;
         le_acl_connections_.erase(handle);
       }
     }
@@ -205,8 +213,8 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
     bool send_packet_upward(uint16_t handle, std::function<void(struct acl_manager::assembler* assembler)> cb) {
       std::unique_lock<std::mutex> lock(le_acl_connections_guard_);
       auto connection = le_acl_connections_.find(handle);
-      if (connection != le_acl_connections_.end()) cb(connection->second.assembler_);
-      return connection != le_acl_connections_.end();
+      if (connection != nullptr) cb(connection->assembler_);
+      return connection != nullptr;
     }
     void add(
         uint16_t handle,
@@ -215,12 +223,9 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
         os::Handler* handler,
         LeConnectionManagementCallbacks* le_connection_management_callbacks) {
       std::unique_lock<std::mutex> lock(le_acl_connections_guard_);
-      auto emplace_pair = le_acl_connections_.emplace(
-          std::piecewise_construct,
-          std::forward_as_tuple(handle),
-          std::forward_as_tuple(remote_address, queue_end, handler));
+      auto emplace_pair = le_acl_connections_.try_emplace(handle, remote_address, queue_end, handler);
       ASSERT(emplace_pair.second);  // Make sure the connection is unique
-      emplace_pair.first->second.le_connection_management_callbacks_ = le_connection_management_callbacks;
+      emplace_pair.first->le_connection_management_callbacks_ = le_connection_management_callbacks;
     }
     uint16_t HACK_get_handle(Address address) const {
       std::unique_lock<std::mutex> lock(le_acl_connections_guard_);
@@ -234,9 +239,9 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
 
     AddressWithType getAddressWithType(uint16_t handle) {
       std::unique_lock<std::mutex> lock(le_acl_connections_guard_);
-      auto it = le_acl_connections_.find(handle);
-      if (it != le_acl_connections_.end()) {
-        return it->second.remote_address_;
+      auto connection = le_acl_connections_.find(handle);
+      if (connection != nullptr) {
+        return connection->remote_address_;
       }
       AddressWithType empty(Address::kEmpty, AddressType::RANDOM_DEVICE_ADDRESS);
       return empty;
@@ -324,6 +329,10 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
 
       arm_on_resume_ = false;
       ready_to_unregister = true;
+      if (status == ErrorCode::SUCCESS) {
+        // Before the removal from the connect list ends the pending attempt
+        record_connected(remote_address);
+      }
       remove_device_from_connect_list(remote_address);
 
       if (!connect_list.empty()) {
@@ -358,6 +367,7 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
         LOG_INFO(
             "Received incoming connection of device in filter accept_list, %s",
             PRIVATE_ADDRESS_WITH_TYPE(remote_address));
+        record_connected(remote_address);
         remove_device_from_connect_list(remote_address);
         if (create_connection_timeout_alarms_.find(remote_address) != create_connection_timeout_alarms_.end()) {
           create_connection_timeout_alarms_.at(remote_address).Cancel();
@@ -447,6 +457,10 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
 
       arm_on_resume_ = false;
       ready_to_unregister = true;
+      if (status == ErrorCode::SUCCESS) {
+        // Before the removal from the connect list ends the pending attempt
+        record_connected(remote_address);
+      }
       remove_device_from_connect_list(remote_address);
 
       if (!connect_list.empty()) {
@@ -482,6 +496,7 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
         LOG_INFO(
             "Received incoming connection of device in filter accept_list, %s",
             PRIVATE_ADDRESS_WITH_TYPE(remote_address));
+        record_connected(remote_address);
         remove_device_from_connect_list(remote_address);
         if (create_connection_timeout_alarms_.find(remote_address) != create_connection_timeout_alarms_.end()) {
           create_connection_timeout_alarms_.at(remote_address).Cancel();
@@ -647,11 +662,39 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
     }
 
     connect_list.insert(address_with_type);
+    connection_predictor_.OnConnectionAttemptStarted(address_with_type, LeConnectionPredictor::Clock::now());
+
+    // Every filter accept list update cancels and restarts an ongoing create connection, so gather
+    // devices added in quick succession and program them together.
+    if (connectability_state_ == ConnectabilityState::ARMED || connectability_state_ == ConnectabilityState::ARMING) {
+      pending_connect_list_.push_back(address_with_type);
+      if (pending_connect_list_.size() == 1) {
+        connect_list_batch_alarm_->Schedule(
+            common::BindOnce(&le_impl::flush_pending_connect_list, common::Unretained(this)), kConnectListBatchDelay);
+      }
+      return;
+    }
+
     register_with_address_manager();
     le_address_manager_->AddDeviceToFilterAcceptList(
         address_with_type.ToFilterAcceptListAddressType(), address_with_type.GetAddress());
   }
 
+  void flush_pending_connect_list() {
+    if (pending_connect_list_.empty()) {
+      return;
+    }
+    auto pending =
+        connection_predictor_.Prioritize(std::move(pending_connect_list_), LeConnectionPredictor::Clock::now());
+    pending_connect_list_.clear();
+    LOG_INFO("Adding %zu devices to filter accept list", pending.size());
+    register_with_address_manager();
+    for (const auto& address_with_type : pending) {
+      le_address_manager_->AddDeviceToFilterAcceptList(
+          address_with_type.ToFilterAcceptListAddressType(), address_with_type.GetAddress());
+    }
+  }
+
   bool is_device_in_connect_list(AddressWithType address_with_type) {
     return (connect_list.find(address_with_type) != connect_list.end());
   }
@@ -664,6 +707,14 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
     connect_list.erase(address_with_type);
     connecting_le_.erase(address_with_type);
     direct_connections_.erase(address_with_type);
+    connection_predictor_.OnConnectionAttemptCancelled(address_with_type);
+
+    auto pending = std::find(pending_connect_list_.begin(), pending_connect_list_.end(), address_with_type);
+    if (pending != pending_connect_list_.end()) {
+      // Never reached the controller
+      pending_connect_list_.erase(pending);
+      return;
+    }
     register_with_address_manager();
     le_address_manager_->RemoveDeviceFromFilterAcceptList(
         address_with_type.ToFilterAcceptListAddressType(), address_with_type.GetAddress());
@@ -671,6 +722,8 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
 
   void clear_connect_list() {
     connect_list.clear();
+    pending_connect_list_.clear();
+    connect_list_batch_alarm_->Cancel();
     register_with_address_manager();
     le_address_manager_->ClearFilterAcceptList();
   }
@@ -748,12 +801,23 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
     uint16_t le_scan_window = kScanWindowSlow;
     uint16_t le_scan_window_2m = kScanWindowSlow;
     uint16_t le_scan_window_coded = kScanWindowSlow;
+    armed_with_fast_parameters_ = true;
     // If there is any direct connection in the connection list, use the fast parameter
     if (!direct_connections_.empty()) {
       le_scan_interval = kScanIntervalFast;
       le_scan_window = kScanWindowFast;
       le_scan_window_2m = kScanWindow2mFast;
       le_scan_window_coded = kScanWindowCodedFast;
+    } else if (auto predicted = connection_predictor_.GetScanParameters(
+                   connect_list, LeConnectionPredictor::Clock::now())) {
+      // Some background devices were seen advertising recently, scan long enough to catch them
+      le_scan_interval = predicted->scan_interval;
+      le_scan_window = predicted->scan_window;
+      le_scan_window_2m = predicted->scan_window / 2;
+      le_scan_window_coded = predicted->scan_window / 2;
+      LOG_DEBUG("Using predicted scan interval:0x%04x window:0x%04x", le_scan_interval, le_scan_window);
+    } else {
+      armed_with_fast_parameters_ = false;
     }
     InitiatorFilterPolicy initiator_filter_policy = InitiatorFilterPolicy::USE_FILTER_ACCEPT_LIST;
     OwnAddressType own_address_type =
@@ -1048,6 +1112,42 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
     return true;
   }
 
+  void on_le_advertisement_report(AddressWithType address_with_type, int8_t rssi) {
+    auto now = LeConnectionPredictor::Clock::now();
+    connection_predictor_.OnAdvertisement(address_with_type, rssi, now);
+
+    // A background device just showed up while the initiator is duty cycling with slow parameters;
+    // restart it so arm_connectability() can pick parameters matching the advertiser.
+    if (connectability_state_ != ConnectabilityState::ARMED || pause_connection || armed_with_fast_parameters_) {
+      return;
+    }
+    if (connecting_le_.find(address_with_type) == connecting_le_.end()) {
+      return;
+    }
+    if (now - last_predictive_rearm_ < kPredictiveRearmHoldoff) {
+      return;
+    }
+    last_predictive_rearm_ = now;
+    LOG_INFO("Background device %s is advertising, re-arming", PRIVATE_ADDRESS_WITH_TYPE(address_with_type));
+    disarm_connectability();
+  }
+
+  void record_connected(AddressWithType address_with_type) {
+    auto time_to_connect = connection_predictor_.OnConnected(address_with_type, LeConnectionPredictor::Clock::now());
+    if (!time_to_connect.has_value()) {
+      return;
+    }
+    const auto& stats = connection_predictor_.GetReconnectStats();
+    LOG_INFO(
+        "Connected to %s in %lld ms (connected:%zu/%zu avg:%lld ms max:%lld ms)",
+        PRIVATE_ADDRESS_WITH_TYPE(address_with_type),
+        static_cast<long long>(time_to_connect->count()),
+        stats.connected,
+        stats.attempts,
+        static_cast<long long>(stats.total_time_to_connect.count() / stats.connected),
+        static_cast<long long>(stats.max_time_to_connect.count()));
+  }
+
   void add_device_to_background_connection_list(AddressWithType address_with_type) {
     background_connections_.insert(address_with_type);
   }
@@ -1151,6 +1251,12 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
   bool disarmed_while_arming_ = false;
   ConnectabilityState connectability_state_{ConnectabilityState::DISARMED};
   std::map<AddressWithType, os::Alarm> create_connection_timeout_alarms_;
+  LeConnectionPredictor connection_predictor_;
+  // Devices added to connect_list whose filter accept list command is deferred
+  std::vector<AddressWithType> pending_connect_list_;
+  std::unique_ptr<os::Alarm> connect_list_batch_alarm_;
+  bool armed_with_fast_parameters_ = false;
+  LeConnectionPredictor::Clock::time_point last_predictive_rearm_;
 };
 
 #undef PRIVATE_ADDRESS_WITH_TYPE
@@ -806,6 +806,77 @@ TEST_F(LeImplTest, enhanced_connection_complete_with_central_role) {
   ASSERT_EQ(ConnectabilityState::DISARMED, le_impl_->connectability_state_);
 }
 
+TEST_F(LeImplTest, connection_complete_records_time_to_reconnect) {
+  set_random_device_address_policy();
+
+  hci::Address remote_address;
+  Address::FromString("D0:05:04:03:02:01", remote_address);
+  hci::AddressWithType address_with_type(remote_address, hci::AddressType::PUBLIC_DEVICE_ADDRESS);
+  // Background connection
+  ASSERT_NO_FATAL_FAILURE(hci_layer_->SetCommandFuture());
+  le_impl_->create_le_connection(address_with_type, true, false);
+  hci_layer_->GetCommand(OpCode::LE_ADD_DEVICE_TO_FILTER_ACCEPT_LIST);
+  ASSERT_NO_FATAL_FAILURE(hci_layer_->SetCommandFuture());
+  hci_layer_->CommandCompleteCallback(LeAddDeviceToFilterAcceptListCompleteBuilder::Create(0x01, ErrorCode::SUCCESS));
+  hci_layer_->GetCommand(OpCode::LE_CREATE_CONNECTION);
+  hci_layer_->CommandStatusCallback(LeCreateConnectionStatusBuilder::Create(ErrorCode::SUCCESS, 0x01));
+  sync_handler();
+  ASSERT_EQ(1u, le_impl_->connection_predictor_.GetReconnectStats().attempts);
+  ASSERT_EQ(0u, le_impl_->connection_predictor_.GetReconnectStats().connected);
+
+  EXPECT_CALL(mock_le_connection_callbacks_, OnLeConnectSuccess(address_with_type, _));
+  hci_layer_->IncomingLeMetaEvent(LeConnectionCompleteBuilder::Create(
+      ErrorCode::SUCCESS,
+      0x0041,
+      Role::CENTRAL,
+      AddressType::PUBLIC_DEVICE_ADDRESS,
+      remote_address,
+      0x0024,
+      0x0000,
+      0x0011,
+      ClockAccuracy::PPM_30));
+  sync_handler();
+
+  // The connection completes the attempt rather than cancelling it
+  ASSERT_EQ(1u, le_impl_->connection_predictor_.GetReconnectStats().connected);
+}
+
+TEST_F(LeImplTest, enhanced_connection_complete_records_time_to_reconnect) {
+  set_random_device_address_policy();
+
+  controller_->AddSupported(OpCode::LE_EXTENDED_CREATE_CONNECTION);
+  hci::Address remote_address;
+  Address::FromString("D0:05:04:03:02:01", remote_address);
+  hci::AddressWithType address_with_type(remote_address, hci::AddressType::PUBLIC_DEVICE_ADDRESS);
+  // Background connection
+  ASSERT_NO_FATAL_FAILURE(hci_layer_->SetCommandFuture());
+  le_impl_->create_le_connection(address_with_type, true, false);
+  hci_layer_->GetCommand(OpCode::LE_ADD_DEVICE_TO_FILTER_ACCEPT_LIST);
+  ASSERT_NO_FATAL_FAILURE(hci_layer_->SetCommandFuture());
+  hci_layer_->CommandCompleteCallback(LeAddDeviceToFilterAcceptListCompleteBuilder::Create(0x01, ErrorCode::SUCCESS));
+  hci_layer_->GetCommand(OpCode::LE_EXTENDED_CREATE_CONNECTION);
+  hci_layer_->CommandStatusCallback(LeExtendedCreateConnectionStatusBuilder::Create(ErrorCode::SUCCESS, 0x01));
+  sync_handler();
+  ASSERT_EQ(1u, le_impl_->connection_predictor_.GetReconnectStats().attempts);
+
+  EXPECT_CALL(mock_le_connection_callbacks_, OnLeConnectSuccess(address_with_type, _));
+  hci_layer_->IncomingLeMetaEvent(LeEnhancedConnectionCompleteBuilder::Create(
+      ErrorCode::SUCCESS,
+      0x0041,
+      Role::CENTRAL,
+      AddressType::PUBLIC_DEVICE_ADDRESS,
+      remote_address,
+      Address::kEmpty,
+      Address::kEmpty,
+      0x0024,
+      0x0000,
+      0x0011,
+      ClockAccuracy::PPM_30));
+  sync_handler();
+
+  ASSERT_EQ(1u, le_impl_->connection_predictor_.GetReconnectStats().connected);
+}
+
 // b/260917913
 TEST_F(LeImplTest, DISABLED_register_with_address_manager__AddressPolicyNotSet) {
   auto log_capture = std::make_unique<LogCapture>();
@@ -42,15 +42,15 @@ RoundRobinScheduler::~RoundRobinScheduler() {
 void RoundRobinScheduler::Register(ConnectionType connection_type, uint16_t handle,
                                    std::shared_ptr<acl_manager::AclConnection::Queue> queue) {
   acl_queue_handler acl_queue_handler = {connection_type, std::move(queue), false, 0};
-  acl_queue_handlers_.insert(std::pair<uint16_t, RoundRobinScheduler::acl_queue_handler>(handle, acl_queue_handler));
+  acl_queue_handlers_.try_emplace(handle, acl_queue_handler);
   if (fragments_to_send_.size() == 0) {
     start_round_robin();
   }
 }
 
 void RoundRobinScheduler::Unregister(uint16_t handle) {
-  ASSERT(acl_queue_handlers_.count(handle) == 1);
-  auto acl_queue_handler = acl_queue_handlers_.find(handle)->second;
+  ASSERT(acl_queue_handlers_.contains(handle));
+  auto acl_queue_handler = *acl_queue_handlers_.find(handle);
   // Reclaim outstanding packets
   if (acl_queue_handler.connection_type_ == ConnectionType::CLASSIC) {
     acl_packet_credits_ += acl_queue_handler.number_of_sent_packets_;
@@ -64,16 +64,16 @@ void RoundRobinScheduler::Unregister(uint16_t handle) {
     acl_queue_handler.queue_->GetDownEnd()->UnregisterDequeue();
   }
   acl_queue_handlers_.erase(handle);
-  starting_point_ = acl_queue_handlers_.begin();
+  starting_point_ = 0;
 }
 
 void RoundRobinScheduler::SetLinkPriority(uint16_t handle, bool high_priority) {
   auto acl_queue_handler = acl_queue_handlers_.find(handle);
-  if (acl_queue_handler == acl_queue_handlers_.end()) {
+  if (acl_queue_handler == nullptr) {
     LOG_WARN("handle %d is invalid", handle);
     return;
   }
-  acl_queue_handler->second.high_priority_ = high_priority;
+  acl_queue_handler->high_priority_ = high_priority;
 }
 
 uint16_t RoundRobinScheduler::GetCredits() {
@@ -104,12 +104,12 @@ void RoundRobinScheduler::start_round_robin() {
     return;
   }
 
-  if (acl_queue_handlers_.size() == 1 || starting_point_ == acl_queue_handlers_.end()) {
-    starting_point_ = acl_queue_handlers_.begin();
+  if (acl_queue_handlers_.size() == 1 || starting_point_ >= acl_queue_handlers_.size()) {
+    starting_point_ = 0;
   }
   size_t count = acl_queue_handlers_.size();
 
-  for (auto acl_queue_handler = starting_point_; count > 0; count--) {
+  for (auto acl_queue_handler = std::next(acl_queue_handlers_.begin(), starting_point_); count > 0; count--) {
     // Prevent registration when credits is zero
     bool classic_buffer_full =
         acl_packet_credits_ == 0 && acl_queue_handler->second.connection_type_ == ConnectionType::CLASSIC;
@@ -118,7 +118,8 @@ void RoundRobinScheduler::start_round_robin() {
     if (!acl_queue_handler->second.dequeue_is_registered_ && !classic_buffer_full && !le_buffer_full) {
       acl_queue_handler->second.dequeue_is_registered_ = true;
       acl_queue_handler->second.queue_->GetDownEnd()->RegisterDequeue(
-          handler_, common::Bind(&RoundRobinScheduler::buffer_packet, common::Unretained(this), acl_queue_handler));
+          handler_,
+          common::Bind(&RoundRobinScheduler::buffer_packet, common::Unretained(this), acl_queue_handler->first));
     }
     acl_queue_handler = std::next(acl_queue_handler);
     if (acl_queue_handler == acl_queue_handlers_.end()) {
@@ -126,23 +127,24 @@ void RoundRobinScheduler::start_round_robin() {
     }
   }
 
-  starting_point_ = std::next(starting_point_);
+  starting_point_++;
 }
 
-void RoundRobinScheduler::buffer_packet(std::map<uint16_t, acl_queue_handler>::iterator acl_queue_handler) {
+void RoundRobinScheduler::buffer_packet(uint16_t handle) {
   BroadcastFlag broadcast_flag = BroadcastFlag::POINT_TO_POINT;
   // Wrap packet and enqueue it
-  uint16_t handle = acl_queue_handler->first;
-  auto packet = acl_queue_handler->second.queue_->GetDownEnd()->TryDequeue();
+  auto acl_queue_handler = acl_queue_handlers_.find(handle);
+  ASSERT(acl_queue_handler != nullptr);
+  auto packet = acl_queue_handler->queue_->GetDownEnd()->TryDequeue();
   ASSERT(packet != nullptr);
 
-  ConnectionType connection_type = acl_queue_handler->second.connection_type_;
+  ConnectionType connection_type = acl_queue_handler->connection_type_;
   size_t mtu = connection_type == ConnectionType::CLASSIC ? hci_mtu_ : le_hci_mtu_;
   PacketBoundaryFlag packet_boundary_flag = (packet->IsFlushable())
                                                 ? PacketBoundaryFlag::FIRST_AUTOMATICALLY_FLUSHABLE
                                                 : PacketBoundaryFlag::FIRST_NON_AUTOMATICALLY_FLUSHABLE;
 
-  int acl_priority = acl_queue_handler->second.high_priority_ ? 1 : 0;
+  int acl_priority = acl_queue_handler->high_priority_ ? 1 : 0;
   if (packet->size() <= mtu) {
     fragments_to_send_.push(
         std::make_pair(
@@ -162,7 +164,7 @@ void RoundRobinScheduler::buffer_packet(std::map<uint16_t, acl_queue_handler>::i
   ASSERT(fragments_to_send_.size() > 0);
   unregister_all_connections();
 
-  acl_queue_handler->second.number_of_sent_packets_ += fragments_to_send_.size();
+  acl_queue_handler->number_of_sent_packets_ += fragments_to_send_.size();
   send_next_fragment();
 }
 
@@ -214,19 +216,19 @@ std::unique_ptr<AclBuilder> RoundRobinScheduler::handle_enqueue_next_fragment()
 
 void RoundRobinScheduler::incoming_acl_credits(uint16_t handle, uint16_t credits) {
   auto acl_queue_handler = acl_queue_handlers_.find(handle);
-  if (acl_queue_handler == acl_queue_handlers_.end()) {
+  if (acl_queue_handler == nullptr) {
     return;
   }
 
-  if (acl_queue_handler->second.number_of_sent_packets_ >= credits) {
-    acl_queue_handler->second.number_of_sent_packets_ -= credits;
+  if (acl_queue_handler->number_of_sent_packets_ >= credits) {
+    acl_queue_handler->number_of_sent_packets_ -= credits;
   } else {
     LOG_WARN("receive more credits than we sent");
-    acl_queue_handler->second.number_of_sent_packets_ = 0;
+    acl_queue_handler->number_of_sent_packets_ = 0;
   }
 
   bool credit_was_zero = false;
-  if (acl_queue_handler->second.connection_type_ == ConnectionType::CLASSIC) {
+  if (acl_queue_handler->connection_type_ == ConnectionType::CLASSIC) {
     if (acl_packet_credits_ == 0) {
       credit_was_zero = true;
     }
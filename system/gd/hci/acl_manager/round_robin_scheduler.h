@@ -21,6 +21,7 @@
 #include "common/bidi_queue.h"
 #include "common/multi_priority_queue.h"
 #include "hci/acl_manager.h"
+#include "hci/acl_manager/handle_table.h"
 #include "hci/controller.h"
 #include "hci/hci_packets.h"
 #include "os/handler.h"
@@ -54,7 +55,7 @@ class RoundRobinScheduler {
 
  private:
   void start_round_robin();
-  void buffer_packet(std::map<uint16_t, acl_queue_handler>::iterator acl_queue_handler);
+  void buffer_packet(uint16_t handle);
   void unregister_all_connections();
   void send_next_fragment();
   std::unique_ptr<AclBuilder> handle_enqueue_next_fragment();
@@ -62,7 +63,7 @@ class RoundRobinScheduler {
 
   os::Handler* handler_ = nullptr;
   Controller* controller_ = nullptr;
-  std::map<uint16_t, acl_queue_handler> acl_queue_handlers_;
+  HandleTable<acl_queue_handler> acl_queue_handlers_;
   common::MultiPriorityQueue<std::pair<ConnectionType, std::unique_ptr<AclBuilder>>, 2> fragments_to_send_;
   uint16_t max_acl_packet_credits_ = 0;
   uint16_t acl_packet_credits_ = 0;
@@ -72,8 +73,8 @@ class RoundRobinScheduler {
   size_t le_hci_mtu_{0};
   std::atomic_bool enqueue_registered_ = false;
   common::BidiQueueEnd<AclBuilder, AclView>* hci_queue_end_ = nullptr;
-  // first register queue end for the Round-robin schedule
-  std::map<uint16_t, acl_queue_handler>::iterator starting_point_;
+  // position of the first register queue end for the Round-robin schedule
+  size_t starting_point_ = 0;
 };
 
 }  // namespace acl_manager
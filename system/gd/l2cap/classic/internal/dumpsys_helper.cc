@@ -57,6 +57,24 @@ bluetooth::l2cap::classic::internal::DumpsysHelper::DumpActiveFixedChannels(
   return channel_offsets;
 }
 
+std::vector<flatbuffers::Offset<bluetooth::l2cap::classic::ChannelSetupData>>
+bluetooth::l2cap::classic::internal::DumpsysHelper::DumpChannelSetupStatistics(
+    flatbuffers::FlatBufferBuilder* fb_builder, const ClassicSignallingManager& signalling_manager) const {
+  std::vector<flatbuffers::Offset<bluetooth::l2cap::classic::ChannelSetupData>> channel_setup_offsets;
+
+  for (const auto& [psm, statistics] : signalling_manager.GetChannelSetupStatistics()) {
+    ChannelSetupDataBuilder builder(*fb_builder);
+    builder.add_psm(psm);
+    builder.add_channels(statistics.channels_);
+    if (statistics.channels_ > 0) {
+      builder.add_avg_time_to_ready_ms(statistics.total_time_to_ready_.count() / statistics.channels_);
+    }
+    builder.add_max_time_to_ready_ms(statistics.max_time_to_ready_.count());
+    channel_setup_offsets.push_back(builder.Finish());
+  }
+  return channel_setup_offsets;
+}
+
 std::vector<flatbuffers::Offset<bluetooth::l2cap::classic::LinkData>>
 bluetooth::l2cap::classic::internal::DumpsysHelper::DumpActiveLinks(flatbuffers::FlatBufferBuilder* fb_builder) const {
   const std::unordered_map<hci::Address, Link>* links = &link_manager_.links_;
@@ -71,10 +89,14 @@ bluetooth::l2cap::classic::internal::DumpsysHelper::DumpActiveLinks(flatbuffers:
     auto fixed_channel_offsets = DumpActiveFixedChannels(fb_builder, it->second.fixed_channel_allocator_);
     auto fixed_channels = fb_builder->CreateVector(fixed_channel_offsets);
 
+    auto channel_setup_offsets = DumpChannelSetupStatistics(fb_builder, it->second.signalling_manager_);
+    auto channel_setup = fb_builder->CreateVector(channel_setup_offsets);
+
     LinkDataBuilder builder(*fb_builder);
     builder.add_address(link_address);
     builder.add_dynamic_channels(dynamic_channels);
     builder.add_fixed_channels(fixed_channels);
+    builder.add_channel_setup(channel_setup);
     link_offsets.push_back(builder.Finish());
   }
   return link_offsets;
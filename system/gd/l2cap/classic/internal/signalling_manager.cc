@@ -16,6 +16,7 @@
 
 #include "l2cap/classic/internal/signalling_manager.h"
 
+#include <algorithm>
 #include <chrono>
 
 #include "common/bind.h"
@@ -55,7 +56,7 @@ ClassicSignallingManager::ClassicSignallingManager(os::Handler* handler, Link* l
                                                    FixedChannelServiceManagerImpl* fixed_service_manager)
     : handler_(handler), link_(link), data_pipeline_manager_(data_pipeline_manager),
       dynamic_service_manager_(dynamic_service_manager), channel_allocator_(channel_allocator),
-      fixed_service_manager_(fixed_service_manager), alarm_(handler) {
+      fixed_service_manager_(fixed_service_manager) {
   ASSERT(handler_ != nullptr);
   ASSERT(link_ != nullptr);
   signalling_channel_ = link_->AllocateFixedChannel(kClassicSignallingCid);
@@ -66,7 +67,7 @@ ClassicSignallingManager::ClassicSignallingManager(os::Handler* handler, Link* l
 }
 
 ClassicSignallingManager::~ClassicSignallingManager() {
-  alarm_.Cancel();
+  outstanding_commands_.clear();
   signalling_channel_->GetQueueUpEnd()->UnregisterDequeue();
   signalling_channel_ = nullptr;
   enqueue_buffer_->Clear();
@@ -74,21 +75,26 @@ ClassicSignallingManager::~ClassicSignallingManager() {
 }
 
 void ClassicSignallingManager::OnCommandReject(CommandRejectView command_reject_view) {
-  if (command_just_sent_.signal_id_ != command_reject_view.GetIdentifier()) {
+  SignalId signal_id = command_reject_view.GetIdentifier();
+  auto outstanding_command = std::find_if(
+      outstanding_commands_.begin(), outstanding_commands_.end(), [signal_id](const OutstandingCommand& command) {
+        return command.command_.signal_id_ == signal_id;
+      });
+  if (outstanding_command == outstanding_commands_.end()) {
     LOG_WARN("Unexpected command reject: no pending request");
     return;
   }
-  if (command_just_sent_.command_code_ == CommandCode::INFORMATION_REQUEST &&
-      command_just_sent_.info_type_ == InformationRequestInfoType::EXTENDED_FEATURES_SUPPORTED) {
+  if (outstanding_command->command_.command_code_ == CommandCode::INFORMATION_REQUEST &&
+      outstanding_command->command_.info_type_ == InformationRequestInfoType::EXTENDED_FEATURES_SUPPORTED) {
     link_->OnRemoteExtendedFeatureReceived(false, false);
   }
-  alarm_.Cancel();
-  handle_send_next_command();
+  complete_command(signal_id);
 
   LOG_INFO("Command rejected");
 }
 
 void ClassicSignallingManager::SendConnectionRequest(Psm psm, Cid local_cid) {
+  channel_setup_started_[local_cid] = std::chrono::steady_clock::now();
   dynamic_service_manager_->GetSecurityEnforcementInterface()->Enforce(
       link_->GetDevice(),
       dynamic_service_manager_->GetService(psm)->GetSecurityPolicy(),
@@ -113,6 +119,7 @@ void ClassicSignallingManager::on_security_result_for_outgoing(
         .hci_error = hci::ErrorCode::SUCCESS,
         .l2cap_connection_response_result = ConnectionResponseResult::NO_RESOURCES_AVAILABLE,
     };
+    channel_setup_started_.erase(local_cid);
     link_->OnOutgoingConnectionRequestFail(local_cid, connection_result);
     return;
   }
@@ -123,42 +130,49 @@ void ClassicSignallingManager::on_security_result_for_outgoing(
     // TODO(b/171253721): If we can receive ENCRYPTION_CHANGE event, we can send command after callback is received.
   }
 
-  PendingCommand pending_command = {next_signal_id_, CommandCode::CONNECTION_REQUEST, psm, local_cid, {}, {}, {}};
-  next_signal_id_++;
-  pending_commands_.push(std::move(pending_command));
-  if (command_just_sent_.signal_id_ == kInvalidSignalId) {
-    handle_send_next_command();
-  }
+  PendingCommand pending_command = {kInvalidSignalId, CommandCode::CONNECTION_REQUEST, psm, local_cid, {}, {}, {}};
+  queue_command(std::move(pending_command));
 }
 
 void ClassicSignallingManager::send_configuration_request(Cid remote_cid,
                                                           std::vector<std::unique_ptr<ConfigurationOption>> config) {
-  PendingCommand pending_command = {next_signal_id_,  CommandCode::CONFIGURATION_REQUEST, {}, {}, remote_cid, {},
-                                    std::move(config)};
-  next_signal_id_++;
-  pending_commands_.push(std::move(pending_command));
-  if (command_just_sent_.signal_id_ == kInvalidSignalId) {
-    handle_send_next_command();
+  // A request for the channel which is not sent yet carries the new options too, replacing its options of the same type
+  for (auto& pending_command : pending_commands_) {
+    if (pending_command.command_code_ != CommandCode::CONFIGURATION_REQUEST ||
+        pending_command.destination_cid_ != remote_cid) {
+      continue;
+    }
+    for (auto& option : config) {
+      auto same_type = std::find_if(
+          pending_command.config_.begin(),
+          pending_command.config_.end(),
+          [&option](const std::unique_ptr<ConfigurationOption>& pending_option) {
+            return pending_option->type_ == option->type_;
+          });
+      if (same_type != pending_command.config_.end()) {
+        *same_type = std::move(option);
+      } else {
+        pending_command.config_.emplace_back(std::move(option));
+      }
+    }
+    LOG_INFO("Merged configuration request for remote cid 0x%x", remote_cid);
+    return;
   }
+
+  PendingCommand pending_command = {kInvalidSignalId,  CommandCode::CONFIGURATION_REQUEST, {}, {}, remote_cid, {},
+                                    std::move(config)};
+  queue_command(std::move(pending_command));
 }
 
 void ClassicSignallingManager::SendDisconnectionRequest(Cid local_cid, Cid remote_cid) {
   PendingCommand pending_command = {
-      next_signal_id_, CommandCode::DISCONNECTION_REQUEST, {}, local_cid, remote_cid, {}, {}};
-  next_signal_id_++;
-  pending_commands_.push(std::move(pending_command));
-  if (command_just_sent_.signal_id_ == kInvalidSignalId) {
-    handle_send_next_command();
-  }
+      kInvalidSignalId, CommandCode::DISCONNECTION_REQUEST, {}, local_cid, remote_cid, {}, {}};
+  queue_command(std::move(pending_command));
 }
 
 void ClassicSignallingManager::SendInformationRequest(InformationRequestInfoType type) {
-  PendingCommand pending_command = {next_signal_id_, CommandCode::INFORMATION_REQUEST, {}, {}, {}, type, {}};
-  next_signal_id_++;
-  pending_commands_.push(std::move(pending_command));
-  if (command_just_sent_.signal_id_ == kInvalidSignalId) {
-    handle_send_next_command();
-  }
+  PendingCommand pending_command = {kInvalidSignalId, CommandCode::INFORMATION_REQUEST, {}, {}, {}, type, {}};
+  queue_command(std::move(pending_command));
 }
 
 void ClassicSignallingManager::SendEchoRequest(std::unique_ptr<packet::RawBuilder> payload) {
@@ -166,7 +180,14 @@ void ClassicSignallingManager::SendEchoRequest(std::unique_ptr<packet::RawBuilde
 }
 
 void ClassicSignallingManager::CancelAlarm() {
-  alarm_.Cancel();
+  for (auto& outstanding_command : outstanding_commands_) {
+    outstanding_command.alarm_->Cancel();
+  }
+}
+
+std::unordered_map<Psm, ClassicSignallingManager::ChannelSetupStatistics>
+ClassicSignallingManager::GetChannelSetupStatistics() const {
+  return channel_setup_statistics_;
 }
 
 void ClassicSignallingManager::OnConnectionRequest(SignalId signal_id, Psm psm, Cid remote_cid) {
@@ -232,6 +253,7 @@ void ClassicSignallingManager::on_security_result_for_incoming(
     LOG_WARN("Can't allocate dynamic channel");
     return;
   }
+  channel_setup_started_[new_channel->GetCid()] = std::chrono::steady_clock::now();
   send_connection_response(
       signal_id,
       remote_cid,
@@ -244,37 +266,34 @@ void ClassicSignallingManager::on_security_result_for_incoming(
 
 void ClassicSignallingManager::OnConnectionResponse(SignalId signal_id, Cid remote_cid, Cid cid,
                                                     ConnectionResponseResult result, ConnectionResponseStatus status) {
-  if (command_just_sent_.signal_id_ != signal_id ||
-      command_just_sent_.command_code_ != CommandCode::CONNECTION_REQUEST) {
-    LOG_WARN("Unexpected response: no pending request. Expected signal id %d type %s, got %d",
-             command_just_sent_.signal_id_.Value(), CommandCodeText(command_just_sent_.command_code_).data(),
-             signal_id.Value());
+  auto outstanding_command = find_outstanding_command(signal_id, CommandCode::CONNECTION_REQUEST);
+  if (outstanding_command == nullptr) {
     return;
   }
-  if (command_just_sent_.source_cid_ != cid) {
-    LOG_WARN("SCID doesn't match: expected %d, received %d", command_just_sent_.source_cid_, cid);
-    handle_send_next_command();
+  if (outstanding_command->command_.source_cid_ != cid) {
+    LOG_WARN("SCID doesn't match: expected %d, received %d", outstanding_command->command_.source_cid_, cid);
+    complete_command(signal_id);
     return;
   }
   if (result == ConnectionResponseResult::PENDING) {
-    alarm_.Schedule(common::BindOnce(&ClassicSignallingManager::on_command_timeout, common::Unretained(this)),
-                    kTimeout);
+    outstanding_command->alarm_->Schedule(
+        common::BindOnce(&ClassicSignallingManager::on_command_timeout, common::Unretained(this), signal_id),
+        kTimeout);
     return;
   }
 
-  command_just_sent_.signal_id_ = kInvalidSignalId;
-  alarm_.Cancel();
+  Psm pending_psm = outstanding_command->command_.psm_;
+  complete_command(signal_id);
   if (result != ConnectionResponseResult::SUCCESS) {
     DynamicChannelManager::ConnectionResult connection_result{
         .connection_result_code = DynamicChannelManager::ConnectionResultCode::FAIL_L2CAP_ERROR,
         .hci_error = hci::ErrorCode::SUCCESS,
         .l2cap_connection_response_result = result,
     };
+    channel_setup_started_.erase(cid);
     link_->OnOutgoingConnectionRequestFail(cid, connection_result);
-    handle_send_next_command();
     return;
   }
-  Psm pending_psm = command_just_sent_.psm_;
   auto new_channel = link_->AllocateReservedDynamicChannel(cid, pending_psm, remote_cid);
   if (new_channel == nullptr) {
     LOG_WARN("Can't allocate dynamic channel");
@@ -283,8 +302,8 @@ void ClassicSignallingManager::OnConnectionResponse(SignalId signal_id, Cid remo
         .hci_error = hci::ErrorCode::SUCCESS,
         .l2cap_connection_response_result = ConnectionResponseResult::NO_RESOURCES_AVAILABLE,
     };
+    channel_setup_started_.erase(cid);
     link_->OnOutgoingConnectionRequestFail(cid, connection_result);
-    handle_send_next_command();
     return;
   }
 
@@ -374,6 +393,7 @@ void ClassicSignallingManager::OnConfigurationRequest(SignalId signal_id, Cid ci
     configuration_state.state_ = ChannelConfigurationState::State::CONFIGURED;
     data_pipeline_manager_->AttachChannel(cid, channel, l2cap::internal::DataPipelineManager::ChannelMode::BASIC);
     data_pipeline_manager_->UpdateClassicConfiguration(cid, configuration_state);
+    on_channel_configured(cid, channel->GetPsm());
   } else if (configuration_state.state_ == ChannelConfigurationState::State::WAIT_CONFIG_REQ_RSP) {
     configuration_state.state_ = ChannelConfigurationState::State::WAIT_CONFIG_RSP;
   }
@@ -495,18 +515,15 @@ void ClassicSignallingManager::negotiate_configuration(Cid cid, Continuation is_
 void ClassicSignallingManager::OnConfigurationResponse(SignalId signal_id, Cid cid, Continuation is_continuation,
                                                        ConfigurationResponseResult result,
                                                        std::vector<std::unique_ptr<ConfigurationOption>> options) {
-  if (command_just_sent_.signal_id_ != signal_id ||
-      command_just_sent_.command_code_ != CommandCode::CONFIGURATION_REQUEST) {
-    LOG_WARN("Unexpected response: no pending request. Expected signal id %d type %s, got %d",
-             command_just_sent_.signal_id_.Value(), CommandCodeText(command_just_sent_.command_code_).data(),
-             signal_id.Value());
+  auto outstanding_command = find_outstanding_command(signal_id, CommandCode::CONFIGURATION_REQUEST);
+  if (outstanding_command == nullptr) {
     return;
   }
 
   auto channel = channel_allocator_->FindChannelByCid(cid);
   if (channel == nullptr) {
     LOG_WARN("Configuration request for an unknown channel");
-    handle_send_next_command();
+    complete_command(signal_id);
     return;
   }
 
@@ -516,20 +533,19 @@ void ClassicSignallingManager::OnConfigurationResponse(SignalId signal_id, Cid c
     case ConfigurationResponseResult::UNKNOWN_OPTIONS:
     case ConfigurationResponseResult::FLOW_SPEC_REJECTED:
       LOG_WARN("Configuration response not SUCCESS: %s", ConfigurationResponseResultText(result).c_str());
-      alarm_.Cancel();
-      handle_send_next_command();
+      complete_command(signal_id);
       return;
 
     case ConfigurationResponseResult::PENDING:
-      alarm_.Schedule(common::BindOnce(&ClassicSignallingManager::on_command_timeout, common::Unretained(this)),
-                      kTimeout);
+      outstanding_command->alarm_->Schedule(
+          common::BindOnce(&ClassicSignallingManager::on_command_timeout, common::Unretained(this), signal_id),
+          kTimeout);
       return;
 
     case ConfigurationResponseResult::UNACCEPTABLE_PARAMETERS:
       LOG_INFO("Configuration response with unacceptable parameters");
-      alarm_.Cancel();
+      complete_command(signal_id);
       negotiate_configuration(cid, is_continuation, std::move(options));
-      handle_send_next_command();
       return;
 
     case ConfigurationResponseResult::SUCCESS:
@@ -549,9 +565,8 @@ void ClassicSignallingManager::OnConfigurationResponse(SignalId signal_id, Cid c
       case ConfigurationOptionType::RETRANSMISSION_AND_FLOW_CONTROL: {
         auto config = RetransmissionAndFlowControlConfigurationOption::Specialize(option.get());
         if (configuration_state.retransmission_and_flow_control_mode_ != config->mode_) {
+          complete_command(signal_id);
           SendDisconnectionRequest(cid, channel->GetRemoteCid());
-          alarm_.Cancel();
-          handle_send_next_command();
           return;
         }
         configuration_state.local_retransmission_and_flow_control_ = *config;
@@ -563,8 +578,7 @@ void ClassicSignallingManager::OnConfigurationResponse(SignalId signal_id, Cid c
       }
       default:
         LOG_WARN("Received some unsupported configuration option: %d", static_cast<int>(option->type_));
-        alarm_.Cancel();
-        handle_send_next_command();
+        complete_command(signal_id);
         return;
     }
   }
@@ -579,12 +593,12 @@ void ClassicSignallingManager::OnConfigurationResponse(SignalId signal_id, Cid c
     configuration_state.state_ = ChannelConfigurationState::State::CONFIGURED;
     data_pipeline_manager_->AttachChannel(cid, channel, l2cap::internal::DataPipelineManager::ChannelMode::BASIC);
     data_pipeline_manager_->UpdateClassicConfiguration(cid, configuration_state);
+    on_channel_configured(cid, channel->GetPsm());
   } else if (configuration_state.state_ == ChannelConfigurationState::State::WAIT_CONFIG_REQ_RSP) {
     configuration_state.state_ = ChannelConfigurationState::State::WAIT_CONFIG_REQ;
   }
 
-  alarm_.Cancel();
-  handle_send_next_command();
+  complete_command(signal_id);
 }
 
 void ClassicSignallingManager::OnDisconnectionRequest(SignalId signal_id, Cid cid, Cid remote_cid) {
@@ -603,23 +617,18 @@ void ClassicSignallingManager::OnDisconnectionRequest(SignalId signal_id, Cid ci
   }
   link_->FreeDynamicChannel(cid);
   channel_configuration_.erase(cid);
+  channel_setup_started_.erase(cid);
 }
 
 void ClassicSignallingManager::OnDisconnectionResponse(SignalId signal_id, Cid remote_cid, Cid cid) {
-  if (command_just_sent_.signal_id_ != signal_id ||
-      command_just_sent_.command_code_ != CommandCode::DISCONNECTION_REQUEST) {
-    LOG_WARN("Unexpected response: no pending request. Expected signal id %d type %s, got %d",
-             command_just_sent_.signal_id_.Value(), CommandCodeText(command_just_sent_.command_code_).data(),
-             signal_id.Value());
+  if (find_outstanding_command(signal_id, CommandCode::DISCONNECTION_REQUEST) == nullptr) {
     return;
   }
 
-  alarm_.Cancel();
-
   auto channel = channel_allocator_->FindChannelByCid(cid);
   if (channel == nullptr) {
     LOG_WARN("Disconnect response for an unknown channel");
-    handle_send_next_command();
+    complete_command(signal_id);
     return;
   }
 
@@ -629,8 +638,9 @@ void ClassicSignallingManager::OnDisconnectionResponse(SignalId signal_id, Cid r
     data_pipeline_manager_->DetachChannel(cid);
   }
   link_->FreeDynamicChannel(cid);
-  handle_send_next_command();
   channel_configuration_.erase(cid);
+  channel_setup_started_.erase(cid);
+  complete_command(signal_id);
 }
 
 void ClassicSignallingManager::OnEchoRequest(SignalId signal_id, const PacketView<kLittleEndian>& packet) {
@@ -642,15 +652,11 @@ void ClassicSignallingManager::OnEchoRequest(SignalId signal_id, const PacketVie
 }
 
 void ClassicSignallingManager::OnEchoResponse(SignalId signal_id, const PacketView<kLittleEndian>& packet) {
-  if (command_just_sent_.signal_id_ != signal_id || command_just_sent_.command_code_ != CommandCode::ECHO_REQUEST) {
-    LOG_WARN("Unexpected response: no pending request. Expected signal id %d type %s, got %d",
-             command_just_sent_.signal_id_.Value(), CommandCodeText(command_just_sent_.command_code_).data(),
-             signal_id.Value());
+  if (find_outstanding_command(signal_id, CommandCode::ECHO_REQUEST) == nullptr) {
     return;
   }
   LOG_INFO("Echo response received");
-  alarm_.Cancel();
-  handle_send_next_command();
+  complete_command(signal_id);
 }
 
 void ClassicSignallingManager::OnInformationRequest(SignalId signal_id, InformationRequestInfoType type) {
@@ -678,11 +684,7 @@ void ClassicSignallingManager::OnInformationRequest(SignalId signal_id, Informat
 }
 
 void ClassicSignallingManager::OnInformationResponse(SignalId signal_id, const InformationResponseView& response) {
-  if (command_just_sent_.signal_id_ != signal_id ||
-      command_just_sent_.command_code_ != CommandCode::INFORMATION_REQUEST) {
-    LOG_WARN("Unexpected response: no pending request. Expected signal id %d type %s, got %d",
-             command_just_sent_.signal_id_.Value(), CommandCodeText(command_just_sent_.command_code_).data(),
-             signal_id.Value());
+  if (find_outstanding_command(signal_id, CommandCode::INFORMATION_REQUEST) == nullptr) {
     return;
   }
 
@@ -718,8 +720,7 @@ void ClassicSignallingManager::OnInformationResponse(SignalId signal_id, const I
     }
   }
 
-  alarm_.Cancel();
-  handle_send_next_command();
+  complete_command(signal_id);
 }
 
 void ClassicSignallingManager::on_incoming_packet() {
@@ -885,30 +886,41 @@ void ClassicSignallingManager::send_connection_response(SignalId signal_id, Cid
   enqueue_buffer_->Enqueue(std::move(builder), handler_);
 }
 
-void ClassicSignallingManager::on_command_timeout() {
-  LOG_WARN("Response time out");
-  if (command_just_sent_.signal_id_ == kInvalidSignalId) {
-    LOG_ERROR("No pending command");
+void ClassicSignallingManager::on_command_timeout(SignalId signal_id) {
+  auto outstanding_command = std::find_if(
+      outstanding_commands_.begin(), outstanding_commands_.end(), [signal_id](const OutstandingCommand& command) {
+        return command.command_.signal_id_ == signal_id;
+      });
+  if (outstanding_command == outstanding_commands_.end()) {
+    LOG_ERROR("No pending command with signal id %d", signal_id.Value());
     return;
   }
-  LOG_WARN("Response time out for %s", CommandCodeText(command_just_sent_.command_code_).c_str());
-  switch (command_just_sent_.command_code_) {
+  // The alarm is not deleted while it runs this timeout
+  auto alarm = std::move(outstanding_command->alarm_);
+  PendingCommand command = std::move(outstanding_command->command_);
+  outstanding_commands_.erase(outstanding_command);
+
+  LOG_WARN("Response time out for %s", CommandCodeText(command.command_code_).c_str());
+  switch (command.command_code_) {
     case CommandCode::CONNECTION_REQUEST: {
       DynamicChannelManager::ConnectionResult connection_result{
           .connection_result_code = DynamicChannelManager::ConnectionResultCode::FAIL_L2CAP_ERROR,
           .hci_error = hci::ErrorCode::SUCCESS,
           .l2cap_connection_response_result = ConnectionResponseResult::NO_RESOURCES_AVAILABLE,
       };
-      link_->OnOutgoingConnectionRequestFail(command_just_sent_.source_cid_, connection_result);
+      channel_setup_started_.erase(command.source_cid_);
+      link_->OnOutgoingConnectionRequestFail(command.source_cid_, connection_result);
       break;
     }
     case CommandCode::CONFIGURATION_REQUEST: {
-      auto channel = channel_allocator_->FindChannelByRemoteCid(command_just_sent_.destination_cid_);
-      SendDisconnectionRequest(channel->GetCid(), channel->GetRemoteCid());
-      return;
+      auto channel = channel_allocator_->FindChannelByRemoteCid(command.destination_cid_);
+      if (channel != nullptr) {
+        SendDisconnectionRequest(channel->GetCid(), channel->GetRemoteCid());
+      }
+      break;
     }
     case CommandCode::INFORMATION_REQUEST: {
-      if (command_just_sent_.info_type_ == InformationRequestInfoType::EXTENDED_FEATURES_SUPPORTED) {
+      if (command.info_type_ == InformationRequestInfoType::EXTENDED_FEATURES_SUPPORTED) {
         link_->OnRemoteExtendedFeatureReceived(false, false);
       }
       break;
@@ -916,56 +928,126 @@ void ClassicSignallingManager::on_command_timeout() {
     default:
       break;
   }
-  handle_send_next_command();
+  send_pending_commands();
 }
 
-void ClassicSignallingManager::handle_send_next_command() {
-  command_just_sent_.signal_id_ = kInvalidSignalId;
-  if (pending_commands_.empty()) {
-    return;
+ClassicSignallingManager::OutstandingCommand* ClassicSignallingManager::find_outstanding_command(
+    SignalId signal_id, CommandCode command_code) {
+  for (auto& outstanding_command : outstanding_commands_) {
+    if (outstanding_command.command_.signal_id_ == signal_id &&
+        outstanding_command.command_.command_code_ == command_code) {
+      return &outstanding_command;
+    }
   }
-  command_just_sent_ = std::move(pending_commands_.front());
-  pending_commands_.pop();
+  LOG_WARN(
+      "Unexpected response: no pending request. Expected type %s, got signal id %d",
+      CommandCodeText(command_code).c_str(),
+      signal_id.Value());
+  return nullptr;
+}
 
-  auto signal_id = command_just_sent_.signal_id_;
-  auto psm = command_just_sent_.psm_;
-  auto source_cid = command_just_sent_.source_cid_;
-  auto destination_cid = command_just_sent_.destination_cid_;
-  auto info_type = command_just_sent_.info_type_;
-  auto config = std::move(command_just_sent_.config_);
-  switch (command_just_sent_.command_code_) {
+void ClassicSignallingManager::queue_command(PendingCommand pending_command) {
+  pending_commands_.push_back(std::move(pending_command));
+  send_pending_commands();
+}
+
+void ClassicSignallingManager::complete_command(SignalId signal_id) {
+  outstanding_commands_.remove_if(
+      [signal_id](const OutstandingCommand& command) { return command.command_.signal_id_ == signal_id; });
+  send_pending_commands();
+}
+
+bool ClassicSignallingManager::has_outstanding_command_for_channel(const PendingCommand& pending_command) const {
+  for (const auto& outstanding_command : outstanding_commands_) {
+    const auto& command = outstanding_command.command_;
+    if ((pending_command.source_cid_ != kInvalidCid && pending_command.source_cid_ == command.source_cid_) ||
+        (pending_command.destination_cid_ != kInvalidCid &&
+         pending_command.destination_cid_ == command.destination_cid_)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+SignalId ClassicSignallingManager::allocate_signal_id() {
+  // The identifier of an outstanding request is not reused until its response is received
+  auto is_outstanding = [this](SignalId signal_id) {
+    return std::any_of(
+        outstanding_commands_.begin(), outstanding_commands_.end(), [signal_id](const OutstandingCommand& command) {
+          return command.command_.signal_id_ == signal_id;
+        });
+  };
+  while (is_outstanding(next_signal_id_)) {
+    next_signal_id_++;
+  }
+  return next_signal_id_++;
+}
+
+void ClassicSignallingManager::send_pending_commands() {
+  auto pending_command = pending_commands_.begin();
+  while (pending_command != pending_commands_.end() && outstanding_commands_.size() < kMaxOutstandingCommands) {
+    if (has_outstanding_command_for_channel(*pending_command)) {
+      pending_command++;
+      continue;
+    }
+    outstanding_commands_.push_back({std::move(*pending_command), std::make_unique<os::Alarm>(handler_)});
+    pending_command = pending_commands_.erase(pending_command);
+    if (!send_command(&outstanding_commands_.back())) {
+      outstanding_commands_.pop_back();
+    }
+  }
+}
+
+bool ClassicSignallingManager::send_command(OutstandingCommand* outstanding_command) {
+  auto& command = outstanding_command->command_;
+  command.signal_id_ = allocate_signal_id();
+  switch (command.command_code_) {
     case CommandCode::CONNECTION_REQUEST: {
-      auto builder = ConnectionRequestBuilder::Create(signal_id.Value(), psm, source_cid);
+      auto builder = ConnectionRequestBuilder::Create(command.signal_id_.Value(), command.psm_, command.source_cid_);
       enqueue_buffer_->Enqueue(std::move(builder), handler_);
-      alarm_.Schedule(common::BindOnce(&ClassicSignallingManager::on_command_timeout, common::Unretained(this)),
-                      kTimeout);
       break;
     }
     case CommandCode::CONFIGURATION_REQUEST: {
-      auto builder =
-          ConfigurationRequestBuilder::Create(signal_id.Value(), destination_cid, Continuation::END, std::move(config));
+      auto builder = ConfigurationRequestBuilder::Create(
+          command.signal_id_.Value(), command.destination_cid_, Continuation::END, std::move(command.config_));
       enqueue_buffer_->Enqueue(std::move(builder), handler_);
-      alarm_.Schedule(common::BindOnce(&ClassicSignallingManager::on_command_timeout, common::Unretained(this)),
-                      kTimeout);
       break;
     }
     case CommandCode::DISCONNECTION_REQUEST: {
-      auto builder = DisconnectionRequestBuilder::Create(signal_id.Value(), destination_cid, source_cid);
+      auto builder = DisconnectionRequestBuilder::Create(
+          command.signal_id_.Value(), command.destination_cid_, command.source_cid_);
       enqueue_buffer_->Enqueue(std::move(builder), handler_);
-      alarm_.Schedule(common::BindOnce(&ClassicSignallingManager::on_command_timeout, common::Unretained(this)),
-                      kTimeout);
       break;
     }
     case CommandCode::INFORMATION_REQUEST: {
-      auto builder = InformationRequestBuilder::Create(signal_id.Value(), info_type);
+      auto builder = InformationRequestBuilder::Create(command.signal_id_.Value(), command.info_type_);
       enqueue_buffer_->Enqueue(std::move(builder), handler_);
-      alarm_.Schedule(common::BindOnce(&ClassicSignallingManager::on_command_timeout, common::Unretained(this)),
-                      kTimeout);
       break;
     }
     default:
-      LOG_WARN("Unsupported command code 0x%x", static_cast<int>(command_just_sent_.command_code_));
+      LOG_WARN("Unsupported command code 0x%x", static_cast<int>(command.command_code_));
+      return false;
+  }
+  outstanding_command->alarm_->Schedule(
+      common::BindOnce(&ClassicSignallingManager::on_command_timeout, common::Unretained(this), command.signal_id_),
+      kTimeout);
+  return true;
+}
+
+void ClassicSignallingManager::on_channel_configured(Cid cid, Psm psm) {
+  auto started = channel_setup_started_.find(cid);
+  if (started == channel_setup_started_.end()) {
+    return;
   }
+  auto time_to_ready =
+      std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started->second);
+  channel_setup_started_.erase(started);
+
+  auto& statistics = channel_setup_statistics_[psm];
+  statistics.channels_++;
+  statistics.total_time_to_ready_ += time_to_ready;
+  statistics.max_time_to_ready_ = std::max(statistics.max_time_to_ready_, time_to_ready);
+  LOG_INFO("Channel psm:0x%x cid:0x%x ready in %d ms", psm, cid, static_cast<int>(time_to_ready.count()));
 }
 
 }  // namespace internal
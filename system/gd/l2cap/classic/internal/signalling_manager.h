@@ -16,8 +16,12 @@
 
 #pragma once
 
+#include <chrono>
 #include <cstdint>
-#include <queue>
+#include <deque>
+#include <list>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include "l2cap/cid.h"
@@ -54,6 +58,17 @@ class Link;
 
 class ClassicSignallingManager {
  public:
+  // Requests outstanding at once on a link. Requests for different channels are sent without waiting for each other's
+  // response, and a request waits while another request for the same channel is outstanding.
+  static constexpr size_t kMaxOutstandingCommands = 4;
+
+  // Time from the connection request to the configured channel
+  struct ChannelSetupStatistics {
+    uint32_t channels_ = 0;
+    std::chrono::milliseconds total_time_to_ready_{0};
+    std::chrono::milliseconds max_time_to_ready_{0};
+  };
+
   ClassicSignallingManager(os::Handler* handler, Link* link,
                            l2cap::internal::DataPipelineManager* data_pipeline_manager,
                            classic::internal::DynamicChannelServiceManagerImpl* dynamic_service_manager,
@@ -76,6 +91,9 @@ class ClassicSignallingManager {
 
   void CancelAlarm();
 
+  // Channel setup statistics of this link, by PSM
+  std::unordered_map<Psm, ChannelSetupStatistics> GetChannelSetupStatistics() const;
+
   void OnConnectionRequest(SignalId signal_id, Psm psm, Cid remote_cid);
 
   void OnConnectionResponse(SignalId signal_id, Cid remote_cid, Cid cid, ConnectionResponseResult result,
@@ -110,8 +128,20 @@ class ClassicSignallingManager {
   void handle_one_command(ControlView control_view);
   void send_connection_response(SignalId signal_id, Cid remote_cid, Cid local_cid, ConnectionResponseResult result,
                                 ConnectionResponseStatus status);
-  void on_command_timeout();
-  void handle_send_next_command();
+  struct OutstandingCommand {
+    PendingCommand command_;
+    std::unique_ptr<os::Alarm> alarm_;
+  };
+
+  void on_command_timeout(SignalId signal_id);
+  OutstandingCommand* find_outstanding_command(SignalId signal_id, CommandCode command_code);
+  void queue_command(PendingCommand pending_command);
+  void complete_command(SignalId signal_id);
+  void send_pending_commands();
+  bool send_command(OutstandingCommand* outstanding_command);
+  bool has_outstanding_command_for_channel(const PendingCommand& pending_command) const;
+  SignalId allocate_signal_id();
+  void on_channel_configured(Cid cid, Psm psm);
 
   void negotiate_configuration(Cid cid, Continuation is_continuation,
                                std::vector<std::unique_ptr<ConfigurationOption>>);
@@ -127,11 +157,12 @@ class ClassicSignallingManager {
   l2cap::internal::DynamicChannelAllocator* channel_allocator_;
   FixedChannelServiceManagerImpl* fixed_service_manager_;
   std::unique_ptr<os::EnqueueBuffer<packet::BasePacketBuilder>> enqueue_buffer_;
-  std::queue<PendingCommand> pending_commands_;
-  PendingCommand command_just_sent_;
-  os::Alarm alarm_;
+  std::deque<PendingCommand> pending_commands_;
+  std::list<OutstandingCommand> outstanding_commands_;
   SignalId next_signal_id_ = kInitialSignalId;
   std::unordered_map<Cid, ChannelConfigurationState> channel_configuration_;
+  std::unordered_map<Cid, std::chrono::steady_clock::time_point> channel_setup_started_;
+  std::unordered_map<Psm, ChannelSetupStatistics> channel_setup_statistics_;
 };
 
 }  // namespace internal
@@ -16,15 +16,26 @@
 
 #include "l2cap/classic/internal/signalling_manager.h"
 
+#include "hci/acl_manager_mock.h"
+#include "l2cap/classic/internal/dynamic_channel_service_impl_mock.h"
 #include "l2cap/classic/internal/dynamic_channel_service_manager_impl_mock.h"
 #include "l2cap/classic/internal/fixed_channel_service_manager_impl_mock.h"
-#include "l2cap/classic/internal/link_mock.h"
+#include "l2cap/classic/internal/link.h"
 #include "l2cap/internal/parameter_provider_mock.h"
+#include "l2cap/l2cap_packets.h"
+#include "os/queue.h"
 
+#include <gmock/gmock-nice-strict.h>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <vector>
+
 using ::testing::_;
+using ::testing::NiceMock;
 using ::testing::Return;
 
 namespace bluetooth {
@@ -33,6 +44,37 @@ namespace classic {
 namespace internal {
 namespace {
 
+constexpr Psm kPsm = 123;
+constexpr Cid kLocalCid = 0x40;
+constexpr Cid kRemoteCid = 0x50;
+constexpr Cid kOtherLocalCid = 0x41;
+constexpr Cid kOtherRemoteCid = 0x51;
+constexpr auto kNoPacketWait = std::chrono::milliseconds(100);
+constexpr auto kPacketWait = std::chrono::seconds(1);
+// The response timeout of the signalling manager, with some margin
+constexpr auto kTimeoutWait = std::chrono::seconds(5);
+
+using classic::internal::testing::MockDynamicChannelServiceImpl;
+using classic::internal::testing::MockDynamicChannelServiceManagerImpl;
+using classic::internal::testing::MockFixedChannelServiceManagerImpl;
+using hci::testing::MockClassicAclConnection;
+using l2cap::internal::testing::MockParameterProvider;
+
+packet::PacketView<packet::kLittleEndian> GetPacketView(std::unique_ptr<packet::BasePacketBuilder> packet) {
+  auto bytes = std::make_shared<std::vector<uint8_t>>();
+  packet::BitInserter i(*bytes);
+  bytes->reserve(packet->size());
+  packet->Serialize(i);
+  return packet::PacketView<packet::kLittleEndian>(bytes);
+}
+
+struct SentCommand {
+  CommandCode code_;
+  uint8_t signal_id_;
+  // Source cid of a disconnection request, destination cid of a configuration request
+  Cid cid_;
+};
+
 class L2capClassicSignallingManagerTest : public ::testing::Test {
  public:
   static void SyncHandler(os::Handler* handler) {
@@ -46,20 +88,188 @@ class L2capClassicSignallingManagerTest : public ::testing::Test {
   void SetUp() override {
     thread_ = new os::Thread("test_thread", os::Thread::Priority::NORMAL);
     l2cap_handler_ = new os::Handler(thread_);
+
+    raw_acl_connection_ = new NiceMock<MockClassicAclConnection>();
+    link_ = new Link(l2cap_handler_, std::unique_ptr<MockClassicAclConnection>(raw_acl_connection_),
+                     &mock_parameter_provider_, &mock_dynamic_service_manager_, &mock_fixed_service_manager_, nullptr);
+    raw_acl_connection_->acl_queue_.GetDownEnd()->RegisterDequeue(
+        l2cap_handler_, common::Bind(&L2capClassicSignallingManagerTest::on_outgoing_packet, common::Unretained(this)));
+    incoming_buffer_ = std::make_unique<os::EnqueueBuffer<packet::PacketView<packet::kLittleEndian>>>(
+        raw_acl_connection_->acl_queue_.GetDownEnd());
   }
 
   void TearDown() override {
+    RunOnL2capThread([this] {
+      incoming_buffer_.reset();
+      raw_acl_connection_->acl_queue_.GetDownEnd()->UnregisterDequeue();
+    });
+    delete link_;
+
     l2cap_handler_->Clear();
     delete l2cap_handler_;
     delete thread_;
   }
 
+  // Link and signalling manager run on the L2CAP thread
+  void RunOnL2capThread(std::function<void()> task) {
+    std::promise<void> promise;
+    auto future = promise.get_future();
+    l2cap_handler_->Post(common::BindOnce(
+        [](std::function<void()> task, std::promise<void>* promise) {
+          task();
+          promise->set_value();
+        },
+        std::move(task),
+        common::Unretained(&promise)));
+    future.wait();
+  }
+
+  bool WaitForSentCommands(size_t count, std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return sent_commands_cv_.wait_for(lock, timeout, [this, count] { return sent_commands_.size() >= count; });
+  }
+
+  SentCommand GetSentCommand(size_t index) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sent_commands_.at(index);
+  }
+
+  void RejectCommand(uint8_t signal_id) {
+    auto reject = CommandRejectNotUnderstoodBuilder::Create(signal_id);
+    auto packet = GetPacketView(BasicFrameBuilder::Create(kClassicSignallingCid, std::move(reject)));
+    incoming_buffer_->Enqueue(std::make_unique<packet::PacketView<packet::kLittleEndian>>(packet), l2cap_handler_);
+  }
+
   os::Thread* thread_ = nullptr;
   os::Handler* l2cap_handler_ = nullptr;
+
+  MockClassicAclConnection* raw_acl_connection_ = nullptr;
+  NiceMock<MockParameterProvider> mock_parameter_provider_;
+  MockFixedChannelServiceManagerImpl mock_fixed_service_manager_;
+  MockDynamicChannelServiceManagerImpl mock_dynamic_service_manager_;
+  Link* link_ = nullptr;
+
+ private:
+  void on_outgoing_packet() {
+    auto packet = GetPacketView(raw_acl_connection_->acl_queue_.GetDownEnd()->TryDequeue());
+    auto basic_frame_view = BasicFrameView::Create(packet);
+    if (!basic_frame_view.IsValid() || basic_frame_view.GetChannelId() != kClassicSignallingCid) {
+      return;
+    }
+    auto control_view = ControlView::Create(basic_frame_view.GetPayload());
+    ASSERT_TRUE(control_view.IsValid());
+    SentCommand command{control_view.GetCode(), control_view.GetIdentifier(), kInvalidCid};
+    if (command.code_ == CommandCode::DISCONNECTION_REQUEST) {
+      auto disconnection_request_view = DisconnectionRequestView::Create(control_view);
+      ASSERT_TRUE(disconnection_request_view.IsValid());
+      command.cid_ = disconnection_request_view.GetSourceCid();
+    } else if (command.code_ == CommandCode::CONFIGURATION_REQUEST) {
+      auto configuration_request_view = ConfigurationRequestView::Create(control_view);
+      ASSERT_TRUE(configuration_request_view.IsValid());
+      command.cid_ = configuration_request_view.GetDestinationCid();
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    sent_commands_.push_back(command);
+    sent_commands_cv_.notify_all();
+  }
+
+  std::unique_ptr<os::EnqueueBuffer<packet::PacketView<packet::kLittleEndian>>> incoming_buffer_;
+  std::mutex mutex_;
+  std::condition_variable sent_commands_cv_;
+  std::vector<SentCommand> sent_commands_;
 };
 
 TEST_F(L2capClassicSignallingManagerTest, precondition) {}
 
+TEST_F(L2capClassicSignallingManagerTest, requests_for_different_channels_are_outstanding_together) {
+  RunOnL2capThread([this] {
+    link_->SendDisconnectionRequest(kLocalCid, kRemoteCid);
+    link_->SendDisconnectionRequest(kOtherLocalCid, kOtherRemoteCid);
+  });
+
+  ASSERT_TRUE(WaitForSentCommands(2, kPacketWait));
+  auto first = GetSentCommand(0);
+  auto second = GetSentCommand(1);
+  EXPECT_EQ(CommandCode::DISCONNECTION_REQUEST, first.code_);
+  EXPECT_EQ(kLocalCid, first.cid_);
+  EXPECT_EQ(CommandCode::DISCONNECTION_REQUEST, second.code_);
+  EXPECT_EQ(kOtherLocalCid, second.cid_);
+  EXPECT_NE(first.signal_id_, second.signal_id_);
+}
+
+TEST_F(L2capClassicSignallingManagerTest, requests_for_the_same_channel_are_serialized) {
+  RunOnL2capThread([this] {
+    link_->SendDisconnectionRequest(kLocalCid, kRemoteCid);
+    link_->SendDisconnectionRequest(kLocalCid, kRemoteCid);
+  });
+
+  ASSERT_TRUE(WaitForSentCommands(1, kPacketWait));
+  ASSERT_FALSE(WaitForSentCommands(2, kNoPacketWait));
+
+  RejectCommand(GetSentCommand(0).signal_id_);
+  ASSERT_TRUE(WaitForSentCommands(2, kPacketWait));
+  EXPECT_EQ(kLocalCid, GetSentCommand(1).cid_);
+  EXPECT_NE(GetSentCommand(0).signal_id_, GetSentCommand(1).signal_id_);
+}
+
+TEST_F(L2capClassicSignallingManagerTest, signal_id_of_outstanding_request_is_not_reused) {
+  RunOnL2capThread([this] { link_->SendDisconnectionRequest(kLocalCid, kRemoteCid); });
+  ASSERT_TRUE(WaitForSentCommands(1, kPacketWait));
+  auto outstanding_signal_id = GetSentCommand(0).signal_id_;
+
+  // Go through all the identifiers while the first request stays outstanding
+  for (size_t i = 1; i <= 256; i++) {
+    RunOnL2capThread([this] { link_->SendInformationRequest(InformationRequestInfoType::CONNECTIONLESS_MTU); });
+    ASSERT_TRUE(WaitForSentCommands(i + 1, kPacketWait));
+    auto command = GetSentCommand(i);
+    ASSERT_EQ(CommandCode::INFORMATION_REQUEST, command.code_);
+    ASSERT_NE(outstanding_signal_id, command.signal_id_);
+    RejectCommand(command.signal_id_);
+  }
+}
+
+TEST_F(L2capClassicSignallingManagerTest, configuration_requests_not_sent_yet_are_merged) {
+  MockDynamicChannelServiceImpl service;
+  EXPECT_CALL(mock_dynamic_service_manager_, GetService(kPsm)).WillRepeatedly(Return(&service));
+
+  Cid local_cid = kInvalidCid;
+  RunOnL2capThread([this, &local_cid] {
+    local_cid = link_->AllocateDynamicChannel(kPsm, kRemoteCid)->GetCid();
+    link_->OnRemoteExtendedFeatureReceived(false, false);
+    link_->SendInitialConfigRequestOrQueue(local_cid);
+    link_->SendInitialConfigRequestOrQueue(local_cid);
+    link_->SendInitialConfigRequestOrQueue(local_cid);
+  });
+
+  ASSERT_TRUE(WaitForSentCommands(1, kPacketWait));
+  ASSERT_FALSE(WaitForSentCommands(2, kNoPacketWait));
+  EXPECT_EQ(CommandCode::CONFIGURATION_REQUEST, GetSentCommand(0).code_);
+  EXPECT_EQ(kRemoteCid, GetSentCommand(0).cid_);
+
+  // The second and the third request went out as one
+  RejectCommand(GetSentCommand(0).signal_id_);
+  ASSERT_TRUE(WaitForSentCommands(2, kPacketWait));
+  EXPECT_EQ(CommandCode::CONFIGURATION_REQUEST, GetSentCommand(1).code_);
+  EXPECT_EQ(kRemoteCid, GetSentCommand(1).cid_);
+  RejectCommand(GetSentCommand(1).signal_id_);
+  ASSERT_FALSE(WaitForSentCommands(3, kNoPacketWait));
+}
+
+TEST_F(L2capClassicSignallingManagerTest, response_timeout_sends_the_waiting_request) {
+  RunOnL2capThread([this] {
+    link_->SendDisconnectionRequest(kLocalCid, kRemoteCid);
+    link_->SendDisconnectionRequest(kLocalCid, kRemoteCid);
+  });
+
+  ASSERT_TRUE(WaitForSentCommands(1, kPacketWait));
+  ASSERT_FALSE(WaitForSentCommands(2, kNoPacketWait));
+
+  // No response to the first request
+  ASSERT_TRUE(WaitForSentCommands(2, kTimeoutWait));
+  EXPECT_EQ(CommandCode::DISCONNECTION_REQUEST, GetSentCommand(1).code_);
+  EXPECT_EQ(kLocalCid, GetSentCommand(1).cid_);
+}
+
 }  // namespace
 }  // namespace internal
 }  // namespace classic
@@ -23,38 +23,37 @@
 #include "common/callback.h"
 #include "os/handler.h"
 #include "os/thread.h"
+#include "os/timer_service.h"
 #include "os/utils.h"
 
 namespace bluetooth {
 namespace os {
 
-// A single-shot alarm for reactor-based thread, implemented by Linux timerfd.
-// When it's constructed, it will register a reactable on the specified thread; when it's destroyed, it will unregister
-// itself from the thread.
+// A single-shot alarm for reactor-based thread. The alarms of a handler share a single Linux timerfd, registered on
+// the thread of the handler when its first alarm is constructed.
 class Alarm {
  public:
-  // Create and register a single-shot alarm on a given handler
+  // Create a single-shot alarm on a given handler
   explicit Alarm(Handler* handler);
 
   Alarm(const Alarm&) = delete;
   Alarm& operator=(const Alarm&) = delete;
 
-  // Unregister this alarm from the thread and release resource
+  // Cancel this alarm
   ~Alarm();
 
   // Schedule the alarm with given delay
   void Schedule(common::OnceClosure task, std::chrono::milliseconds delay);
 
+  // Schedule the alarm with given delay, allowing it to fire up to |slack| late so that it can share a wakeup with
+  // another alarm of the handler
+  void Schedule(common::OnceClosure task, std::chrono::milliseconds delay, std::chrono::milliseconds slack);
+
   // Cancel the alarm. No-op if it's not armed.
   void Cancel();
 
  private:
-  common::OnceClosure task_;
-  Handler* handler_;
-  int fd_ = 0;
-  Reactor::Reactable* token_;
-  mutable std::mutex mutex_;
-  void on_fire();
+  TimerService* timer_service_;
 };
 
 }  // namespace os
@@ -17,6 +17,7 @@
 #include <chrono>
 #include <future>
 #include <unordered_map>
+#include <vector>
 
 #include "benchmark/benchmark.h"
 #include "common/bind.h"
@@ -140,3 +141,35 @@ BENCHMARK_REGISTER_F(BM_ReactableAlarm, periodic_accuracy)
     ->Args({2000, 15, 20})
     ->Iterations(1)
     ->UseRealTime();
+
+// Many alarms of one handler spread over 100 ms, as many ERTM channels would arm, with the slack given in milliseconds
+BENCHMARK_DEFINE_F(BM_ReactableAlarm, many_alarms_wakeups)(State& state) {
+  constexpr int kNumAlarms = 100;
+  auto slack = std::chrono::milliseconds(state.range(0));
+  std::vector<std::unique_ptr<Alarm>> alarms;
+  for (int i = 0; i < kNumAlarms; i++) {
+    alarms.push_back(std::make_unique<Alarm>(handler_.get()));
+  }
+  auto wakeups_before = handler_->GetTimerStatistics().wakeups;
+  for (auto _ : state) {
+    scheduled_tasks_ = kNumAlarms;
+    task_counter_ = 0;
+    promise_ = std::promise<void>();
+    start_time_ = std::chrono::steady_clock::now();
+    for (int i = 0; i < kNumAlarms; i++) {
+      alarms[i]->Schedule(
+          Bind(
+              &BM_ReactableAlarm_many_alarms_wakeups_Benchmark::AlarmSleepAndCountDelayedTime,
+              bluetooth::common::Unretained(this)),
+          std::chrono::milliseconds(i),
+          slack);
+    }
+    promise_.get_future().get();
+  }
+  auto statistics = handler_->GetTimerStatistics();
+  state.counters["wakeups_per_iteration"] =
+      static_cast<double>(statistics.wakeups - wakeups_before) / state.iterations();
+  state.counters["wakeups_per_second"] = statistics.wakeups_per_second;
+};
+
+BENCHMARK_REGISTER_F(BM_ReactableAlarm, many_alarms_wakeups)->Arg(0)->Arg(5)->Arg(20)->Iterations(10)->UseRealTime();
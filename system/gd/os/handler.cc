@@ -74,6 +74,22 @@ void Handler::WaitUntilStopped(std::chrono::milliseconds timeout) {
   ASSERT(thread_->GetReactor()->WaitForUnregisteredReactable(timeout));
 }
 
+TimerService::Statistics Handler::GetTimerStatistics() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (timer_service_ == nullptr) {
+    return TimerService::Statistics{};
+  }
+  return timer_service_->GetStatistics();
+}
+
+TimerService* Handler::get_timer_service() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (timer_service_ == nullptr) {
+    timer_service_ = std::make_unique<TimerService>(thread_);
+  }
+  return timer_service_.get();
+}
+
 void Handler::handle_next_event() {
   common::OnceClosure closure;
   {
@@ -25,6 +25,7 @@
 #include "common/callback.h"
 #include "common/contextual_callback.h"
 #include "os/thread.h"
+#include "os/timer_service.h"
 #include "os/utils.h"
 
 namespace bluetooth {
@@ -53,6 +54,9 @@ class Handler : public common::IPostableContext {
   // Die if the current reactable doesn't stop before the timeout.  Must be called after Clear()
   void WaitUntilStopped(std::chrono::milliseconds timeout);
 
+  // Statistics of the timers of the alarms on this handler
+  TimerService::Statistics GetTimerStatistics() const;
+
   template <typename Functor, typename... Args>
   void Call(Functor&& functor, Args&&... args) {
     Post(common::BindOnce(std::forward<Functor>(functor), std::forward<Args>(args)...));
@@ -105,8 +109,11 @@ class Handler : public common::IPostableContext {
   Thread* thread_;
   std::unique_ptr<Reactor::Event> event_;
   Reactor::Reactable* reactable_;
+  // Created with the first alarm, shared by all the alarms on this handler
+  std::unique_ptr<TimerService> timer_service_;
   mutable std::mutex mutex_;
   void handle_next_event();
+  TimerService* get_timer_service();
 };
 
 }  // namespace os
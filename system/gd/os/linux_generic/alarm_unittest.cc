@@ -17,6 +17,7 @@
 #include "os/alarm.h"
 
 #include <future>
+#include <vector>
 
 #include "common/bind.h"
 #include "gtest/gtest.h"
@@ -49,10 +50,11 @@ class AlarmTest : public ::testing::Test {
   void fake_timer_advance(uint64_t ms) {
     handler_->Post(common::BindOnce(fake_timerfd_advance, ms));
   }
+
   Alarm* alarm_;
+  Handler* handler_;
 
  private:
-  Handler* handler_;
   Thread* thread_;
 };
 
@@ -99,6 +101,66 @@ TEST_F(AlarmTest, delete_while_alarm_armed) {
   std::this_thread::sleep_for(std::chrono::milliseconds(10));
 }
 
+TEST_F(AlarmTest, alarms_fire_in_deadline_order) {
+  Alarm second_alarm(handler_);
+  Alarm third_alarm(handler_);
+  std::vector<int> fired;
+  std::promise<void> promise;
+  auto future = promise.get_future();
+  auto record = [](std::vector<int>* fired, int alarm) { fired->push_back(alarm); };
+  third_alarm.Schedule(
+      BindOnce(&std::promise<void>::set_value, common::Unretained(&promise)), std::chrono::milliseconds(30));
+  alarm_->Schedule(BindOnce(record, &fired, 1), std::chrono::milliseconds(10));
+  second_alarm.Schedule(BindOnce(record, &fired, 2), std::chrono::milliseconds(20));
+  ASSERT_EQ(3ul, handler_->GetTimerStatistics().armed_timers);
+
+  fake_timer_advance(10);
+  fake_timer_advance(10);
+  fake_timer_advance(10);
+  future.get();
+  ASSERT_EQ(std::vector<int>({1, 2}), fired);
+
+  auto statistics = handler_->GetTimerStatistics();
+  ASSERT_EQ(0ul, statistics.armed_timers);
+  ASSERT_EQ(3ul, statistics.wakeups);
+  ASSERT_EQ(3ul, statistics.fired_timers);
+}
+
+TEST_F(AlarmTest, slack_coalesces_wakeups) {
+  Alarm second_alarm(handler_);
+  bool first_fired = false;
+  std::promise<void> promise;
+  auto future = promise.get_future();
+  alarm_->Schedule(
+      BindOnce([](bool* fired) { *fired = true; }, &first_fired),
+      std::chrono::milliseconds(10),
+      std::chrono::milliseconds(10));
+  second_alarm.Schedule(
+      BindOnce(&std::promise<void>::set_value, common::Unretained(&promise)), std::chrono::milliseconds(15));
+
+  fake_timer_advance(10);
+  fake_timer_advance(5);
+  future.get();
+  ASSERT_TRUE(first_fired);
+  ASSERT_EQ(1ul, handler_->GetTimerStatistics().wakeups);
+  ASSERT_EQ(2ul, handler_->GetTimerStatistics().fired_timers);
+}
+
+TEST_F(AlarmTest, cancel_alarm_due_in_same_wakeup) {
+  Alarm second_alarm(handler_);
+  Alarm third_alarm(handler_);
+  std::promise<void> promise;
+  auto future = promise.get_future();
+  alarm_->Schedule(BindOnce(&Alarm::Cancel, common::Unretained(&second_alarm)), std::chrono::milliseconds(10));
+  second_alarm.Schedule(BindOnce([]() { ASSERT_TRUE(false) << "Should not happen"; }), std::chrono::milliseconds(10));
+  third_alarm.Schedule(
+      BindOnce(&std::promise<void>::set_value, common::Unretained(&promise)), std::chrono::milliseconds(10));
+
+  fake_timer_advance(10);
+  future.get();
+  ASSERT_EQ(2ul, handler_->GetTimerStatistics().fired_timers);
+}
+
 }  // namespace
 }  // namespace os
 }  // namespace bluetooth
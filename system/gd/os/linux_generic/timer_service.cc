@@ -0,0 +1,169 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "os/timer_service.h"
+
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "common/bind.h"
+#include "os/linux_generic/linux.h"
+#include "os/log.h"
+#include "os/utils.h"
+
+#ifdef OS_ANDROID
+#define ALARM_CLOCK CLOCK_BOOTTIME_ALARM
+#else
+#define ALARM_CLOCK CLOCK_BOOTTIME
+#endif
+
+namespace bluetooth {
+namespace os {
+using common::Closure;
+using common::OnceClosure;
+
+TimerService::TimerService(Thread* thread)
+    : thread_(thread), fd_(TIMERFD_CREATE(ALARM_CLOCK, TFD_NONBLOCK)), created_at_(Now()) {
+  ASSERT_LOG(fd_ != -1, "cannot create timerfd: %s", strerror(errno));
+
+  token_ = thread_->GetReactor()->Register(
+      fd_, common::Bind(&TimerService::on_fire, common::Unretained(this)), Closure());
+}
+
+TimerService::~TimerService() {
+  thread_->GetReactor()->Unregister(token_);
+
+  int close_status;
+  RUN_NO_INTR(close_status = TIMERFD_CLOSE(fd_));
+  ASSERT(close_status != -1);
+}
+
+TimerService::TimePoint TimerService::Now() {
+#ifdef USE_FAKE_TIMERS
+  return TimePoint(fake_timer::fake_timerfd_get_clock());
+#else
+  timespec now;
+  clock_gettime(CLOCK_BOOTTIME, &now);
+  return TimePoint(now.tv_sec * 1000 + now.tv_nsec / 1000000);
+#endif
+}
+
+void TimerService::Schedule(
+    Key key, OnceClosure task, std::chrono::milliseconds delay, std::chrono::milliseconds slack) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  cancel_locked(key);
+
+  TimePoint deadline = Now() + delay;
+  Timer& timer = timers_[key];
+  timer.task = std::move(task);
+  timer.sequence = next_sequence_++;
+  timer.deadline = deadlines_.emplace(deadline, key);
+  timer.latest = latest_.emplace(deadline + slack, key);
+  arm_locked();
+}
+
+void TimerService::Cancel(Key key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  cancel_locked(key);
+  arm_locked();
+}
+
+void TimerService::cancel_locked(Key key) {
+  auto timer = timers_.find(key);
+  if (timer == timers_.end()) {
+    return;
+  }
+  deadlines_.erase(timer->second.deadline);
+  latest_.erase(timer->second.latest);
+  timers_.erase(timer);
+}
+
+void TimerService::arm_locked() {
+  TimePoint wake_at = latest_.empty() ? TimePoint(0) : latest_.begin()->first;
+  if (wake_at == armed_for_) {
+    return;
+  }
+
+  itimerspec timer_itimerspec{/* disarm timer */};
+  if (wake_at != TimePoint(0)) {
+    // A zero delay would disarm the timer, so deadlines that already passed are set one millisecond away
+    long delay_ms = std::max<long>((wake_at - Now()).count(), 1);
+    timer_itimerspec.it_value = {delay_ms / 1000, delay_ms % 1000 * 1000000};
+  }
+  int result = TIMERFD_SETTIME(fd_, 0, &timer_itimerspec, nullptr);
+  ASSERT(result == 0);
+  armed_for_ = wake_at;
+}
+
+TimerService::Statistics TimerService::GetStatistics() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::chrono::duration<double> uptime = Now() - created_at_;
+  return Statistics{
+      .armed_timers = timers_.size(),
+      .wakeups = wakeups_,
+      .fired_timers = fired_timers_,
+      .wakeups_per_second = uptime.count() > 0 ? wakeups_ / uptime.count() : 0,
+  };
+}
+
+void TimerService::on_fire() {
+  std::vector<std::pair<Key, uint64_t>> due;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t times_invoked;
+    auto bytes_read = read(fd_, &times_invoked, sizeof(uint64_t));
+    if (bytes_read != static_cast<ssize_t>(sizeof(uint64_t))) {
+      // The timer was rearmed between its expiration and this read
+      return;
+    }
+    wakeups_++;
+
+    // The clock may be read back slightly before the time the timer was armed for
+    TimePoint now = std::max(Now(), armed_for_);
+    armed_for_ = TimePoint(0);
+    for (auto it = deadlines_.begin(); it != deadlines_.end() && it->first <= now; it++) {
+      due.emplace_back(it->second, timers_[it->second].sequence);
+    }
+  }
+
+  // Timers are fired one at a time, so a task cancelling or rescheduling a timer due in this same wakeup takes effect.
+  // Timers scheduled by the tasks are left for the next wakeup.
+  for (const auto& [key, sequence] : due) {
+    OnceClosure task;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto timer = timers_.find(key);
+      if (timer == timers_.end() || timer->second.sequence != sequence) {
+        continue;
+      }
+      task = std::move(timer->second.task);
+      cancel_locked(key);
+      fired_timers_++;
+    }
+    std::move(task).Run();
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  arm_locked();
+}
+
+}  // namespace os
+}  // namespace bluetooth
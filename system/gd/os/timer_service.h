@@ -0,0 +1,97 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
+#include "common/callback.h"
+#include "os/reactor.h"
+#include "os/thread.h"
+
+namespace bluetooth {
+namespace os {
+
+// Timers of all the alarms of a handler, multiplexed on a single Linux timerfd registered with the thread.
+//
+// Each timer has a deadline and a slack: it may fire up to slack after its deadline. The timerfd is armed for the
+// earliest time at which one of the timers can no longer wait, and every timer whose deadline has passed then fires
+// in the same wakeup.
+class TimerService {
+ public:
+  using Key = const void*;
+
+  struct Statistics {
+    size_t armed_timers;
+    uint64_t wakeups;
+    uint64_t fired_timers;
+    double wakeups_per_second;
+  };
+
+  explicit TimerService(Thread* thread);
+
+  TimerService(const TimerService&) = delete;
+  TimerService& operator=(const TimerService&) = delete;
+
+  // Unregister the timerfd from the thread and release resource
+  ~TimerService();
+
+  // Arm the timer identified by |key|, replacing the task and deadline it was armed with
+  void Schedule(Key key, common::OnceClosure task, std::chrono::milliseconds delay, std::chrono::milliseconds slack);
+
+  // Disarm the timer identified by |key|. No-op if it's not armed.
+  void Cancel(Key key);
+
+  Statistics GetStatistics() const;
+
+ private:
+  using TimePoint = std::chrono::milliseconds;
+
+  struct Timer {
+    common::OnceClosure task;
+    // Tells apart successive schedules of the same key
+    uint64_t sequence;
+    std::multimap<TimePoint, Key>::iterator deadline;
+    std::multimap<TimePoint, Key>::iterator latest;
+  };
+
+  static TimePoint Now();
+  void cancel_locked(Key key);
+  void arm_locked();
+  void on_fire();
+
+  Thread* thread_;
+  int fd_ = 0;
+  Reactor::Reactable* token_;
+  std::unordered_map<Key, Timer> timers_;
+  // Armed timers ordered by deadline, and by deadline plus slack
+  std::multimap<TimePoint, Key> deadlines_;
+  std::multimap<TimePoint, Key> latest_;
+  // Time the timerfd is armed for, zero when disarmed
+  TimePoint armed_for_{0};
+  const TimePoint created_at_;
+  uint64_t next_sequence_ = 0;
+  uint64_t wakeups_ = 0;
+  uint64_t fired_timers_ = 0;
+  mutable std::mutex mutex_;
+};
+
+}  // namespace os
+}  // namespace bluetooth
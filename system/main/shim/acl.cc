@@ -33,6 +33,7 @@
 #include "device/include/controller.h"
 #include "gd/common/bidi_queue.h"
 #include "gd/common/bind.h"
+#include "gd/common/connection_timeline.h"
 #include "gd/common/init_flags.h"
 #include "gd/common/strings.h"
 #include "gd/common/sync_map_count.h"
@@ -64,6 +65,7 @@
 #include "stack/include/btm_status.h"
 #include "stack/include/gatt_api.h"
 #include "stack/include/pan_api.h"
+#include "stack/include/sdp_api.h"
 #include "stack/include/sec_hci_link_interface.h"
 #include "stack/l2cap/l2c_int.h"
 #include "types/ble_address_with_type.h"
@@ -633,6 +635,8 @@ class ClassicShimAclConnection
   }
 
   void OnReadRemoteSupportedFeaturesComplete(uint64_t features) override {
+    common::ConnectionTimeline::GetInstance().Record(
+        handle_, common::ConnectionMilestone::REMOTE_FEATURES);
     TRY_POSTING_ON_MAIN(interface_.on_read_remote_supported_features_complete,
                         handle_, features);
 
@@ -1235,13 +1239,56 @@ void DumpsysRecord(int fd) {
 }
 #undef DUMPSYS_TAG
 
+#define DUMPSYS_TAG "shim::legacy::timeline"
+void DumpsysConnectionTimeline(int fd) {
+  LOG_DUMPSYS_TITLE(fd, DUMPSYS_TAG);
+  const auto& timeline = common::ConnectionTimeline::GetInstance();
+
+  for (const auto& statistics : timeline.GetStatistics()) {
+    LOG_DUMPSYS(
+        fd,
+        "%s %-20s count:%-5zu p50:%5lldms p90:%5lldms p99:%5lldms max:%5lldms",
+        statistics.incoming ? "incoming" : "outgoing",
+        common::ConnectionMilestoneText(statistics.milestone).c_str(),
+        statistics.count, static_cast<long long>(statistics.p50.count()),
+        static_cast<long long>(statistics.p90.count()),
+        static_cast<long long>(statistics.p99.count()),
+        static_cast<long long>(statistics.max.count()));
+  }
+
+  for (const auto& connection : timeline.GetTimelines()) {
+    std::string milestones;
+    for (size_t i = 0; i < common::kNumConnectionMilestones; i++) {
+      if (!connection.milestones[i].has_value()) continue;
+      milestones += base::StringPrintf(
+          " %s:%lldms",
+          common::ConnectionMilestoneText(
+              static_cast<common::ConnectionMilestone>(i))
+              .c_str(),
+          static_cast<long long>(connection.milestones[i]->count()));
+    }
+    if (connection.disconnected.has_value()) {
+      milestones += base::StringPrintf(
+          " disconnected:%lldms",
+          static_cast<long long>(connection.disconnected->count()));
+    }
+    LOG_DUMPSYS(fd, "%s handle:0x%04x %s%s",
+                PRIVATE_ADDRESS(connection.address), connection.handle,
+                connection.incoming ? "incoming" : "outgoing",
+                milestones.c_str());
+  }
+}
+#undef DUMPSYS_TAG
+
 void shim::legacy::Acl::Dump(int fd) const {
   PAN_Dumpsys(fd);
+  SDP_Dumpsys(fd);
   DumpsysHid(fd);
   DumpsysRecord(fd);
   DumpsysAcl(fd);
   DumpsysL2cap(fd);
   DumpsysBtm(fd);
+  DumpsysConnectionTimeline(fd);
 }
 
 shim::legacy::Acl::Acl(os::Handler* handler,
@@ -1370,6 +1417,11 @@ void shim::legacy::Acl::IgnoreLeConnectionFrom(
                    address_with_type);
 }
 
+void shim::legacy::Acl::ReportLeAdvertisement(
+    const hci::AddressWithType& address_with_type, int8_t rssi) {
+  GetAclManager()->ReportLeAdvertisement(address_with_type, rssi);
+}
+
 void shim::legacy::Acl::OnClassicLinkDisconnected(HciHandle handle,
                                                   hci::ErrorCode reason) {
   hci::Address remote_address =
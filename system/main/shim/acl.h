@@ -76,6 +76,8 @@ class Acl : public hci::acl_manager::ConnectionCallbacks,
                               std::promise<bool> promise) override;
   void IgnoreLeConnectionFrom(
       const hci::AddressWithType& address_with_type) override;
+  void ReportLeAdvertisement(const hci::AddressWithType& address_with_type,
+                             int8_t rssi);
   void DisconnectClassic(uint16_t handle, tHCI_REASON reason,
                          std::string comment) override;
   void DisconnectLe(uint16_t handle, tHCI_REASON reason,
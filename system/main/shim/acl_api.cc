@@ -57,6 +57,12 @@ void bluetooth::shim::ACL_IgnoreLeConnectionFrom(
       ToAddressWithTypeFromLegacy(legacy_address_with_type));
 }
 
+void bluetooth::shim::ACL_ReportLeAdvertisement(
+    const tBLE_BD_ADDR& legacy_address_with_type, int8_t rssi) {
+  Stack::GetInstance()->GetAcl()->ReportLeAdvertisement(
+      ToAddressWithTypeFromLegacy(legacy_address_with_type), rssi);
+}
+
 void bluetooth::shim::ACL_WriteData(uint16_t handle, BT_HDR* p_buf) {
   std::unique_ptr<bluetooth::packet::RawBuilder> packet = MakeUniquePacket(
       p_buf->data + p_buf->offset + HCI_DATA_PREAMBLE_SIZE,
@@ -30,6 +30,7 @@
 #include "hci/le_acl_connection_interface.h"
 #include "hci/vendor_specific_event_manager.h"
 #include "main/shim/hci_layer.h"
+#include "main/shim/helpers.h"
 #include "main/shim/shim.h"
 #include "main/shim/stack.h"
 #include "osi/include/allocator.h"
@@ -281,13 +282,8 @@ static bluetooth::os::EnqueueBuffer<bluetooth::hci::ScoBuilder>*
 
 static std::unique_ptr<bluetooth::packet::RawBuilder> MakeUniquePacket(
     const uint8_t* data, size_t len) {
-  bluetooth::packet::RawBuilder builder;
-  std::vector<uint8_t> bytes(data, data + len);
-
-  auto payload = std::make_unique<bluetooth::packet::RawBuilder>();
-  payload->AddOctets(bytes);
-
-  return payload;
+  return std::make_unique<bluetooth::packet::RawBuilder>(
+      std::vector<uint8_t>(data, data + len));
 }
 
 static BT_HDR* WrapPacketAndCopy(
@@ -360,31 +356,32 @@ static void transmit_command(const BT_HDR* command,
 
   // little endian command opcode
   uint16_t command_op_code = (data[1] << 8 | data[0]);
-  // Gd stack API requires opcode specification and calculates length, so
-  // no need to provide opcode or length here.
-  data += (kCommandOpcodeSize + kCommandLengthSize);
-  len -= (kCommandOpcodeSize + kCommandLengthSize);
-
   auto op_code = static_cast<const bluetooth::hci::OpCode>(command_op_code);
 
-  auto payload = MakeUniquePacket(data, len);
-  auto packet =
-      bluetooth::hci::CommandBuilder::Create(op_code, std::move(payload));
-
   LOG_DEBUG("Sending command %s", bluetooth::hci::OpCodeText(op_code).c_str());
 
   if (bluetooth::hci::Checker::IsCommandStatusOpcode(op_code)) {
+    // The command is handed back to the status callback, so the parameters
+    // have to be copied. Gd stack API requires opcode specification and
+    // calculates length, so no need to provide opcode or length here.
+    data += (kCommandOpcodeSize + kCommandLengthSize);
+    len -= (kCommandOpcodeSize + kCommandLengthSize);
+    auto packet = bluetooth::hci::CommandBuilder::Create(
+        op_code, MakeUniquePacket(data, len));
     auto command_unique = std::make_unique<OsiObject>(command);
     bluetooth::shim::GetHciLayer()->EnqueueCommand(
         std::move(packet), bluetooth::shim::GetGdShimHandler()->BindOnce(
                                OnTransmitPacketStatus, status_callback, context,
                                std::move(command_unique)));
   } else {
+    // Nothing refers to the command after it is sent: the packet takes
+    // ownership of the buffer and serializes the parameters from it.
+    auto packet = bluetooth::hci::CommandBuilder::Create(
+        op_code, std::make_unique<bluetooth::LegacyCommandPayload>(command));
     bluetooth::shim::GetHciLayer()->EnqueueCommand(
         std::move(packet),
         bluetooth::shim::GetGdShimHandler()->BindOnce(
             OnTransmitPacketCommandComplete, complete_callback, context));
-    osi_free(const_cast<void*>(static_cast<const void*>(command)));
   }
 }
 
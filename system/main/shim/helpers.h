@@ -16,6 +16,9 @@
 #pragma once
 
 #include "gd/common/init_flags.h"
+#include "gd/os/log.h"
+#include "gd/packet/base_packet_builder.h"
+#include "gd/packet/bit_inserter.h"
 #include "gd/packet/raw_builder.h"
 #include "hci/address_with_type.h"
 #include "osi/include/allocator.h"
@@ -107,14 +110,47 @@ inline tBLE_BD_ADDR ToLegacyAddressWithType(
 
 inline std::unique_ptr<bluetooth::packet::RawBuilder> MakeUniquePacket(
     const uint8_t* data, size_t len, bool is_flushable) {
-  bluetooth::packet::RawBuilder builder;
-  std::vector<uint8_t> bytes(data, data + len);
-  auto payload = std::make_unique<bluetooth::packet::RawBuilder>();
-  payload->AddOctets(bytes);
+  auto payload = std::make_unique<bluetooth::packet::RawBuilder>(
+      std::vector<uint8_t>(data, data + len));
   payload->SetFlushable(is_flushable);
   return payload;
 }
 
+// Parameters of a legacy HCI command, serialized straight out of the BT_HDR
+// built by stack/hcic instead of being copied into a RawBuilder first. The
+// builder takes ownership of the buffer and frees it when it is destroyed,
+// once the gd HCI layer is done with the command.
+class LegacyCommandPayload : public bluetooth::packet::BasePacketBuilder {
+ public:
+  // Size of the opcode and parameter length, which the gd CommandBuilder
+  // writes itself.
+  static constexpr size_t kCommandHeaderSize = 3;
+
+  explicit LegacyCommandPayload(const BT_HDR* command) : command_(command) {
+    ASSERT(command_ != nullptr);
+    ASSERT(command_->len >= kCommandHeaderSize);
+  }
+  LegacyCommandPayload(const LegacyCommandPayload&) = delete;
+  LegacyCommandPayload& operator=(const LegacyCommandPayload&) = delete;
+  ~LegacyCommandPayload() override {
+    osi_free(const_cast<void*>(static_cast<const void*>(command_)));
+  }
+
+  size_t size() const override { return command_->len - kCommandHeaderSize; }
+
+  void Serialize(bluetooth::packet::BitInserter& it) const override {
+    const uint8_t* begin =
+        command_->data + command_->offset + kCommandHeaderSize;
+    const uint8_t* end = begin + size();
+    for (const uint8_t* p = begin; p != end; p++) {
+      it.insert_byte(*p);
+    }
+  }
+
+ private:
+  const BT_HDR* command_;
+};
+
 inline BT_HDR* MakeLegacyBtHdrPacket(
     std::unique_ptr<bluetooth::hci::PacketView<bluetooth::hci::kLittleEndian>>
         packet,
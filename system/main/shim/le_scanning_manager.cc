@@ -128,6 +128,8 @@ extern void btif_dm_update_ble_remote_properties(const RawAddress& bd_addr,
 extern void btm_ble_process_adv_addr(RawAddress& raw_address,
                                      tBLE_ADDR_TYPE* address_type);
 
+extern void btm_ble_bgconn_process_adv(const RawAddress& bd_addr, int8_t rssi);
+
 using bluetooth::shim::BleScannerInterfaceImpl;
 
 void BleScannerInterfaceImpl::Init() {
@@ -420,6 +422,9 @@ void BleScannerInterfaceImpl::OnScanResult(
 
   if (ble_addr_type != BLE_ADDR_ANONYMOUS) {
     btm_ble_process_adv_addr(raw_address, &ble_addr_type);
+    if (event_type & (1 << BLE_EVT_CONNECTABLE_BIT)) {
+      btm_ble_bgconn_process_adv(raw_address, rssi);
+    }
   }
 
   do_in_jni_thread(
@@ -158,5 +158,10 @@ void LogMetricBluetoothLEConnectionMetricEvent(
   bluetooth::os::LogMetricBluetoothLEConnectionMetricEvent(address, origin_type, connection_type, transaction_state, argument_list);
 }
 
+void LogConnectionMilestone(uint16_t handle,
+                            common::ConnectionMilestone milestone) {
+  common::ConnectionTimeline::GetInstance().Record(handle, milestone);
+}
+
 }  // namespace shim
 }  // namespace bluetooth
\ No newline at end of file
@@ -21,6 +21,7 @@
 #include <frameworks/proto_logging/stats/enums/bluetooth/le/enums.pb.h>
 
 #include <unordered_map>
+#include "gd/common/connection_timeline.h"
 #include "types/raw_address.h"
 #include "metrics/metrics_state.h"
 
@@ -218,5 +219,15 @@ void LogMetricBluetoothLEConnectionMetricEvent(
     android::bluetooth::le::LeConnectionType connection_type,
     android::bluetooth::le::LeConnectionState transaction_state,
     std::vector<std::pair<os::ArgumentType, int>> argument_list);
+
+/**
+ * Record that a connection reached a milestone of its establishment in the
+ * connection timeline
+ *
+ * @param handle connection handle of the connection
+ * @param milestone milestone that was reached
+ */
+void LogConnectionMilestone(uint16_t handle,
+                            common::ConnectionMilestone milestone);
 }  // namespace shim
 }  // namespace bluetooth
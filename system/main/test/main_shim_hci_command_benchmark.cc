@@ -0,0 +1,102 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstring>
+#include <vector>
+
+#include "hci/hci_packets.h"
+#include "internal_include/bt_target.h"
+#include "main/shim/helpers.h"
+#include "osi/include/allocator.h"
+#include "packet/bit_inserter.h"
+#include "packet/raw_builder.h"
+#include "stack/include/bt_hdr.h"
+#include "stack/include/hcidefs.h"
+
+using ::benchmark::State;
+using bluetooth::hci::CommandBuilder;
+using bluetooth::hci::OpCode;
+using bluetooth::packet::BitInserter;
+using bluetooth::packet::RawBuilder;
+
+namespace {
+
+constexpr uint8_t kAcceptListParams[] = {0x00, 0x11, 0x22, 0x33,
+                                         0x44, 0x55, 0x66};
+
+// An LE Add Device To Accept List command, allocated and filled the way
+// btu_hcif_send_cmd_with_cb() does for the stack/hcic commands.
+BT_HDR* MakeLegacyCommand() {
+  BT_HDR* p = static_cast<BT_HDR*>(osi_malloc(HCI_CMD_BUF_SIZE));
+  uint8_t* pp = reinterpret_cast<uint8_t*>(p + 1);
+  p->len = HCIC_PREAMBLE_SIZE + sizeof(kAcceptListParams);
+  p->offset = 0;
+  UINT16_TO_STREAM(pp, HCI_BLE_ADD_ACCEPTLIST);
+  UINT8_TO_STREAM(pp, sizeof(kAcceptListParams));
+  memcpy(pp, kAcceptListParams, sizeof(kAcceptListParams));
+  return p;
+}
+
+// What the gd HCI layer does with the command when it is sent.
+void Send(std::unique_ptr<CommandBuilder> packet, std::vector<uint8_t>* bytes) {
+  bytes->clear();
+  BitInserter bi(*bytes);
+  packet->Serialize(bi);
+}
+
+// The path the shim used to take for every command: the parameters are
+// copied into a vector, then again into a RawBuilder, and the legacy buffer
+// is freed. Status commands still take a single copy.
+void BM_HciCommandCopied(State& state) {
+  std::vector<uint8_t> bytes;
+  for (auto _ : state) {
+    BT_HDR* command = MakeLegacyCommand();
+    const uint8_t* data = command->data + command->offset + HCIC_PREAMBLE_SIZE;
+    size_t len = command->len - HCIC_PREAMBLE_SIZE;
+    std::vector<uint8_t> params(data, data + len);
+    auto payload = std::make_unique<RawBuilder>();
+    payload->AddOctets(params);
+    Send(CommandBuilder::Create(OpCode::LE_ADD_DEVICE_TO_FILTER_ACCEPT_LIST,
+                                std::move(payload)),
+         &bytes);
+    osi_free(command);
+  }
+  state.counters["commands_per_second"] =
+      benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+}
+
+// Complete commands: the packet adopts the legacy buffer.
+void BM_HciCommandAdopted(State& state) {
+  std::vector<uint8_t> bytes;
+  for (auto _ : state) {
+    Send(CommandBuilder::Create(
+             OpCode::LE_ADD_DEVICE_TO_FILTER_ACCEPT_LIST,
+             std::make_unique<bluetooth::LegacyCommandPayload>(
+                 MakeLegacyCommand())),
+         &bytes);
+  }
+  state.counters["commands_per_second"] =
+      benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_HciCommandCopied);
+BENCHMARK(BM_HciCommandAdopted);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -492,6 +492,32 @@ TEST_F(MainShimTest, helpers) {
   } while (++reason != 0);
 }
 
+TEST_F(MainShimTest, legacy_command_payload) {
+  // HCI_Write_Page_Timeout with a 0x2000 timeout, built the way stack/hcic
+  // builds commands: behind an offset in the BT_HDR.
+  const std::vector<uint8_t> command_bytes = {0x18, 0x0c, 0x02, 0x00, 0x20};
+  const uint16_t offset = 8;
+  BT_HDR* command = static_cast<BT_HDR*>(
+      osi_calloc(sizeof(BT_HDR) + offset + command_bytes.size()));
+  command->offset = offset;
+  command->len = command_bytes.size();
+  std::copy(command_bytes.begin(), command_bytes.end(),
+            command->data + offset);
+
+  auto payload = std::make_unique<LegacyCommandPayload>(command);
+  ASSERT_EQ(2UL, payload->size());
+
+  auto packet = hci::CommandBuilder::Create(hci::OpCode::WRITE_PAGE_TIMEOUT,
+                                            std::move(payload));
+  std::vector<uint8_t> bytes;
+  packet::BitInserter bi(bytes);
+  packet->Serialize(bi);
+  ASSERT_EQ(command_bytes, bytes);
+
+  // The packet owns the buffer, which is freed with it.
+  packet.reset();
+}
+
 TEST_F(MainShimTest, connect_and_disconnect) {
   hci::Address address({0x11, 0x22, 0x33, 0x44, 0x55, 0x66});
 
@@ -308,6 +308,8 @@ tA2DP_STATUS A2DP_FindService(uint16_t service_uuid, const RawAddress& bd_addr,
               PRIVATE_ADDRESS(bd_addr), service_uuid);
     return A2DP_FAIL;
   }
+  /* the stream endpoint record rarely changes, reconnect from the cache */
+  a2dp_cb.find.p_db->use_cache = true;
 
   /* store service_uuid */
   a2dp_cb.find.service_uuid = service_uuid;
@@ -133,6 +133,8 @@ uint16_t AVRC_FindService(uint16_t service_uuid, const RawAddress& bd_addr,
                                p_db->num_attr, p_db->p_attrs);
 
   if (result) {
+    p_db->p_db->use_cache = true;
+
     /* store service_uuid and discovery db pointer */
     avrc_cb.p_db = p_db->p_db;
     avrc_cb.service_uuid = service_uuid;
@@ -233,6 +233,20 @@ void BTM_AcceptlistRemove(const RawAddress& address) {
   return;
 }
 
+/** Lets the LE connection manager learn when devices waiting in the
+ * acceptlist advertise, so it can prioritize them and tune its scan
+ * parameters. Only connectable advertisements should be reported. */
+void btm_ble_bgconn_process_adv(const RawAddress& bd_addr, int8_t rssi) {
+  tBTM_SEC_DEV_REC* p_dev_rec = btm_find_dev(bd_addr);
+  if (p_dev_rec == NULL ||
+      !(p_dev_rec->ble.in_controller_list & BTM_ACCEPTLIST_BIT)) {
+    return;
+  }
+
+  bluetooth::shim::ACL_ReportLeAdvertisement(
+      convert_to_address_with_type(bd_addr, p_dev_rec), rssi);
+}
+
 /** Clear the acceptlist, end any pending acceptlist connections */
 void BTM_AcceptlistClear() {
   if (!controller_get_interface()->supports_ble()) {
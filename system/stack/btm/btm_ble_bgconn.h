@@ -28,6 +28,10 @@ extern void BTM_AcceptlistRemove(const RawAddress& address);
 /** Clear the acceptlist, end any pending acceptlist connections */
 extern void BTM_AcceptlistClear();
 
+/** Reports a connectable advertisement from |bd_addr| to the LE connection
+ * manager if the device is waiting in the acceptlist */
+extern void btm_ble_bgconn_process_adv(const RawAddress& bd_addr, int8_t rssi);
+
 /* Use fast scan window/interval for LE connection establishment.
  * This does not send any requests to controller, instead it changes the
  * parameters that will be used after next add/remove request.
@@ -71,6 +71,7 @@ extern void btm_ble_adv_filter_init(void);
 extern void btm_clear_all_pending_le_entry(void);
 extern const tBLE_BD_ADDR convert_to_address_with_type(
     const RawAddress& bd_addr, const tBTM_SEC_DEV_REC* p_dev_rec);
+extern void btm_ble_bgconn_process_adv(const RawAddress& bd_addr, int8_t rssi);
 
 #define BTM_EXT_BLE_RMT_NAME_TIMEOUT_MS (30 * 1000)
 #define MIN_ADV_LENGTH 2
@@ -2537,7 +2538,7 @@ void btm_clear_all_pending_le_entry(void) {
     if ((p_ent->in_use) &&
         (p_ent->inq_info.results.device_type == BT_DEVICE_TYPE_BLE) &&
         !p_ent->scan_rsp)
-      p_ent->in_use = false;
+      btm_cb.btm_inq_vars.inq_db_index.Release(p_ent);
   }
 }
 
@@ -2755,6 +2756,10 @@ void btm_ble_process_adv_pkt_cont(uint16_t evt_type, tBLE_ADDR_TYPE addr_type,
   tBTM_INQUIRY_VAR_ST* p_inq = &btm_cb.btm_inq_vars;
   bool update = true;
 
+  if (ble_evt_type_is_connectable(evt_type)) {
+    btm_ble_bgconn_process_adv(bda, rssi);
+  }
+
   std::vector<uint8_t> tmp;
   if (data_len != 0) tmp.insert(tmp.begin(), data, data + data_len);
 
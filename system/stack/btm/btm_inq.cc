@@ -831,6 +831,8 @@ void btm_inq_db_init(void) {
   btm_cb.btm_inq_vars.remote_name_timer =
       alarm_new("btm_inq.remote_name_timer");
   btm_cb.btm_inq_vars.no_inc_ssp = BTM_NO_SSP_ON_INQUIRY;
+  btm_cb.btm_inq_vars.inq_db_index.Reset(btm_cb.btm_inq_vars.inq_db,
+                                         BTM_INQ_DB_SIZE);
 }
 
 void btm_inq_db_free(void) {
@@ -903,13 +905,14 @@ void btm_clr_inq_db(const RawAddress* p_bda) {
   BTM_TRACE_DEBUG("btm_clr_inq_db: inq_active:0x%x state:%d",
                   btm_cb.btm_inq_vars.inq_active, btm_cb.btm_inq_vars.state);
 #endif
-  for (xx = 0; xx < BTM_INQ_DB_SIZE; xx++, p_ent++) {
-    if (p_ent->in_use) {
-      /* If this is the specified BD_ADDR or clearing all devices */
-      if (p_bda == NULL || (p_ent->inq_info.results.remote_bd_addr == *p_bda)) {
-        p_ent->in_use = false;
-      }
+  if (p_bda != NULL) {
+    p_ent = p_inq->inq_db_index.Find(*p_bda);
+    if (p_ent != NULL) p_inq->inq_db_index.Release(p_ent);
+  } else {
+    for (xx = 0; xx < BTM_INQ_DB_SIZE; xx++, p_ent++) {
+      p_ent->in_use = false;
     }
+    p_inq->inq_db_index.Reset(p_inq->inq_db, BTM_INQ_DB_SIZE);
   }
 #if (BTM_INQ_DEBUG == TRUE)
   BTM_TRACE_DEBUG("inq_active:0x%x state:%d", btm_cb.btm_inq_vars.inq_active,
@@ -979,57 +982,22 @@ bool btm_inq_find_bdaddr(const RawAddress& p_bda) {
  *
  ******************************************************************************/
 tINQ_DB_ENT* btm_inq_db_find(const RawAddress& p_bda) {
-  uint16_t xx;
-  tINQ_DB_ENT* p_ent = btm_cb.btm_inq_vars.inq_db;
-
-  for (xx = 0; xx < BTM_INQ_DB_SIZE; xx++, p_ent++) {
-    if (p_ent->in_use && p_ent->inq_info.results.remote_bd_addr == p_bda)
-      return (p_ent);
-  }
-
-  /* If here, not found */
-  return (NULL);
+  return btm_cb.btm_inq_vars.inq_db_index.Find(p_bda);
 }
 
 /*******************************************************************************
  *
  * Function         btm_inq_db_new
  *
- * Description      This function looks through the inquiry database for an
- *                  unused entry. If no entry is free, it allocates the oldest
- *                  entry.
+ * Description      This function takes an unused entry from the inquiry
+ *                  database. If no entry is free, it reuses the least
+ *                  recently used entry.
  *
  * Returns          pointer to entry
  *
  ******************************************************************************/
 tINQ_DB_ENT* btm_inq_db_new(const RawAddress& p_bda) {
-  uint16_t xx;
-  tINQ_DB_ENT* p_ent = btm_cb.btm_inq_vars.inq_db;
-  tINQ_DB_ENT* p_old = btm_cb.btm_inq_vars.inq_db;
-  uint64_t ot = UINT64_MAX;
-
-  for (xx = 0; xx < BTM_INQ_DB_SIZE; xx++, p_ent++) {
-    if (!p_ent->in_use) {
-      memset(p_ent, 0, sizeof(tINQ_DB_ENT));
-      p_ent->inq_info.results.remote_bd_addr = p_bda;
-      p_ent->in_use = true;
-
-      return (p_ent);
-    }
-
-    if (p_ent->time_of_resp < ot) {
-      p_old = p_ent;
-      ot = p_ent->time_of_resp;
-    }
-  }
-
-  /* If here, no free entry found. Return the oldest. */
-
-  memset(p_old, 0, sizeof(tINQ_DB_ENT));
-  p_old->inq_info.results.remote_bd_addr = p_bda;
-  p_old->in_use = true;
-
-  return (p_old);
+  return btm_cb.btm_inq_vars.inq_db_index.Allocate(p_bda);
 }
 
 /*******************************************************************************
@@ -1138,8 +1106,11 @@ void btm_process_inq_results(const uint8_t* p, uint8_t hci_evt_len,
       }
       /* If we received a second Extended Inq Event for an already */
       /* discovered device, this is because for the first one EIR was not
-         received */
-      else if ((inq_res_mode == BTM_INQ_RESULT_EXTENDED) && (p_i)) {
+         received. An EIR identical to the one already reported carries
+         nothing new. */
+      else if ((inq_res_mode == BTM_INQ_RESULT_EXTENDED) && (p_i) &&
+               !(p_i->eir_cached &&
+                 memcmp(p_i->eir, p, HCI_EXT_INQ_RESPONSE_LEN) == 0)) {
         p_cur = &p_i->inq_info.results;
         update = true;
       }
@@ -1201,10 +1172,16 @@ void btm_process_inq_results(const uint8_t* p, uint8_t hci_evt_len,
 
     if (is_new || update) {
       if (inq_res_mode == BTM_INQ_RESULT_EXTENDED) {
-        memset(p_cur->eir_uuid, 0,
-               BTM_EIR_SERVICE_ARRAY_SIZE * (BTM_EIR_ARRAY_BITS / 8));
-        /* set bit map of UUID list from received EIR */
-        btm_set_eir_uuid(p, p_cur);
+        /* only parse the EIR if it changed since it was last parsed */
+        if (!p_i->eir_cached ||
+            memcmp(p_i->eir, p, HCI_EXT_INQ_RESPONSE_LEN) != 0) {
+          memset(p_cur->eir_uuid, 0,
+                 BTM_EIR_SERVICE_ARRAY_SIZE * (BTM_EIR_ARRAY_BITS / 8));
+          /* set bit map of UUID list from received EIR */
+          btm_set_eir_uuid(p, p_cur);
+          memcpy(p_i->eir, p, HCI_EXT_INQ_RESPONSE_LEN);
+          p_i->eir_cached = true;
+        }
         p_eir_data = p;
       } else
         p_eir_data = NULL;
@@ -1253,6 +1230,10 @@ void btm_sort_inq_result(void) {
   }
 
   osi_free(p_tmp);
+
+  /* Entries moved within the database */
+  btm_cb.btm_inq_vars.inq_db_index.Reset(btm_cb.btm_inq_vars.inq_db,
+                                         BTM_INQ_DB_SIZE);
 }
 
 /*******************************************************************************
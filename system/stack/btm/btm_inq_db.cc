@@ -0,0 +1,97 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "stack/btm/neighbor_inquiry.h"
+
+void InquiryDbIndex::Reset(tINQ_DB_ENT* entries, size_t num_entries) {
+  entries_ = entries;
+  num_entries_ = num_entries;
+  lru_.clear();
+  index_.clear();
+  free_.clear();
+
+  std::vector<tINQ_DB_ENT*> in_use;
+  for (size_t i = num_entries; i > 0; i--) {
+    tINQ_DB_ENT* p_ent = &entries[i - 1];
+    if (p_ent->in_use) {
+      in_use.push_back(p_ent);
+    } else {
+      free_.push_back(p_ent);
+    }
+  }
+
+  std::stable_sort(in_use.begin(), in_use.end(),
+                   [](const tINQ_DB_ENT* a, const tINQ_DB_ENT* b) {
+                     return a->time_of_resp > b->time_of_resp;
+                   });
+  for (tINQ_DB_ENT* p_ent : in_use) {
+    const RawAddress& bd_addr = p_ent->inq_info.results.remote_bd_addr;
+    if (index_.count(bd_addr) != 0) {
+      /* Keep only the most recent entry for a given address */
+      p_ent->in_use = false;
+      free_.push_back(p_ent);
+      continue;
+    }
+    index_[bd_addr] = lru_.insert(lru_.end(), p_ent);
+  }
+}
+
+tINQ_DB_ENT* InquiryDbIndex::Find(const RawAddress& bd_addr) {
+  auto it = index_.find(bd_addr);
+  if (it == index_.end()) return nullptr;
+
+  lru_.splice(lru_.begin(), lru_, it->second);
+  return *it->second;
+}
+
+tINQ_DB_ENT* InquiryDbIndex::Allocate(const RawAddress& bd_addr) {
+  tINQ_DB_ENT* p_ent = Find(bd_addr);
+  if (p_ent != nullptr) {
+    lru_.pop_front();
+    index_.erase(bd_addr);
+  } else if (!free_.empty()) {
+    p_ent = free_.back();
+    free_.pop_back();
+  } else if (!lru_.empty()) {
+    /* No free entry, reuse the least recently used one */
+    p_ent = lru_.back();
+    lru_.pop_back();
+    index_.erase(p_ent->inq_info.results.remote_bd_addr);
+  } else {
+    return nullptr;
+  }
+
+  memset(p_ent, 0, sizeof(tINQ_DB_ENT));
+  p_ent->inq_info.results.remote_bd_addr = bd_addr;
+  p_ent->in_use = true;
+  index_[bd_addr] = lru_.insert(lru_.begin(), p_ent);
+  return p_ent;
+}
+
+void InquiryDbIndex::Release(tINQ_DB_ENT* p_ent) {
+  if (!p_ent->in_use) return;
+  p_ent->in_use = false;
+
+  auto it = index_.find(p_ent->inq_info.results.remote_bd_addr);
+  if (it != index_.end() && *it->second == p_ent) {
+    lru_.erase(it->second);
+    index_.erase(it);
+  }
+  free_.push_back(p_ent);
+}
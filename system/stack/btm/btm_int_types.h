@@ -316,7 +316,7 @@ typedef struct tBTM_CB {
     memset(&ble_ctr_cb, 0, sizeof(ble_ctr_cb));
     memset(&enc_rand, 0, sizeof(enc_rand));
     memset(&cmn_ble_vsc_cb, 0, sizeof(cmn_ble_vsc_cb));
-    memset(&btm_inq_vars, 0, sizeof(btm_inq_vars));
+    btm_inq_vars = {};
     memset(&sco_cb, 0, sizeof(sco_cb));
     memset(&api, 0, sizeof(api));
     memset(p_rmt_name_callback, 0, sizeof(p_rmt_name_callback));
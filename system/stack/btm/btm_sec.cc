@@ -39,6 +39,7 @@
 #include "l2c_api.h"
 #include "main/shim/btm_api.h"
 #include "main/shim/dumpsys.h"
+#include "main/shim/metrics_api.h"
 #include "main/shim/shim.h"
 #include "osi/include/allocator.h"
 #include "osi/include/compat.h"
@@ -3324,6 +3325,11 @@ void btm_sec_encrypt_change(uint16_t handle, tHCI_STATUS status,
   }
   btm_cb.collision_start_time = 0;
 
+  if (status == HCI_SUCCESS && encr_enable) {
+    bluetooth::shim::LogConnectionMilestone(
+        handle, bluetooth::common::ConnectionMilestone::ENCRYPTION_CHANGE);
+  }
+
   tBTM_SEC_DEV_REC* p_dev_rec = btm_find_dev_by_handle(handle);
   if (p_dev_rec == nullptr) {
     LOG_WARN(
@@ -17,10 +17,14 @@
 #pragma once
 
 #include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
 
 #include "osi/include/alarm.h"
 #include "stack/include/bt_device_type.h"
 #include "stack/include/btm_api_types.h"
+#include "stack/include/hcidefs.h"
 #include "types/ble_address_with_type.h"
 #include "types/raw_address.h"
 
@@ -171,8 +175,41 @@ typedef struct {
   tBTM_INQ_INFO inq_info;
   bool in_use;
   bool scan_rsp;
+  bool eir_cached; /* eir holds the EIR last parsed into inq_info.results */
+  uint8_t eir[HCI_EXT_INQ_RESPONSE_LEN];
 } tINQ_DB_ENT;
 
+/* Address index and least recently used order over the fixed size inquiry
+ * database. Entries keep their slot in the database array so that pointers
+ * handed out through BTM_InqDbRead/BTM_InqDbFirst/BTM_InqDbNext stay valid;
+ * only lookup and eviction go through the index.
+ */
+class InquiryDbIndex {
+ public:
+  /* Rebuilds the index from the in_use entries of the database, ordering
+   * them by time_of_resp */
+  void Reset(tINQ_DB_ENT* entries, size_t num_entries);
+
+  /* Returns the entry for the address, marking it most recently used */
+  tINQ_DB_ENT* Find(const RawAddress& bd_addr);
+
+  /* Returns a cleared in_use entry for the address, evicting the least
+   * recently used entry when the database is full */
+  tINQ_DB_ENT* Allocate(const RawAddress& bd_addr);
+
+  /* Marks the entry as not in use */
+  void Release(tINQ_DB_ENT* p_ent);
+
+  size_t Size() const { return index_.size(); }
+
+ private:
+  tINQ_DB_ENT* entries_{nullptr};
+  size_t num_entries_{0};
+  std::list<tINQ_DB_ENT*> lru_; /* most recently used first */
+  std::unordered_map<RawAddress, std::list<tINQ_DB_ENT*>::iterator> index_;
+  std::vector<tINQ_DB_ENT*> free_; /* lowest slot last */
+};
+
 typedef struct /* contains the parameters passed to the inquiry functions */
 {
   uint8_t mode;     /* general or limited */
@@ -214,6 +251,7 @@ typedef struct {
   uint16_t num_bd_entries; /* Number of entries in database */
   uint16_t max_bd_entries; /* Maximum number of entries that can be stored */
   tINQ_DB_ENT inq_db[BTM_INQ_DB_SIZE];
+  InquiryDbIndex inq_db_index;
   tBTM_INQ_PARMS inqparms; /* Contains the parameters for the current inquiry */
   tBTM_INQUIRY_CMPL
       inq_cmpl_info; /* Status and number of responses from the last inquiry */
@@ -236,6 +274,7 @@ typedef struct {
     alarm_free(remote_name_timer);
     remote_name_timer = alarm_new("btm_inq.remote_name_timer");
     no_inc_ssp = BTM_NO_SSP_ON_INQUIRY;
+    inq_db_index.Reset(inq_db, BTM_INQ_DB_SIZE);
   }
   void Free() { alarm_free(remote_name_timer); }
 
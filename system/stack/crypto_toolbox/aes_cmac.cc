@@ -77,6 +77,27 @@ Octet16 aes_128(const Octet16& key, const Octet16& message) {
   return output;
 }
 
+/* This function computes AES_128(key, message) for each of |messages|,
+ * expanding the key schedule only once for the whole batch */
+std::vector<Octet16> aes_128(const Octet16& key,
+                             const std::vector<Octet16>& messages) {
+  Octet16 key_reversed;
+  std::reverse_copy(key.begin(), key.end(), key_reversed.begin());
+
+  aes_context ctx;
+  aes_set_key(key_reversed.data(), key_reversed.size(), &ctx);
+
+  std::vector<Octet16> outputs(messages.size());
+  for (size_t i = 0; i < messages.size(); i++) {
+    Octet16 message_reversed;
+    std::reverse_copy(messages[i].begin(), messages[i].end(),
+                      message_reversed.begin());
+    aes_encrypt(message_reversed.data(), outputs[i].data(), &ctx);
+    std::reverse(outputs[i].begin(), outputs[i].end());
+  }
+  return outputs;
+}
+
 /** utility function to padding the given text to be a 128 bits data. The
  * parameter dest is input and output parameter, it must point to a
  * OCTET16_LEN memory space; where include length bytes valid data. */
@@ -17,6 +17,8 @@
 #pragma once
 #include <base/logging.h>
 
+#include <vector>
+
 #include "check.h"
 #include "stack/include/bt_octets.h"
 #include "stack/include/bt_types.h"
@@ -24,6 +26,8 @@
 namespace crypto_toolbox {
 
 extern Octet16 aes_128(const Octet16& key, const Octet16& message);
+extern std::vector<Octet16> aes_128(const Octet16& key,
+                                    const std::vector<Octet16>& messages);
 extern Octet16 aes_cmac(const Octet16& key, const uint8_t* message,
                         uint16_t length);
 extern Octet16 f4(const uint8_t* u, const uint8_t* v, const Octet16& x,
@@ -637,7 +637,13 @@ void gatt_process_prep_write_rsp(tGATT_TCB& tcb, tGATT_CLCB* p_clcb,
  ******************************************************************************/
 void gatt_process_notification(tGATT_TCB& tcb, uint16_t cid, uint8_t op_code,
                                uint16_t len, uint8_t* p_data) {
-  tGATT_VALUE value = {};
+  // The value is parsed in place in the callback data rather than copied into
+  // it, and only its header is cleared: this runs for every notification
+  tGATT_CL_COMPLETE gatt_cl_complete;
+  tGATT_VALUE& value = gatt_cl_complete.att_value;
+  value.conn_id = 0;
+  value.offset = 0;
+  value.auth_req = GATT_AUTH_REQ_NONE;
   tGATT_REG* p_reg;
   uint16_t conn_id;
   tGATT_STATUS encrypt_status = {};
@@ -729,8 +735,7 @@ void gatt_process_notification(tGATT_TCB& tcb, uint16_t cid, uint8_t op_code,
 
   STREAM_TO_ARRAY(value.value, p, value.len);
 
-  tGATT_CL_COMPLETE gatt_cl_complete;
-  gatt_cl_complete.att_value = value;
+  // The cid shares its storage with the conn_id of the value
   gatt_cl_complete.cid = cid;
 
   for (i = 0, p_reg = gatt_cb.cl_rcb; i < GATT_MAX_APPS; i++, p_reg++) {
@@ -766,7 +771,6 @@ void gatt_process_notification(tGATT_TCB& tcb, uint16_t cid, uint8_t op_code,
     // Accounting
     rem_len -= value.len;
 
-    gatt_cl_complete.att_value = value;
     gatt_cl_complete.cid = cid;
 
     for (i = 0, p_reg = gatt_cb.cl_rcb; i < GATT_MAX_APPS; i++, p_reg++) {
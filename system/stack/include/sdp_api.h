@@ -166,6 +166,8 @@ typedef struct {
       raw_data; /* Received record from server. allocated/released by client  */
   uint32_t raw_size; /* size of raw_data */
   uint32_t raw_used; /* length of raw_data used */
+  bool use_cache;    /* Serve search attribute requests of bonded devices
+                        from the discovery cache when possible */
 } tSDP_DISCOVERY_DB;
 
 /* This structure is used to add protocol lists and find protocol elements */
@@ -635,4 +637,30 @@ uint8_t SDP_SetTraceLevel(uint8_t new_level);
 bool SDP_FindServiceUUIDInRec(const tSDP_DISC_REC* p_rec,
                               bluetooth::Uuid* p_uuid);
 
+/*******************************************************************************
+ *
+ * Function         SDP_InvalidateDiscoveryCache
+ *
+ * Description      Drop the search attribute responses cached for the
+ *                  searches of |uuid| on a device, e.g. when a profile finds
+ *                  that a cached record no longer matches the device. The
+ *                  next such search goes to the device.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void SDP_InvalidateDiscoveryCache(const RawAddress& bd_addr,
+                                  const bluetooth::Uuid& uuid);
+
+/*******************************************************************************
+ *
+ * Function         SDP_Dumpsys
+ *
+ * Description      Dump the discovery cache statistics of each service.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void SDP_Dumpsys(int fd);
+
 #endif /* SDP_API_H */
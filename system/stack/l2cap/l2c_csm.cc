@@ -132,6 +132,10 @@ void l2c_csm_execute(tL2C_CCB* p_ccb, tL2CEVT event, void* p_data) {
             channel_state_text(p_ccb->chnl_state).c_str(), p_ccb->chnl_state,
             l2c_csm_get_event_name(event), event);
 
+  const tL2C_CHNL_STATE entry_state = p_ccb->chnl_state;
+  const uint16_t handle =
+      (p_ccb->p_lcb != nullptr) ? p_ccb->p_lcb->Handle() : HCI_INVALID_HANDLE;
+
   switch (p_ccb->chnl_state) {
     case CST_CLOSED:
       l2c_csm_closed(p_ccb, event, p_data);
@@ -173,6 +177,13 @@ void l2c_csm_execute(tL2C_CCB* p_ccb, tL2CEVT event, void* p_data) {
       LOG_ERROR("Unhandled state %d, event %d", p_ccb->chnl_state, event);
       break;
   }
+
+  // The CCB comes from a static pool, it can still be read if it was released
+  if (handle != HCI_INVALID_HANDLE && entry_state != CST_OPEN &&
+      l2cu_is_ccb_active(p_ccb) && p_ccb->chnl_state == CST_OPEN) {
+    bluetooth::shim::LogConnectionMilestone(
+        handle, bluetooth::common::ConnectionMilestone::PROFILE_CHANNEL_OPEN);
+  }
 }
 
 /*******************************************************************************
@@ -28,6 +28,7 @@
 
 #include "bt_target.h"
 #include "hcimsgs.h"  // HCID_GET_
+#include "main/shim/metrics_api.h"
 #include "main/shim/shim.h"
 #include "osi/include/allocator.h"
 #include "osi/include/log.h"
@@ -778,6 +779,12 @@ static void process_l2cap_cmd(tL2C_LCB* p_lcb, uint8_t* p, uint16_t pkt_len) {
         STREAM_TO_UINT16(info_type, p);
         STREAM_TO_UINT16(result, p);
 
+        if (info_type == L2CAP_EXTENDED_FEATURES_INFO_TYPE) {
+          bluetooth::shim::LogConnectionMilestone(
+              p_lcb->Handle(),
+              bluetooth::common::ConnectionMilestone::L2CAP_INFORMATION);
+        }
+
         if ((info_type == L2CAP_EXTENDED_FEATURES_INFO_TYPE) &&
             (result == L2CAP_INFO_RESP_RESULT_SUCCESS)) {
           if (p + 4 > p_next_cmd) {
@@ -487,8 +487,10 @@ void PORT_DlcEstablishCnf(tRFC_MCB* p_mcb, uint8_t dlci, uint16_t mtu,
   if (!p_port) return;
 
   if (result != RFCOMM_SUCCESS) {
-    p_port->error = PORT_START_FAILED;
-    port_rfc_closed(p_port, PORT_START_FAILED);
+    /* A DLC refused by the peer has no service behind its server channel */
+    p_port->error =
+        (result == RFCOMM_DLC_REFUSED) ? PORT_INVALID_SCN : PORT_START_FAILED;
+    port_rfc_closed(p_port, p_port->error);
     log_counter_metrics(
         android::bluetooth::CodePathCounterKeyEnum::RFCOMM_PORT_START_FAILED,
         1);
@@ -42,6 +42,7 @@
 */
 #define RFCOMM_SUCCESS 0
 #define RFCOMM_ERROR 1
+#define RFCOMM_DLC_REFUSED 2 /* Peer answered the DLC SABME with DM */
 #define RFCOMM_SECURITY_ERR 112
 
 /*
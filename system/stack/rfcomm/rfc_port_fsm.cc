@@ -233,7 +233,8 @@ void rfc_port_sm_sabme_wait_ua(tPORT* p_port, tRFC_PORT_EVENT event,
                            p_port->handle);
       p_port->rfc.p_mcb->is_disc_initiator = true;
       PORT_DlcEstablishCnf(p_port->rfc.p_mcb, p_port->dlci,
-                           p_port->rfc.p_mcb->peer_l2cap_mtu, RFCOMM_ERROR);
+                           p_port->rfc.p_mcb->peer_l2cap_mtu,
+                           RFCOMM_DLC_REFUSED);
       rfc_port_closed(p_port);
       return;
 
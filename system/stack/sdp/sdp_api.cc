@@ -163,8 +163,8 @@ bool SDP_ServiceSearchAttributeRequest(const RawAddress& p_bd_addr,
                                        tSDP_DISC_CMPL_CB* p_cb) {
   tCONN_CB* p_ccb;
 
-  /* Specific BD address */
-  p_ccb = sdp_conn_originate(p_bd_addr);
+  /* Specific BD address, unless the response is in the discovery cache */
+  p_ccb = sdp_cache_originate(p_bd_addr, p_db);
 
   if (!p_ccb) return (false);
 
@@ -196,8 +196,8 @@ bool SDP_ServiceSearchAttributeRequest2(const RawAddress& p_bd_addr,
                                         const void* user_data) {
   tCONN_CB* p_ccb;
 
-  /* Specific BD address */
-  p_ccb = sdp_conn_originate(p_bd_addr);
+  /* Specific BD address, unless the response is in the discovery cache */
+  p_ccb = sdp_cache_originate(p_bd_addr, p_db);
 
   if (!p_ccb) return (false);
 
@@ -0,0 +1,386 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "SDP_Cache"
+
+/******************************************************************************
+ *
+ *  This file contains the discovery cache of the SDP client. The complete
+ *  search attribute responses of bonded devices are kept in the config, next
+ *  to the bond, so that profiles reconnecting to an unchanged device do not
+ *  have to open an SDP channel again.
+ *
+ *  A cached response is only used if the remote version and the services of
+ *  the device are still the ones it was saved with, and if it is not older
+ *  than kBtifConfigBlobMaxAgeSeconds.
+ *
+ ******************************************************************************/
+
+#include <string.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "btif/include/btif_config.h"
+#include "btif/include/btif_config_blob.h"
+#include "common/time_util.h"
+#include "main/shim/dumpsys.h"
+#include "osi/include/alarm.h"
+#include "osi/include/allocator.h"
+#include "osi/include/log.h"
+#include "stack/include/btm_api.h"
+#include "stack/include/sdp_api.h"
+#include "stack/sdp/sdpint.h"
+#include "types/bluetooth/uuid.h"
+#include "types/raw_address.h"
+
+using bluetooth::Uuid;
+
+namespace {
+
+constexpr uint8_t kCacheFormat = 1;
+constexpr size_t kMaxEntries = 6;
+constexpr uint16_t kMaxResponseBytes = 512;
+
+// Written by btif_storage with the services found by the last full discovery
+constexpr char kRemoteService[] = "Service";
+
+struct CacheEntry {
+  std::vector<uint8_t> filters;  // UUID and attribute filters of the search
+  uint64_t stored_at;            // Seconds since the epoch
+  std::vector<uint8_t> response;
+};
+
+struct ServiceStatistics {
+  size_t hits = 0;
+  size_t misses = 0;
+  size_t stores = 0;
+  size_t timed_misses = 0;
+  uint64_t total_miss_ms = 0;
+};
+
+// Statistics by the first UUID filter of the searches
+std::map<Uuid, ServiceStatistics> statistics;
+
+// FNV-1a hash of what the cached responses depend on: the remote version,
+// which changes with a firmware update, and the services of the device.
+uint32_t device_signature(const std::string& bdstr) {
+  std::string state;
+  for (const std::string& key :
+       {BT_CONFIG_KEY_REMOTE_VER_MFCT, BT_CONFIG_KEY_REMOTE_VER_VER,
+        BT_CONFIG_KEY_REMOTE_VER_SUBVER}) {
+    int value = 0;
+    btif_config_get_int(bdstr, key, &value);
+    state += std::to_string(value) + ";";
+  }
+
+  char services[1280];
+  int size = sizeof(services);
+  if (btif_config_get_str(bdstr, kRemoteService, services, &size)) {
+    state += services;
+  }
+
+  uint32_t hash = 2166136261u;
+  for (unsigned char c : state) {
+    hash = (hash ^ c) * 16777619u;
+  }
+  return hash;
+}
+
+// Whether |uuid| is one of the UUID filters encoded in |filters|
+bool filters_contain(const std::vector<uint8_t>& filters, const Uuid& uuid) {
+  if (filters.empty()) return false;
+  const Uuid::UUID128Bit& bytes = uuid.To128BitBE();
+  size_t end = 1 + filters[0] * bytes.size();
+  if (end > filters.size()) return false;
+  for (size_t pos = 1; pos < end; pos += bytes.size()) {
+    if (std::equal(bytes.begin(), bytes.end(), filters.begin() + pos))
+      return true;
+  }
+  return false;
+}
+
+std::vector<uint8_t> search_filters(const tSDP_DISCOVERY_DB& db) {
+  std::vector<uint8_t> filters;
+  filters.push_back(db.num_uuid_filters);
+  for (uint16_t i = 0; i < db.num_uuid_filters; i++) {
+    const Uuid::UUID128Bit& uuid = db.uuid_filters[i].To128BitBE();
+    filters.insert(filters.end(), uuid.begin(), uuid.end());
+  }
+  filters.push_back(db.num_attr_filters);
+  for (uint16_t i = 0; i < db.num_attr_filters; i++) {
+    BtifConfigBlobWriter(filters).u16(db.attr_filters[i]);
+  }
+  return filters;
+}
+
+// Return the entries cached for |bd_addr|, empty if they no longer match the
+// device
+std::vector<CacheEntry> load_entries(const RawAddress& bd_addr) {
+  const std::string bdstr = bd_addr.ToString();
+  std::vector<CacheEntry> entries;
+  const std::vector<uint8_t> blob =
+      btif_config_get_blob(bdstr, BT_CONFIG_KEY_SDP_DISCOVERY_CACHE);
+  if (blob.empty()) return entries;
+
+  BtifConfigBlobReader reader(blob);
+  uint8_t format, num_entries;
+  uint32_t signature;
+  if (!reader.u8(&format) || format != kCacheFormat ||
+      !reader.u32(&signature) || !reader.u8(&num_entries)) {
+    LOG_WARN("Dropping unreadable discovery cache of %s",
+             PRIVATE_ADDRESS(bd_addr));
+    return entries;
+  }
+  if (signature != device_signature(bdstr)) {
+    LOG_INFO("Discovery cache of %s is stale", PRIVATE_ADDRESS(bd_addr));
+    return entries;
+  }
+
+  for (uint8_t i = 0; i < num_entries; i++) {
+    CacheEntry entry;
+    uint16_t filters_len, response_len;
+    if (!reader.u16(&filters_len) ||
+        !reader.bytes(filters_len, &entry.filters) ||
+        !reader.u64(&entry.stored_at) || !reader.u16(&response_len) ||
+        !reader.bytes(response_len, &entry.response)) {
+      LOG_WARN("Dropping truncated discovery cache of %s",
+               PRIVATE_ADDRESS(bd_addr));
+      return {};
+    }
+    entries.push_back(std::move(entry));
+  }
+  if (!reader.done()) return {};
+  return entries;
+}
+
+void save_entries(const RawAddress& bd_addr,
+                  const std::vector<CacheEntry>& entries) {
+  const std::string bdstr = bd_addr.ToString();
+  if (entries.empty()) {
+    if (btif_config_exist(bdstr, BT_CONFIG_KEY_SDP_DISCOVERY_CACHE))
+      btif_config_remove(bdstr, BT_CONFIG_KEY_SDP_DISCOVERY_CACHE);
+    return;
+  }
+
+  std::vector<uint8_t> blob;
+  BtifConfigBlobWriter writer(blob);
+  writer.u8(kCacheFormat);
+  writer.u32(device_signature(bdstr));
+  writer.u8(entries.size());
+  for (const CacheEntry& entry : entries) {
+    writer.u16(entry.filters.size());
+    writer.bytes(entry.filters);
+    writer.u64(entry.stored_at);
+    writer.u16(entry.response.size());
+    writer.bytes(entry.response);
+  }
+  btif_config_set_bin(bdstr, BT_CONFIG_KEY_SDP_DISCOVERY_CACHE, blob.data(),
+                      blob.size());
+}
+
+// Forget the records a failed parse left in |db|
+void reset_discovery_db(tSDP_DISCOVERY_DB* p_db) {
+  p_db->p_first_rec = NULL;
+  p_db->mem_free = p_db->mem_size;
+  p_db->p_free_mem = (uint8_t*)(p_db + 1);
+  p_db->raw_used = 0;
+}
+
+void sdp_cache_deliver(void* data) {
+  tCONN_CB* p_ccb = (tCONN_CB*)data;
+  if (p_ccb->con_state != SDP_STATE_FROM_CACHE) return;
+  sdp_disconnect(p_ccb, SDP_SUCCESS);
+}
+
+// Serve the search of |p_db| from the cache, return the CCB which delivers it
+tCONN_CB* sdp_cache_lookup(const RawAddress& bd_addr,
+                           tSDP_DISCOVERY_DB* p_db) {
+  std::vector<CacheEntry> entries = load_entries(bd_addr);
+  const std::vector<uint8_t> filters = search_filters(*p_db);
+  const uint64_t now = btif_config_blob_now();
+
+  auto entry = entries.begin();
+  while (entry != entries.end() && entry->filters != filters) entry++;
+  if (entry == entries.end()) return nullptr;
+  if (btif_config_blob_is_expired(entry->stored_at, now) ||
+      entry->response.size() > kMaxResponseBytes) {
+    entries.erase(entry);
+    save_entries(bd_addr, entries);
+    return nullptr;
+  }
+
+  tCONN_CB* p_ccb = sdpu_allocate_ccb();
+  if (p_ccb == nullptr) return nullptr;
+
+  p_ccb->con_state = SDP_STATE_FROM_CACHE;
+  p_ccb->con_flags |= SDP_FLAGS_IS_ORIG;
+  p_ccb->device_address = bd_addr;
+  p_ccb->p_db = p_db;
+  p_ccb->rsp_list = (uint8_t*)osi_malloc(SDP_MAX_LIST_BYTE_COUNT);
+  memcpy(p_ccb->rsp_list, entry->response.data(), entry->response.size());
+  p_ccb->list_len = entry->response.size();
+
+  tSDP_STATUS status = sdp_save_search_attr_rsp(p_ccb);
+  if (status != SDP_SUCCESS) {
+    LOG_WARN("Dropping cached response of %s, status:%d",
+             PRIVATE_ADDRESS(bd_addr), status);
+    sdpu_release_ccb(*p_ccb);
+    reset_discovery_db(p_db);
+    entries.erase(entry);
+    save_entries(bd_addr, entries);
+    return nullptr;
+  }
+
+  // Complete from the main loop, as a search through the channel would, once
+  // the caller has set up the callbacks of the CCB
+  alarm_set_on_mloop(p_ccb->sdp_conn_timer, 0, sdp_cache_deliver, p_ccb);
+  return p_ccb;
+}
+
+}  // namespace
+
+/*******************************************************************************
+ *
+ * Function         sdp_cache_originate
+ *
+ * Description      This function starts a search attribute request of
+ *                  |p_db|. If the database opted in the discovery cache and
+ *                  the response of the device is cached, the records are
+ *                  saved into the database and the returned CCB completes
+ *                  from the main loop. Otherwise an SDP channel is opened.
+ *
+ * Returns          The CCB of the request, or NULL if it could not start.
+ *
+ ******************************************************************************/
+tCONN_CB* sdp_cache_originate(const RawAddress& bd_addr,
+                              tSDP_DISCOVERY_DB* p_db) {
+  if (p_db == nullptr || !p_db->use_cache || p_db->num_uuid_filters == 0) {
+    return sdp_conn_originate(bd_addr);
+  }
+
+  ServiceStatistics& stats = statistics[p_db->uuid_filters[0]];
+  tCONN_CB* p_ccb = sdp_cache_lookup(bd_addr, p_db);
+  if (p_ccb != nullptr) {
+    LOG_INFO("Search of %s served from the discovery cache",
+             PRIVATE_ADDRESS(bd_addr));
+    stats.hits++;
+    return p_ccb;
+  }
+
+  stats.misses++;
+  p_ccb = sdp_conn_originate(bd_addr);
+  if (p_ccb != nullptr) {
+    p_ccb->cache_miss_start_ms = bluetooth::common::time_get_os_boottime_ms();
+  }
+  return p_ccb;
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_cache_store
+ *
+ * Description      This function caches the complete search attribute
+ *                  response held in |ccb|, if its database opted in the
+ *                  discovery cache and the device is bonded.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void sdp_cache_store(const tCONN_CB& ccb) {
+  const tSDP_DISCOVERY_DB* p_db = ccb.p_db;
+  if (p_db == nullptr || !p_db->use_cache || p_db->num_uuid_filters == 0) {
+    return;
+  }
+
+  ServiceStatistics& stats = statistics[p_db->uuid_filters[0]];
+  if (ccb.cache_miss_start_ms != 0) {
+    stats.timed_misses++;
+    stats.total_miss_ms +=
+        bluetooth::common::time_get_os_boottime_ms() - ccb.cache_miss_start_ms;
+  }
+
+  if (ccb.list_len > kMaxResponseBytes ||
+      !btm_sec_is_a_bonded_dev(ccb.device_address)) {
+    return;
+  }
+
+  std::vector<CacheEntry> entries = load_entries(ccb.device_address);
+  CacheEntry entry = {
+      .filters = search_filters(*p_db),
+      .stored_at = btif_config_blob_now(),
+      .response =
+          std::vector<uint8_t>(ccb.rsp_list, ccb.rsp_list + ccb.list_len),
+  };
+
+  auto existing = entries.begin();
+  while (existing != entries.end() && existing->filters != entry.filters)
+    existing++;
+  if (existing != entries.end()) {
+    *existing = std::move(entry);
+  } else {
+    if (entries.size() == kMaxEntries) {
+      auto oldest = entries.begin();
+      for (auto it = entries.begin(); it != entries.end(); it++) {
+        if (it->stored_at < oldest->stored_at) oldest = it;
+      }
+      entries.erase(oldest);
+    }
+    entries.push_back(std::move(entry));
+  }
+  save_entries(ccb.device_address, entries);
+  stats.stores++;
+}
+
+/*******************************************************************************
+ *
+ * Function         SDP_InvalidateDiscoveryCache
+ *
+ * Description      Drop the search attribute responses cached for the
+ *                  searches of |uuid| on a device.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void SDP_InvalidateDiscoveryCache(const RawAddress& bd_addr, const Uuid& uuid) {
+  std::vector<CacheEntry> entries = load_entries(bd_addr);
+  auto stale = std::remove_if(
+      entries.begin(), entries.end(), [&uuid](const CacheEntry& entry) {
+        return filters_contain(entry.filters, uuid);
+      });
+  if (stale == entries.end()) return;
+  entries.erase(stale, entries.end());
+  save_entries(bd_addr, entries);
+}
+
+#define DUMPSYS_TAG "shim::legacy::sdp"
+void SDP_Dumpsys(int fd) {
+  LOG_DUMPSYS_TITLE(fd, DUMPSYS_TAG);
+
+  for (const auto& [uuid, stats] : statistics) {
+    uint64_t average_miss_ms =
+        stats.timed_misses ? stats.total_miss_ms / stats.timed_misses : 0;
+    LOG_DUMPSYS(fd,
+                "service:%s cache hits:%zu misses:%zu stored:%zu "
+                "average_miss_ms:%llu",
+                uuid.ToString().c_str(), stats.hits, stats.misses,
+                stats.stores, static_cast<unsigned long long>(average_miss_ms));
+  }
+}
+#undef DUMPSYS_TAG
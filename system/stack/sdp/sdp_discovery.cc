@@ -544,9 +544,7 @@ static void process_service_attr_rsp(tCONN_CB* p_ccb, uint8_t* p_reply,
  ******************************************************************************/
 static void process_service_search_attr_rsp(tCONN_CB* p_ccb, uint8_t* p_reply,
                                             uint8_t* p_reply_end) {
-  uint8_t *p, *p_start, *p_end, *p_param_len;
-  uint8_t type;
-  uint32_t seq_len;
+  uint8_t *p_start, *p_param_len;
   uint16_t param_len, lists_byte_count = 0;
   bool cont_request_needed = false;
 
@@ -666,10 +664,36 @@ static void process_service_search_attr_rsp(tCONN_CB* p_ccb, uint8_t* p_reply,
 /* We now have the full response, which is a sequence of sequences */
 /*******************************************************************/
 
+  tSDP_STATUS status = sdp_save_search_attr_rsp(p_ccb);
+  if (status != SDP_SUCCESS) {
+    sdp_disconnect(p_ccb, status);
+    return;
+  }
+  sdp_cache_store(*p_ccb);
+
+  /* Since we got everything we need, disconnect the call */
+  sdpu_log_attribute_metrics(p_ccb->device_address, p_ccb->p_db);
+  sdp_disconnect(p_ccb, SDP_SUCCESS);
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_save_search_attr_rsp
+ *
+ * Description      This function saves the complete service search attribute
+ *                  response held in the CCB into its discovery database.
+ *
+ * Returns          SDP_SUCCESS, or the reason the response was rejected
+ *
+ ******************************************************************************/
+tSDP_STATUS sdp_save_search_attr_rsp(tCONN_CB* p_ccb) {
+  uint8_t *p, *p_end;
+  uint8_t type;
+  uint32_t seq_len;
+
   if (!sdp_copy_raw_data(p_ccb, true)) {
     LOG_ERROR("sdp_copy_raw_data failed");
-    sdp_disconnect(p_ccb, SDP_ILLEGAL_PARAMETER);
-    return;
+    return SDP_ILLEGAL_PARAMETER;
   }
 
   p = &p_ccb->rsp_list[0];
@@ -679,33 +703,26 @@ static void process_service_search_attr_rsp(tCONN_CB* p_ccb, uint8_t* p_reply,
 
   if ((type >> 3) != DATA_ELE_SEQ_DESC_TYPE) {
     LOG_WARN("Wrong element in attr_rsp type:0x%02x", type);
-    sdp_disconnect(p_ccb, SDP_ILLEGAL_PARAMETER);
-    return;
+    return SDP_ILLEGAL_PARAMETER;
   }
   p = sdpu_get_len_from_type(p, p + p_ccb->list_len, type, &seq_len);
   if (p == NULL || (p + seq_len) > (p + p_ccb->list_len)) {
     LOG_WARN("Illegal search attribute length");
-    sdp_disconnect(p_ccb, SDP_ILLEGAL_PARAMETER);
-    return;
+    return SDP_ILLEGAL_PARAMETER;
   }
   p_end = &p_ccb->rsp_list[p_ccb->list_len];
 
   if ((p + seq_len) != p_end) {
-    sdp_disconnect(p_ccb, SDP_INVALID_CONT_STATE);
-    return;
+    return SDP_INVALID_CONT_STATE;
   }
 
   while (p < p_end) {
     p = save_attr_seq(p_ccb, p, &p_ccb->rsp_list[p_ccb->list_len]);
     if (!p) {
-      sdp_disconnect(p_ccb, SDP_DB_FULL);
-      return;
+      return SDP_DB_FULL;
     }
   }
-
-  /* Since we got everything we need, disconnect the call */
-  sdpu_log_attribute_metrics(p_ccb->device_address, p_ccb->p_db);
-  sdp_disconnect(p_ccb, SDP_SUCCESS);
+  return SDP_SUCCESS;
 }
 
 /*******************************************************************************
@@ -385,6 +385,13 @@ void sdp_disconnect(tCONN_CB* p_ccb, tSDP_REASON reason) {
   tCONN_CB& ccb = *p_ccb;
   SDP_TRACE_EVENT("SDP - disconnect  CID: 0x%x", ccb.connection_id);
 
+  /* Served from the discovery cache, there is no channel to close */
+  if (ccb.con_state == SDP_STATE_FROM_CACHE) {
+    sdpu_callback(ccb, reason);
+    sdpu_release_ccb(ccb);
+    return;
+  }
+
   /* Check if we have a connection ID */
   if (ccb.connection_id != 0) {
     ccb.disconnect_reason = reason;
@@ -129,6 +129,7 @@ struct tCONN_CB {
 #define SDP_STATE_CFG_SETUP 2
 #define SDP_STATE_CONNECTED 3
 #define SDP_STATE_CONN_PEND 4
+#define SDP_STATE_FROM_CACHE 5 /* Response taken from the discovery cache */
   uint8_t con_state;
 
 #define SDP_FLAGS_IS_ORIG 0x01
@@ -167,6 +168,8 @@ struct tCONN_CB {
   uint16_t cont_offset;     /* Continuation state data in the server response */
   tSDP_CONT_INFO cont_info; /* structure to hold continuation information for
                                the server response */
+  uint64_t cache_miss_start_ms; /* Boot time a cacheable search missed the
+                                   discovery cache, 0 otherwise */
   tCONN_CB() = default;
 
  private:
@@ -263,5 +266,12 @@ extern void sdp_server_handle_client_req(tCONN_CB* p_ccb, BT_HDR* p_msg);
  */
 extern void sdp_disc_connected(tCONN_CB* p_ccb);
 extern void sdp_disc_server_rsp(tCONN_CB* p_ccb, BT_HDR* p_msg);
+extern tSDP_STATUS sdp_save_search_attr_rsp(tCONN_CB* p_ccb);
+
+/* Functions provided by sdp_cache.cc
+ */
+extern tCONN_CB* sdp_cache_originate(const RawAddress& bd_addr,
+                                     tSDP_DISCOVERY_DB* p_db);
+extern void sdp_cache_store(const tCONN_CB& ccb);
 
 #endif
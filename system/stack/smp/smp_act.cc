@@ -1565,27 +1565,37 @@ void smp_idle_terminate(tSMP_CB* p_cb, tSMP_INT_DATA* p_data) {
 }
 
 /*******************************************************************************
- * Function     smp_both_have_public_keys
- * Description  The function is called when both local and peer public keys are
- *              saved.
+ * Function     smp_dhkey_computed
+ * Description  The function is called when the DHKey is saved.
  *              Actions:
- *              - invokes DHKey computation;
  *              - on peripheral side invokes sending local public key to the
  *peer.
  *              - invokes SC phase 1 process.
  ******************************************************************************/
-void smp_both_have_public_keys(tSMP_CB* p_cb, tSMP_INT_DATA* p_data) {
+static void smp_dhkey_computed(tSMP_CB* p_cb) {
   SMP_TRACE_DEBUG("%s", __func__);
 
-  /* invokes DHKey computation */
-  smp_compute_dhkey(p_cb);
-
   /* on peripheral side invokes sending local public key to the peer */
   if (p_cb->role == HCI_ROLE_PERIPHERAL) smp_send_pair_public_key(p_cb, NULL);
 
   smp_sm_event(p_cb, SMP_SC_DHKEY_CMPLT_EVT, NULL);
 }
 
+/*******************************************************************************
+ * Function     smp_both_have_public_keys
+ * Description  The function is called when both local and peer public keys are
+ *              saved.
+ *              Actions:
+ *              - invokes DHKey computation, which continues in
+ *                smp_dhkey_computed.
+ ******************************************************************************/
+void smp_both_have_public_keys(tSMP_CB* p_cb, tSMP_INT_DATA* p_data) {
+  SMP_TRACE_DEBUG("%s", __func__);
+
+  /* invokes DHKey computation */
+  smp_compute_dhkey(p_cb, smp_dhkey_computed);
+}
+
 /*******************************************************************************
  * Function     smp_start_secure_connection_phase1
  * Description  Start Secure Connection phase1 i.e. invokes initialization of
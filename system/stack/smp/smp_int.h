@@ -310,8 +310,15 @@ typedef struct {
   tSMP_STATUS cert_failure; /*failure case for certification */
   alarm_t* delayed_auth_timer_ent;
   tBLE_BD_ADDR pairing_ble_bd_addr;
+  /* Time spent in elliptic curve operations for this pairing */
+  uint64_t crypto_time_us;
+  uint8_t crypto_ops;
+  bool used_precomputed_key;
 } tSMP_CB;
 
+/* Continuation of an elliptic curve operation run on the crypto thread */
+typedef void(tSMP_CRYPTO_CBACK)(tSMP_CB* p_cb);
+
 /* Server Action functions are of this type */
 typedef void (*tSMP_ACT)(tSMP_CB* p_cb, tSMP_INT_DATA* p_data);
 
@@ -458,7 +465,9 @@ extern void smp_generate_passkey(tSMP_CB* p_cb, tSMP_INT_DATA* p_data);
 extern void smp_generate_rand_cont(tSMP_CB* p_cb, tSMP_INT_DATA* p_data);
 extern void smp_create_private_key(tSMP_CB* p_cb, tSMP_INT_DATA* p_data);
 extern void smp_use_oob_private_key(tSMP_CB* p_cb, tSMP_INT_DATA* p_data);
-extern void smp_compute_dhkey(tSMP_CB* p_cb);
+extern void smp_compute_dhkey(tSMP_CB* p_cb, tSMP_CRYPTO_CBACK* p_cback);
+extern void smp_crypto_init(void);
+extern void smp_crypto_cancel_pending(void);
 extern void smp_calculate_local_commitment(tSMP_CB* p_cb);
 extern Octet16 smp_calculate_peer_commitment(tSMP_CB* p_cb);
 extern void smp_calculate_numeric_comparison_display_number(
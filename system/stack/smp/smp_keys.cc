@@ -25,12 +25,14 @@
 #include <base/callback.h>
 
 #include <algorithm>
+#include <chrono>
 #include <cstring>
 
 #include "bt_target.h"
 #include "bt_utils.h"
 #include "btm_ble_api.h"
 #include "btm_ble_int.h"
+#include "common/message_loop_thread.h"
 #include "device/include/controller.h"
 #include "osi/include/osi.h"
 #include "p_256_ecc_pp.h"
@@ -40,11 +42,13 @@
 #include "stack/crypto_toolbox/crypto_toolbox.h"
 #include "stack/include/acl_api.h"
 #include "stack/include/bt_octets.h"
+#include "stack/include/btu.h"
 #include "types/raw_address.h"
 
 extern tBTM_CB btm_cb;  // TODO Remove
 
 using base::Bind;
+using bluetooth::common::MessageLoopThread;
 using crypto_toolbox::aes_128;
 
 #ifndef SMP_MAX_ENC_REPEAT
@@ -576,6 +580,241 @@ Octet16 smp_calculate_legacy_short_term_key(tSMP_CB* p_cb) {
   return aes_128(p_cb->tk, text);
 }
 
+namespace {
+
+// Elliptic curve point multiplications take milliseconds, they run on this
+// thread so that the main thread keeps serving the other profiles during
+// pairing.
+MessageLoopThread smp_crypto_thread("bt_smp_crypto_thread");
+
+// Incremented whenever the pairing control block is reset, the results of
+// operations started for a previous pairing are then dropped.
+uint32_t smp_crypto_session = 0;
+
+// Incremented whenever SMP is initialized, a key pair still being generated
+// for the previous stack instance is then dropped.
+uint32_t smp_precompute_generation = 0;
+
+// Local key pair generated ahead of the next pairing. It is used by a
+// single pairing and wiped when taken.
+struct {
+  bool valid;
+  bool pending;
+  BT_OCTET32 private_key;
+  Point public_key;
+} smp_precomputed_key_pair;
+
+// Saves the result of an operation in the control block.
+typedef void(tSMP_CRYPTO_SAVE)(tSMP_CB* p_cb, const Point& result);
+
+struct SmpCryptoRequest {
+  tSMP_CB* p_cb;
+  uint32_t session;
+  Point point;
+  BT_OCTET32 scalar;
+  tSMP_CRYPTO_SAVE* p_save;
+  tSMP_CRYPTO_CBACK* p_cback;
+  Point result;
+  uint64_t time_us;
+};
+
+void smp_crypto_compute(SmpCryptoRequest* request) {
+  auto start = std::chrono::steady_clock::now();
+  ECC_PointMult(&request->result, &request->point,
+                (uint32_t*)request->scalar);
+  request->time_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+  memset(request->scalar, 0, BT_OCTET32_LEN);
+}
+
+void smp_crypto_done(SmpCryptoRequest request) {
+  if (request.session != smp_crypto_session) {
+    LOG_INFO("Dropping elliptic curve result of a previous pairing");
+    return;
+  }
+
+  tSMP_CB* p_cb = request.p_cb;
+  p_cb->crypto_time_us += request.time_us;
+  p_cb->crypto_ops++;
+  request.p_save(p_cb, request.result);
+  request.p_cback(p_cb);
+}
+
+// Multiplies |point| by |scalar| on the crypto thread, then saves the result
+// and calls |p_cback| on the main thread. The operation runs inline when the
+// crypto thread is not running, as in unit tests.
+void smp_run_crypto(tSMP_CB* p_cb, const Point& point,
+                    const BT_OCTET32 scalar, tSMP_CRYPTO_SAVE* p_save,
+                    tSMP_CRYPTO_CBACK* p_cback) {
+  SmpCryptoRequest request{};
+  request.p_cb = p_cb;
+  request.session = smp_crypto_session;
+  request.point = point;
+  memcpy(request.scalar, scalar, BT_OCTET32_LEN);
+  request.p_save = p_save;
+  request.p_cback = p_cback;
+
+  if (!smp_crypto_thread.IsRunning()) {
+    smp_crypto_compute(&request);
+    smp_crypto_done(request);
+    return;
+  }
+
+  smp_crypto_thread.DoInThread(
+      FROM_HERE,
+      base::BindOnce(
+          [](SmpCryptoRequest request) {
+            smp_crypto_compute(&request);
+            do_in_main_thread(FROM_HERE,
+                              base::BindOnce(&smp_crypto_done, request));
+          },
+          request));
+}
+
+void smp_save_public_key(tSMP_CB* p_cb, const Point& public_key) {
+  memcpy(p_cb->loc_publ_key.x, public_key.x, BT_OCTET32_LEN);
+  memcpy(p_cb->loc_publ_key.y, public_key.y, BT_OCTET32_LEN);
+}
+
+void smp_save_dhkey(tSMP_CB* p_cb, const Point& new_publ_key) {
+  memcpy(p_cb->dhkey, new_publ_key.x, BT_OCTET32_LEN);
+
+  smp_debug_print_nbyte_little_endian(p_cb->dhkey, "Old DHKey", BT_OCTET32_LEN);
+
+  smp_debug_print_nbyte_little_endian(p_cb->private_key, "private",
+                                      BT_OCTET32_LEN);
+  smp_debug_print_nbyte_little_endian(p_cb->peer_publ_key.x, "rem public(x)",
+                                      BT_OCTET32_LEN);
+  smp_debug_print_nbyte_little_endian(p_cb->peer_publ_key.y, "rem public(y)",
+                                      BT_OCTET32_LEN);
+  smp_debug_print_nbyte_little_endian(p_cb->dhkey, "Reverted DHKey",
+                                      BT_OCTET32_LEN);
+}
+
+// Notifies SM that the local private key / public key pair is created.
+void smp_process_public_key(tSMP_CB* p_cb) {
+  smp_debug_print_nbyte_little_endian(p_cb->private_key, "private",
+                                      BT_OCTET32_LEN);
+  smp_debug_print_nbyte_little_endian(p_cb->loc_publ_key.x, "local public(x)",
+                                      BT_OCTET32_LEN);
+  smp_debug_print_nbyte_little_endian(p_cb->loc_publ_key.y, "local public(y)",
+                                      BT_OCTET32_LEN);
+  p_cb->flags |= SMP_PAIR_FLAG_HAVE_LOCAL_PUBL_KEY;
+  smp_sm_event(p_cb, SMP_LOC_PUBL_KEY_CRTD_EVT, NULL);
+}
+
+bool smp_take_precomputed_key_pair(tSMP_CB* p_cb) {
+  if (!smp_precomputed_key_pair.valid) return false;
+
+  memcpy(p_cb->private_key, smp_precomputed_key_pair.private_key,
+         BT_OCTET32_LEN);
+  smp_save_public_key(p_cb, smp_precomputed_key_pair.public_key);
+  memset(&smp_precomputed_key_pair, 0, sizeof(smp_precomputed_key_pair));
+  p_cb->used_precomputed_key = true;
+  return true;
+}
+
+void smp_precompute_public_key(void) {
+  SmpCryptoRequest request{};
+  request.session = smp_precompute_generation;
+  request.point = curve_p256.G;
+  memcpy(request.scalar, smp_precomputed_key_pair.private_key,
+         BT_OCTET32_LEN);
+
+  smp_crypto_thread.DoInThread(
+      FROM_HERE,
+      base::BindOnce(
+          [](SmpCryptoRequest request) {
+            smp_crypto_compute(&request);
+            do_in_main_thread(
+                FROM_HERE, base::BindOnce(
+                               [](SmpCryptoRequest request) {
+                                 if (request.session !=
+                                     smp_precompute_generation) {
+                                   return;
+                                 }
+                                 smp_precomputed_key_pair.public_key =
+                                     request.result;
+                                 smp_precomputed_key_pair.pending = false;
+                                 smp_precomputed_key_pair.valid = true;
+                               },
+                               request));
+          },
+          request));
+}
+
+void smp_precompute_private_key(uint32_t generation, size_t offset,
+                                BT_OCTET8 rand) {
+  if (generation != smp_precompute_generation) return;
+
+  memcpy(&smp_precomputed_key_pair.private_key[offset], rand, BT_OCTET8_LEN);
+  offset += BT_OCTET8_LEN;
+  if (offset < BT_OCTET32_LEN) {
+    btsnd_hcic_ble_rand(
+        Bind(&smp_precompute_private_key, generation, offset));
+    return;
+  }
+  smp_precompute_public_key();
+}
+
+}  // namespace
+
+/*******************************************************************************
+ *
+ * Function         smp_crypto_init
+ *
+ * Description      This function starts the thread running the elliptic curve
+ *                  operations of the pairings. The thread outlives a stack
+ *                  restart, the results of the operations started before it
+ *                  are dropped.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void smp_crypto_init(void) {
+  smp_crypto_session++;
+  smp_precompute_generation++;
+  memset(&smp_precomputed_key_pair, 0, sizeof(smp_precomputed_key_pair));
+  if (!smp_crypto_thread.IsRunning()) {
+    smp_crypto_thread.StartUp();
+  }
+}
+
+/*******************************************************************************
+ *
+ * Function         smp_crypto_cancel_pending
+ *
+ * Description      This function is called when the pairing control block is
+ *                  reset, the results of the operations in progress are
+ *                  dropped.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void smp_crypto_cancel_pending(void) { smp_crypto_session++; }
+
+/*******************************************************************************
+ *
+ * Function         smp_precompute_key_pair
+ *
+ * Description      This function generates the local key pair of the next
+ *                  pairing in the background, unless one is already available
+ *                  or being generated.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void smp_precompute_key_pair(void) {
+  if (!smp_crypto_thread.IsRunning() || smp_precomputed_key_pair.valid ||
+      smp_precomputed_key_pair.pending) {
+    return;
+  }
+  smp_precomputed_key_pair.pending = true;
+  btsnd_hcic_ble_rand(Bind(&smp_precompute_private_key,
+                           smp_precompute_generation, static_cast<size_t>(0)));
+}
+
 /*******************************************************************************
  *
  * Function         smp_create_private_key
@@ -613,6 +852,13 @@ void smp_create_private_key(tSMP_CB* p_cb, tSMP_INT_DATA* p_data) {
     LOG_WARN("OOB Association Model with no saved data present");
   }
 
+  if (smp_take_precomputed_key_pair(p_cb)) {
+    smp_precompute_key_pair();
+    smp_process_public_key(p_cb);
+    return;
+  }
+  smp_precompute_key_pair();
+
   btsnd_hcic_ble_rand(Bind(
       [](tSMP_CB* p_cb, BT_OCTET8 rand) {
         memcpy((void*)p_cb->private_key, rand, BT_OCTET8_LEN);
@@ -700,31 +946,17 @@ void smp_use_oob_private_key(tSMP_CB* p_cb, tSMP_INT_DATA* p_data) {
  * Function         smp_process_private_key
  *
  * Description      This function processes private key.
- *                  It calculates public key and notifies SM that private key /
- *                  public key pair is created.
+ *                  It calculates public key on the crypto thread and notifies
+ *                  SM that private key / public key pair is created.
  *
  * Returns          void
  *
  ******************************************************************************/
 void smp_process_private_key(tSMP_CB* p_cb) {
-  Point public_key;
-  BT_OCTET32 private_key;
-
   SMP_TRACE_DEBUG("%s", __func__);
 
-  memcpy(private_key, p_cb->private_key, BT_OCTET32_LEN);
-  ECC_PointMult(&public_key, &(curve_p256.G), (uint32_t*)private_key);
-  memcpy(p_cb->loc_publ_key.x, public_key.x, BT_OCTET32_LEN);
-  memcpy(p_cb->loc_publ_key.y, public_key.y, BT_OCTET32_LEN);
-
-  smp_debug_print_nbyte_little_endian(p_cb->private_key, "private",
-                                      BT_OCTET32_LEN);
-  smp_debug_print_nbyte_little_endian(p_cb->loc_publ_key.x, "local public(x)",
-                                      BT_OCTET32_LEN);
-  smp_debug_print_nbyte_little_endian(p_cb->loc_publ_key.y, "local public(y)",
-                                      BT_OCTET32_LEN);
-  p_cb->flags |= SMP_PAIR_FLAG_HAVE_LOCAL_PUBL_KEY;
-  smp_sm_event(p_cb, SMP_LOC_PUBL_KEY_CRTD_EVT, NULL);
+  smp_run_crypto(p_cb, curve_p256.G, p_cb->private_key, &smp_save_public_key,
+                 &smp_process_public_key);
 }
 
 /*******************************************************************************
@@ -732,37 +964,26 @@ void smp_process_private_key(tSMP_CB* p_cb) {
  * Function         smp_compute_dhkey
  *
  * Description      The function:
- *                  - calculates a new public key using as input local private
- *                    key and peer public key;
- *                  - saves the new public key x-coordinate as DHKey.
+ *                  - calculates a new public key on the crypto thread, using
+ *                    as input local private key and peer public key;
+ *                  - saves the new public key x-coordinate as DHKey;
+ *                  - calls |p_cback| once the DHKey is saved.
  *
  * Returns          void
  *
  ******************************************************************************/
-void smp_compute_dhkey(tSMP_CB* p_cb) {
-  Point peer_publ_key, new_publ_key;
-  BT_OCTET32 private_key;
+void smp_compute_dhkey(tSMP_CB* p_cb, tSMP_CRYPTO_CBACK* p_cback) {
+  Point peer_publ_key;
 
   SMP_TRACE_DEBUG("%s", __func__);
 
-  memcpy(private_key, p_cb->private_key, BT_OCTET32_LEN);
   memcpy(peer_publ_key.x, p_cb->peer_publ_key.x, BT_OCTET32_LEN);
   memcpy(peer_publ_key.y, p_cb->peer_publ_key.y, BT_OCTET32_LEN);
+  memset(peer_publ_key.z, 0, sizeof(peer_publ_key.z));
+  peer_publ_key.z[0] = 1;
 
-  ECC_PointMult(&new_publ_key, &peer_publ_key, (uint32_t*)private_key);
-
-  memcpy(p_cb->dhkey, new_publ_key.x, BT_OCTET32_LEN);
-
-  smp_debug_print_nbyte_little_endian(p_cb->dhkey, "Old DHKey", BT_OCTET32_LEN);
-
-  smp_debug_print_nbyte_little_endian(p_cb->private_key, "private",
-                                      BT_OCTET32_LEN);
-  smp_debug_print_nbyte_little_endian(p_cb->peer_publ_key.x, "rem public(x)",
-                                      BT_OCTET32_LEN);
-  smp_debug_print_nbyte_little_endian(p_cb->peer_publ_key.y, "rem public(y)",
-                                      BT_OCTET32_LEN);
-  smp_debug_print_nbyte_little_endian(p_cb->dhkey, "Reverted DHKey",
-                                      BT_OCTET32_LEN);
+  smp_run_crypto(p_cb, peer_publ_key, p_cb->private_key, &smp_save_dhkey,
+                 p_cback);
 }
 
 /** The function calculates and saves local commmitment in CB. */
@@ -25,6 +25,8 @@
 #include <ctype.h>
 #include <string.h>
 
+#include <cinttypes>
+
 #include "bt_target.h"
 #include "bt_utils.h"
 #include "btm_ble_api.h"
@@ -890,6 +892,7 @@ void smp_cb_cleanup(tSMP_CB* p_cb) {
 
   alarm_cancel(p_cb->smp_rsp_timer_ent);
   alarm_cancel(p_cb->delayed_auth_timer_ent);
+  smp_crypto_cancel_pending();
   memset(p_cb, 0, sizeof(tSMP_CB));
   p_cb->p_callback = p_callback;
   p_cb->trace_level = trace_level;
@@ -1002,6 +1005,14 @@ void smp_proc_pairing_cmpl(tSMP_CB* p_cb) {
                           metric_status);
   }
 
+  if (p_cb->crypto_ops > 0) {
+    LOG_INFO(
+        "Pairing crypto remote:%s elliptic curve operations:%hhu time:%" PRIu64
+        "us precomputed key pair:%s",
+        PRIVATE_ADDRESS(pairing_bda), p_cb->crypto_ops, p_cb->crypto_time_us,
+        p_cb->used_precomputed_key ? "true" : "false");
+  }
+
   if (p_cb->status == SMP_SUCCESS && p_cb->smp_over_br) {
     btm_dev_consolidate_existing_connections(pairing_bda);
   }
@@ -0,0 +1,120 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "stack/btm/neighbor_inquiry.h"
+#include "types/raw_address.h"
+
+using ::benchmark::State;
+
+namespace {
+
+constexpr size_t kNumResults = 10000;
+
+// Addresses of a scan storm: |num_devices| advertisers, each reporting many
+// times in random order, as seen during a busy LE scan merged into inquiry.
+std::vector<RawAddress> ScanStorm(size_t num_devices) {
+  std::mt19937 rng(num_devices);
+  std::uniform_int_distribution<uint32_t> pick(0, num_devices - 1);
+  std::vector<RawAddress> results(kNumResults);
+  for (auto& bd_addr : results) {
+    uint32_t id = pick(rng);
+    bd_addr = RawAddress({0x00, 0x11, static_cast<uint8_t>(id >> 24),
+                          static_cast<uint8_t>(id >> 16),
+                          static_cast<uint8_t>(id >> 8),
+                          static_cast<uint8_t>(id)});
+  }
+  return results;
+}
+
+// The linear search and oldest-entry eviction the inquiry database used
+// before it was indexed, kept as the baseline.
+tINQ_DB_ENT* LinearFind(std::vector<tINQ_DB_ENT>& db, const RawAddress& bda) {
+  for (auto& ent : db) {
+    if (ent.in_use && ent.inq_info.results.remote_bd_addr == bda) return &ent;
+  }
+  return nullptr;
+}
+
+tINQ_DB_ENT* LinearNew(std::vector<tINQ_DB_ENT>& db, const RawAddress& bda) {
+  tINQ_DB_ENT* p_old = &db[0];
+  uint64_t ot = UINT64_MAX;
+  for (auto& ent : db) {
+    if (!ent.in_use) {
+      p_old = &ent;
+      break;
+    }
+    if (ent.time_of_resp < ot) {
+      p_old = &ent;
+      ot = ent.time_of_resp;
+    }
+  }
+  memset(p_old, 0, sizeof(tINQ_DB_ENT));
+  p_old->inq_info.results.remote_bd_addr = bda;
+  p_old->in_use = true;
+  return p_old;
+}
+
+void BM_InquiryDbLinear(State& state) {
+  std::vector<tINQ_DB_ENT> db(state.range(0));
+  auto results = ScanStorm(state.range(1));
+  uint64_t now = 0;
+  for (auto _ : state) {
+    for (const auto& bda : results) {
+      tINQ_DB_ENT* p_ent = LinearFind(db, bda);
+      if (p_ent == nullptr) p_ent = LinearNew(db, bda);
+      p_ent->time_of_resp = ++now;
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * results.size());
+}
+
+void BM_InquiryDbIndexed(State& state) {
+  std::vector<tINQ_DB_ENT> db(state.range(0));
+  InquiryDbIndex index;
+  index.Reset(db.data(), db.size());
+  auto results = ScanStorm(state.range(1));
+  uint64_t now = 0;
+  for (auto _ : state) {
+    for (const auto& bda : results) {
+      tINQ_DB_ENT* p_ent = index.Find(bda);
+      if (p_ent == nullptr) p_ent = index.Allocate(bda);
+      p_ent->time_of_resp = ++now;
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * results.size());
+}
+
+// Database size x number of distinct advertisers
+void ScanStormArgs(benchmark::internal::Benchmark* b) {
+  for (int db_size : {40, 256, 1024}) {
+    for (int num_devices : {20, 200, 2000}) {
+      b->Args({db_size, num_devices});
+    }
+  }
+}
+
+}  // namespace
+
+BENCHMARK(BM_InquiryDbLinear)->Apply(ScanStormArgs);
+BENCHMARK(BM_InquiryDbIndexed)->Apply(ScanStormArgs);
+
+BENCHMARK_MAIN();
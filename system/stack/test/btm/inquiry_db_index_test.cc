@@ -0,0 +1,113 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <array>
+
+#include "stack/btm/neighbor_inquiry.h"
+#include "types/raw_address.h"
+
+namespace {
+
+constexpr size_t kNumEntries = 4;
+
+RawAddress MakeAddress(uint8_t id) {
+  return RawAddress({0x11, 0x22, 0x33, 0x44, 0x55, id});
+}
+
+class InquiryDbIndexTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    entries_ = {};
+    index_.Reset(entries_.data(), entries_.size());
+  }
+
+  std::array<tINQ_DB_ENT, kNumEntries> entries_;
+  InquiryDbIndex index_;
+};
+
+}  // namespace
+
+TEST_F(InquiryDbIndexTest, allocate_and_find) {
+  tINQ_DB_ENT* p_ent = index_.Allocate(MakeAddress(1));
+  ASSERT_NE(nullptr, p_ent);
+  ASSERT_TRUE(p_ent->in_use);
+  ASSERT_EQ(MakeAddress(1), p_ent->inq_info.results.remote_bd_addr);
+  // Free slots are handed out in database order
+  ASSERT_EQ(&entries_[0], p_ent);
+
+  ASSERT_EQ(p_ent, index_.Find(MakeAddress(1)));
+  ASSERT_EQ(nullptr, index_.Find(MakeAddress(2)));
+  ASSERT_EQ(1UL, index_.Size());
+}
+
+TEST_F(InquiryDbIndexTest, release) {
+  tINQ_DB_ENT* p_ent = index_.Allocate(MakeAddress(1));
+  index_.Release(p_ent);
+  ASSERT_FALSE(p_ent->in_use);
+  ASSERT_EQ(nullptr, index_.Find(MakeAddress(1)));
+  ASSERT_EQ(0UL, index_.Size());
+
+  // Released entries are reused
+  ASSERT_EQ(p_ent, index_.Allocate(MakeAddress(2)));
+}
+
+TEST_F(InquiryDbIndexTest, evicts_least_recently_used) {
+  for (uint8_t i = 0; i < kNumEntries; i++) {
+    ASSERT_NE(nullptr, index_.Allocate(MakeAddress(i)));
+  }
+
+  // Refresh the oldest entry so that the second one becomes the oldest
+  tINQ_DB_ENT* p_first = index_.Find(MakeAddress(0));
+  tINQ_DB_ENT* p_second = index_.Find(MakeAddress(1));
+  for (uint8_t i = 2; i < kNumEntries; i++) index_.Find(MakeAddress(i));
+  index_.Find(MakeAddress(0));
+
+  tINQ_DB_ENT* p_ent = index_.Allocate(MakeAddress(0xff));
+  ASSERT_EQ(p_second, p_ent);
+  ASSERT_EQ(nullptr, index_.Find(MakeAddress(1)));
+  ASSERT_EQ(p_first, index_.Find(MakeAddress(0)));
+  ASSERT_EQ(kNumEntries, index_.Size());
+}
+
+TEST_F(InquiryDbIndexTest, reset_orders_by_time_of_resp) {
+  for (uint8_t i = 0; i < kNumEntries; i++) {
+    entries_[i].in_use = true;
+    entries_[i].inq_info.results.remote_bd_addr = MakeAddress(i);
+    entries_[i].time_of_resp = 100 - i;
+  }
+  index_.Reset(entries_.data(), entries_.size());
+  ASSERT_EQ(kNumEntries, index_.Size());
+
+  // The entry with the oldest response is evicted first
+  tINQ_DB_ENT* p_ent = index_.Allocate(MakeAddress(0xff));
+  ASSERT_EQ(&entries_[kNumEntries - 1], p_ent);
+}
+
+TEST_F(InquiryDbIndexTest, reset_drops_duplicate_addresses) {
+  entries_[0].in_use = true;
+  entries_[0].inq_info.results.remote_bd_addr = MakeAddress(1);
+  entries_[0].time_of_resp = 1;
+  entries_[1].in_use = true;
+  entries_[1].inq_info.results.remote_bd_addr = MakeAddress(1);
+  entries_[1].time_of_resp = 2;
+  index_.Reset(entries_.data(), entries_.size());
+
+  ASSERT_EQ(1UL, index_.Size());
+  ASSERT_EQ(&entries_[1], index_.Find(MakeAddress(1)));
+  ASSERT_FALSE(entries_[0].in_use);
+}
@@ -399,4 +399,22 @@ TEST(CryptoToolboxTest, bt_spec_example_d_12_test) {
   EXPECT_EQ(expected_ltk, ltk);
 }
 
+TEST(CryptoToolboxTest, aes_128_batch_matches_single) {
+  Octet16 key{0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+              0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+  std::vector<Octet16> messages(3);
+  for (size_t i = 0; i < messages.size(); i++) {
+    messages[i].fill(0);
+    messages[i][0] = i;
+    messages[i][15] = 0xff - i;
+  }
+
+  std::vector<Octet16> outputs = aes_128(key, messages);
+  ASSERT_EQ(messages.size(), outputs.size());
+  for (size_t i = 0; i < messages.size(); i++) {
+    EXPECT_EQ(aes_128(key, messages[i]), outputs[i]);
+  }
+  EXPECT_TRUE(aes_128(key, std::vector<Octet16>{}).empty());
+}
+
 }  // namespace crypto_toolbox
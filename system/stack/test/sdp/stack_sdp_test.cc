@@ -19,9 +19,13 @@
 #include <stdlib.h>
 
 #include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
 
 #include "stack/include/sdp_api.h"
 #include "stack/sdp/sdpint.h"
+#include "test/mock/mock_btif_config.h"
 #include "test/mock/mock_osi_allocator.h"
 #include "test/mock/mock_stack_l2cap_api.h"
 
@@ -32,6 +36,9 @@
 static int L2CA_ConnectReq2_cid = 0x42;
 static RawAddress addr = RawAddress({0xA1, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6});
 static tSDP_DISCOVERY_DB* sdp_db = nullptr;
+static bool peer_bonded = false;
+
+bool btm_sec_is_a_bonded_dev(const RawAddress& bda) { return peer_bonded; }
 
 class StackSdpMainTest : public ::testing::Test {
  protected:
@@ -172,3 +179,117 @@ TEST_F(StackSdpMainTest, sdp_service_search_request_queuing_race_condition) {
 
   sdp_disconnect(p_ccb2, SDP_SUCCESS);
 }
+
+class StackSdpCacheTest : public StackSdpMainTest {
+ protected:
+  void SetUp() override {
+    StackSdpMainTest::SetUp();
+    config_.clear();
+    test::mock::btif_config::btif_config_exist.body =
+        [this](const std::string& section, const std::string& key) {
+          return config_.count(section + key) != 0;
+        };
+    test::mock::btif_config::btif_config_get_bin_length.body =
+        [this](const std::string& section, const std::string& key) {
+          auto it = config_.find(section + key);
+          return it == config_.end() ? 0 : it->second.size();
+        };
+    test::mock::btif_config::btif_config_get_bin.body =
+        [this](const std::string& section, const std::string& key,
+               uint8_t* value, size_t* length) {
+          auto it = config_.find(section + key);
+          if (it == config_.end() || *length < it->second.size()) return false;
+          std::copy(it->second.begin(), it->second.end(), value);
+          *length = it->second.size();
+          return true;
+        };
+    test::mock::btif_config::btif_config_set_bin.body =
+        [this](const std::string& section, const std::string& key,
+               const uint8_t* value, size_t length) {
+          config_[section + key].assign(value, value + length);
+          return true;
+        };
+    test::mock::btif_config::btif_config_remove.body =
+        [this](const std::string& section, const std::string& key) {
+          return config_.erase(section + key) != 0;
+        };
+    peer_bonded = true;
+
+    const bluetooth::Uuid uuid = bluetooth::Uuid::From16Bit(0x110b);
+    const uint16_t attr = 0x0001;
+    ASSERT_TRUE(SDP_InitDiscoveryDb(sdp_db, BT_DEFAULT_BUFFER_SIZE, 1, &uuid,
+                                    1, &attr));
+    sdp_db->use_cache = true;
+  }
+
+  void TearDown() override {
+    test::mock::btif_config::btif_config_exist = {};
+    test::mock::btif_config::btif_config_get_bin_length = {};
+    test::mock::btif_config::btif_config_get_bin = {};
+    test::mock::btif_config::btif_config_set_bin = {};
+    test::mock::btif_config::btif_config_remove = {};
+    peer_bonded = false;
+    StackSdpMainTest::TearDown();
+  }
+
+  // Complete a search through the channel of |p_ccb| with a response holding
+  // the service class list of an audio sink
+  void CompleteSearch(tCONN_CB* p_ccb) {
+    const std::vector<uint8_t> response = {0x35, 0x0a, 0x35, 0x08,
+                                           0x09, 0x00, 0x01, 0x35,
+                                           0x03, 0x19, 0x11, 0x0b};
+    p_ccb->rsp_list = (uint8_t*)osi_malloc(SDP_MAX_LIST_BYTE_COUNT);
+    std::copy(response.begin(), response.end(), p_ccb->rsp_list);
+    p_ccb->list_len = response.size();
+    ASSERT_EQ(SDP_SUCCESS, sdp_save_search_attr_rsp(p_ccb));
+    sdp_cache_store(*p_ccb);
+    sdp_disconnect(p_ccb, SDP_SUCCESS);
+    sdp_cb.reg_info.pL2CA_DisconnectCfm_Cb(p_ccb->connection_id, 0);
+  }
+
+  std::map<std::string, std::vector<uint8_t>> config_;
+};
+
+TEST_F(StackSdpCacheTest, reconnection_skips_sdp) {
+  ASSERT_TRUE(SDP_ServiceSearchAttributeRequest(addr, sdp_db, nullptr));
+  const int cid = L2CA_ConnectReq2_cid;
+  tCONN_CB* p_ccb = sdpu_find_ccb_by_cid(cid);
+  ASSERT_NE(p_ccb, nullptr);
+  ASSERT_EQ(p_ccb->con_state, SDP_STATE_CONN_SETUP);
+  CompleteSearch(p_ccb);
+  ASSERT_EQ(p_ccb->con_state, SDP_STATE_IDLE);
+
+  sdp_db->p_first_rec = nullptr;
+  sdp_db->mem_free = sdp_db->mem_size;
+  sdp_db->p_free_mem = (uint8_t*)(sdp_db + 1);
+  ASSERT_TRUE(SDP_ServiceSearchAttributeRequest(addr, sdp_db, nullptr));
+
+  // No channel was opened, the records are already in the database
+  ASSERT_EQ(cid, L2CA_ConnectReq2_cid);
+  p_ccb = sdpu_find_ccb_by_db(sdp_db);
+  ASSERT_NE(p_ccb, nullptr);
+  ASSERT_EQ(p_ccb->con_state, SDP_STATE_FROM_CACHE);
+  ASSERT_NE(SDP_FindServiceInDb(sdp_db, 0x110b, nullptr), nullptr);
+
+  sdp_disconnect(p_ccb, SDP_SUCCESS);
+  ASSERT_EQ(p_ccb->con_state, SDP_STATE_IDLE);
+}
+
+TEST_F(StackSdpCacheTest, invalidated_cache_goes_to_the_device) {
+  ASSERT_TRUE(SDP_ServiceSearchAttributeRequest(addr, sdp_db, nullptr));
+  CompleteSearch(sdpu_find_ccb_by_cid(L2CA_ConnectReq2_cid));
+
+  // Only the searches of the invalidated service are dropped
+  SDP_InvalidateDiscoveryCache(addr, bluetooth::Uuid::From16Bit(0x111f));
+  ASSERT_TRUE(config_.count(addr.ToString() +
+                            BT_CONFIG_KEY_SDP_DISCOVERY_CACHE) != 0);
+  SDP_InvalidateDiscoveryCache(addr, bluetooth::Uuid::From16Bit(0x110b));
+
+  const int cid = L2CA_ConnectReq2_cid;
+  ASSERT_TRUE(SDP_ServiceSearchAttributeRequest(addr, sdp_db, nullptr));
+  ASSERT_NE(cid, L2CA_ConnectReq2_cid);
+  tCONN_CB* p_ccb = sdpu_find_ccb_by_cid(L2CA_ConnectReq2_cid);
+  ASSERT_NE(p_ccb, nullptr);
+  ASSERT_EQ(p_ccb->con_state, SDP_STATE_CONN_SETUP);
+  sdp_disconnect(p_ccb, SDP_SUCCESS);
+}
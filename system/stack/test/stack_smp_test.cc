@@ -412,4 +412,33 @@ TEST(SmpEccValidationTest, test_invalid_points) {
 
   EXPECT_FALSE(ECC_ValidatePoint(p));
 }
+
+namespace {
+int dhkey_computed_count = 0;
+void on_dhkey_computed(tSMP_CB*) { dhkey_computed_count++; }
+}  // namespace
+
+// The crypto thread is not started, the DHKey is computed inline.
+TEST(SmpCryptoTest, test_compute_dhkey) {
+  p_256_init_curve();
+
+  uint32_t two[KEY_LENGTH_DWORDS_P256] = {2};
+  uint32_t six[KEY_LENGTH_DWORDS_P256] = {6};
+  Point generator = curve_p256.G;
+  Point peer_publ_key, expected;
+  ECC_PointMult(&peer_publ_key, &generator, two);
+  ECC_PointMult(&expected, &generator, six);
+
+  tSMP_CB cb{};
+  cb.private_key[0] = 3;
+  memcpy(cb.peer_publ_key.x, peer_publ_key.x, BT_OCTET32_LEN);
+  memcpy(cb.peer_publ_key.y, peer_publ_key.y, BT_OCTET32_LEN);
+
+  dhkey_computed_count = 0;
+  smp_compute_dhkey(&cb, on_dhkey_computed);
+
+  EXPECT_EQ(dhkey_computed_count, 1);
+  EXPECT_EQ(memcmp(cb.dhkey, expected.x, BT_OCTET32_LEN), 0);
+  EXPECT_EQ(cb.crypto_ops, 1);
+}
 }  // namespace testing
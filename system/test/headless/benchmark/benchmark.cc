@@ -0,0 +1,103 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "bt_headless"
+
+#include "test/headless/benchmark/benchmark.h"
+
+#include <cstdio>
+#include <sstream>
+
+#include "base/logging.h"     // LOG() stdout and android log
+#include "osi/include/log.h"  // android log only
+#include "test/headless/benchmark/gatt.h"
+#include "test/headless/benchmark/latency.h"
+#include "test/headless/benchmark/throughput.h"
+#include "test/headless/get_options.h"
+#include "test/headless/headless.h"
+
+using namespace bluetooth::test::headless;
+
+Benchmark::Benchmark(const bluetooth::test::headless::GetOpt& options)
+    : HeadlessTest<int>(options) {
+  test_nodes_.emplace(
+      "connect",
+      std::make_unique<bluetooth::test::headless::ConnectLatency>(options));
+  test_nodes_.emplace(
+      "l2cap", std::make_unique<bluetooth::test::headless::L2capThroughput>(
+                   options, BT_TRANSPORT_BR_EDR));
+  test_nodes_.emplace(
+      "coc", std::make_unique<bluetooth::test::headless::L2capThroughput>(
+                 options, BT_TRANSPORT_LE));
+  test_nodes_.emplace(
+      "gatt", std::make_unique<bluetooth::test::headless::GattNotificationRate>(
+                  options));
+  test_nodes_.emplace(
+      "gatt_server",
+      std::make_unique<bluetooth::test::headless::GattNotificationServer>(
+          options));
+  test_nodes_.emplace(
+      "rfcomm",
+      std::make_unique<bluetooth::test::headless::RfcommThroughput>(options));
+  test_nodes_.emplace(
+      "sink",
+      std::make_unique<bluetooth::test::headless::ThroughputSink>(options));
+}
+
+BenchmarkResult::BenchmarkResult(const std::string& benchmark) {
+  Add("benchmark", benchmark);
+}
+
+BenchmarkResult& BenchmarkResult::Add(const std::string& key, double value) {
+  std::ostringstream ss;
+  ss << value;
+  fields_.emplace_back(key, ss.str());
+  return *this;
+}
+
+BenchmarkResult& BenchmarkResult::Add(const std::string& key,
+                                      const std::string& value) {
+  fields_.emplace_back(key, "\"" + value + "\"");
+  return *this;
+}
+
+void BenchmarkResult::Print() const {
+  std::ostringstream ss;
+  ss << kBenchmarkResultTag << " {";
+  for (size_t i = 0; i < fields_.size(); i++) {
+    ss << (i ? ", " : "") << "\"" << fields_[i].first
+       << "\": " << fields_[i].second;
+  }
+  ss << "}";
+  fprintf(stdout, "%s\n", ss.str().c_str());
+  fflush(stdout);
+}
+
+std::map<std::string, std::string>
+bluetooth::test::headless::ParseBenchmarkArgs(std::list<std::string>& args) {
+  std::map<std::string, std::string> parsed;
+  while (!args.empty()) {
+    std::string arg = args.front();
+    args.pop_front();
+    auto v = GetOpt::Split(arg);
+    if (v.size() == 2) {
+      parsed[v[0]] = v[1];
+    } else {
+      LOG(WARNING) << "Ignoring benchmark argument " << arg;
+    }
+  }
+  return parsed;
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <list>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "test/headless/get_options.h"
+#include "test/headless/headless.h"
+
+namespace bluetooth {
+namespace test {
+namespace headless {
+
+class Benchmark : public HeadlessTest<int> {
+ public:
+  Benchmark(const bluetooth::test::headless::GetOpt& options);
+};
+
+// Result of a benchmark run, printed on stdout as a single line holding a
+// JSON object, prefixed with kBenchmarkResultTag so that scripts can tell
+// the results apart from the rest of the output.
+class BenchmarkResult {
+ public:
+  BenchmarkResult(const std::string& benchmark);
+
+  BenchmarkResult& Add(const std::string& key, double value);
+  BenchmarkResult& Add(const std::string& key, const std::string& value);
+
+  void Print() const;
+
+ private:
+  std::vector<std::pair<std::string, std::string>> fields_;
+};
+
+constexpr char kBenchmarkResultTag[] = "BENCHMARK_RESULT";
+
+// Parse the <key>=<value> arguments following the benchmark name.
+std::map<std::string, std::string> ParseBenchmarkArgs(
+    std::list<std::string>& args);
+
+}  // namespace headless
+}  // namespace test
+}  // namespace bluetooth
@@ -0,0 +1,511 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "bt_headless_benchmark"
+
+#include "test/headless/benchmark/gatt.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "base/logging.h"     // LOG() stdout and android log
+#include "osi/include/log.h"  // android log only
+#include "stack/include/btm_api.h"
+#include "stack/include/btu.h"
+#include "stack/include/gatt_api.h"
+#include "test/headless/benchmark/benchmark.h"
+#include "test/headless/get_options.h"
+#include "test/headless/headless.h"
+#include "types/bluetooth/uuid.h"
+#include "types/raw_address.h"
+
+using namespace bluetooth::test::headless;
+using namespace std::chrono_literals;
+using bluetooth::Uuid;
+
+namespace {
+
+const Uuid kServerAppUuid =
+    Uuid::FromString("5ab1e7a0-4c1d-4a36-9c5e-2b0d9b1f0000");
+const Uuid kClientAppUuid =
+    Uuid::FromString("5ab1e7a0-4c1d-4a36-9c5e-2b0d9b1f0001");
+const Uuid kServiceUuid =
+    Uuid::FromString("5ab1e7a0-4c1d-4a36-9c5e-2b0d9b1f0002");
+const Uuid kCharacteristicUuid =
+    Uuid::FromString("5ab1e7a0-4c1d-4a36-9c5e-2b0d9b1f0003");
+
+constexpr uint32_t kDefaultNotifications = 1000;
+constexpr uint16_t kDefaultLength = GATT_DEF_BLE_MTU_SIZE - 3;
+// Largest notification value with the MTU requested by the client
+constexpr uint16_t kMaxLength = GATT_MAX_MTU_SIZE - 3;
+constexpr auto kBenchmarkTimeout = 120s;
+
+// The client starts a transfer by writing the number of notifications, then
+// their length, in little endian, to the benchmark characteristic.
+constexpr uint16_t kStartRequestSize = 6;
+
+using Clock = std::chrono::steady_clock;
+
+double milliseconds(Clock::duration duration) {
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+// State of the server. The GATT callbacks run on the main thread, the
+// benchmark thread only waits for |done| or |failed|.
+struct {
+  tGATT_IF gatt_if{0};
+  uint16_t value_handle{0};
+  uint16_t conn_id{GATT_INVALID_CONN_ID};
+  uint32_t notifications{0};
+  uint16_t length{0};
+  uint32_t sent{0};
+  bool congested{false};
+  Clock::time_point start_time;
+  Clock::time_point sent_time;
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool done{false};
+  bool failed{false};
+} server;
+
+void server_finish(bool failed) {
+  server.conn_id = GATT_INVALID_CONN_ID;
+  std::lock_guard<std::mutex> lock(server.mutex);
+  server.done = !failed;
+  server.failed = failed;
+  server.cv.notify_all();
+}
+
+// Send notifications until the link reports congestion or all of them were
+// handed to GATT.
+void server_send_until_congested() {
+  std::vector<uint8_t> value(server.length);
+  while (!server.congested && server.sent < server.notifications) {
+    std::fill(value.begin(), value.end(), server.sent & 0xff);
+    tGATT_STATUS status = GATTS_HandleValueNotification(
+        server.conn_id, server.value_handle, value.size(), value.data());
+    // A congested link still accepted the notification
+    if (status == GATT_CONGESTED) {
+      server.congested = true;
+    } else if (status != GATT_SUCCESS) {
+      LOG_WARN("Notification failed status:%hhu", status);
+      server_finish(true);
+      return;
+    }
+    server.sent++;
+  }
+
+  if (server.sent == server.notifications) {
+    server.sent_time = Clock::now();
+    server_finish(false);
+  }
+}
+
+void server_start(uint16_t conn_id, const uint8_t* request) {
+  server.conn_id = conn_id;
+  server.notifications = request[0] | (request[1] << 8) | (request[2] << 16) |
+                         ((uint32_t)request[3] << 24);
+  server.length = request[4] | (request[5] << 8);
+  server.sent = 0;
+  server.congested = false;
+  server.start_time = Clock::now();
+  server_send_until_congested();
+}
+
+void server_conn_cb(tGATT_IF, const RawAddress& bda, uint16_t conn_id,
+                    bool connected, tGATT_DISCONN_REASON reason,
+                    tBT_TRANSPORT) {
+  if (connected || conn_id != server.conn_id) return;
+
+  LOG_WARN("%s disconnected reason:%d after %u notifications",
+           bda.ToString().c_str(), reason, server.sent);
+  server_finish(true);
+}
+
+void server_req_cb(uint16_t conn_id, uint32_t trans_id, tGATTS_REQ_TYPE type,
+                   tGATTS_DATA* p_data) {
+  if (type != GATTS_REQ_TYPE_WRITE_CHARACTERISTIC) {
+    LOG_WARN("Unexpected request type:%hhu", type);
+    return;
+  }
+
+  const tGATT_WRITE_REQ& req = p_data->write_req;
+  bool valid = req.handle == server.value_handle && !req.is_prep &&
+               req.len == kStartRequestSize &&
+               server.conn_id == GATT_INVALID_CONN_ID;
+  if (req.need_rsp) {
+    tGATTS_RSP rsp{};
+    rsp.handle = req.handle;
+    GATTS_SendRsp(conn_id, trans_id, valid ? GATT_SUCCESS : GATT_ERROR, &rsp);
+  }
+  if (valid) server_start(conn_id, req.value);
+}
+
+void server_congestion_cb(uint16_t conn_id, bool congested) {
+  if (conn_id != server.conn_id) return;
+
+  server.congested = congested;
+  if (!congested) server_send_until_congested();
+}
+
+tGATT_CBACK server_callbacks = {.p_conn_cb = server_conn_cb,
+                                .p_cmpl_cb = nullptr,
+                                .p_disc_res_cb = nullptr,
+                                .p_disc_cmpl_cb = nullptr,
+                                .p_req_cb = server_req_cb,
+                                .p_enc_cmpl_cb = nullptr,
+                                .p_congestion_cb = server_congestion_cb,
+                                .p_phy_update_cb = nullptr,
+                                .p_conn_update_cb = nullptr};
+
+void server_register() {
+  server.gatt_if =
+      GATT_Register(kServerAppUuid, "Benchmark", &server_callbacks, false);
+  if (server.gatt_if == 0) {
+    LOG_ERROR("Unable to register the benchmark server");
+    server_finish(true);
+    return;
+  }
+  GATT_StartIf(server.gatt_if);
+
+  btgatt_db_element_t service[] = {
+      {
+          .uuid = kServiceUuid,
+          .type = BTGATT_DB_PRIMARY_SERVICE,
+      },
+      {.uuid = kCharacteristicUuid,
+       .type = BTGATT_DB_CHARACTERISTIC,
+       .properties = GATT_CHAR_PROP_BIT_WRITE | GATT_CHAR_PROP_BIT_NOTIFY,
+       .permissions = GATT_PERM_WRITE},
+  };
+  if (GATTS_AddService(server.gatt_if, service,
+                       sizeof(service) / sizeof(btgatt_db_element_t)) !=
+      GATT_SERVICE_STARTED) {
+    LOG_ERROR("Unable to add the benchmark service");
+    GATT_Deregister(server.gatt_if);
+    server.gatt_if = 0;
+    server_finish(true);
+    return;
+  }
+  server.value_handle = service[1].attribute_handle;
+
+  // Accept the LE connection of the client
+  BTM_SetConnectability(BTM_CONNECTABLE | BTM_BLE_CONNECTABLE);
+}
+
+// State of the client, accessed like the server one.
+struct {
+  tGATT_IF gatt_if{0};
+  RawAddress bd_addr;
+  uint16_t conn_id{GATT_INVALID_CONN_ID};
+  uint16_t value_handle{0};
+  uint32_t notifications{kDefaultNotifications};
+  uint16_t length{kDefaultLength};
+  uint32_t received{0};
+  Clock::time_point open_time;
+  Clock::time_point connected_time;
+  Clock::time_point request_time;
+  Clock::time_point first_time;
+  Clock::time_point last_time;
+  Clock::duration max_interval;
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool done{false};
+  bool failed{false};
+} client;
+
+void client_finish(bool failed) {
+  std::lock_guard<std::mutex> lock(client.mutex);
+  if (client.done || client.failed) return;
+  client.done = !failed;
+  client.failed = failed;
+  client.cv.notify_all();
+}
+
+void client_request() {
+  tGATT_VALUE value{};
+  value.conn_id = client.conn_id;
+  value.handle = client.value_handle;
+  value.len = kStartRequestSize;
+  value.value[0] = client.notifications & 0xff;
+  value.value[1] = (client.notifications >> 8) & 0xff;
+  value.value[2] = (client.notifications >> 16) & 0xff;
+  value.value[3] = (client.notifications >> 24) & 0xff;
+  value.value[4] = client.length & 0xff;
+  value.value[5] = (client.length >> 8) & 0xff;
+
+  client.request_time = Clock::now();
+  tGATT_STATUS status = GATTC_Write(client.conn_id, GATT_WRITE, &value);
+  if (status != GATT_SUCCESS) {
+    LOG_WARN("Write failed status:%hhu", status);
+    client_finish(true);
+  }
+}
+
+void client_discover() {
+  tGATT_STATUS status =
+      GATTC_Discover(client.conn_id, GATT_DISC_CHAR, 0x0001, 0xffff);
+  if (status != GATT_SUCCESS) {
+    LOG_WARN("Discovery failed status:%hhu", status);
+    client_finish(true);
+  }
+}
+
+void client_connected(uint16_t conn_id) {
+  // Already connected links are reported by both GATT_StartIf() and
+  // GATT_GetConnIdIfConnected()
+  if (client.conn_id != GATT_INVALID_CONN_ID) return;
+
+  client.conn_id = conn_id;
+  client.connected_time = Clock::now();
+  // The MTU may already have been exchanged on this link
+  if (GATTC_ConfigureMTU(conn_id, GATT_MAX_MTU_SIZE) != GATT_SUCCESS) {
+    client_discover();
+  }
+}
+
+void client_notified(uint16_t len) {
+  if (len != client.length) {
+    LOG_WARN("Unexpected notification length:%hu", len);
+  }
+  auto now = Clock::now();
+  if (client.received == 0) {
+    client.first_time = now;
+  } else {
+    client.max_interval = std::max(client.max_interval, now - client.last_time);
+  }
+  client.last_time = now;
+  if (++client.received == client.notifications) {
+    client_finish(false);
+  }
+}
+
+void client_conn_cb(tGATT_IF gatt_if, const RawAddress& bda, uint16_t conn_id,
+                    bool connected, tGATT_DISCONN_REASON reason,
+                    tBT_TRANSPORT transport) {
+  if (gatt_if != client.gatt_if || bda != client.bd_addr ||
+      transport != BT_TRANSPORT_LE) {
+    return;
+  }
+
+  if (connected) {
+    client_connected(conn_id);
+  } else {
+    LOG_WARN("%s disconnected reason:%d after %u notifications",
+             bda.ToString().c_str(), reason, client.received);
+    client.conn_id = GATT_INVALID_CONN_ID;
+    client_finish(true);
+  }
+}
+
+void client_cmpl_cb(uint16_t conn_id, tGATTC_OPTYPE op, tGATT_STATUS status,
+                    tGATT_CL_COMPLETE* p_data) {
+  if (conn_id != client.conn_id) return;
+
+  switch (op) {
+    case GATTC_OPTYPE_CONFIG:
+      client_discover();
+      break;
+    case GATTC_OPTYPE_WRITE:
+      if (status != GATT_SUCCESS) {
+        LOG_WARN("Request rejected status:%hhu", status);
+        client_finish(true);
+      }
+      break;
+    case GATTC_OPTYPE_NOTIFICATION:
+      if (p_data->att_value.handle == client.value_handle) {
+        client_notified(p_data->att_value.len);
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+void client_disc_res_cb(uint16_t conn_id, tGATT_DISC_TYPE disc_type,
+                        tGATT_DISC_RES* p_data) {
+  if (conn_id != client.conn_id || disc_type != GATT_DISC_CHAR) return;
+
+  if (p_data->value.dclr_value.char_uuid == kCharacteristicUuid) {
+    client.value_handle = p_data->value.dclr_value.val_handle;
+  }
+}
+
+void client_disc_cmpl_cb(uint16_t conn_id, tGATT_DISC_TYPE disc_type,
+                         tGATT_STATUS status) {
+  if (conn_id != client.conn_id || disc_type != GATT_DISC_CHAR) return;
+
+  if (client.value_handle == 0) {
+    LOG_WARN("Benchmark characteristic not found status:%hhu", status);
+    client_finish(true);
+    return;
+  }
+  client_request();
+}
+
+tGATT_CBACK client_callbacks = {.p_conn_cb = client_conn_cb,
+                                .p_cmpl_cb = client_cmpl_cb,
+                                .p_disc_res_cb = client_disc_res_cb,
+                                .p_disc_cmpl_cb = client_disc_cmpl_cb,
+                                .p_req_cb = nullptr,
+                                .p_enc_cmpl_cb = nullptr,
+                                .p_congestion_cb = nullptr,
+                                .p_phy_update_cb = nullptr,
+                                .p_conn_update_cb = nullptr};
+
+void client_open() {
+  client.gatt_if =
+      GATT_Register(kClientAppUuid, "Benchmark client", &client_callbacks,
+                    false);
+  if (client.gatt_if == 0) {
+    LOG_ERROR("Unable to register the benchmark client");
+    client_finish(true);
+    return;
+  }
+  GATT_StartIf(client.gatt_if);
+
+  client.open_time = Clock::now();
+  if (!GATT_Connect(client.gatt_if, client.bd_addr, BTM_BLE_DIRECT_CONNECTION,
+                    BT_TRANSPORT_LE, false)) {
+    LOG_ERROR("Unable to connect to %s", client.bd_addr.ToString().c_str());
+    client_finish(true);
+    return;
+  }
+  uint16_t conn_id;
+  if (GATT_GetConnIdIfConnected(client.gatt_if, client.bd_addr, &conn_id,
+                                BT_TRANSPORT_LE)) {
+    client_connected(conn_id);
+  }
+}
+
+void client_close() {
+  if (client.gatt_if == 0) return;
+  if (client.conn_id != GATT_INVALID_CONN_ID) {
+    GATT_Disconnect(client.conn_id);
+  }
+  GATT_Deregister(client.gatt_if);
+  client.gatt_if = 0;
+  client.conn_id = GATT_INVALID_CONN_ID;
+}
+
+}  // namespace
+
+int bluetooth::test::headless::GattNotificationRate::Run() {
+  if (options_.device_.size() != 1) {
+    fprintf(stdout, "This benchmark requires a single device specified\n");
+    options_.Usage();
+    return -1;
+  }
+
+  auto args = ParseBenchmarkArgs(options_.non_options_);
+  uint32_t notifications = kDefaultNotifications;
+  uint32_t length = kDefaultLength;
+  if (args.count("notifications")) {
+    notifications = std::stoul(args["notifications"]);
+  }
+  if (args.count("length")) length = std::stoul(args["length"]);
+  if (notifications == 0 || length == 0 || length > kMaxLength) {
+    fprintf(stdout,
+            "Invalid arguments notifications:%u length:%u (max %hu)\n",
+            notifications, length, kMaxLength);
+    return -1;
+  }
+
+  const RawAddress bd_addr = options_.device_.front();
+
+  return RunOnHeadlessStack<int>([=]() {
+    {
+      std::lock_guard<std::mutex> lock(client.mutex);
+      client.done = false;
+      client.failed = false;
+    }
+
+    post_on_bt_main([=]() {
+      client.bd_addr = bd_addr;
+      client.notifications = notifications;
+      client.length = length;
+      client.conn_id = GATT_INVALID_CONN_ID;
+      client.value_handle = 0;
+      client.received = 0;
+      client.max_interval = Clock::duration::zero();
+      client_open();
+    });
+
+    bool completed;
+    {
+      std::unique_lock<std::mutex> lock(client.mutex);
+      completed = client.cv.wait_for(
+          lock, kBenchmarkTimeout,
+          []() { return client.done || client.failed; });
+      completed = completed && client.done;
+    }
+
+    post_on_bt_main([]() { client_close(); });
+
+    if (!completed) {
+      fprintf(stdout, "Unable to receive %u notifications from %s\n",
+              notifications, bd_addr.ToString().c_str());
+      return -1;
+    }
+
+    auto duration = client.last_time - client.request_time;
+    std::chrono::duration<double> seconds = duration;
+    BenchmarkResult("gatt_notification_rate")
+        .Add("device", bd_addr.ToString())
+        .Add("notifications", notifications)
+        .Add("length", length)
+        .Add("setup_ms", milliseconds(client.connected_time - client.open_time))
+        .Add("first_ms", milliseconds(client.first_time - client.request_time))
+        .Add("duration_ms", milliseconds(duration))
+        .Add("per_second", notifications / seconds.count())
+        .Add("kbps",
+             (double)notifications * length * 8 / seconds.count() / 1000)
+        .Add("max_interval_ms", milliseconds(client.max_interval))
+        .Print();
+    return 0;
+  });
+}
+
+int bluetooth::test::headless::GattNotificationServer::Run() {
+  return RunOnHeadlessStack<int>([]() {
+    {
+      std::lock_guard<std::mutex> lock(server.mutex);
+      server.done = false;
+      server.failed = false;
+    }
+    post_on_bt_main([]() {
+      if (server.gatt_if == 0) server_register();
+    });
+
+    fprintf(stdout, "Waiting for a notification request\n");
+    std::unique_lock<std::mutex> lock(server.mutex);
+    server.cv.wait(lock, []() { return server.done || server.failed; });
+    if (server.failed) return -1;
+
+    BenchmarkResult("gatt_notification_server")
+        .Add("notifications", server.notifications)
+        .Add("length", server.length)
+        .Add("sent_ms", milliseconds(server.sent_time - server.start_time))
+        .Print();
+    return 0;
+  });
+}
@@ -0,0 +1,126 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "bt_headless_benchmark"
+
+#include "test/headless/benchmark/latency.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "base/logging.h"     // LOG() stdout and android log
+#include "osi/include/log.h"  // android log only
+#include "stack/include/acl_api.h"
+#include "stack/include/btu.h"
+#include "stack/include/l2cap_acl_interface.h"
+#include "test/headless/benchmark/benchmark.h"
+#include "test/headless/get_options.h"
+#include "test/headless/headless.h"
+#include "test/headless/interface.h"
+#include "types/raw_address.h"
+
+using namespace bluetooth::test::headless;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr auto kConnectTimeout = 30s;
+
+std::mutex acl_state_mutex;
+std::condition_variable acl_state_cv;
+std::optional<bt_acl_state_t> acl_state;
+
+void acl_state_changed_callback(interface_data_t data) {
+  std::lock_guard<std::mutex> lock(acl_state_mutex);
+  acl_state = data.params.acl_state_changed.state;
+  acl_state_cv.notify_all();
+}
+
+// Run |action| on the main thread and wait for the ACL to reach |state|,
+// returns false on timeout.
+bool change_acl_state(std::function<void()> action, bt_acl_state_t state) {
+  std::unique_lock<std::mutex> lock(acl_state_mutex);
+  acl_state.reset();
+  post_on_bt_main(std::move(action));
+  return acl_state_cv.wait_for(lock, kConnectTimeout,
+                               [state] { return acl_state == state; });
+}
+
+}  // namespace
+
+int bluetooth::test::headless::ConnectLatency::Run() {
+  if (options_.device_.size() != 1) {
+    fprintf(stdout, "This benchmark requires a single device specified\n");
+    options_.Usage();
+    return -1;
+  }
+
+  const RawAddress& bd_addr = options_.device_.front();
+  std::vector<double> latencies;
+
+  headless_add_callback("acl_state_changed", acl_state_changed_callback);
+  int rc = RunOnHeadlessStack<int>([&bd_addr, &latencies]() {
+    auto start = std::chrono::steady_clock::now();
+    if (!change_acl_state(
+            [bd_addr]() {
+              acl_create_classic_connection(bd_addr, false, false);
+            },
+            BT_ACL_STATE_CONNECTED)) {
+      fprintf(stdout, "Unable to connect to %s\n", bd_addr.ToString().c_str());
+      return -1;
+    }
+    std::chrono::duration<double, std::milli> latency =
+        std::chrono::steady_clock::now() - start;
+    latencies.push_back(latency.count());
+
+    BenchmarkResult("connect_latency")
+        .Add("device", bd_addr.ToString())
+        .Add("latency_ms", latency.count())
+        .Print();
+
+    if (!change_acl_state(
+            [bd_addr]() { btm_remove_acl(bd_addr, BT_TRANSPORT_BR_EDR); },
+            BT_ACL_STATE_DISCONNECTED)) {
+      fprintf(stdout, "Unable to disconnect from %s\n",
+              bd_addr.ToString().c_str());
+      return -1;
+    }
+    return 0;
+  });
+  headless_remove_callback("acl_state_changed", acl_state_changed_callback);
+
+  if (!latencies.empty()) {
+    std::sort(latencies.begin(), latencies.end());
+    double total = 0;
+    for (double latency : latencies) {
+      total += latency;
+    }
+    BenchmarkResult("connect_latency_summary")
+        .Add("device", bd_addr.ToString())
+        .Add("samples", latencies.size())
+        .Add("min_ms", latencies.front())
+        .Add("median_ms", latencies[latencies.size() / 2])
+        .Add("mean_ms", total / latencies.size())
+        .Add("max_ms", latencies.back())
+        .Print();
+  }
+  return rc;
+}
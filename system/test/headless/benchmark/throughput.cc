@@ -0,0 +1,610 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "bt_headless_benchmark"
+
+#include "test/headless/benchmark/throughput.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "base/logging.h"     // LOG() stdout and android log
+#include "osi/include/allocator.h"
+#include "osi/include/log.h"  // android log only
+#include "stack/include/bt_hdr.h"
+#include "stack/include/btm_api_types.h"
+#include "stack/include/btu.h"
+#include "stack/include/gap_api.h"
+#include "stack/include/l2c_api.h"
+#include "stack/include/port_api.h"
+#include "stack/include/sdpdefs.h"
+#include "test/headless/benchmark/benchmark.h"
+#include "test/headless/get_options.h"
+#include "test/headless/headless.h"
+#include "types/raw_address.h"
+
+using namespace bluetooth::test::headless;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr uint16_t kBenchmarkPsm = 0x1001;
+constexpr uint16_t kBenchmarkLePsm = 0x0081;
+constexpr uint8_t kBenchmarkScn = 30;
+constexpr uint16_t kBenchmarkMtu = 2048;
+constexpr uint16_t kBenchmarkLeMps = 0xffff;
+constexpr size_t kDefaultTotalBytes = 1 << 20;
+constexpr auto kBenchmarkTimeout = 120s;
+
+// Each transfer starts with its total size in bytes, in little endian, so
+// that the sink knows when all the data was received. The sink then sends
+// back a single byte, and the transfer time is measured up to its receipt.
+constexpr size_t kTransferHeaderSize = 4;
+constexpr uint8_t kTransferAck = 0x06;
+
+using Clock = std::chrono::steady_clock;
+
+const char* transport_name(tBT_TRANSPORT transport) {
+  return transport == BT_TRANSPORT_LE ? "le" : "br_edr";
+}
+
+double kbps(size_t bytes, Clock::duration duration) {
+  std::chrono::duration<double> seconds = duration;
+  if (seconds.count() <= 0) return 0;
+  return bytes * 8 / seconds.count() / 1000;
+}
+
+double milliseconds(Clock::duration duration) {
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+tL2CAP_CFG_INFO benchmark_cfg() {
+  tL2CAP_CFG_INFO cfg{};
+  cfg.mtu_present = true;
+  cfg.mtu = kBenchmarkMtu;
+  return cfg;
+}
+
+BT_HDR* malloc_l2cap_buf(uint16_t len) {
+  BT_HDR* msg = (BT_HDR*)osi_malloc(BT_HDR_SIZE + L2CAP_MIN_OFFSET + len);
+  msg->offset = L2CAP_MIN_OFFSET;
+  msg->len = len;
+  return msg;
+}
+
+uint8_t* get_l2cap_sdu_start_ptr(BT_HDR* msg) {
+  return (uint8_t*)(msg) + BT_HDR_SIZE + L2CAP_MIN_OFFSET;
+}
+
+// Fill |len| bytes of a transfer of |total| bytes, from |offset|.
+void fill_transfer(uint8_t* p, size_t offset, size_t len, size_t total) {
+  for (size_t i = 0; i < len; i++) {
+    size_t pos = offset + i;
+    p[i] = pos < kTransferHeaderSize ? (total >> (8 * pos)) & 0xff
+                                     : pos & 0xff;
+  }
+}
+
+// State of the sending side, on a GAP L2CAP channel or an RFCOMM port. The
+// stack callbacks run on the main thread, the benchmark thread only waits
+// for |done| or |failed|.
+struct {
+  bool rfcomm{false};
+  // GAP or RFCOMM port handle, GAP_INVALID_HANDLE without a channel.
+  uint16_t handle{GAP_INVALID_HANDLE};
+  size_t total_bytes{kDefaultTotalBytes};
+  size_t sdu_size{kBenchmarkMtu};
+  size_t queued_bytes{0};
+  bool congested{false};
+  // Within PORT_WriteData(), which reports PORT_EV_TXEMPTY synchronously.
+  bool writing{false};
+  Clock::time_point open_time;
+  Clock::time_point connected_time;
+  Clock::time_point acked_time;
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool done{false};
+  bool failed{false};
+} sender;
+
+void sender_finish(bool failed) {
+  std::lock_guard<std::mutex> lock(sender.mutex);
+  sender.done = !failed;
+  sender.failed = failed;
+  sender.cv.notify_all();
+}
+
+// Hand |len| bytes of the transfer to the channel, |written| is the part
+// which was accepted.
+bool sender_write(uint16_t len, uint16_t* written) {
+  if (sender.rfcomm) {
+    std::vector<uint8_t> data(len);
+    fill_transfer(data.data(), sender.queued_bytes, len, sender.total_bytes);
+    sender.writing = true;
+    int status = PORT_WriteData(sender.handle, (const char*)data.data(), len,
+                                written);
+    sender.writing = false;
+    if (status != PORT_SUCCESS) {
+      LOG_WARN("Write failed status:%d", status);
+      return false;
+    }
+    return true;
+  }
+
+  BT_HDR* msg = malloc_l2cap_buf(len);
+  fill_transfer(get_l2cap_sdu_start_ptr(msg), sender.queued_bytes, len,
+                sender.total_bytes);
+  uint16_t status = GAP_ConnWriteData(sender.handle, msg);
+  if (status != BT_PASS) {
+    LOG_WARN("Write failed status:%hu", status);
+    return false;
+  }
+  *written = len;
+  return true;
+}
+
+// Queue data until the channel reports congestion or all the data was
+// handed to the channel.
+void sender_send_until_congested() {
+  while (!sender.congested && sender.queued_bytes < sender.total_bytes) {
+    uint16_t len = std::min(sender.sdu_size,
+                            sender.total_bytes - sender.queued_bytes);
+    uint16_t written = 0;
+    if (!sender_write(len, &written)) {
+      sender_finish(true);
+      return;
+    }
+    sender.queued_bytes += written;
+    // The RFCOMM transmit queue is full until PORT_EV_TXEMPTY
+    if (written < len) sender.congested = true;
+  }
+}
+
+void sender_connected() {
+  sender.connected_time = Clock::now();
+  sender_send_until_congested();
+}
+
+void sender_acked() {
+  if (sender.acked_time != Clock::time_point()) return;
+  sender.acked_time = Clock::now();
+  sender_finish(false);
+}
+
+void sender_closed() {
+  sender.handle = GAP_INVALID_HANDLE;
+  if (sender.acked_time == Clock::time_point()) {
+    LOG_WARN("Channel closed after %zu bytes", sender.queued_bytes);
+    sender_finish(true);
+  }
+}
+
+void sender_callback(uint16_t gap_handle, uint16_t event, tGAP_CB_DATA*) {
+  if (gap_handle != sender.handle) return;
+
+  switch (event) {
+    case GAP_EVT_CONN_OPENED:
+      sender.sdu_size = std::min<size_t>(sender.sdu_size,
+                                         GAP_ConnGetRemMtuSize(gap_handle));
+      sender_connected();
+      break;
+    case GAP_EVT_CONN_CONGESTED:
+      sender.congested = true;
+      break;
+    case GAP_EVT_CONN_UNCONGESTED:
+      sender.congested = false;
+      sender_send_until_congested();
+      break;
+    case GAP_EVT_CONN_DATA_AVAIL: {
+      uint8_t ack[kTransferHeaderSize];
+      uint16_t len = 0;
+      if (GAP_ConnReadData(gap_handle, ack, sizeof(ack), &len) == BT_PASS &&
+          len > 0) {
+        sender_acked();
+      }
+    } break;
+    case GAP_EVT_CONN_CLOSED:
+      sender_closed();
+      break;
+    default:
+      break;
+  }
+}
+
+void rfcomm_sender_mgmt_callback(uint32_t code, uint16_t port_handle) {
+  if (port_handle != sender.handle) return;
+
+  if (code == PORT_SUCCESS) {
+    sender_connected();
+  } else {
+    sender_closed();
+  }
+}
+
+void rfcomm_sender_event_callback(uint32_t events, uint16_t port_handle) {
+  if (port_handle != sender.handle) return;
+
+  if (events & PORT_EV_RXCHAR) {
+    char ack[kTransferHeaderSize];
+    uint16_t len = 0;
+    if (PORT_ReadData(port_handle, ack, sizeof(ack), &len) == PORT_SUCCESS &&
+        len > 0) {
+      sender_acked();
+    }
+  }
+  if ((events & PORT_EV_TXEMPTY) && sender.congested && !sender.writing) {
+    sender.congested = false;
+    sender_send_until_congested();
+  }
+}
+
+// Run one transfer: |open| is called on the main thread to open the
+// channel, and |close| to release it at the end. Returns false if the sink
+// did not acknowledge the transfer.
+bool sender_run(size_t total_bytes, size_t sdu_size, bool rfcomm,
+                std::function<void()> open,
+                std::function<void(uint16_t)> close) {
+  {
+    std::lock_guard<std::mutex> lock(sender.mutex);
+    sender.done = false;
+    sender.failed = false;
+  }
+
+  post_on_bt_main([=]() {
+    sender.rfcomm = rfcomm;
+    sender.total_bytes = total_bytes;
+    sender.sdu_size = sdu_size;
+    sender.queued_bytes = 0;
+    sender.congested = false;
+    sender.acked_time = Clock::time_point();
+    sender.open_time = Clock::now();
+    open();
+  });
+
+  bool completed;
+  {
+    std::unique_lock<std::mutex> lock(sender.mutex);
+    completed = sender.cv.wait_for(
+        lock, kBenchmarkTimeout,
+        []() { return sender.done || sender.failed; });
+    completed = completed && sender.done;
+  }
+
+  post_on_bt_main([close]() {
+    if (sender.handle != GAP_INVALID_HANDLE) {
+      uint16_t handle = sender.handle;
+      sender.handle = GAP_INVALID_HANDLE;
+      close(handle);
+    }
+  });
+  return completed;
+}
+
+// State of the receiving side, one per channel kind. Only accessed from the
+// main thread, but for the wait in ThroughputSink::Run().
+struct Sink {
+  tBT_TRANSPORT transport;
+  bool rfcomm{false};
+  uint16_t handle{GAP_INVALID_HANDLE};
+  size_t bytes{0};
+  size_t expected_bytes{0};
+  Clock::time_point first_time;
+  Clock::time_point last_time;
+};
+
+Sink sinks[] = {{BT_TRANSPORT_BR_EDR},
+                {BT_TRANSPORT_LE},
+                {BT_TRANSPORT_BR_EDR, true /* rfcomm */}};
+std::vector<uint8_t> sink_buffer(kBenchmarkMtu);
+
+std::mutex sink_mutex;
+std::condition_variable sink_cv;
+size_t sink_closed_channels{0};
+
+void sink_callback(uint16_t gap_handle, uint16_t event, tGAP_CB_DATA*);
+void rfcomm_sink_mgmt_callback(uint32_t code, uint16_t port_handle);
+void rfcomm_sink_event_callback(uint32_t events, uint16_t port_handle);
+
+void sink_listen(Sink& sink) {
+  if (sink.rfcomm) {
+    // The server port keeps listening after each connection
+    int status = RFCOMM_CreateConnectionWithSecurity(
+        UUID_SERVCLASS_SERIAL_PORT, kBenchmarkScn, true /* is_server */,
+        0 /* mtu */, RawAddress::kAny, &sink.handle, rfcomm_sink_mgmt_callback,
+        BTM_SEC_NONE);
+    if (status != PORT_SUCCESS) {
+      LOG_ERROR("Unable to listen on scn:%hhu status:%d", kBenchmarkScn,
+                status);
+      sink.handle = GAP_INVALID_HANDLE;
+      return;
+    }
+    PORT_SetEventMask(sink.handle, PORT_EV_RXCHAR);
+    PORT_SetEventCallback(sink.handle, rfcomm_sink_event_callback);
+    return;
+  }
+
+  tL2CAP_CFG_INFO cfg = benchmark_cfg();
+  bool le = sink.transport == BT_TRANSPORT_LE;
+  sink.handle = GAP_ConnOpen(
+      "Benchmark sink", BTM_SEC_SERVICE_FIRST_EMPTY, true /* is_server */,
+      nullptr, le ? kBenchmarkLePsm : kBenchmarkPsm, kBenchmarkLeMps, &cfg,
+      nullptr, BTM_SEC_NONE, sink_callback, sink.transport);
+  if (sink.handle == GAP_INVALID_HANDLE) {
+    LOG_ERROR("Unable to listen on transport:%s",
+              transport_name(sink.transport));
+  }
+}
+
+Sink* sink_find(uint16_t handle, bool rfcomm) {
+  for (auto& sink : sinks) {
+    if (sink.rfcomm == rfcomm && sink.handle == handle) return &sink;
+  }
+  return nullptr;
+}
+
+void sink_opened(Sink& sink) {
+  sink.bytes = 0;
+  sink.expected_bytes = 0;
+  sink.first_time = Clock::time_point();
+}
+
+void sink_ack(Sink& sink) {
+  if (sink.rfcomm) {
+    const char ack = kTransferAck;
+    uint16_t len = 0;
+    PORT_WriteData(sink.handle, &ack, sizeof(ack), &len);
+    return;
+  }
+  BT_HDR* msg = malloc_l2cap_buf(sizeof(kTransferAck));
+  *get_l2cap_sdu_start_ptr(msg) = kTransferAck;
+  GAP_ConnWriteData(sink.handle, msg);
+}
+
+void sink_received(Sink& sink, const uint8_t* data, uint16_t len) {
+  if (sink.first_time == Clock::time_point()) {
+    sink.first_time = Clock::now();
+  }
+  sink.last_time = Clock::now();
+  for (uint16_t i = 0; i < len && sink.bytes + i < kTransferHeaderSize; i++) {
+    sink.expected_bytes |= (size_t)data[i] << (8 * (sink.bytes + i));
+  }
+  sink.bytes += len;
+  if (sink.bytes < kTransferHeaderSize || sink.bytes != sink.expected_bytes) {
+    return;
+  }
+
+  sink_ack(sink);
+  BenchmarkResult(sink.rfcomm ? "rfcomm_sink" : "l2cap_sink")
+      .Add("transport", transport_name(sink.transport))
+      .Add("bytes", sink.bytes)
+      .Add("duration_ms", milliseconds(sink.last_time - sink.first_time))
+      .Add("kbps", kbps(sink.bytes, sink.last_time - sink.first_time))
+      .Print();
+}
+
+void sink_closed(Sink& sink) {
+  if (sink.bytes != sink.expected_bytes) {
+    LOG_WARN("Channel closed after %zu of %zu bytes", sink.bytes,
+             sink.expected_bytes);
+  }
+  std::lock_guard<std::mutex> lock(sink_mutex);
+  sink_closed_channels++;
+  sink_cv.notify_all();
+}
+
+void sink_callback(uint16_t gap_handle, uint16_t event, tGAP_CB_DATA*) {
+  Sink* sink = sink_find(gap_handle, false);
+  if (sink == nullptr) return;
+
+  switch (event) {
+    case GAP_EVT_CONN_OPENED:
+      sink_opened(*sink);
+      break;
+    case GAP_EVT_CONN_DATA_AVAIL: {
+      uint16_t len = 0;
+      while (GAP_ConnReadData(gap_handle, sink_buffer.data(),
+                              sink_buffer.size(), &len) == BT_PASS &&
+             len > 0) {
+        sink_received(*sink, sink_buffer.data(), len);
+      }
+    } break;
+    case GAP_EVT_CONN_CLOSED:
+      // The server channel is released along with the connection.
+      sink_listen(*sink);
+      sink_closed(*sink);
+      break;
+    default:
+      break;
+  }
+}
+
+void rfcomm_sink_mgmt_callback(uint32_t code, uint16_t port_handle) {
+  Sink* sink = sink_find(port_handle, true);
+  if (sink == nullptr) return;
+
+  if (code == PORT_SUCCESS) {
+    sink_opened(*sink);
+  } else {
+    sink_closed(*sink);
+  }
+}
+
+void rfcomm_sink_event_callback(uint32_t events, uint16_t port_handle) {
+  Sink* sink = sink_find(port_handle, true);
+  if (sink == nullptr || !(events & PORT_EV_RXCHAR)) return;
+
+  uint16_t len = 0;
+  while (PORT_ReadData(port_handle, (char*)sink_buffer.data(),
+                       sink_buffer.size(), &len) == PORT_SUCCESS &&
+         len > 0) {
+    sink_received(*sink, sink_buffer.data(), len);
+  }
+}
+
+// Parse the arguments common to the throughput benchmarks, |chunk| is the
+// name of the argument giving the size of each write.
+bool parse_throughput_args(std::list<std::string>& non_options,
+                           const std::string& chunk, size_t* total_bytes,
+                           size_t* chunk_size) {
+  auto args = ParseBenchmarkArgs(non_options);
+  *total_bytes = kDefaultTotalBytes;
+  *chunk_size = kBenchmarkMtu;
+  if (args.count("bytes")) *total_bytes = std::stoul(args["bytes"]);
+  if (args.count(chunk)) *chunk_size = std::stoul(args[chunk]);
+  if (*total_bytes < kTransferHeaderSize || *chunk_size == 0 ||
+      *chunk_size > kBenchmarkMtu) {
+    fprintf(stdout, "Invalid arguments bytes:%zu (min %zu) %s:%zu (max %hu)\n",
+            *total_bytes, kTransferHeaderSize, chunk.c_str(), *chunk_size,
+            kBenchmarkMtu);
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+int bluetooth::test::headless::L2capThroughput::Run() {
+  if (options_.device_.size() != 1) {
+    fprintf(stdout, "This benchmark requires a single device specified\n");
+    options_.Usage();
+    return -1;
+  }
+
+  size_t total_bytes, sdu_size;
+  if (!parse_throughput_args(options_.non_options_, "sdu", &total_bytes,
+                             &sdu_size)) {
+    return -1;
+  }
+
+  const RawAddress bd_addr = options_.device_.front();
+  const tBT_TRANSPORT transport = transport_;
+
+  return RunOnHeadlessStack<int>([=]() {
+    auto open = [=]() {
+      tL2CAP_CFG_INFO cfg = benchmark_cfg();
+      bool le = transport == BT_TRANSPORT_LE;
+      sender.handle = GAP_ConnOpen(
+          "Benchmark", BTM_SEC_SERVICE_FIRST_EMPTY, false /* is_server */,
+          &bd_addr, le ? kBenchmarkLePsm : kBenchmarkPsm, kBenchmarkLeMps,
+          &cfg, nullptr, BTM_SEC_NONE, sender_callback, transport);
+      if (sender.handle == GAP_INVALID_HANDLE) {
+        LOG_ERROR("Unable to open channel to %s", bd_addr.ToString().c_str());
+        sender_finish(true);
+      }
+    };
+    if (!sender_run(total_bytes, sdu_size, false /* rfcomm */, open,
+                    [](uint16_t handle) { GAP_ConnClose(handle); })) {
+      fprintf(stdout, "Unable to send %zu bytes to %s\n", total_bytes,
+              bd_addr.ToString().c_str());
+      return -1;
+    }
+
+    BenchmarkResult(transport == BT_TRANSPORT_LE ? "coc_throughput"
+                                                 : "l2cap_throughput")
+        .Add("device", bd_addr.ToString())
+        .Add("bytes", total_bytes)
+        .Add("sdu", sender.sdu_size)
+        .Add("setup_ms", milliseconds(sender.connected_time - sender.open_time))
+        .Add("duration_ms",
+             milliseconds(sender.acked_time - sender.connected_time))
+        .Add("kbps",
+             kbps(total_bytes, sender.acked_time - sender.connected_time))
+        .Print();
+    return 0;
+  });
+}
+
+int bluetooth::test::headless::RfcommThroughput::Run() {
+  if (options_.device_.size() != 1) {
+    fprintf(stdout, "This benchmark requires a single device specified\n");
+    options_.Usage();
+    return -1;
+  }
+
+  size_t total_bytes, write_size;
+  if (!parse_throughput_args(options_.non_options_, "write", &total_bytes,
+                             &write_size)) {
+    return -1;
+  }
+
+  const RawAddress bd_addr = options_.device_.front();
+
+  return RunOnHeadlessStack<int>([=]() {
+    auto open = [=]() {
+      int status = RFCOMM_CreateConnectionWithSecurity(
+          UUID_SERVCLASS_SERIAL_PORT, kBenchmarkScn, false /* is_server */,
+          0 /* mtu */, bd_addr, &sender.handle, rfcomm_sender_mgmt_callback,
+          BTM_SEC_NONE);
+      if (status != PORT_SUCCESS) {
+        LOG_ERROR("Unable to open port to %s status:%d",
+                  bd_addr.ToString().c_str(), status);
+        sender.handle = GAP_INVALID_HANDLE;
+        sender_finish(true);
+        return;
+      }
+      PORT_SetEventMask(sender.handle, PORT_EV_RXCHAR | PORT_EV_TXEMPTY);
+      PORT_SetEventCallback(sender.handle, rfcomm_sender_event_callback);
+    };
+    if (!sender_run(total_bytes, write_size, true /* rfcomm */, open,
+                    [](uint16_t handle) { RFCOMM_RemoveConnection(handle); })) {
+      fprintf(stdout, "Unable to send %zu bytes to %s\n", total_bytes,
+              bd_addr.ToString().c_str());
+      return -1;
+    }
+
+    BenchmarkResult("rfcomm_throughput")
+        .Add("device", bd_addr.ToString())
+        .Add("bytes", total_bytes)
+        .Add("write", write_size)
+        .Add("setup_ms", milliseconds(sender.connected_time - sender.open_time))
+        .Add("duration_ms",
+             milliseconds(sender.acked_time - sender.connected_time))
+        .Add("kbps",
+             kbps(total_bytes, sender.acked_time - sender.connected_time))
+        .Print();
+    return 0;
+  });
+}
+
+int bluetooth::test::headless::ThroughputSink::Run() {
+  return RunOnHeadlessStack<int>([]() {
+    {
+      std::lock_guard<std::mutex> lock(sink_mutex);
+      sink_closed_channels = 0;
+    }
+    post_on_bt_main([]() {
+      for (auto& sink : sinks) {
+        if (sink.handle == GAP_INVALID_HANDLE) sink_listen(sink);
+      }
+    });
+
+    fprintf(stdout,
+            "Waiting for a benchmark channel on psm:0x%04x, le psm:0x%04x "
+            "and scn:%hhu\n",
+            kBenchmarkPsm, kBenchmarkLePsm, kBenchmarkScn);
+    std::unique_lock<std::mutex> lock(sink_mutex);
+    sink_cv.wait(lock, []() { return sink_closed_channels > 0; });
+    return 0;
+  });
+}
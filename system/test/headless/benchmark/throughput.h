@@ -0,0 +1,64 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "test/headless/get_options.h"
+#include "test/headless/headless.h"
+#include "types/bt_transport.h"
+
+namespace bluetooth {
+namespace test {
+namespace headless {
+
+// Throughput of an L2CAP channel to a remote device running the sink
+// benchmark: a BR/EDR dynamic channel in basic mode, or an LE credit based
+// channel. The transfer ends when the sink acknowledges the receipt of all
+// the data. Arguments: bytes=<total bytes>, sdu=<bytes per SDU>.
+class L2capThroughput : public HeadlessTest<int> {
+ public:
+  L2capThroughput(const bluetooth::test::headless::GetOpt& options,
+                  tBT_TRANSPORT transport)
+      : HeadlessTest<int>(options), transport_(transport) {}
+  int Run() override;
+
+ private:
+  tBT_TRANSPORT transport_;
+};
+
+// Throughput of an RFCOMM channel to a remote device running the sink
+// benchmark, measured like the L2CAP one. Arguments: bytes=<total bytes>,
+// write=<bytes per write>.
+class RfcommThroughput : public HeadlessTest<int> {
+ public:
+  RfcommThroughput(const bluetooth::test::headless::GetOpt& options)
+      : HeadlessTest<int>(options) {}
+  int Run() override;
+};
+
+// Accept the channels opened by the throughput benchmarks on L2CAP over
+// both transports and on RFCOMM, acknowledge each transfer and report the
+// rate at which its data was received, once per loop.
+class ThroughputSink : public HeadlessTest<int> {
+ public:
+  ThroughputSink(const bluetooth::test::headless::GetOpt& options)
+      : HeadlessTest<int>(options) {}
+  int Run() override;
+};
+
+}  // namespace headless
+}  // namespace test
+}  // namespace bluetooth
@@ -24,6 +24,7 @@
 
 #include "base/logging.h"     // LOG() stdout and android log
 #include "osi/include/log.h"  // android log only
+#include "test/headless/benchmark/benchmark.h"
 #include "test/headless/connect/connect.h"
 #include "test/headless/dumpsys/dumpsys.h"
 #include "test/headless/get_options.h"
@@ -59,6 +60,9 @@ class Main : public HeadlessTest<int> {
  public:
   Main(const bluetooth::test::headless::GetOpt& options)
       : HeadlessTest<int>(options) {
+    test_nodes_.emplace(
+        "benchmark",
+        std::make_unique<bluetooth::test::headless::Benchmark>(options));
     test_nodes_.emplace(
         "dumpsys",
         std::make_unique<bluetooth::test::headless::Dumpsys>(options));
@@ -0,0 +1,61 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Generated mock file from original source file
+ *   Functions generated:7
+ */
+
+#include <map>
+#include <string>
+
+extern std::map<std::string, int> mock_function_count_map;
+
+#include <vector>
+
+#include "bta/include/bta_gatt_queue.h"
+
+#ifndef UNUSED_ATTR
+#define UNUSED_ATTR
+#endif
+
+void BtaGattQueue::Clean(uint16_t conn_id) {
+  mock_function_count_map[__func__]++;
+}
+void BtaGattQueue::ConfigureMtu(uint16_t conn_id, uint16_t mtu) {
+  mock_function_count_map[__func__]++;
+}
+void BtaGattQueue::DebugDump(int fd) { mock_function_count_map[__func__]++; }
+void BtaGattQueue::ReadCharacteristic(uint16_t conn_id, uint16_t handle,
+                                      GATT_READ_OP_CB cb, void* cb_data) {
+  mock_function_count_map[__func__]++;
+}
+void BtaGattQueue::ReadDescriptor(uint16_t conn_id, uint16_t handle,
+                                  GATT_READ_OP_CB cb, void* cb_data) {
+  mock_function_count_map[__func__]++;
+}
+void BtaGattQueue::WriteCharacteristic(uint16_t conn_id, uint16_t handle,
+                                       std::vector<uint8_t> value,
+                                       tGATT_WRITE_TYPE write_type,
+                                       GATT_WRITE_OP_CB cb, void* cb_data) {
+  mock_function_count_map[__func__]++;
+}
+void BtaGattQueue::WriteDescriptor(uint16_t conn_id, uint16_t handle,
+                                   std::vector<uint8_t> value,
+                                   tGATT_WRITE_TYPE write_type,
+                                   GATT_WRITE_OP_CB cb, void* cb_data) {
+  mock_function_count_map[__func__]++;
+}
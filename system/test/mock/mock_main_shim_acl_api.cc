@@ -54,6 +54,10 @@ void bluetooth::shim::ACL_IgnoreLeConnectionFrom(
     const tBLE_BD_ADDR& legacy_address_with_type) {
   mock_function_count_map[__func__]++;
 }
+void bluetooth::shim::ACL_ReportLeAdvertisement(
+    const tBLE_BD_ADDR& legacy_address_with_type, int8_t rssi) {
+  mock_function_count_map[__func__]++;
+}
 void bluetooth::shim::ACL_ConfigureLePrivacy(bool is_le_privacy_enabled) {
   mock_function_count_map[__func__]++;
 }
@@ -189,5 +189,9 @@ void bluetooth::shim::LogMetricBluetoothLEConnectionMetricEvent(
   mock_function_count_map[__func__]++;
   // test::mock::main_shim_metrics_api::LogMetricBluetoothLEConnectionMetricEvent(raw_address, origin_type, connection_type, transaction_state, argument_list);
 }
+void bluetooth::shim::LogConnectionMilestone(
+    uint16_t handle, bluetooth::common::ConnectionMilestone milestone) {
+  mock_function_count_map[__func__]++;
+}
 
 // END mockcify generation
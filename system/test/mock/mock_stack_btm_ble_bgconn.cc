@@ -56,6 +56,7 @@ struct BTM_SetLeConnectionModeToSlow BTM_SetLeConnectionModeToSlow;
 struct BTM_AcceptlistAdd BTM_AcceptlistAdd;
 struct BTM_AcceptlistRemove BTM_AcceptlistRemove;
 struct BTM_AcceptlistClear BTM_AcceptlistClear;
+struct btm_ble_bgconn_process_adv btm_ble_bgconn_process_adv;
 
 }  // namespace stack_btm_ble_bgconn
 }  // namespace mock
@@ -106,5 +107,9 @@ void BTM_AcceptlistClear() {
   mock_function_count_map[__func__]++;
   test::mock::stack_btm_ble_bgconn::BTM_AcceptlistClear();
 }
+void btm_ble_bgconn_process_adv(const RawAddress& bd_addr, int8_t rssi) {
+  mock_function_count_map[__func__]++;
+  test::mock::stack_btm_ble_bgconn::btm_ble_bgconn_process_adv(bd_addr, rssi);
+}
 
 // END mockcify generation
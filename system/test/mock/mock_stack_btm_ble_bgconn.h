@@ -147,6 +147,17 @@ struct BTM_AcceptlistClear {
   void operator()() { body(); };
 };
 extern struct BTM_AcceptlistClear BTM_AcceptlistClear;
+// Name: btm_ble_bgconn_process_adv
+// Params: const RawAddress& bd_addr, int8_t rssi
+// Returns: void
+struct btm_ble_bgconn_process_adv {
+  std::function<void(const RawAddress& bd_addr, int8_t rssi)> body{
+      [](const RawAddress& bd_addr, int8_t rssi) {}};
+  void operator()(const RawAddress& bd_addr, int8_t rssi) {
+    body(bd_addr, rssi);
+  };
+};
+extern struct btm_ble_bgconn_process_adv btm_ble_bgconn_process_adv;
 
 }  // namespace stack_btm_ble_bgconn
 }  // namespace mock
@@ -63,6 +63,8 @@ struct SDP_GetDiRecord SDP_GetDiRecord;
 struct SDP_SetLocalDiRecord SDP_SetLocalDiRecord;
 struct SDP_GetNumDiRecords SDP_GetNumDiRecords;
 struct SDP_SetTraceLevel SDP_SetTraceLevel;
+struct SDP_InvalidateDiscoveryCache SDP_InvalidateDiscoveryCache;
+struct SDP_Dumpsys SDP_Dumpsys;
 
 }  // namespace stack_sdp_api
 }  // namespace mock
@@ -179,5 +181,14 @@ uint8_t SDP_SetTraceLevel(uint8_t new_level) {
   mock_function_count_map[__func__]++;
   return test::mock::stack_sdp_api::SDP_SetTraceLevel(new_level);
 }
+void SDP_InvalidateDiscoveryCache(const RawAddress& bd_addr,
+                                  const bluetooth::Uuid& uuid) {
+  mock_function_count_map[__func__]++;
+  test::mock::stack_sdp_api::SDP_InvalidateDiscoveryCache(bd_addr, uuid);
+}
+void SDP_Dumpsys(int fd) {
+  mock_function_count_map[__func__]++;
+  test::mock::stack_sdp_api::SDP_Dumpsys(fd);
+}
 
 // END mockcify generation
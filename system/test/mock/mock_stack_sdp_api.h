@@ -301,6 +301,25 @@ struct SDP_SetTraceLevel {
   uint8_t operator()(uint8_t new_level) { return body(new_level); };
 };
 extern struct SDP_SetTraceLevel SDP_SetTraceLevel;
+// Name: SDP_InvalidateDiscoveryCache
+// Params: const RawAddress& bd_addr, const bluetooth::Uuid& uuid
+// Returns: void
+struct SDP_InvalidateDiscoveryCache {
+  std::function<void(const RawAddress& bd_addr, const bluetooth::Uuid& uuid)>
+      body{[](const RawAddress& bd_addr, const bluetooth::Uuid& uuid) { ; }};
+  void operator()(const RawAddress& bd_addr, const bluetooth::Uuid& uuid) {
+    body(bd_addr, uuid);
+  };
+};
+extern struct SDP_InvalidateDiscoveryCache SDP_InvalidateDiscoveryCache;
+// Name: SDP_Dumpsys
+// Params: int fd
+// Returns: void
+struct SDP_Dumpsys {
+  std::function<void(int fd)> body{[](int fd) { ; }};
+  void operator()(int fd) { body(fd); };
+};
+extern struct SDP_Dumpsys SDP_Dumpsys;
 
 }  // namespace stack_sdp_api
 }  // namespace mock
@@ -10,6 +10,10 @@
 known_benchmarks=(
   bluetooth_benchmark_thread_performance
   bluetooth_benchmark_timer_performance
+  bluetooth_benchmark_stack_btm_inquiry_db
+  bluetooth_benchmark_broadcaster_encoding
+  bluetooth_benchmark_device_interop
+  bluetooth_benchmark_main_shim_hci_command
 )
 
 usage() {
@@ -28,6 +28,7 @@
 #include <optional>
 
 #include "model/setup/async_manager.h"
+#include "model/setup/simulation_clock.h"
 #include "net/posix/posix_async_socket_connector.h"
 #include "net/posix/posix_async_socket_server.h"
 #include "test_environment.h"
@@ -43,6 +44,10 @@ DEFINE_string(default_commands_file, "",
               "commands file which root-canal runs it as default");
 DEFINE_bool(enable_hci_sniffer, false, "enable hci sniffer");
 DEFINE_bool(enable_baseband_sniffer, false, "enable baseband sniffer");
+DEFINE_bool(virtual_time, false,
+            "skip to the next simulation event when the hosts are idle");
+DEFINE_int32(virtual_time_idle_threshold_ms, 100,
+             "time without host traffic after which the hosts are idle");
 
 constexpr uint16_t kTestPort = 6401;
 constexpr uint16_t kHciServerPort = 6402;
@@ -92,6 +97,10 @@ int main(int argc, char** argv) {
   android::base::InitLogging(argv);
 
   LOG_INFO("main");
+  if (FLAGS_virtual_time) {
+    rootcanal::SimulationClock::SetVirtualTime(
+        true, std::chrono::milliseconds(FLAGS_virtual_time_idle_threshold_ms));
+  }
   uint16_t test_port = kTestPort;
   uint16_t hci_server_port = kHciServerPort;
   uint16_t link_server_port = kLinkServerPort;
@@ -20,6 +20,7 @@
 #include <cstdint>
 #include <limits>
 #include <ostream>
+#include <vector>
 
 namespace rootcanal::pcap {
 
@@ -48,7 +49,7 @@ static void WriteRecordHeader(std::ostream& output, uint32_t length) {
 
   // https://tools.ietf.org/id/draft-gharris-opsawg-pcap-00.html#name-packet-record
   uint32_t seconds = time / 1s;
-  uint32_t microseconds = (time % 1s) / 1ms;
+  uint32_t microseconds = (time % 1s) / 1us;
   uint32_t captured_packet_length = length;
   uint32_t original_packet_length = length;
 
@@ -58,4 +59,19 @@ static void WriteRecordHeader(std::ostream& output, uint32_t length) {
   output.write((char*)&original_packet_length, 4);
 }
 
+// Append a record header to a buffer of pending records, to be written to
+// the output stream in a batch.
+static inline void AppendRecordHeader(std::vector<char>& buffer, uint32_t length) {
+  auto time = std::chrono::system_clock::now().time_since_epoch();
+
+  uint32_t header[4] = {
+      static_cast<uint32_t>(time / 1s),
+      static_cast<uint32_t>((time % 1s) / 1us),
+      length,
+      length,
+  };
+  buffer.insert(buffer.end(), reinterpret_cast<char*>(header),
+                reinterpret_cast<char*>(header) + sizeof(header));
+}
+
 }  // namespace rootcanal::pcap
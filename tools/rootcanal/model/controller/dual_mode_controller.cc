@@ -46,7 +46,17 @@ void DualModeController::IncomingPacket(
   link_layer_controller_.IncomingPacket(incoming);
 }
 
-void DualModeController::TimerTick() { link_layer_controller_.TimerTick(); }
+void DualModeController::TimerTick() {
+  link_layer_controller_.TimerTick();
+  UpdateReceiveFilter();
+}
+
+void DualModeController::UpdateReceiveFilter() {
+  SetReceiveFilter(
+      link_layer_controller_.IsListeningForAdvertising()
+          ? PhyLayer::ReceiveFilter::ADDRESSED_AND_ADVERTISING
+          : PhyLayer::ReceiveFilter::ADDRESSED);
+}
 
 void DualModeController::Close() {
   link_layer_controller_.Close();
@@ -80,6 +90,7 @@ DualModeController::DualModeController(const std::string& properties_filename,
   Address public_address{};
   ASSERT(Address::FromString("3C:5A:B4:04:05:06", public_address));
   SetAddress(public_address);
+  UpdateReceiveFilter();
 
   link_layer_controller_.RegisterRemoteChannel(
       [this](std::shared_ptr<model::packets::LinkLayerPacketBuilder> packet,
@@ -431,6 +442,10 @@ void DualModeController::HandleCommand(
     LOG_INFO("Unknown command, opcode: 0x%04X, OGF: 0x%04X, OCF: 0x%04X",
              opcode, (opcode & 0xFC00) >> 10, opcode & 0x03FF);
   }
+
+  // Scanning and initiating are started by HCI commands: update the phy
+  // routing right away so that the next advertising PDUs are received.
+  UpdateReceiveFilter();
 }
 
 void DualModeController::RegisterEventChannel(
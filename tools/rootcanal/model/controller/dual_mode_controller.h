@@ -639,6 +639,9 @@ class DualModeController : public Device {
   // the error code UNKNOWN_OPCODE.
   void SendCommandCompleteUnknownOpCodeEvent(uint16_t op_code) const;
 
+  // Only receive LE advertising PDUs while scanning or initiating.
+  void UpdateReceiveFilter();
+
   // Callbacks to send packets back to the HCI.
   std::function<void(std::shared_ptr<bluetooth::hci::AclBuilder>)> send_acl_;
   std::function<void(std::shared_ptr<bluetooth::hci::EventBuilder>)>
@@ -21,8 +21,12 @@
 #include <lmp.h>
 #endif /* ROOTCANAL_LMP */
 
+#include <atomic>
+#include <cinttypes>
+
 #include "crypto_toolbox/crypto_toolbox.h"
 #include "log.h"
+#include "model/setup/simulation_clock.h"
 #include "packet/raw_builder.h"
 
 using std::vector;
@@ -48,6 +52,18 @@ constexpr uint16_t kNumCommandPackets = 0x01;
 
 constexpr milliseconds kNoDelayMs(0);
 
+// Largest advertising data carried by a single report in an LE Extended
+// Advertising Report event: the 255 byte event parameters minus the
+// subevent code, the number of reports and the fixed fields of the report
+// (Vol 4, Part E § 7.7.65.13).
+constexpr size_t kMaxExtendedAdvertisingReportDataLength = 229;
+
+// Seeds handed to the controllers in creation order.
+static std::minstd_rand::result_type NextRpaSeed() {
+  static std::atomic<std::minstd_rand::result_type> seed{1};
+  return seed++;
+}
+
 // TODO: Model Rssi?
 static uint8_t GetRssi() {
   static uint8_t rssi = 0;
@@ -134,17 +150,38 @@ bool LinkLayerController::FilterAcceptListBusy() {
 
 bool LinkLayerController::LeFilterAcceptListContainsDevice(
     FilterAcceptListAddressType address_type, Address address) {
-  for (auto const& entry : le_filter_accept_list_) {
-    if (entry.address_type == address_type &&
-        (address_type == FilterAcceptListAddressType::ANONYMOUS_ADVERTISERS ||
-         entry.address == address)) {
-      return true;
-    }
+  address_resolution_stats_.filter_accept_list_lookups++;
+  switch (address_type) {
+    case FilterAcceptListAddressType::PUBLIC:
+      return le_filter_accept_list_public_.count(address) > 0;
+    case FilterAcceptListAddressType::RANDOM:
+      return le_filter_accept_list_random_.count(address) > 0;
+    case FilterAcceptListAddressType::ANONYMOUS_ADVERTISERS:
+      return le_filter_accept_list_anonymous_;
   }
 
   return false;
 }
 
+void LinkLayerController::UpdateFilterAcceptListIndex() {
+  le_filter_accept_list_public_.clear();
+  le_filter_accept_list_random_.clear();
+  le_filter_accept_list_anonymous_ = false;
+  for (auto const& entry : le_filter_accept_list_) {
+    switch (entry.address_type) {
+      case FilterAcceptListAddressType::PUBLIC:
+        le_filter_accept_list_public_.insert(entry.address);
+        break;
+      case FilterAcceptListAddressType::RANDOM:
+        le_filter_accept_list_random_.insert(entry.address);
+        break;
+      case FilterAcceptListAddressType::ANONYMOUS_ADVERTISERS:
+        le_filter_accept_list_anonymous_ = true;
+        break;
+    }
+  }
+}
+
 bool LinkLayerController::LeFilterAcceptListContainsDevice(
     AddressWithType address) {
   FilterAcceptListAddressType address_type;
@@ -199,21 +236,46 @@ std::optional<AddressWithType> LinkLayerController::ResolvePrivateAddress(
     return {};
   }
 
+  address_resolution_stats_.resolutions++;
+  auto& cache = rpa_cache_[irk == IrkSelection::Local ? 1 : 0];
+  auto cached = cache.find(address.GetAddress());
+  if (cached != cache.end()) {
+    address_resolution_stats_.rpa_cache_hits++;
+    return cached->second;
+  }
+
+  std::optional<AddressWithType> identity_address;
   for (auto const& entry : le_resolving_list_) {
     std::array<uint8_t, LinkLayerController::kIrkSize> const& used_irk =
         irk == IrkSelection::Local ? entry.local_irk : entry.peer_irk;
 
+    address_resolution_stats_.irk_checks++;
     if (address.IsRpaThatMatchesIrk(used_irk)) {
-      return PeerIdentityAddress(entry.peer_identity_address,
-                                 entry.peer_identity_address_type);
+      identity_address = PeerIdentityAddress(entry.peer_identity_address,
+                                             entry.peer_identity_address_type);
+      break;
     }
   }
 
-  return {};
+  // The RPAs of the active advertisers are expected to fit in the cache,
+  // start over when it is full rather than tracking the least recently
+  // used entries.
+  if (cache.size() >= kRpaCacheSize) {
+    cache.clear();
+  }
+  cache.emplace(address.GetAddress(), identity_address);
+  return identity_address;
+}
+
+void LinkLayerController::InvalidateRpaCache() {
+  for (auto& cache : rpa_cache_) {
+    cache.clear();
+  }
 }
 
 static Address generate_rpa(
-    std::array<uint8_t, LinkLayerController::kIrkSize> irk);
+    std::array<uint8_t, LinkLayerController::kIrkSize> irk,
+    std::minstd_rand& random);
 
 std::optional<AddressWithType>
 LinkLayerController::GenerateResolvablePrivateAddress(AddressWithType address,
@@ -228,7 +290,7 @@ LinkLayerController::GenerateResolvablePrivateAddress(AddressWithType address,
       std::array<uint8_t, LinkLayerController::kIrkSize> const& used_irk =
           irk == IrkSelection::Local ? entry.local_irk : entry.peer_irk;
 
-      return AddressWithType{generate_rpa(used_irk),
+      return AddressWithType{generate_rpa(used_irk, rpa_random_),
                              AddressType::RANDOM_DEVICE_ADDRESS};
     }
   }
@@ -369,6 +431,7 @@ ErrorCode LinkLayerController::LeAddDeviceToResolvingList(
   le_resolving_list_.emplace_back(
       ResolvingListEntry{peer_identity_address_type, peer_identity_address,
                          peer_irk, local_irk, PrivacyMode::NETWORK});
+  InvalidateRpaCache();
   return ErrorCode::SUCCESS;
 }
 
@@ -393,6 +456,7 @@ ErrorCode LinkLayerController::LeRemoveDeviceFromResolvingList(
     if (it->peer_identity_address_type == peer_identity_address_type &&
         it->peer_identity_address == peer_identity_address) {
       le_resolving_list_.erase(it);
+      InvalidateRpaCache();
       return ErrorCode::SUCCESS;
     }
   }
@@ -420,6 +484,7 @@ ErrorCode LinkLayerController::LeClearResolvingList() {
   }
 
   le_resolving_list_.clear();
+  InvalidateRpaCache();
   return ErrorCode::SUCCESS;
 }
 
@@ -494,6 +559,7 @@ ErrorCode LinkLayerController::LeClearFilterAcceptList() {
   }
 
   le_filter_accept_list_.clear();
+  UpdateFilterAcceptListIndex();
   return ErrorCode::SUCCESS;
 }
 
@@ -525,6 +591,7 @@ ErrorCode LinkLayerController::LeAddDeviceToFilterAcceptList(
 
   le_filter_accept_list_.emplace_back(
       FilterAcceptListEntry{address_type, address});
+  UpdateFilterAcceptListIndex();
   return ErrorCode::SUCCESS;
 }
 
@@ -554,6 +621,7 @@ ErrorCode LinkLayerController::LeRemoveDeviceFromFilterAcceptList(
         (address_type == FilterAcceptListAddressType::ANONYMOUS_ADVERTISERS ||
          it->address == address)) {
       le_filter_accept_list_.erase(it);
+      UpdateFilterAcceptListIndex();
       return ErrorCode::SUCCESS;
     }
   }
@@ -847,7 +915,7 @@ ErrorCode LinkLayerController::LeSetExtendedScanEnable(
   scanner_.duration = duration_ms;
   scanner_.period = period_ms;
 
-  auto now = std::chrono::steady_clock::now();
+  auto now = SimulationClock::now();
 
   // At the end of a single scan (Duration non-zero but Period zero), an
   // HCI_LE_Scan_Timeout event shall be generated.
@@ -1362,6 +1430,7 @@ LinkLayerController::LinkLayerController(const Address& address,
                                          const ControllerProperties& properties)
     : address_(address),
       properties_(properties),
+      rpa_random_(NextRpaSeed()),
       lm_(nullptr, link_manager_destroy) {
   ops_ = {
       .user_pointer = this,
@@ -1421,7 +1490,9 @@ LinkLayerController::LinkLayerController(const Address& address,
 #else
 LinkLayerController::LinkLayerController(const Address& address,
                                          const ControllerProperties& properties)
-    : address_(address), properties_(properties) {}
+    : address_(address),
+      properties_(properties),
+      rpa_random_(NextRpaSeed()) {}
 #endif
 
 void LinkLayerController::SendLeLinkLayerPacket(
@@ -2622,19 +2693,20 @@ void LinkLayerController::IncomingKeypressNotificationPacket(
 #endif /* !ROOTCANAL_LMP */
 
 static Address generate_rpa(
-    std::array<uint8_t, LinkLayerController::kIrkSize> irk) {
+    std::array<uint8_t, LinkLayerController::kIrkSize> irk,
+    std::minstd_rand& random) {
   // most significant bit, bit7, bit6 is 01 to be resolvable random
   // Bits of the random part of prand shall not be all 1 or all 0
   std::array<uint8_t, 3> prand;
-  prand[0] = std::rand();
-  prand[1] = std::rand();
-  prand[2] = std::rand();
+  prand[0] = random();
+  prand[1] = random();
+  prand[2] = random();
 
   constexpr uint8_t BLE_RESOLVE_ADDR_MSB = 0x40;
   prand[2] &= ~0xC0;  // BLE Address mask
   if ((prand[0] == 0x00 && prand[1] == 0x00 && prand[2] == 0x00) ||
       (prand[0] == 0xFF && prand[1] == 0xFF && prand[2] == 0x3F)) {
-    prand[0] = (uint8_t)(std::rand() % 0xFE + 1);
+    prand[0] = (uint8_t)(random() % 0xFE + 1);
   }
   prand[2] |= BLE_RESOLVE_ADDR_MSB;
 
@@ -2866,8 +2938,7 @@ void LinkLayerController::ScanIncomingLeLegacyAdvertisingPdu(
     response.direct_address_ = Address::kEmpty;
     response.advertising_data_ = advertising_data;
 
-    send_event_(bluetooth::hci::LeExtendedAdvertisingReportRawBuilder::Create(
-        {response}));
+    SendLeExtendedAdvertisingReport(std::move(response));
   }
 
   // Did the user enable Active scanning ?
@@ -3281,8 +3352,7 @@ void LinkLayerController::ScanIncomingLeExtendedAdvertisingPdu(
     response.direct_address_ = Address::kEmpty;
     response.advertising_data_ = advertising_data;
 
-    send_event_(bluetooth::hci::LeExtendedAdvertisingReportRawBuilder::Create(
-        {response}));
+    SendLeExtendedAdvertisingReport(std::move(response));
   }
 
   // Did the user enable Active scanning ?
@@ -4510,9 +4580,29 @@ void LinkLayerController::IncomingLeScanResponsePacket(
     response.tx_power_ = 0x7F;
     response.advertising_data_ = scan_response.GetScanResponseData();
     response.rssi_ = rssi;
+    SendLeExtendedAdvertisingReport(std::move(response));
+  }
+}
+
+// Advertising data that does not fit in one report is split over several
+// reports, all but the last one with the data status set to incomplete, more
+// data to come (Vol 4, Part E § 7.7.65.13).
+void LinkLayerController::SendLeExtendedAdvertisingReport(
+    bluetooth::hci::LeExtendedAdvertisingResponseRaw response) {
+  std::vector<uint8_t> data = std::move(response.advertising_data_);
+  size_t offset = 0;
+  do {
+    size_t length = std::min(kMaxExtendedAdvertisingReportDataLength,
+                             data.size() - offset);
+    response.advertising_data_.assign(data.begin() + offset,
+                                      data.begin() + offset + length);
+    offset += length;
+    response.data_status_ = offset < data.size()
+                                ? bluetooth::hci::DataStatus::CONTINUING
+                                : bluetooth::hci::DataStatus::COMPLETE;
     send_event_(bluetooth::hci::LeExtendedAdvertisingReportRawBuilder::Create(
         {response}));
-  }
+  } while (offset < data.size());
 }
 
 void LinkLayerController::LeScanning() {
@@ -4520,7 +4610,7 @@ void LinkLayerController::LeScanning() {
     return;
   }
 
-  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  std::chrono::steady_clock::time_point now = SimulationClock::now();
 
   // Extended Scanning Timeout
 
@@ -6118,13 +6208,24 @@ void LinkLayerController::Reset() {
   le_filter_accept_list_.clear();
   le_resolving_list_.clear();
   le_resolving_list_enabled_ = false;
+  UpdateFilterAcceptListIndex();
+  InvalidateRpaCache();
+  LOG_INFO(
+      "address resolution: %" PRIu64 " resolutions, %" PRIu64
+      " cache hits, %" PRIu64 " IRK checks, %" PRIu64
+      " filter accept list lookups",
+      address_resolution_stats_.resolutions,
+      address_resolution_stats_.rpa_cache_hits,
+      address_resolution_stats_.irk_checks,
+      address_resolution_stats_.filter_accept_list_lookups);
+  address_resolution_stats_ = AddressResolutionStats{};
   legacy_advertising_in_use_ = false;
   extended_advertising_in_use_ = false;
   legacy_advertiser_ = LegacyAdvertiser{};
   extended_advertisers_.clear();
   scanner_ = Scanner{};
   initiator_ = Initiator{};
-  last_inquiry_ = steady_clock::now();
+  last_inquiry_ = SimulationClock::now();
   inquiry_mode_ = InquiryType::STANDARD;
   inquiry_lap_ = 0;
   inquiry_max_responses_ = 0;
@@ -6184,7 +6285,7 @@ void LinkLayerController::SetInquiryMaxResponses(uint8_t max) {
 }
 
 void LinkLayerController::Inquiry() {
-  steady_clock::time_point now = steady_clock::now();
+  steady_clock::time_point now = SimulationClock::now();
   if (duration_cast<milliseconds>(now - last_inquiry_) < milliseconds(2000)) {
     return;
   }
@@ -19,6 +19,9 @@
 #include <algorithm>
 #include <chrono>
 #include <map>
+#include <random>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "hci/address.h"
@@ -238,6 +241,22 @@ class LinkLayerController {
   std::optional<AddressWithType> GenerateResolvablePrivateAddress(
       AddressWithType address, IrkSelection irk);
 
+  // Counters for the address resolution and filter accept list lookups
+  // made by this controller since the last reset.
+  struct AddressResolutionStats {
+    // RPAs looked up in the resolving list.
+    uint64_t resolutions{0};
+    // Lookups answered by the RPA cache.
+    uint64_t rpa_cache_hits{0};
+    // ah() computations.
+    uint64_t irk_checks{0};
+    uint64_t filter_accept_list_lookups{0};
+  };
+
+  AddressResolutionStats const& GetAddressResolutionStats() const {
+    return address_resolution_stats_;
+  }
+
   // Check if the selected address matches one of the controller's device
   // addresses (public or random static).
   bool IsLocalPublicOrRandomAddress(AddressWithType address) {
@@ -312,6 +331,12 @@ class LinkLayerController {
   void SetInquiryMaxResponses(uint8_t max);
   void Inquiry();
 
+  // True if the LE scanner or initiator is enabled, i.e. advertising PDUs
+  // received from the phy are processed.
+  bool IsListeningForAdvertising() const {
+    return scanner_.IsEnabled() || initiator_.IsEnabled();
+  }
+
   bool GetInquiryScanEnable() { return inquiry_scan_enable_; }
   void SetInquiryScanEnable(bool enable);
 
@@ -572,6 +597,9 @@ class LinkLayerController {
   void IncomingIsoConnectionResponsePacket(
       model::packets::LinkLayerPacketView packet);
 
+  void SendLeExtendedAdvertisingReport(
+      bluetooth::hci::LeExtendedAdvertisingResponseRaw response);
+
   void ScanIncomingLeLegacyAdvertisingPdu(
       model::packets::LeLegacyAdvertisingPduView& pdu, uint8_t rssi);
   void ScanIncomingLeExtendedAdvertisingPdu(
@@ -865,6 +893,11 @@ class LinkLayerController {
   // Resolvable Private Address Timeout (Vol 4, Part E § 7.8.45).
   std::chrono::seconds resolvable_private_address_timeout_{0x0384};
 
+  // Source of the prand part of the generated RPAs. Each controller has its
+  // own so that the addresses do not depend on the order in which devices
+  // ticking on different threads generate them.
+  std::minstd_rand rpa_random_;
+
   // Page Scan Repetition Mode (Vol 2 Part B § 8.3.1 Page Scan substate).
   // The Page Scan Repetition Mode depends on the selected Page Scan Interval.
   PageScanRepetitionMode page_scan_repetition_mode_{PageScanRepetitionMode::R0};
@@ -901,6 +934,15 @@ class LinkLayerController {
 
   std::vector<FilterAcceptListEntry> le_filter_accept_list_;
 
+  // Index of le_filter_accept_list_ by address type, rebuilt whenever
+  // the list is modified. Scanners and advertisers check the list for
+  // every received PDU.
+  std::unordered_set<Address> le_filter_accept_list_public_;
+  std::unordered_set<Address> le_filter_accept_list_random_;
+  bool le_filter_accept_list_anonymous_{false};
+
+  void UpdateFilterAcceptListIndex();
+
   struct ResolvingListEntry {
     PeerAddressType peer_identity_address_type;
     Address peer_identity_address;
@@ -912,6 +954,19 @@ class LinkLayerController {
   std::vector<ResolvingListEntry> le_resolving_list_;
   bool le_resolving_list_enabled_{false};
 
+  // Outcome of the resolution of recently received RPAs against the
+  // resolving list, for the peer and local IRKs, including the RPAs that
+  // could not be resolved. Devices keep the same RPA for several minutes,
+  // so most PDUs are resolved without computing ah() for every entry.
+  // The cache is dropped whenever the resolving list is modified.
+  static constexpr size_t kRpaCacheSize = 256;
+  std::array<std::unordered_map<Address, std::optional<AddressWithType>>, 2>
+      rpa_cache_;
+
+  void InvalidateRpaCache();
+
+  AddressResolutionStats address_resolution_stats_;
+
   // Flag set when any legacy advertising command has been received
   // since the last power-on-reset.
   // From Vol 4, Part E § 3.1.1 Legacy and extended advertising,
@@ -17,6 +17,7 @@
 #include "beacon.h"
 
 #include "model/setup/device_boutique.h"
+#include "model/setup/simulation_clock.h"
 
 namespace rootcanal {
 using namespace model::packets;
@@ -34,7 +35,10 @@ Beacon::Beacon()
       }),
       scan_response_data_(
           {0x05 /* Length */, 0x08 /* TYPE_NAME_SHORT */, 'b', 'e', 'a', 'c'}),
-      advertising_interval_(1280ms) {}
+      advertising_interval_(1280ms) {
+  // Beacons only answer scan requests sent to their address.
+  SetReceiveFilter(PhyLayer::ReceiveFilter::ADDRESSED);
+}
 
 Beacon::Beacon(const std::vector<std::string>& args) : Beacon() {
   if (args.size() >= 2) {
@@ -47,7 +51,7 @@ Beacon::Beacon(const std::vector<std::string>& args) : Beacon() {
 }
 
 void Beacon::TimerTick() {
-  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  std::chrono::steady_clock::time_point now = SimulationClock::now();
   if ((now - advertising_last_) >= advertising_interval_) {
     advertising_last_ = now;
     SendLinkLayerPacket(
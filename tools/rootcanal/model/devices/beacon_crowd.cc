@@ -0,0 +1,255 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "beacon_crowd.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <sstream>
+
+#include "log.h"
+#include "model/setup/device_boutique.h"
+
+namespace rootcanal {
+using namespace model::packets;
+using namespace std::chrono_literals;
+
+bool BeaconCrowd::registered_ =
+    DeviceBoutique::Register("beacon_crowd", &BeaconCrowd::Create);
+
+// Largest advertising data of an extended advertising set
+// (Vol 4, Part E § 7.8.57).
+static constexpr size_t kMaxExtendedAdvertisingDataLength = 1650;
+
+// Random delay added to each advertising event (Vol 6, Part B § 4.4.2.2.1).
+static constexpr std::chrono::milliseconds kMaxAdvertisingDelay = 10ms;
+
+// Parses a decimal argument, the arguments come straight from the test
+// channel and must not take RootCanal down.
+static bool ParseUnsigned(std::string const& text, unsigned long* value) {
+  if (text.empty() || text[0] < '0' || text[0] > '9') {
+    return false;
+  }
+  char* end = nullptr;
+  errno = 0;
+  *value = std::strtoul(text.c_str(), &end, 10);
+  return errno == 0 && *end == '\0';
+}
+
+BeaconCrowd::BeaconCrowd(const std::vector<std::string>& args) {
+  if (args.size() >= 2 && !Address::FromString(args[1], address_)) {
+    LOG_WARN("Ignoring invalid beacon_crowd address %s", args[1].c_str());
+  }
+
+  size_t count = 1;
+  unsigned long value = 0;
+  if (args.size() >= 3) {
+    if (ParseUnsigned(args[2], &value)) {
+      count = std::min<size_t>(value, kMaxBeacons);
+    } else {
+      LOG_WARN("Ignoring invalid beacon_crowd count %s", args[2].c_str());
+    }
+  }
+
+  if (args.size() >= 4) {
+    if (ParseUnsigned(args[3], &value)) {
+      // Shortest and longest advertising intervals
+      // (Vol 6, Part B § 4.4.2.2.1).
+      advertising_interval_ = std::max(
+          std::chrono::milliseconds(std::min(value, 10485759ul)), 20ms);
+    } else {
+      LOG_WARN("Ignoring invalid beacon_crowd interval %s", args[3].c_str());
+    }
+  }
+
+  for (size_t i = 4; i < args.size(); i++) {
+    ParseOption(args[i]);
+  }
+
+  // Spread the beacons over the first advertising interval, and give each
+  // one a share of the flags that matches the configured distribution.
+  random_.seed(std::hash<Address>{}(address_));
+  auto now = SimulationClock::now();
+  beacons_.resize(count);
+  for (uint32_t index = 0; index < count; index++) {
+    uint8_t flags = 0;
+    if ((random_() % 100) < extended_percent_) {
+      flags |= kExtended;
+    }
+    if ((random_() % 100) < scannable_percent_) {
+      flags |= kScannable;
+    }
+    beacons_[index] = flags;
+    auto phase = std::chrono::microseconds(random_() %
+                                           (advertising_interval_ / 1us));
+    schedule_.emplace(now + phase, index);
+  }
+
+  // Scan requests are only received for the last few addresses of a
+  // device by default, which does not cover a crowd.
+  SetReceiveFilter(scannable_percent_ > 0 ? PhyLayer::ReceiveFilter::ALL
+                                          : PhyLayer::ReceiveFilter::ADDRESSED);
+}
+
+void BeaconCrowd::ParseOption(std::string const& option) {
+  auto separator = option.find('=');
+  if (separator == std::string::npos) {
+    LOG_WARN("Ignoring invalid beacon_crowd option %s", option.c_str());
+    return;
+  }
+
+  std::string name = option.substr(0, separator);
+  unsigned long value = 0;
+  if (!ParseUnsigned(option.substr(separator + 1), &value)) {
+    LOG_WARN("Ignoring invalid beacon_crowd option %s", option.c_str());
+    return;
+  }
+  if (name == "extended") {
+    extended_percent_ = std::min(value, 100ul);
+  } else if (name == "scannable") {
+    scannable_percent_ = std::min(value, 100ul);
+  } else if (name == "data") {
+    extended_data_length_ =
+        std::min<size_t>(value, kMaxExtendedAdvertisingDataLength);
+  } else if (name == "rpa_rotation") {
+    // Longest resolvable private address timeout (Vol 4, Part E § 7.8.45).
+    rpa_rotation_ = std::chrono::seconds(std::min(value, 0xa1b8ul));
+  } else {
+    LOG_WARN("Ignoring unknown beacon_crowd option %s", option.c_str());
+  }
+}
+
+std::string BeaconCrowd::ToString() const {
+  std::stringstream ss;
+  ss << Device::ToString() << " " << beacons_.size() << " beacons, "
+     << advertising_count_ << " advertising PDUs, " << scan_response_count_
+     << " scan responses";
+  return ss.str();
+}
+
+Address BeaconCrowd::GetBeaconAddress(uint32_t index,
+                                      SimulationClock::time_point now) const {
+  // The index is kept in the three low order bytes so that scan requests
+  // can be matched without a lookup table.
+  Address address = address_;
+  address.address[0] = index;
+  address.address[1] = index >> 8;
+  address.address[2] = index >> 16;
+
+  if (rpa_rotation_.count() == 0) {
+    // Static random address.
+    address.address[5] |= 0xc0;
+    return address;
+  }
+
+  // Resolvable private address, with a random part that changes with every
+  // rotation period. Each beacon rotates at a different time.
+  auto offset = rpa_rotation_ * (index % 64) / 64;
+  uint64_t epoch = (now.time_since_epoch() + offset) / rpa_rotation_;
+  uint32_t prand = ((epoch * kMaxBeacons + index) * 0x9e3779b97f4a7c15) >> 40;
+  address.address[3] = prand;
+  address.address[4] = prand >> 8;
+  address.address[5] = ((prand >> 16) & 0x3f) | 0x40;
+  return address;
+}
+
+std::vector<uint8_t> BeaconCrowd::AdvertisingData(uint32_t index,
+                                                  size_t length) const {
+  std::vector<uint8_t> data;
+  data.reserve(length);
+  data.insert(data.end(),
+              {0x02 /* Length */, 0x01 /* TYPE_FLAG */,
+               0x4 /* BREDR_NOT_SUPPORTED */ | 0x2 /* GENERAL_DISCOVERABLE */});
+
+  // Manufacturer specific data, holding the beacon index and filling the
+  // rest of the payload. AD structures are at most 255 bytes long.
+  while (data.size() + 8 <= length) {
+    size_t ad_length = std::min<size_t>(255, length - data.size() - 1);
+    data.insert(data.end(),
+                {static_cast<uint8_t>(ad_length),
+                 0xff /* TYPE_MANUFACTURER_SPECIFIC_DATA */, 0xe0, 0x00,
+                 static_cast<uint8_t>(index), static_cast<uint8_t>(index >> 8),
+                 static_cast<uint8_t>(index >> 16)});
+    data.resize(data.size() + ad_length - 6, static_cast<uint8_t>(index));
+  }
+  return data;
+}
+
+void BeaconCrowd::SendAdvertising(uint32_t index,
+                                  SimulationClock::time_point now) {
+  Address address = GetBeaconAddress(index, now);
+  bool scannable = beacons_[index] & kScannable;
+  advertising_count_++;
+
+  if (beacons_[index] & kExtended) {
+    SendLinkLayerPacket(
+        LeExtendedAdvertisingPduBuilder::Create(
+            address, Address::kEmpty, AddressType::RANDOM, AddressType::PUBLIC,
+            false /* connectable */, scannable, false /* directed */,
+            index & 0xf /* sid */, 0x7f /* tx_power */, PrimaryPhyType::LE_1M,
+            SecondaryPhyType::LE_2M,
+            AdvertisingData(index, extended_data_length_)),
+        Phy::Type::LOW_ENERGY);
+  } else {
+    SendLinkLayerPacket(
+        LeLegacyAdvertisingPduBuilder::Create(
+            address, Address::kEmpty, AddressType::RANDOM, AddressType::PUBLIC,
+            scannable ? LegacyAdvertisingType::ADV_SCAN_IND
+                      : LegacyAdvertisingType::ADV_NONCONN_IND,
+            AdvertisingData(index, 31)),
+        Phy::Type::LOW_ENERGY);
+  }
+}
+
+void BeaconCrowd::TimerTick() {
+  auto now = SimulationClock::now();
+  while (!schedule_.empty() && schedule_.top().first <= now) {
+    auto [time, index] = schedule_.top();
+    schedule_.pop();
+    SendAdvertising(index, now);
+
+    // Keep the beacons from advertising in lockstep.
+    auto delay =
+        std::chrono::microseconds(random_() % (kMaxAdvertisingDelay / 1us));
+    schedule_.emplace(std::max(time + advertising_interval_ + delay, now),
+                      index);
+  }
+}
+
+void BeaconCrowd::IncomingPacket(LinkLayerPacketView packet) {
+  if (packet.GetType() != PacketType::LE_SCAN) {
+    return;
+  }
+
+  Address destination = packet.GetDestinationAddress();
+  uint32_t index = destination.address[0] | (destination.address[1] << 8) |
+                   (destination.address[2] << 16);
+  if (index >= beacons_.size() || !(beacons_[index] & kScannable) ||
+      destination != GetBeaconAddress(index, SimulationClock::now())) {
+    return;
+  }
+
+  scan_response_count_++;
+  SendLinkLayerPacket(
+      LeScanResponseBuilder::Create(
+          destination, packet.GetSourceAddress(), AddressType::RANDOM,
+          std::vector<uint8_t>({0x06 /* Length */, 0x08 /* TYPE_NAME_SHORT */,
+                                'c', 'r', 'o', 'w', 'd'})),
+      Phy::Type::LOW_ENERGY);
+}
+
+}  // namespace rootcanal
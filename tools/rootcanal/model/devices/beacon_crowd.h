@@ -0,0 +1,107 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <queue>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "device.h"
+#include "model/setup/simulation_clock.h"
+
+namespace rootcanal {
+
+// A crowd of LE beacons simulated by a single device, to stress the scanning
+// path of the hosts with realistic densities.
+//
+//   add beacon_crowd <base_address> <count> [interval_ms] [option=value...]
+//
+// Options:
+//   extended=<percent>   share of beacons using extended advertising.
+//   scannable=<percent>  share of beacons answering scan requests.
+//   data=<bytes>         extended advertising data length, up to 1650.
+//                        The scanning controllers split data longer than
+//                        229 bytes over several advertising reports.
+//   rpa_rotation=<s>     use resolvable private addresses renewed every
+//                        <s> seconds instead of static random addresses.
+//
+// Invalid arguments are ignored with a warning. The beacons are a compact
+// table, and only the beacons that are due are visited on each tick.
+class BeaconCrowd : public Device {
+ public:
+  BeaconCrowd(const std::vector<std::string>& args);
+  virtual ~BeaconCrowd() = default;
+
+  static std::shared_ptr<Device> Create(const std::vector<std::string>& args) {
+    return std::make_shared<BeaconCrowd>(args);
+  }
+
+  // Return a string representation of the type of device.
+  virtual std::string GetTypeString() const override { return "beacon_crowd"; }
+
+  virtual std::string ToString() const override;
+
+  virtual void TimerTick() override;
+  virtual void IncomingPacket(
+      model::packets::LinkLayerPacketView packet) override;
+
+  // Address used by the beacon |index| at the time |now|.
+  Address GetBeaconAddress(uint32_t index,
+                           SimulationClock::time_point now) const;
+
+  size_t GetNumBeacons() const { return beacons_.size(); }
+  uint64_t GetAdvertisingCount() const { return advertising_count_; }
+  uint64_t GetScanResponseCount() const { return scan_response_count_; }
+
+  static constexpr uint32_t kMaxBeacons = 1 << 24;
+
+ private:
+  enum BeaconFlags : uint8_t {
+    kExtended = 1 << 0,
+    kScannable = 1 << 1,
+  };
+
+  void ParseOption(std::string const& option);
+  void SendAdvertising(uint32_t index, SimulationClock::time_point now);
+  std::vector<uint8_t> AdvertisingData(uint32_t index, size_t length) const;
+
+  // Flags of each beacon, by index.
+  std::vector<uint8_t> beacons_;
+
+  // Beacons by time of their next advertising event.
+  using Event = std::pair<SimulationClock::time_point, uint32_t>;
+  std::priority_queue<Event, std::vector<Event>, std::greater<Event>>
+      schedule_;
+
+  std::chrono::milliseconds advertising_interval_{1280};
+  unsigned extended_percent_{0};
+  unsigned scannable_percent_{0};
+  size_t extended_data_length_{31};
+  std::chrono::seconds rpa_rotation_{0};
+
+  std::minstd_rand random_;
+  uint64_t advertising_count_{0};
+  uint64_t scan_response_count_{0};
+
+  static bool registered_;
+};
+
+}  // namespace rootcanal
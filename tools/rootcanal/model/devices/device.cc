@@ -25,6 +25,8 @@ std::string Device::ToString() const {
 }
 
 void Device::RegisterPhyLayer(std::shared_ptr<PhyLayer> phy) {
+  phy->SetReceiveFilter(receive_filter_);
+  phy->SetPosition(position_);
   phy_layers_.push_back(phy);
 }
 
@@ -48,6 +50,27 @@ void Device::UnregisterPhyLayer(Phy::Type phy_type, uint32_t factory_id) {
   }
 }
 
+void Device::SetReceiveFilter(PhyLayer::ReceiveFilter filter) {
+  if (filter == receive_filter_) {
+    return;
+  }
+  receive_filter_ = filter;
+  for (auto& phy : phy_layers_) {
+    if (phy != nullptr) {
+      phy->SetReceiveFilter(filter);
+    }
+  }
+}
+
+void Device::SetPosition(PhyLayer::Position position) {
+  position_ = position;
+  for (auto& phy : phy_layers_) {
+    if (phy != nullptr) {
+      phy->SetPosition(position);
+    }
+  }
+}
+
 void Device::SendLinkLayerPacket(
     std::shared_ptr<model::packets::LinkLayerPacketBuilder> to_send,
     Phy::Type phy_type) {
@@ -19,6 +19,7 @@
 #include <chrono>
 #include <cstdint>
 #include <map>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -58,6 +59,12 @@ class Device {
 
   void UnregisterPhyLayer(Phy::Type phy_type, uint32_t factory_id);
 
+  // Set which packets the device needs to receive on all its phy layers.
+  void SetReceiveFilter(PhyLayer::ReceiveFilter filter);
+
+  // Set the location of the device, used by phys with a limited range.
+  void SetPosition(PhyLayer::Position position);
+
   virtual void IncomingPacket(model::packets::LinkLayerPacketView){};
 
   virtual void SendLinkLayerPacket(
@@ -81,6 +88,11 @@ class Device {
 
   // Callback to be invoked when this device is closed.
   std::function<void()> close_callback_;
+
+ private:
+  // Applied to the phy layers registered later on.
+  PhyLayer::ReceiveFilter receive_filter_{PhyLayer::ReceiveFilter::ALL};
+  std::optional<PhyLayer::Position> position_{};
 };
 
 }  // namespace rootcanal
@@ -40,6 +40,7 @@ H4DataChannelPacketizer::H4DataChannelPacketizer(
     ClientDisconnectCallback disconnect_cb)
     : uart_socket_(socket),
       h4_parser_(command_cb, event_cb, acl_cb, sco_cb, iso_cb, true),
+      read_buffer_(kReadBufferSize),
       disconnect_cb_(std::move(disconnect_cb)) {}
 
 size_t H4DataChannelPacketizer::Send(uint8_t type, const uint8_t* data,
@@ -66,10 +67,7 @@ size_t H4DataChannelPacketizer::Send(uint8_t type, const uint8_t* data,
 
 void H4DataChannelPacketizer::OnDataReady(
     std::shared_ptr<AsyncDataChannel> socket) {
-  ssize_t bytes_to_read = h4_parser_.BytesRequested();
-  std::vector<uint8_t> buffer(bytes_to_read);
-
-  ssize_t bytes_read = socket->Recv(buffer.data(), bytes_to_read);
+  ssize_t bytes_read = socket->Recv(read_buffer_.data(), read_buffer_.size());
   if (bytes_read == 0) {
     LOG_INFO("remote disconnected!");
     disconnected_ = true;
@@ -89,7 +87,7 @@ void H4DataChannelPacketizer::OnDataReady(
                        strerror(errno));
     }
   }
-  h4_parser_.Consume(buffer.data(), bytes_read);
+  h4_parser_.ConsumeStream(read_buffer_.data(), bytes_read);
 }
 
 }  // namespace rootcanal
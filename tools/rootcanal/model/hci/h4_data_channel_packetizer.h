@@ -20,6 +20,7 @@
 #include <stdint.h>  // for uint8_t
 
 #include <memory>  // for shared_ptr
+#include <vector>  // for vector
 
 #include "h4_parser.h"     // for ClientDisconnectCallback, H4Parser
 #include "hci_protocol.h"  // for PacketReadCallback, AsyncDataChannel, HciProtocol
@@ -48,6 +49,11 @@ class H4DataChannelPacketizer : public HciProtocol {
   std::shared_ptr<AsyncDataChannel> uart_socket_;
   H4Parser h4_parser_;
 
+  // Data is read from the socket in chunks of up to kReadBufferSize bytes,
+  // which may hold several packets. Partial packets are kept by the parser.
+  static constexpr size_t kReadBufferSize = 16384;
+  std::vector<uint8_t> read_buffer_;
+
   ClientDisconnectCallback disconnect_cb_;
   bool disconnected_{false};
 };
@@ -16,6 +16,7 @@
 
 #include "model/hci/h4_parser.h"  // for H4Parser, PacketType, H4Pars...
 
+#include <algorithm>  // for min
 #include <array>
 #include <cstddef>     // for size_t
 #include <cstdint>     // for uint8_t, int32_t
@@ -197,6 +198,7 @@ bool H4Parser::Consume(const uint8_t* buffer, int32_t bytes_read) {
           OnPacketReady();
           state_ = HCI_TYPE;
         } else {
+          packet_.reserve(packet_.size() + payload_size);
           bytes_wanted_ = payload_size;
           state_ = HCI_PAYLOAD;
         }
@@ -212,4 +214,16 @@ bool H4Parser::Consume(const uint8_t* buffer, int32_t bytes_read) {
   }
   return true;
 }
+
+bool H4Parser::ConsumeStream(const uint8_t* buffer, size_t bytes) {
+  while (bytes > 0) {
+    size_t chunk = std::min(bytes, BytesRequested());
+    if (!Consume(buffer, static_cast<int32_t>(chunk))) {
+      return false;
+    }
+    buffer += chunk;
+    bytes -= chunk;
+  }
+  return true;
+}
 }  // namespace rootcanal
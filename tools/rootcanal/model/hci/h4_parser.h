@@ -54,6 +54,10 @@ class H4Parser {
   // Consumes the given number of bytes, returns true on success.
   bool Consume(const uint8_t* buffer, int32_t bytes);
 
+  // Consumes a chunk of the H4 stream of any size, which may hold several
+  // packets, and a partial packet at the end. Returns true on success.
+  bool ConsumeStream(const uint8_t* buffer, size_t bytes);
+
   // The maximum number of bytes the parser can consume in the current state.
   size_t BytesRequested();
 
@@ -26,32 +26,57 @@ HciSniffer::HciSniffer(std::shared_ptr<HciTransport> transport,
   SetOutputStream(outputStream);
 }
 
+HciSniffer::~HciSniffer() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  FlushRecords();
+}
+
 void HciSniffer::SetOutputStream(std::shared_ptr<std::ostream> outputStream) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  FlushRecords();
   output_ = outputStream;
   if (output_) {
     uint32_t linktype = 201;  // http://www.tcpdump.org/linktypes.html
                               // LINKTYPE_BLUETOOTH_HCI_H4_WITH_PHDR
 
     pcap::WriteHeader(*output_, linktype);
+    output_->flush();
+    pending_records_.reserve(kFlushThreshold);
   }
 }
 
 void HciSniffer::AppendRecord(PacketDirection packet_direction,
                               PacketType packet_type,
                               const std::vector<uint8_t>& packet) {
+  std::lock_guard<std::mutex> lock(mutex_);
   if (output_ == nullptr) {
     return;
   }
-  pcap::WriteRecordHeader(*output_, 4 + 1 + packet.size());
+  pcap::AppendRecordHeader(pending_records_, 4 + 1 + packet.size());
 
   // http://www.tcpdump.org/linktypes.html LINKTYPE_BLUETOOTH_HCI_H4_WITH_PHDR
   char direction[4] = {0, 0, 0, static_cast<char>(packet_direction)};
-  uint8_t idc = static_cast<uint8_t>(packet_type);
+  char idc = static_cast<char>(packet_type);
+
+  pending_records_.insert(pending_records_.end(), direction,
+                          direction + sizeof(direction));
+  pending_records_.push_back(idc);
+  pending_records_.insert(pending_records_.end(), packet.begin(),
+                          packet.end());
+
+  if (pending_records_.size() >= kFlushThreshold) {
+    FlushRecords();
+  }
+}
 
-  output_->write(direction, sizeof(direction));
-  output_->write((char*)&idc, 1);
-  output_->write((char*)packet.data(), packet.size());
+void HciSniffer::FlushRecords() {
+  if (output_ == nullptr || pending_records_.empty()) {
+    pending_records_.clear();
+    return;
+  }
+  output_->write(pending_records_.data(), pending_records_.size());
   output_->flush();
+  pending_records_.clear();
 }
 
 void HciSniffer::RegisterCallbacks(PacketCallback command_callback,
@@ -84,11 +109,18 @@ void HciSniffer::RegisterCallbacks(PacketCallback command_callback,
       close_callback);
 }
 
-void HciSniffer::TimerTick() { transport_->TimerTick(); }
+void HciSniffer::TimerTick() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    FlushRecords();
+  }
+  transport_->TimerTick();
+}
 
 void HciSniffer::Close() {
   transport_->Close();
-  output_->flush();
+  std::lock_guard<std::mutex> lock(mutex_);
+  FlushRecords();
 }
 
 void HciSniffer::SendEvent(const std::vector<uint8_t>& packet) {
@@ -19,7 +19,9 @@
 #include <cstdint>
 #include <fstream>
 #include <memory>
+#include <mutex>
 #include <ostream>
+#include <vector>
 
 #include "model/hci/h4.h"
 #include "model/hci/hci_transport.h"
@@ -33,11 +35,15 @@ enum class PacketDirection : uint8_t {
 
 // A Hci Transport that logs all the in and out going
 // packets to a stream.
+//
+// Records are collected in memory and written to the stream in batches,
+// on timer ticks or when kFlushThreshold bytes are pending, to keep the
+// stream writes off the packet path.
 class HciSniffer : public HciTransport {
  public:
   HciSniffer(std::shared_ptr<HciTransport> transport,
              std::shared_ptr<std::ostream> outputStream = nullptr);
-  ~HciSniffer() = default;
+  ~HciSniffer();
 
   static std::shared_ptr<HciTransport> Create(
       std::shared_ptr<HciTransport> transport,
@@ -70,6 +76,15 @@ class HciSniffer : public HciTransport {
   void AppendRecord(PacketDirection direction, PacketType type,
                     const std::vector<uint8_t>& packet);
 
+  // Write the pending records to the output stream. Requires mutex_.
+  void FlushRecords();
+
+  static constexpr size_t kFlushThreshold = 65536;
+
+  // Packets are received on the HCI socket thread and sent from the
+  // simulation thread.
+  std::mutex mutex_;
+  std::vector<char> pending_records_;
   std::shared_ptr<std::ostream> output_;
   std::shared_ptr<HciTransport> transport_;
 };
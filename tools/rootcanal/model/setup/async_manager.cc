@@ -18,14 +18,17 @@
 
 #include <algorithm>
 #include <atomic>
+#include <cerrno>
 #include <condition_variable>
+#include <cstring>
 #include <mutex>
 #include <thread>
 #include <vector>
 
 #include "fcntl.h"
 #include "log.h"
-#include "sys/select.h"
+#include "model/setup/simulation_clock.h"
+#include "sys/epoll.h"
 #include "unistd.h"
 
 namespace rootcanal {
@@ -39,9 +42,11 @@ namespace rootcanal {
 // After construction of this objects nothing happens beyond some very simple
 // member initialization. When the first FD is set up for watching the object
 // starts a new thread which watches the given (and later provided) FDs using
-// select() inside a loop. A special FD (a pipe) is also watched which is
+// epoll inside a loop. FDs are added to and removed from the epoll set as
+// they are watched and unwatched, so the cost of each wake up only depends
+// on the number of ready FDs. A special FD (a pipe) is also watched which is
 // used to notify the thread of internal changes on the object state (like
-// the addition of new FDs to watch on). Every access to internal state is
+// the request to stop). Every access to internal state is
 // synchronized using a single internal mutex. The thread is only stopped on
 // destruction of the object, by modifying a flag, which is the only member
 // variable accessed without acquiring the lock (because the notification to
@@ -71,6 +76,9 @@ namespace rootcanal {
 // resumes execution believing that it needs to continue and waits on the
 // cond var possibly forever if there are no tasks scheduled, efectively
 // causing a deadlock).
+// Task times are in simulation time (see SimulationClock). In virtual time
+// mode, the thread advances the simulation clock to the next task instead
+// of waiting for it, as long as the hosts are idle.
 
 // This number also states the maximum number of scheduled tasks we can handle
 // at a given time
@@ -91,16 +99,16 @@ static inline AsyncTaskId NextAsyncTaskId(const AsyncTaskId id) {
 // no need to treat that case.
 static const int kNotificationBufferSize = 10;
 
+// Maximum number of ready FDs handled per wake up of the reading thread,
+// the remaining ones are reported by the next epoll_wait().
+static const int kMaxEvents = 64;
+
 // Async File Descriptor Watcher Implementation:
 class AsyncManager::AsyncFdWatcher {
  public:
   int WatchFdForNonBlockingReads(
       int file_descriptor, const ReadCallback& on_read_fd_ready_callback) {
-    // add file descriptor and callback
-    {
-      std::unique_lock<std::recursive_mutex> guard(internal_mutex_);
-      watched_shared_fds_[file_descriptor] = on_read_fd_ready_callback;
-    }
+    std::unique_lock<std::recursive_mutex> guard(internal_mutex_);
 
     // start the thread if not started yet
     int started = tryStartThread();
@@ -109,15 +117,24 @@ class AsyncManager::AsyncFdWatcher {
       return started;
     }
 
-    // notify the thread so that it knows of the new FD
-    notifyThread();
+    // add file descriptor and callback
+    bool watched = watched_shared_fds_.count(file_descriptor) != 0;
+    watched_shared_fds_[file_descriptor] = on_read_fd_ready_callback;
+    if (!watched && addToEpollSet(file_descriptor) != 0) {
+      watched_shared_fds_.erase(file_descriptor);
+      return -1;
+    }
 
     return 0;
   }
 
   void StopWatchingFileDescriptor(int file_descriptor) {
     std::unique_lock<std::recursive_mutex> guard(internal_mutex_);
-    watched_shared_fds_.erase(file_descriptor);
+    if (watched_shared_fds_.erase(file_descriptor) == 0) {
+      return;
+    }
+    // The FD may have been closed already, which removed it from the set.
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, file_descriptor, nullptr);
   }
 
   AsyncFdWatcher() = default;
@@ -143,6 +160,11 @@ class AsyncManager::AsyncFdWatcher {
     {
       std::unique_lock<std::recursive_mutex> guard(internal_mutex_);
       watched_shared_fds_.clear();
+      if (std::this_thread::get_id() != thread_.get_id()) {
+        close(epoll_fd_);
+        close(notification_listen_fd_);
+        close(notification_write_fd_);
+      }
     }
 
     return 0;
@@ -167,6 +189,13 @@ class AsyncManager::AsyncFdWatcher {
     notification_listen_fd_ = pipe_fds[0];
     notification_write_fd_ = pipe_fds[1];
 
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd_ < 0 || addToEpollSet(notification_listen_fd_) != 0) {
+      LOG_ERROR("%s: Unable to create the epoll set: %s", __func__,
+                strerror(errno));
+      return -1;
+    }
+
     thread_ = std::thread([this]() { ThreadRoutine(); });
     if (!thread_.joinable()) {
       LOG_ERROR("%s: Unable to start reading thread", __func__);
@@ -184,42 +213,54 @@ class AsyncManager::AsyncFdWatcher {
     return 0;
   }
 
-  int setUpFileDescriptorSet(fd_set& read_fds) {
-    // add comm channel to the set
-    FD_SET(notification_listen_fd_, &read_fds);
-    int nfds = notification_listen_fd_;
-
-    // add watched FDs to the set
-    {
-      std::unique_lock<std::recursive_mutex> guard(internal_mutex_);
-      for (auto& fdp : watched_shared_fds_) {
-        FD_SET(fdp.first, &read_fds);
-        nfds = std::max(fdp.first, nfds);
-      }
+  int addToEpollSet(int file_descriptor) {
+    struct epoll_event event {};
+    event.events = EPOLLIN;
+    event.data.fd = file_descriptor;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, file_descriptor, &event) != 0 &&
+        errno != EEXIST) {
+      LOG_ERROR("%s: Unable to watch fd %d: %s", __func__, file_descriptor,
+                strerror(errno));
+      return -1;
     }
-    return nfds;
+    return 0;
   }
 
   // check the comm channel and read everything there
-  bool consumeThreadNotifications(fd_set& read_fds) {
-    if (FD_ISSET(notification_listen_fd_, &read_fds)) {
-      char buffer[kNotificationBufferSize];
-      while (TEMP_FAILURE_RETRY(read(notification_listen_fd_, buffer,
-                                     kNotificationBufferSize)) ==
-             kNotificationBufferSize) {
+  bool consumeThreadNotifications(const struct epoll_event* events,
+                                  int num_events) {
+    for (int i = 0; i < num_events; i++) {
+      if (events[i].data.fd == notification_listen_fd_) {
+        char buffer[kNotificationBufferSize];
+        while (TEMP_FAILURE_RETRY(read(notification_listen_fd_, buffer,
+                                       kNotificationBufferSize)) ==
+               kNotificationBufferSize) {
+        }
+        return true;
       }
-      return true;
     }
     return false;
   }
 
-  // check all file descriptors and call callbacks if necesary
-  void runAppropriateCallbacks(fd_set& read_fds) {
+  // call the callbacks of the ready file descriptors, in ascending FD order
+  // so that they run in the same order regardless of how epoll reports them
+  void runAppropriateCallbacks(const struct epoll_event* events,
+                               int num_events) {
+    std::vector<int> ready_fds;
+    for (int i = 0; i < num_events; i++) {
+      ready_fds.push_back(events[i].data.fd);
+    }
+    std::sort(ready_fds.begin(), ready_fds.end());
+
+    // The hosts are not idle, hold virtual time.
+    SimulationClock::OnHostActivity();
+
     std::vector<decltype(watched_shared_fds_)::value_type> fds;
     std::unique_lock<std::recursive_mutex> guard(internal_mutex_);
-    for (auto& fdc : watched_shared_fds_) {
-      if (FD_ISSET(fdc.first, &read_fds)) {
-        fds.push_back(fdc);
+    for (int fd : ready_fds) {
+      auto fdc = watched_shared_fds_.find(fd);
+      if (fdc != watched_shared_fds_.end()) {
+        fds.push_back(*fdc);
       }
     }
     for (auto& p : fds) {
@@ -228,14 +269,12 @@ class AsyncManager::AsyncFdWatcher {
   }
 
   void ThreadRoutine() {
+    struct epoll_event events[kMaxEvents];
     while (running_) {
-      fd_set read_fds;
-      FD_ZERO(&read_fds);
-      int nfds = setUpFileDescriptorSet(read_fds);
-
       // wait until there is data available to read on some FD
-      int retval = select(nfds + 1, &read_fds, NULL, NULL, NULL);
-      if (retval <= 0) {  // there was some error or a timeout
+      int retval =
+          TEMP_FAILURE_RETRY(epoll_wait(epoll_fd_, events, kMaxEvents, -1));
+      if (retval <= 0) {  // there was some error
         LOG_ERROR(
             "%s: There was an error while waiting for data on the file "
             "descriptors: %s",
@@ -243,14 +282,14 @@ class AsyncManager::AsyncFdWatcher {
         continue;
       }
 
-      consumeThreadNotifications(read_fds);
+      consumeThreadNotifications(events, retval);
 
       // Do not read if there was a call to stop running
       if (!running_) {
         break;
       }
 
-      runAppropriateCallbacks(read_fds);
+      runAppropriateCallbacks(events, retval);
     }
   }
 
@@ -263,6 +302,7 @@ class AsyncManager::AsyncFdWatcher {
   // A pair of FD to send information to the reading thread
   int notification_listen_fd_{};
   int notification_write_fd_{};
+  int epoll_fd_{-1};
 };
 
 // Async task manager implementation
@@ -272,8 +312,8 @@ class AsyncManager::AsyncTaskManager {
 
   AsyncTaskId ExecAsync(AsyncUserId user_id, std::chrono::milliseconds delay,
                         const TaskCallback& callback) {
-    return scheduleTask(std::make_shared<Task>(
-        std::chrono::steady_clock::now() + delay, callback, user_id));
+    return scheduleTask(std::make_shared<Task>(SimulationClock::now() + delay,
+                                               callback, user_id));
   }
 
   AsyncTaskId ExecAsyncPeriodically(AsyncUserId user_id,
@@ -281,7 +321,7 @@ class AsyncManager::AsyncTaskManager {
                                     std::chrono::milliseconds period,
                                     const TaskCallback& callback) {
     return scheduleTask(std::make_shared<Task>(
-        std::chrono::steady_clock::now() + delay, period, callback, user_id));
+        SimulationClock::now() + delay, period, callback, user_id));
   }
 
   bool CancelAsyncTask(AsyncTaskId async_task_id) {
@@ -458,7 +498,7 @@ class AsyncManager::AsyncTaskManager {
         std::unique_lock<std::mutex> guard(internal_mutex_);
         if (!task_queue_.empty()) {
           task_p = *(task_queue_.begin());
-          if (task_p->time < std::chrono::steady_clock::now()) {
+          if (task_p->time <= SimulationClock::now()) {
             run_it = true;
             callback = task_p->callback;
             task_queue_.erase(task_p);  // need to remove and add again if
@@ -488,7 +528,15 @@ class AsyncManager::AsyncTaskManager {
           // have been freed (e.g. via CancelAsyncTask).
           std::chrono::steady_clock::time_point time =
               (*task_queue_.begin())->time;
-          internal_cond_var_.wait_until(guard, time);
+          // In virtual time mode, jump to the next task rather than sleeping
+          // while the hosts are idle, and check again once they are.
+          std::chrono::steady_clock::time_point idle_time;
+          if (SimulationClock::CanSkipTime(&idle_time)) {
+            SimulationClock::AdvanceTo(time);
+            continue;
+          }
+          time = SimulationClock::ToWallTime(time);
+          internal_cond_var_.wait_until(guard, std::min(time, idle_time));
         } else {
           internal_cond_var_.wait(guard);
         }
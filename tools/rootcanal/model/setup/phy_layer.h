@@ -16,12 +16,32 @@
 
 #pragma once
 
+#include <optional>
+
 #include "include/phy.h"
 #include "packets/link_layer_packets.h"
 namespace rootcanal {
 
 class PhyLayer {
  public:
+  // Packets the device attached to the phy needs to see. The phy layer
+  // factory uses it to skip devices that would drop the packet anyway.
+  enum class ReceiveFilter {
+    // Every packet, e.g. sniffers and remote link layer connections.
+    ALL,
+    // Broadcasts and packets sent to one of the device addresses.
+    ADDRESSED,
+    // Same as ADDRESSED, plus LE advertising PDUs (scanning or initiating).
+    ADDRESSED_AND_ADVERTISING,
+  };
+
+  // Location of the device in meters, used by the phy range model.
+  struct Position {
+    float x;
+    float y;
+    float z;
+  };
+
   PhyLayer(Phy::Type phy_type, uint32_t id,
            const std::function<void(model::packets::LinkLayerPacketView)>&
                device_receive,
@@ -49,12 +69,26 @@ class PhyLayer {
 
   uint32_t GetDeviceId() { return device_id_; }
 
+  virtual void SetReceiveFilter(ReceiveFilter filter) {
+    receive_filter_ = filter;
+  }
+
+  ReceiveFilter GetReceiveFilter() const { return receive_filter_; }
+
+  virtual void SetPosition(std::optional<Position> position) {
+    position_ = position;
+  }
+
+  const std::optional<Position>& GetPosition() const { return position_; }
+
   virtual ~PhyLayer() = default;
 
  private:
   Phy::Type phy_type_;
   uint32_t id_;
   uint32_t device_id_;
+  ReceiveFilter receive_filter_{ReceiveFilter::ALL};
+  std::optional<Position> position_{};
 
  protected:
   const std::function<void(model::packets::LinkLayerPacketView)>
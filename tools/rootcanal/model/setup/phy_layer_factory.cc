@@ -16,10 +16,30 @@
 
 #include "phy_layer_factory.h"
 
+#include <algorithm>
+#include <cmath>
 #include <sstream>
 
+#include "model/setup/simulation_worker_pool.h"
+
 namespace rootcanal {
 
+using model::packets::PacketType;
+
+// Maximum number of source addresses remembered per phy. Devices rotating
+// their address keep only the most recent ones routed.
+static constexpr size_t kMaxSourceAddressesPerPhy = 16;
+
+static bool IsAdvertisingPdu(model::packets::LinkLayerPacketView packet) {
+  switch (packet.GetType()) {
+    case PacketType::LE_LEGACY_ADVERTISING_PDU:
+    case PacketType::LE_EXTENDED_ADVERTISING_PDU:
+      return true;
+    default:
+      return false;
+  }
+}
+
 PhyLayerFactory::PhyLayerFactory(Phy::Type phy_type, uint32_t factory_id)
     : phy_type_(phy_type), factory_id_(factory_id) {}
 
@@ -34,6 +54,8 @@ std::shared_ptr<PhyLayer> PhyLayerFactory::GetPhyLayer(
   std::shared_ptr<PhyLayer> new_phy = std::make_shared<PhyLayerImpl>(
       phy_type_, next_id_++, device_receive, device_id, this);
   phy_layers_.push_back(new_phy);
+  phys_by_id_[new_phy->GetId()] = new_phy;
+  UpdateReceiveFilter(new_phy->GetId());
   return new_phy;
 }
 
@@ -41,11 +63,149 @@ void PhyLayerFactory::UnregisterPhyLayer(uint32_t id) {
   for (auto phy : phy_layers_) {
     if (phy->GetId() == id) {
       phy_layers_.remove(phy);
+      phys_by_id_.erase(id);
+      promiscuous_phys_.erase(id);
+      advertising_phys_.erase(id);
+      ForgetSourceAddresses(id);
       return;
     }
   }
 }
 
+void PhyLayerFactory::UpdateReceiveFilter(uint32_t phy_id) {
+  if (auto deferred = DeferredOperations::Current(); deferred != nullptr) {
+    deferred->Defer([this, phy_id] { UpdateReceiveFilter(phy_id); });
+    return;
+  }
+
+  auto it = phys_by_id_.find(phy_id);
+  if (it == phys_by_id_.end()) {
+    return;
+  }
+
+  auto const& phy = it->second;
+  switch (phy->GetReceiveFilter()) {
+    case PhyLayer::ReceiveFilter::ALL:
+      promiscuous_phys_[phy_id] = phy;
+      advertising_phys_[phy_id] = phy;
+      break;
+    case PhyLayer::ReceiveFilter::ADDRESSED:
+      promiscuous_phys_.erase(phy_id);
+      advertising_phys_.erase(phy_id);
+      break;
+    case PhyLayer::ReceiveFilter::ADDRESSED_AND_ADVERTISING:
+      promiscuous_phys_.erase(phy_id);
+      advertising_phys_[phy_id] = phy;
+      break;
+  }
+}
+
+void PhyLayerFactory::SetRange(float range) { range_ = range; }
+
+bool PhyLayerFactory::InRange(PhyLayer const& sender,
+                              PhyLayer const& receiver) const {
+  if (range_ <= 0 || !sender.GetPosition() || !receiver.GetPosition()) {
+    return true;
+  }
+  auto const& a = *sender.GetPosition();
+  auto const& b = *receiver.GetPosition();
+  float dx = a.x - b.x;
+  float dy = a.y - b.y;
+  float dz = a.z - b.z;
+  return dx * dx + dy * dy + dz * dz <= range_ * range_;
+}
+
+void PhyLayerFactory::LearnSourceAddress(uint32_t phy_id,
+                                         Address const& address) {
+  if (address == Address::kEmpty) {
+    return;
+  }
+
+  auto& owners = address_owners_[address];
+  if (std::find(owners.begin(), owners.end(), phy_id) != owners.end()) {
+    return;
+  }
+  owners.push_back(phy_id);
+
+  auto& addresses = source_addresses_[phy_id];
+  addresses.push_back(address);
+  if (addresses.size() > kMaxSourceAddressesPerPhy) {
+    auto& oldest_owners = address_owners_[addresses.front()];
+    oldest_owners.erase(
+        std::remove(oldest_owners.begin(), oldest_owners.end(), phy_id),
+        oldest_owners.end());
+    if (oldest_owners.empty()) {
+      address_owners_.erase(addresses.front());
+    }
+    addresses.pop_front();
+  }
+}
+
+void PhyLayerFactory::ForgetSourceAddresses(uint32_t phy_id) {
+  auto it = source_addresses_.find(phy_id);
+  if (it == source_addresses_.end()) {
+    return;
+  }
+  for (auto const& address : it->second) {
+    auto& owners = address_owners_[address];
+    owners.erase(std::remove(owners.begin(), owners.end(), phy_id),
+                 owners.end());
+    if (owners.empty()) {
+      address_owners_.erase(address);
+    }
+  }
+  source_addresses_.erase(it);
+}
+
+void PhyLayerFactory::GetReceivers(
+    model::packets::LinkLayerPacketView packet, uint32_t sender_id,
+    std::vector<std::shared_ptr<PhyLayer>>& receivers) const {
+  // Look through the RSSI wrapper to route on the actual PDU.
+  auto routed_packet = packet;
+  if (packet.GetType() == PacketType::RSSI_WRAPPER) {
+    auto rssi_wrapper = model::packets::RssiWrapperView::Create(packet);
+    if (rssi_wrapper.IsValid()) {
+      routed_packet = model::packets::LinkLayerPacketView::Create(
+          rssi_wrapper.GetPayload());
+      if (!routed_packet.IsValid()) {
+        routed_packet = packet;
+      }
+    }
+  }
+
+  auto add_receivers = [&](auto const& phys) {
+    for (auto const& [id, phy] : phys) {
+      if (id != sender_id) {
+        receivers.push_back(phy);
+      }
+    }
+  };
+
+  if (IsAdvertisingPdu(routed_packet)) {
+    add_receivers(advertising_phys_);
+    return;
+  }
+
+  auto destination = routed_packet.GetDestinationAddress();
+  auto owners = address_owners_.find(destination);
+  if (destination == Address::kEmpty || owners == address_owners_.end()) {
+    add_receivers(phys_by_id_);
+    return;
+  }
+
+  add_receivers(promiscuous_phys_);
+  for (uint32_t id : owners->second) {
+    if (id != sender_id && promiscuous_phys_.count(id) == 0) {
+      receivers.push_back(phys_by_id_.at(id));
+    }
+  }
+  // Keep the registration order, as when delivering to every phy.
+  std::sort(receivers.begin(), receivers.end(),
+            [](auto const& a, auto const& b) {
+              return a->GetId() < b->GetId();
+            });
+}
+
 void PhyLayerFactory::UnregisterAllPhyLayers() {
   while (!phy_layers_.empty()) {
     if (phy_layers_.begin() != phy_layers_.end()) {
@@ -74,10 +234,33 @@ void PhyLayerFactory::Send(
 
 void PhyLayerFactory::Send(model::packets::LinkLayerPacketView packet,
                            uint32_t id, [[maybe_unused]] uint32_t device_id) {
-  for (const auto& phy : phy_layers_) {
-    if (id != phy->GetId()) {
-      phy->Receive(packet);
+  // Sent from a simulation shard: deliver at the end of the tick.
+  if (auto deferred = DeferredOperations::Current(); deferred != nullptr) {
+    deferred->Defer(
+        [this, packet, id, device_id] { Send(packet, id, device_id); });
+    return;
+  }
+
+  std::shared_ptr<PhyLayer> sender;
+  if (auto it = phys_by_id_.find(id); it != phys_by_id_.end()) {
+    sender = it->second;
+    LearnSourceAddress(id, packet.GetSourceAddress());
+  }
+
+  // Receivers may send packets or unregister from within Receive(),
+  // so work on a copy of the routing tables.
+  std::vector<std::shared_ptr<PhyLayer>> receivers;
+  GetReceivers(packet, id, receivers);
+
+  filtered_packets_ +=
+      phys_by_id_.size() - receivers.size() - (sender != nullptr ? 1 : 0);
+  for (const auto& phy : receivers) {
+    if (sender != nullptr && !InRange(*sender, *phy)) {
+      filtered_packets_++;
+      continue;
     }
+    delivered_packets_++;
+    phy->Receive(packet);
   }
 }
 
@@ -125,6 +308,11 @@ void PhyLayerImpl::Send(model::packets::LinkLayerPacketView packet) {
   factory_->Send(packet, GetId(), GetDeviceId());
 }
 
+void PhyLayerImpl::SetReceiveFilter(ReceiveFilter filter) {
+  PhyLayer::SetReceiveFilter(filter);
+  factory_->UpdateReceiveFilter(GetId());
+}
+
 void PhyLayerImpl::Unregister() { factory_->UnregisterPhyLayer(GetId()); }
 
 bool PhyLayerImpl::IsFactoryId(uint32_t id) {
@@ -16,16 +16,22 @@
 
 #pragma once
 
+#include <deque>
 #include <list>
+#include <map>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
+#include "hci/address.h"
 #include "include/phy.h"
 #include "packets/link_layer_packets.h"
 #include "phy_layer.h"
 
 namespace rootcanal {
 
+using ::bluetooth::hci::Address;
+
 class PhyLayerFactory {
   friend class PhyLayerImpl;
 
@@ -51,6 +57,16 @@ class PhyLayerFactory {
 
   virtual std::string ToString() const;
 
+  // Drop packets between devices further apart than |range| meters.
+  // Devices without a position are always in range; a range of zero (the
+  // default) disables the range model.
+  void SetRange(float range);
+
+  // Number of packets handed to phys and skipped by the routing since the
+  // factory was created.
+  uint64_t GetDeliveredPacketCount() const { return delivered_packets_; }
+  uint64_t GetFilteredPacketCount() const { return filtered_packets_; }
+
  protected:
   virtual void Send(
       std::shared_ptr<model::packets::LinkLayerPacketBuilder> packet,
@@ -58,12 +74,40 @@ class PhyLayerFactory {
   virtual void Send(
       model::packets::LinkLayerPacketView packet,
       uint32_t phy_id, uint32_t device_id);
+  // Refresh the routing tables after the receive filter of a phy changed.
+  void UpdateReceiveFilter(uint32_t phy_id);
   std::list<std::shared_ptr<PhyLayer>> phy_layers_;
 
  private:
+  // Select the phys that need to see |packet|, in registration order.
+  void GetReceivers(model::packets::LinkLayerPacketView packet,
+                    uint32_t sender_id,
+                    std::vector<std::shared_ptr<PhyLayer>>& receivers) const;
+  bool InRange(PhyLayer const& sender, PhyLayer const& receiver) const;
+  void LearnSourceAddress(uint32_t phy_id, Address const& address);
+  void ForgetSourceAddresses(uint32_t phy_id);
+
   Phy::Type phy_type_;
   uint32_t next_id_{1};
   const uint32_t factory_id_;
+  float range_{0};
+
+  // Registered phys, indexed by id.
+  std::map<uint32_t, std::shared_ptr<PhyLayer>> phys_by_id_;
+  // Phys receiving every packet (ReceiveFilter::ALL).
+  std::map<uint32_t, std::shared_ptr<PhyLayer>> promiscuous_phys_;
+  // Phys receiving LE advertising PDUs (ALL or ADDRESSED_AND_ADVERTISING).
+  std::map<uint32_t, std::shared_ptr<PhyLayer>> advertising_phys_;
+
+  // The addresses a device accepts unicast packets on are the ones it sends
+  // from: its public and random addresses, advertising addresses, RPAs...
+  // They are learnt from the source address of the packets each phy sends.
+  // Unicast packets to an address not seen yet go to every phy.
+  std::unordered_map<Address, std::vector<uint32_t>> address_owners_;
+  std::unordered_map<uint32_t, std::deque<Address>> source_addresses_;
+
+  uint64_t delivered_packets_{0};
+  uint64_t filtered_packets_{0};
 };
 
 class PhyLayerImpl : public PhyLayer {
@@ -78,6 +122,7 @@ class PhyLayerImpl : public PhyLayer {
       std::shared_ptr<model::packets::LinkLayerPacketBuilder> packet) override;
   void Send(model::packets::LinkLayerPacketView packet) override;
   void Receive(model::packets::LinkLayerPacketView packet) override;
+  void SetReceiveFilter(ReceiveFilter filter) override;
   void Unregister() override;
   bool IsFactoryId(uint32_t factory_id) override;
   void TimerTick() override;
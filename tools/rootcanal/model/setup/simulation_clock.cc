@@ -0,0 +1,93 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "model/setup/simulation_clock.h"
+
+#include "log.h"
+
+namespace rootcanal {
+
+using std::chrono::steady_clock;
+
+std::atomic<SimulationClock::duration::rep> SimulationClock::skipped_{0};
+std::atomic<bool> SimulationClock::virtual_time_{false};
+std::atomic<SimulationClock::duration::rep> SimulationClock::idle_threshold_{
+    kDefaultIdleThreshold.count()};
+std::atomic<SimulationClock::time_point::rep>
+    SimulationClock::last_host_activity_{0};
+std::atomic<SimulationClock::time_point::rep>
+    SimulationClock::statistics_start_{
+        steady_clock::now().time_since_epoch().count()};
+std::atomic<SimulationClock::duration::rep>
+    SimulationClock::statistics_skipped_{0};
+
+SimulationClock::time_point SimulationClock::now() {
+  return steady_clock::now() + duration(skipped_);
+}
+
+void SimulationClock::Advance(duration delta) {
+  if (delta > duration::zero()) {
+    skipped_ += delta.count();
+  }
+}
+
+void SimulationClock::AdvanceTo(time_point time) { Advance(time - now()); }
+
+SimulationClock::time_point SimulationClock::ToWallTime(time_point time) {
+  return time - duration(skipped_);
+}
+
+void SimulationClock::SetVirtualTime(bool enabled, duration idle_threshold) {
+  LOG_INFO("Virtual time %s, idle threshold %lld ms",
+           enabled ? "enabled" : "disabled",
+           static_cast<long long>(
+               std::chrono::duration_cast<std::chrono::milliseconds>(
+                   idle_threshold)
+                   .count()));
+  idle_threshold_ = idle_threshold.count();
+  virtual_time_ = enabled;
+}
+
+bool SimulationClock::IsVirtualTime() { return virtual_time_; }
+
+void SimulationClock::OnHostActivity() {
+  last_host_activity_ = steady_clock::now().time_since_epoch().count();
+}
+
+bool SimulationClock::CanSkipTime(time_point* idle_time) {
+  if (!virtual_time_) {
+    *idle_time = time_point::max();
+    return false;
+  }
+  *idle_time = time_point(duration(last_host_activity_)) +
+               duration(idle_threshold_);
+  return *idle_time <= steady_clock::now();
+}
+
+SimulationClock::duration SimulationClock::GetWallTime() {
+  return steady_clock::now() - time_point(duration(statistics_start_));
+}
+
+SimulationClock::duration SimulationClock::GetSimulatedTime() {
+  return GetWallTime() + duration(skipped_ - statistics_skipped_);
+}
+
+void SimulationClock::ResetStatistics() {
+  statistics_skipped_ = skipped_.load();
+  statistics_start_ = steady_clock::now().time_since_epoch().count();
+}
+
+}  // namespace rootcanal
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+namespace rootcanal {
+
+// Time of the simulation. It follows the steady clock, plus the time skipped
+// over: either explicitly with Advance(), or in virtual time mode, where the
+// task thread jumps to the next scheduled event instead of sleeping as long
+// as the hosts are idle.
+//
+// The model reads the time from this clock instead of the steady clock so
+// that timeouts, advertising intervals and the like are in simulation time.
+class SimulationClock {
+ public:
+  using duration = std::chrono::steady_clock::duration;
+  using time_point = std::chrono::steady_clock::time_point;
+
+  static time_point now();
+
+  // Move the simulation time forward without waiting.
+  static void Advance(duration delta);
+  static void AdvanceTo(time_point time);
+
+  // Steady clock time at which the simulation reaches |time|, unless time is
+  // skipped in the meantime.
+  static time_point ToWallTime(time_point time);
+
+  // Turn the virtual time mode on or off. The hosts are idle when no data
+  // was received from them for |idle_threshold| of wall clock time.
+  static void SetVirtualTime(bool enabled,
+                             duration idle_threshold = kDefaultIdleThreshold);
+  static bool IsVirtualTime();
+
+  // Data was received from a host (HCI, test channel, link layer socket).
+  static void OnHostActivity();
+
+  // Whether time can be skipped in virtual time mode. If not, |idle_time| is
+  // set to the steady clock time at which the hosts will be idle, or to
+  // time_point::max() when virtual time is disabled.
+  static bool CanSkipTime(time_point* idle_time);
+
+  // Simulation and wall clock time elapsed since the clock was last reset.
+  static duration GetSimulatedTime();
+  static duration GetWallTime();
+  static void ResetStatistics();
+
+  static constexpr duration kDefaultIdleThreshold =
+      std::chrono::milliseconds(100);
+
+ private:
+  static std::atomic<duration::rep> skipped_;
+  static std::atomic<bool> virtual_time_;
+  static std::atomic<duration::rep> idle_threshold_;
+  static std::atomic<time_point::rep> last_host_activity_;
+  static std::atomic<time_point::rep> statistics_start_;
+  static std::atomic<duration::rep> statistics_skipped_;
+};
+
+}  // namespace rootcanal
@@ -0,0 +1,52 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "model/setup/simulation_worker_pool.h"
+
+#include <utility>
+
+namespace rootcanal {
+
+static thread_local DeferredOperations* current_deferred_operations = nullptr;
+
+DeferredOperations::Scope::Scope(DeferredOperations& operations)
+    : previous_(current_deferred_operations) {
+  current_deferred_operations = &operations;
+}
+
+DeferredOperations::Scope::~Scope() {
+  current_deferred_operations = previous_;
+}
+
+DeferredOperations* DeferredOperations::Current() {
+  return current_deferred_operations;
+}
+
+void DeferredOperations::Defer(std::function<void()> operation) {
+  operations_.push_back(std::move(operation));
+}
+
+void DeferredOperations::Run() {
+  // Operations may defer more operations if a scope is active on this
+  // thread, take them out first.
+  std::vector<std::function<void()>> operations;
+  operations.swap(operations_);
+  for (auto& operation : operations) {
+    operation();
+  }
+}
+
+}  // namespace rootcanal
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "common/worker_pool.h"
+
+namespace rootcanal {
+
+// Threads ticking the shards of a simulation. The calling thread takes part
+// in the work, and RunAndWait() only returns once every shard is done, which
+// makes it the tick boundary.
+using SimulationWorkerPool = bluetooth::common::WorkerPool;
+
+// Operations on state shared between devices (the phys, the task queue),
+// recorded while a shard of devices ticks on a worker thread. The model
+// runs the operations of every shard in shard order once the tick is over,
+// so the outcome of a tick does not depend on how the shards were scheduled.
+class DeferredOperations {
+ public:
+  // Record the operations deferred from the calling thread while in scope.
+  class Scope {
+   public:
+    explicit Scope(DeferredOperations& operations);
+    ~Scope();
+
+   private:
+    DeferredOperations* previous_;
+  };
+
+  // The operations recorded for the calling thread, or nullptr when shared
+  // state can be used directly.
+  static DeferredOperations* Current();
+
+  void Defer(std::function<void()> operation);
+
+  // Run the recorded operations in the order they were deferred, and forget
+  // them.
+  void Run();
+
+  bool IsEmpty() const { return operations_.empty(); }
+
+ private:
+  std::vector<std::function<void()>> operations_;
+};
+
+}  // namespace rootcanal
@@ -24,6 +24,7 @@
 
 #include "device_boutique.h"
 #include "log.h"
+#include "model/setup/simulation_clock.h"
 #include "phy.h"
 
 using std::vector;
@@ -45,9 +46,15 @@ TestCommandHandler::TestCommandHandler(TestModel& test_model)
   SET_HANDLER("del_device_from_phy", DelDeviceFromPhy);
   SET_HANDLER("list", List);
   SET_HANDLER("set_device_address", SetDeviceAddress);
+  SET_HANDLER("set_device_position", SetDevicePosition);
+  SET_HANDLER("set_phy_range", SetPhyRange);
   SET_HANDLER("set_timer_period", SetTimerPeriod);
   SET_HANDLER("start_timer", StartTimer);
   SET_HANDLER("stop_timer", StopTimer);
+  SET_HANDLER("set_simulation_threads", SetSimulationThreads);
+  SET_HANDLER("set_virtual_time", SetVirtualTime);
+  SET_HANDLER("advance_time", AdvanceTime);
+  SET_HANDLER("get_time", GetTime);
   SET_HANDLER("reset", Reset);
 #undef SET_HANDLER
 }
@@ -261,6 +268,40 @@ void TestCommandHandler::SetDeviceAddress(const vector<std::string>& args) {
   send_response_(response_string_);
 }
 
+void TestCommandHandler::SetDevicePosition(const vector<std::string>& args) {
+  if (args.size() != 3 && args.size() != 4) {
+    response_string_ =
+        "TestCommandHandler 'set_device_position' takes three or four "
+        "arguments";
+    send_response_(response_string_);
+    return;
+  }
+  size_t device_id = std::stoi(args[0]);
+  PhyLayer::Position position{
+      .x = std::stof(args[1]),
+      .y = std::stof(args[2]),
+      .z = args.size() == 4 ? std::stof(args[3]) : 0.f,
+  };
+  model_.SetDevicePosition(device_id, position);
+  response_string_ = "set_device_position " + args[0];
+  for (size_t i = 1; i < args.size(); i++) {
+    response_string_ += " " + args[i];
+  }
+  send_response_(response_string_);
+}
+
+void TestCommandHandler::SetPhyRange(const vector<std::string>& args) {
+  if (args.size() != 2) {
+    response_string_ = "TestCommandHandler 'set_phy_range' takes two arguments";
+    send_response_(response_string_);
+    return;
+  }
+  size_t phy_index = std::stoi(args[0]);
+  model_.SetPhyRange(phy_index, std::stof(args[1]));
+  response_string_ = "set_phy_range " + args[0] + " " + args[1];
+  send_response_(response_string_);
+}
+
 void TestCommandHandler::SetTimerPeriod(const vector<std::string>& args) {
   if (args.size() != 1) {
     LOG_INFO("SetTimerPeriod takes 1 argument");
@@ -295,6 +336,71 @@ void TestCommandHandler::StopTimer(const vector<std::string>& args) {
   send_response_(response_string_);
 }
 
+void TestCommandHandler::SetSimulationThreads(
+    const vector<std::string>& args) {
+  if (args.size() != 1) {
+    response_string_ =
+        "TestCommandHandler 'set_simulation_threads' takes one argument";
+    send_response_(response_string_);
+    return;
+  }
+  int num_threads = std::stoi(args[0]);
+  if (num_threads < 0) {
+    response_string_ = "invalid number of threads " + args[0];
+    send_response_(response_string_);
+    return;
+  }
+  model_.SetSimulationThreads(num_threads);
+  response_string_ = "set_simulation_threads " + args[0];
+  send_response_(response_string_);
+}
+
+void TestCommandHandler::SetVirtualTime(const vector<std::string>& args) {
+  if (args.empty() || args.size() > 2 ||
+      (args[0] != "on" && args[0] != "off")) {
+    response_string_ =
+        "TestCommandHandler 'set_virtual_time' takes on|off and an optional "
+        "idle threshold in milliseconds";
+    send_response_(response_string_);
+    return;
+  }
+  std::chrono::milliseconds idle_threshold =
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+          SimulationClock::kDefaultIdleThreshold);
+  if (args.size() == 2) {
+    idle_threshold = std::chrono::milliseconds(std::stoi(args[1]));
+  }
+  model_.SetVirtualTime(args[0] == "on", idle_threshold);
+  response_string_ = "set_virtual_time " + args[0] + " " +
+                     std::to_string(idle_threshold.count());
+  send_response_(response_string_);
+}
+
+void TestCommandHandler::AdvanceTime(const vector<std::string>& args) {
+  if (args.size() != 1) {
+    response_string_ = "TestCommandHandler 'advance_time' takes one argument";
+    send_response_(response_string_);
+    return;
+  }
+  int duration = std::stoi(args[0]);
+  if (duration <= 0) {
+    response_string_ = "invalid duration " + args[0];
+    send_response_(response_string_);
+    return;
+  }
+  model_.AdvanceTime(std::chrono::milliseconds(duration));
+  response_string_ = "advance_time " + args[0];
+  send_response_(response_string_);
+}
+
+void TestCommandHandler::GetTime(const vector<std::string>& args) {
+  if (args.size() > 0) {
+    LOG_INFO("Unused args: arg[0] = %s", args[0].c_str());
+  }
+  response_string_ = model_.GetTimeStatistics();
+  send_response_(response_string_);
+}
+
 void TestCommandHandler::Reset(const std::vector<std::string>& args) {
   if (args.size() > 0) {
     LOG_INFO("Unused args: arg[0] = %s", args[0].c_str());
@@ -78,6 +78,12 @@ class TestCommandHandler {
   // Change the device's MAC address
   void SetDeviceAddress(const std::vector<std::string>& args);
 
+  // Place the device at a position, in meters
+  void SetDevicePosition(const std::vector<std::string>& args);
+
+  // Limit the range of a phy, in meters
+  void SetPhyRange(const std::vector<std::string>& args);
+
   // Timer management functions
   void SetTimerPeriod(const std::vector<std::string>& args);
 
@@ -85,6 +91,16 @@ class TestCommandHandler {
 
   void StopTimer(const std::vector<std::string>& args);
 
+  // Tick the devices on several threads
+  void SetSimulationThreads(const std::vector<std::string>& args);
+
+  // Virtual time management functions
+  void SetVirtualTime(const std::vector<std::string>& args);
+
+  void AdvanceTime(const std::vector<std::string>& args);
+
+  void GetTime(const std::vector<std::string>& args);
+
   void Reset(const std::vector<std::string>& args);
 
   // For manual testing
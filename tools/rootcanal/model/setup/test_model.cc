@@ -18,17 +18,25 @@
 
 #include <stdlib.h>  // for size_t
 
+#include <algorithm>    // for min
 #include <iomanip>      // for operator<<, setfill
 #include <iostream>     // for basic_ostream
+#include <limits>       // for numeric_limits
 #include <memory>       // for shared_ptr, make...
+#include <sstream>      // for stringstream
 #include <type_traits>  // for remove_extent_t
 #include <utility>      // for move
 
-#include "include/phy.h"  // for Phy, Phy::Type
-#include "log.h"          // for LOG_WARN, LOG_INFO
+#include "include/phy.h"                   // for Phy, Phy::Type
+#include "log.h"                           // for LOG_WARN, LOG_INFO
+#include "model/setup/simulation_clock.h"  // for SimulationClock
 
 namespace rootcanal {
 
+// Devices are split in more shards than there are threads so that a few
+// busy devices don't keep a single thread behind the others.
+static constexpr size_t kShardsPerThread = 4;
+
 TestModel::TestModel(
     std::function<AsyncUserId()> get_user_id,
     std::function<AsyncTaskId(AsyncUserId, std::chrono::milliseconds,
@@ -201,11 +209,14 @@ size_t TestModel::AddHciConnection(std::shared_ptr<HciDevice> dev) {
   }
 
   AsyncUserId user_id = get_user_id_();
-  dev->RegisterTaskScheduler([user_id, this](std::chrono::milliseconds delay,
-                                             TaskCallback task_callback) {
-    return schedule_task_(user_id, delay, std::move(task_callback));
+  auto tasks = std::make_shared<DeviceTasks>();
+  dev->RegisterTaskScheduler([user_id, tasks, this](
+                                 std::chrono::milliseconds delay,
+                                 TaskCallback task_callback) {
+    return ScheduleDeviceTask(user_id, tasks, delay, std::move(task_callback));
   });
-  dev->RegisterTaskCancel(cancel_task_);
+  dev->RegisterTaskCancel(
+      [tasks, this](AsyncTaskId task_id) { CancelDeviceTask(*tasks, task_id); });
   dev->RegisterCloseCallback([this, index, user_id] {
     schedule_task_(
         user_id, std::chrono::milliseconds(0),
@@ -233,6 +244,22 @@ void TestModel::SetDeviceAddress(size_t index, Address address) {
   devices_[index]->SetAddress(std::move(address));
 }
 
+void TestModel::SetDevicePosition(size_t index, PhyLayer::Position position) {
+  if (index >= devices_.size() || devices_[index] == nullptr) {
+    LOG_WARN("Can't find device %zu", index);
+    return;
+  }
+  devices_[index]->SetPosition(position);
+}
+
+void TestModel::SetPhyRange(size_t phy_index, float range) {
+  if (phy_index >= phys_.size()) {
+    LOG_WARN("Can't find phy %zu", phy_index);
+    return;
+  }
+  phys_[phy_index]->SetRange(range);
+}
+
 const std::string& TestModel::List() {
   list_string_ = "";
   list_string_ += " Devices: \r\n";
@@ -253,10 +280,148 @@ const std::string& TestModel::List() {
 }
 
 void TestModel::TimerTick() {
-  for (size_t i = 0; i < devices_.size(); i++) {
-    if (devices_[i] != nullptr) {
-      devices_[i]->TimerTick();
+  if (simulation_pool_ == nullptr) {
+    for (size_t i = 0; i < devices_.size(); i++) {
+      if (devices_[i] != nullptr) {
+        devices_[i]->TimerTick();
+      }
+    }
+    return;
+  }
+
+  // Shards are contiguous ranges of devices and their deferred operations
+  // run in shard order, so the outcome of the tick is the same for any
+  // number of threads.
+  size_t num_shards =
+      std::min(devices_.size(),
+               kShardsPerThread * (simulation_pool_->GetNumWorkers() + 1));
+  shard_operations_.resize(num_shards);
+  simulation_pool_->RunAndWait(num_shards, [this, num_shards](size_t shard) {
+    DeferredOperations::Scope scope(shard_operations_[shard]);
+    size_t end = devices_.size() * (shard + 1) / num_shards;
+    for (size_t i = devices_.size() * shard / num_shards; i < end; i++) {
+      if (devices_[i] != nullptr) {
+        devices_[i]->TimerTick();
+      }
     }
+  });
+
+  for (auto& operations : shard_operations_) {
+    operations.Run();
+  }
+}
+
+void TestModel::SetSimulationThreads(size_t num_threads) {
+  schedule_task_(model_user_id_, std::chrono::milliseconds(0),
+                 [this, num_threads]() {
+                   LOG_INFO("Ticking devices on %zu thread(s)",
+                            std::max<size_t>(num_threads, 1));
+                   simulation_pool_.reset();
+                   if (num_threads > 1) {
+                     simulation_pool_ = std::make_unique<SimulationWorkerPool>(
+                         num_threads - 1);
+                   }
+                 });
+}
+
+void TestModel::SetVirtualTime(bool enabled,
+                               std::chrono::milliseconds idle_threshold) {
+  SimulationClock::SetVirtualTime(enabled, idle_threshold);
+  SimulationClock::ResetStatistics();
+}
+
+void TestModel::AdvanceTime(std::chrono::milliseconds duration) {
+  LOG_INFO("Advancing time by %lld ms",
+           static_cast<long long>(duration.count()));
+  SimulationClock::Advance(duration);
+}
+
+std::string TestModel::GetTimeStatistics() const {
+  using std::chrono::duration_cast;
+  using std::chrono::milliseconds;
+  auto simulated =
+      duration_cast<milliseconds>(SimulationClock::GetSimulatedTime());
+  auto wall = duration_cast<milliseconds>(SimulationClock::GetWallTime());
+  std::stringstream statistics;
+  statistics << "simulated " << simulated.count() << " ms in " << wall.count()
+             << " ms";
+  if (wall.count() > 0) {
+    statistics << " (" << std::fixed << std::setprecision(1)
+               << static_cast<double>(simulated.count()) / wall.count()
+               << "x)";
+  }
+  statistics << (SimulationClock::IsVirtualTime() ? ", virtual time"
+                                                  : ", real time");
+  return statistics.str();
+}
+
+AsyncTaskId TestModel::ScheduleDeviceTask(AsyncUserId user_id,
+                                          std::shared_ptr<DeviceTasks> tasks,
+                                          std::chrono::milliseconds delay,
+                                          TaskCallback task_callback) {
+  std::lock_guard<std::mutex> lock(tasks->mutex);
+  if (tasks->queued.size() == std::numeric_limits<AsyncTaskId>::max()) {
+    LOG_WARN("Too many tasks scheduled by user %u",
+             static_cast<unsigned>(user_id));
+    return kInvalidTaskId;
+  }
+  AsyncTaskId task_id = tasks->last_task_id;
+  do {
+    task_id = task_id == std::numeric_limits<AsyncTaskId>::max()
+                  ? kInvalidTaskId + 1
+                  : task_id + 1;
+  } while (tasks->queued.count(task_id) != 0);
+  tasks->last_task_id = task_id;
+
+  TaskCallback callback = [tasks, task_id,
+                           task_callback = std::move(task_callback)]() {
+    {
+      std::lock_guard<std::mutex> lock(tasks->mutex);
+      tasks->queued.erase(task_id);
+    }
+    task_callback();
+  };
+
+  // Tasks scheduled from a simulation shard are queued at the end of the
+  // tick, in device order rather than in the order the threads happened to
+  // run. The queue orders tasks due at the same time by their queue id, so
+  // the ids must not be taken from the worker threads either.
+  if (auto deferred = DeferredOperations::Current(); deferred != nullptr) {
+    tasks->queued[task_id] = kInvalidTaskId;
+    deferred->Defer([this, user_id, tasks, task_id, delay,
+                     callback = std::move(callback)] {
+      std::lock_guard<std::mutex> lock(tasks->mutex);
+      auto queued = tasks->queued.find(task_id);
+      // Unless the task was cancelled during the tick
+      if (queued != tasks->queued.end()) {
+        queued->second = schedule_task_(user_id, delay, callback);
+      }
+    });
+    return task_id;
+  }
+
+  AsyncTaskId queued_id = schedule_task_(user_id, delay, std::move(callback));
+  if (queued_id == kInvalidTaskId) {
+    return kInvalidTaskId;
+  }
+  tasks->queued[task_id] = queued_id;
+  return task_id;
+}
+
+void TestModel::CancelDeviceTask(DeviceTasks& tasks, AsyncTaskId task_id) {
+  AsyncTaskId queued_id;
+  {
+    std::lock_guard<std::mutex> lock(tasks.mutex);
+    auto queued = tasks.queued.find(task_id);
+    if (queued == tasks.queued.end()) {
+      return;
+    }
+    queued_id = queued->second;
+    tasks.queued.erase(queued);
+  }
+  // Cancelling waits for the task if it is running, which takes the lock.
+  if (queued_id != kInvalidTaskId) {
+    cancel_task_(queued_id);
   }
 }
 
@@ -20,13 +20,16 @@
 
 #include <chrono>      // for milliseconds
 #include <functional>  // for function
+#include <map>         // for map
 #include <memory>      // for shared_ptr
+#include <mutex>       // for mutex
 #include <string>      // for string
 #include <vector>      // for vector
 
 #include "hci/address.h"                       // for Address
 #include "model/devices/hci_device.h"          // for HciDevice
 #include "model/setup/async_manager.h"         // for AsyncUserId, AsyncTaskId
+#include "model/setup/simulation_worker_pool.h"  // for SimulationWorkerPool
 #include "phy.h"                               // for Phy, Phy::Type
 #include "phy_layer_factory.h"                 // for PhyLayerFactory
 
@@ -93,12 +96,35 @@ class TestModel {
   // Set the device's Bluetooth address
   void SetDeviceAddress(size_t device_index, Address device_address);
 
+  // Set the device's position, used by phys with a limited range
+  void SetDevicePosition(size_t device_index, PhyLayer::Position position);
+
+  // Drop packets between devices further apart than |range| meters
+  void SetPhyRange(size_t phy_index, float range);
+
   // Let devices know about the passage of time
   void TimerTick();
   void StartTimer();
   void StopTimer();
   void SetTimerPeriod(std::chrono::milliseconds new_period);
 
+  // Tick the devices on |num_threads| threads. Packets sent and tasks
+  // scheduled by the devices during a multi-threaded tick are exchanged at
+  // the end of the tick, in device order, so the simulation stays
+  // reproducible. Zero or one thread (the default) ticks the devices one
+  // after the other and delivers packets immediately.
+  void SetSimulationThreads(size_t num_threads);
+
+  // Skip ahead to the next scheduled event instead of waiting for it while
+  // no data is received from the hosts for |idle_threshold|.
+  void SetVirtualTime(bool enabled, std::chrono::milliseconds idle_threshold);
+
+  // Move the simulation time forward without waiting
+  void AdvanceTime(std::chrono::milliseconds duration);
+
+  // Report the simulated time, the wall clock time, and their ratio
+  std::string GetTimeStatistics() const;
+
   // List the devices that the test knows about
   const std::string& List();
 
@@ -106,6 +132,23 @@ class TestModel {
   void Reset();
 
  private:
+  // Tasks scheduled by one device. The device gets its own task ids, so that
+  // the tasks it schedules during a multi-threaded tick can be queued at the
+  // end of the tick and still be cancelled before.
+  struct DeviceTasks {
+    std::mutex mutex;
+    AsyncTaskId last_task_id{kInvalidTaskId};
+    // Id of each task in the task queue, kInvalidTaskId until the end of the
+    // tick for the tasks scheduled from a simulation shard.
+    std::map<AsyncTaskId, AsyncTaskId> queued;
+  };
+
+  AsyncTaskId ScheduleDeviceTask(AsyncUserId user_id,
+                                 std::shared_ptr<DeviceTasks> tasks,
+                                 std::chrono::milliseconds delay,
+                                 TaskCallback task_callback);
+  void CancelDeviceTask(DeviceTasks& tasks, AsyncTaskId task_id);
+
   std::vector<std::unique_ptr<PhyLayerFactory>> phys_;
   std::vector<std::shared_ptr<Device>> devices_;
   std::string list_string_;
@@ -130,6 +173,10 @@ class TestModel {
   AsyncUserId model_user_id_;
   AsyncTaskId timer_tick_task_{kInvalidTaskId};
   std::chrono::milliseconds timer_period_{};
+
+  // Workers and per shard deferred operations of multi-threaded ticks.
+  std::unique_ptr<SimulationWorkerPool> simulation_pool_;
+  std::vector<DeferredOperations> shard_operations_;
 };
 
 }  // namespace rootcanal
@@ -214,6 +214,18 @@ class TestChannelShell(cmd.Cmd):
     """
         self._test_channel.send_command('set_device_address', args.split())
 
+    def do_set_device_position(self, args):
+        """Arguments: dev_num x y [z] Place device dev_num at (x, y, z), in meters.
+
+    """
+        self._test_channel.send_command('set_device_position', args.split())
+
+    def do_set_phy_range(self, args):
+        """Arguments: phy_num range Drop packets on phy phy_num between devices more than range meters apart.
+
+    """
+        self._test_channel.send_command('set_phy_range', args.split())
+
     def do_list(self, args):
         """Arguments: [dev_num [attr]] List the devices from the controller, optionally filtered by device and attr.
 
@@ -235,6 +247,26 @@ class TestChannelShell(cmd.Cmd):
     """
         self._test_channel.send_command('stop_timer', args.split())
 
+    def do_set_simulation_threads(self, args):
+        """Arguments: num_threads Tick the devices on num_threads threads, packets are exchanged at the end of each tick.
+    """
+        self._test_channel.send_command('set_simulation_threads', args.split())
+
+    def do_set_virtual_time(self, args):
+        """Arguments: on|off [idle_ms] Skip to the next simulation event instead of waiting for it when the hosts have been idle for idle_ms.
+    """
+        self._test_channel.send_command('set_virtual_time', args.split())
+
+    def do_advance_time(self, args):
+        """Arguments: time_ms Move the simulation time forward by time_ms milliseconds.
+    """
+        self._test_channel.send_command('advance_time', args.split())
+
+    def do_get_time(self, args):
+        """Arguments: None. Report the simulated and wall clock time elapsed.
+    """
+        self._test_channel.send_command('get_time', args.split())
+
     def do_wait(self, args):
         """Arguments: time in seconds (float).
     """
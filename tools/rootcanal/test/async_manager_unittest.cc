@@ -35,6 +35,8 @@
 #include <thread>
 #include <tuple>  // for tuple
 
+#include "model/setup/simulation_clock.h"  // for SimulationClock
+
 namespace rootcanal {
 
 class Event {
@@ -489,4 +491,50 @@ TEST_F(AsyncManagerTest, TestCancelAsyncTasksFromUser) {
   ASSERT_FALSE(async_manager_.CancelAsyncTask(task5_id));
 }
 
+TEST_F(AsyncManagerTest, TestVirtualTimeSkipsToNextTask) {
+  AsyncUserId user = async_manager_.GetNextUserId();
+  Event task_ran;
+  auto wall_start = std::chrono::steady_clock::now();
+  auto simulation_start = SimulationClock::now();
+
+  SimulationClock::SetVirtualTime(true, std::chrono::milliseconds(1));
+  async_manager_.ExecAsync(user, std::chrono::seconds(60),
+                           [&task_ran]() { task_ran.set(); });
+  ASSERT_TRUE(task_ran.wait_for(std::chrono::seconds(5)));
+  SimulationClock::SetVirtualTime(false);
+
+  ASSERT_LT(std::chrono::steady_clock::now() - wall_start,
+            std::chrono::seconds(5));
+  ASSERT_GE(SimulationClock::now() - simulation_start,
+            std::chrono::seconds(60));
+}
+
+TEST_F(AsyncManagerTest, TestVirtualTimeWaitsForIdleHosts) {
+  AsyncUserId user = async_manager_.GetNextUserId();
+  Event task_ran;
+
+  SimulationClock::OnHostActivity();
+  SimulationClock::SetVirtualTime(true, std::chrono::seconds(10));
+  async_manager_.ExecAsync(user, std::chrono::seconds(60),
+                           [&task_ran]() { task_ran.set(); });
+  ASSERT_FALSE(task_ran.wait_for(std::chrono::milliseconds(100)));
+  SimulationClock::SetVirtualTime(false);
+  async_manager_.CancelAsyncTasksFromUser(user);
+}
+
+TEST_F(AsyncManagerTest, TestAdvanceTimeRunsDueTasks) {
+  AsyncUserId user = async_manager_.GetNextUserId();
+  Event task_ran;
+
+  async_manager_.ExecAsync(user, std::chrono::seconds(60),
+                           [&task_ran]() { task_ran.set(); });
+  ASSERT_FALSE(task_ran.wait_for(std::chrono::milliseconds(50)));
+
+  // Advance from the task thread, like the test channel does.
+  async_manager_.ExecAsync(user, std::chrono::milliseconds(0), []() {
+    SimulationClock::Advance(std::chrono::seconds(60));
+  });
+  ASSERT_TRUE(task_ran.wait_for(std::chrono::seconds(5)));
+}
+
 }  // namespace rootcanal
@@ -0,0 +1,188 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "model/devices/beacon_crowd.h"
+
+#include <gtest/gtest.h>
+
+#include <map>
+
+#include "hci/hci_packets.h"
+#include "model/controller/link_layer_controller.h"
+#include "model/setup/phy_layer_factory.h"
+#include "packet/bit_inserter.h"
+
+namespace rootcanal {
+
+using namespace model::packets;
+using namespace std::chrono_literals;
+
+class BeaconCrowdTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    scanner_ = factory_.GetPhyLayer(
+        [this](LinkLayerPacketView packet) { received_.push_back(packet); },
+        0);
+  }
+
+  std::shared_ptr<BeaconCrowd> AddCrowd(std::vector<std::string> args) {
+    auto crowd = std::make_shared<BeaconCrowd>(args);
+    crowd->RegisterPhyLayer(factory_.GetPhyLayer(
+        [crowd](LinkLayerPacketView packet) { crowd->IncomingPacket(packet); },
+        1));
+    return crowd;
+  }
+
+  PhyLayerFactory factory_{Phy::Type::LOW_ENERGY, 0};
+  std::shared_ptr<PhyLayer> scanner_;
+  std::vector<LinkLayerPacketView> received_;
+};
+
+TEST_F(BeaconCrowdTest, EveryBeaconAdvertisesOncePerInterval) {
+  auto crowd = AddCrowd({"beacon_crowd", "c0:00:00:00:00:00", "1000", "100"});
+  ASSERT_EQ(crowd->GetNumBeacons(), 1000u);
+
+  // The first advertising events are spread over the first interval.
+  for (int i = 0; i < 10; i++) {
+    crowd->TimerTick();
+    SimulationClock::Advance(10ms);
+  }
+  crowd->TimerTick();
+
+  std::map<Address, int> advertising_events;
+  for (auto const& packet : received_) {
+    ASSERT_EQ(packet.GetType(), PacketType::LE_LEGACY_ADVERTISING_PDU);
+    advertising_events[packet.GetSourceAddress()]++;
+  }
+  EXPECT_EQ(advertising_events.size(), 1000u);
+  for (auto const& [address, count] : advertising_events) {
+    // The beacons starting first may have started the next interval.
+    EXPECT_LE(count, 2) << address;
+  }
+  EXPECT_EQ(crowd->GetAdvertisingCount(), received_.size());
+}
+
+TEST_F(BeaconCrowdTest, ExtendedAdvertising) {
+  auto crowd = AddCrowd({"beacon_crowd", "c0:00:00:00:00:00", "100", "20",
+                         "extended=100", "data=600"});
+  SimulationClock::Advance(20ms);
+  crowd->TimerTick();
+
+  ASSERT_EQ(received_.size(), 100u);
+  for (auto const& packet : received_) {
+    ASSERT_EQ(packet.GetType(), PacketType::LE_EXTENDED_ADVERTISING_PDU);
+  }
+}
+
+TEST_F(BeaconCrowdTest, LongExtendedAdvertisingDataIsSplitOverReports) {
+  using namespace bluetooth::hci;
+
+  std::vector<LeExtendedAdvertisingResponseRaw> reports;
+  ControllerProperties properties;
+  LinkLayerController scanner(Address::kEmpty, properties);
+  scanner.RegisterEventChannel([&reports](std::shared_ptr<EventBuilder> event) {
+    auto bytes = std::make_shared<std::vector<uint8_t>>();
+    bluetooth::packet::BitInserter inserter(*bytes);
+    event->Serialize(inserter);
+    auto report = LeExtendedAdvertisingReportRawView::Create(
+        LeMetaEventView::Create(
+            EventView::Create(bluetooth::packet::PacketView<
+                              bluetooth::packet::kLittleEndian>(bytes))));
+    ASSERT_TRUE(report.IsValid());
+    for (auto const& response : report.GetResponses()) {
+      reports.push_back(response);
+    }
+  });
+  scanner.RegisterRemoteChannel(
+      [](std::shared_ptr<LinkLayerPacketBuilder>, Phy::Type) {});
+  scanner.SetEventMask(UINT64_C(1)
+                       << (static_cast<uint8_t>(EventCode::LE_META_EVENT) - 1));
+  scanner.SetLeEventMask(
+      UINT64_C(1)
+      << (static_cast<uint8_t>(SubeventCode::EXTENDED_ADVERTISING_REPORT) - 1));
+
+  PhyScanParameters parameters;
+  parameters.le_scan_type_ = LeScanType::PASSIVE;
+  parameters.le_scan_interval_ = 0x4;
+  parameters.le_scan_window_ = 0x4;
+  ASSERT_EQ(ErrorCode::SUCCESS,
+            scanner.LeSetExtendedScanParameters(
+                OwnAddressType::PUBLIC_DEVICE_ADDRESS,
+                LeScanningFilterPolicy::ACCEPT_ALL, 0x1, {parameters}));
+  ASSERT_EQ(ErrorCode::SUCCESS, scanner.LeSetExtendedScanEnable(
+                                    true, FilterDuplicates::DISABLED, 0, 0));
+
+  auto crowd = AddCrowd({"beacon_crowd", "c0:00:00:00:00:00", "1", "20",
+                         "extended=100", "data=600"});
+  SimulationClock::Advance(20ms);
+  crowd->TimerTick();
+  ASSERT_EQ(received_.size(), 1u);
+  scanner.IncomingPacket(received_[0]);
+
+  // An event carries at most 229 bytes of advertising data.
+  ASSERT_EQ(reports.size(), 3u);
+  EXPECT_EQ(reports[0].data_status_, DataStatus::CONTINUING);
+  EXPECT_EQ(reports[0].advertising_data_.size(), 229u);
+  EXPECT_EQ(reports[1].data_status_, DataStatus::CONTINUING);
+  EXPECT_EQ(reports[1].advertising_data_.size(), 229u);
+  EXPECT_EQ(reports[2].data_status_, DataStatus::COMPLETE);
+  EXPECT_EQ(reports[2].advertising_data_.size(), 142u);
+
+  Address beacon = crowd->GetBeaconAddress(0, SimulationClock::now());
+  std::vector<uint8_t> data;
+  for (auto const& report : reports) {
+    EXPECT_EQ(report.address_, beacon);
+    data.insert(data.end(), report.advertising_data_.begin(),
+                report.advertising_data_.end());
+  }
+  EXPECT_EQ(data, LeExtendedAdvertisingPduView::Create(received_[0])
+                      .GetAdvertisingData());
+}
+
+TEST_F(BeaconCrowdTest, InvalidArgumentsAreIgnored) {
+  auto crowd = AddCrowd({"beacon_crowd", "not an address", "many", "-5",
+                         "extended=all", "data", "scannable=1x"});
+  EXPECT_EQ(crowd->GetNumBeacons(), 1u);
+
+  SimulationClock::Advance(1280ms);
+  crowd->TimerTick();
+  ASSERT_EQ(received_.size(), 1u);
+  EXPECT_EQ(received_[0].GetType(), PacketType::LE_LEGACY_ADVERTISING_PDU);
+}
+
+TEST_F(BeaconCrowdTest, ScanResponse) {
+  auto crowd = AddCrowd({"beacon_crowd", "c0:00:00:00:00:00", "16", "20",
+                         "scannable=100", "rpa_rotation=900"});
+  Address beacon = crowd->GetBeaconAddress(5, SimulationClock::now());
+  EXPECT_EQ(beacon.address[5] & 0xc0, 0x40);
+
+  scanner_->Send(LeScanBuilder::Create(Address::kEmpty, beacon,
+                                       AddressType::PUBLIC,
+                                       AddressType::RANDOM));
+  ASSERT_EQ(received_.size(), 1u);
+  EXPECT_EQ(received_[0].GetType(), PacketType::LE_SCAN_RESPONSE);
+  EXPECT_EQ(received_[0].GetSourceAddress(), beacon);
+
+  // Addresses from a past rotation period are not answered.
+  SimulationClock::Advance(900s);
+  scanner_->Send(LeScanBuilder::Create(Address::kEmpty, beacon,
+                                       AddressType::PUBLIC,
+                                       AddressType::RANDOM));
+  EXPECT_EQ(received_.size(), 1u);
+  EXPECT_EQ(crowd->GetScanResponseCount(), 1u);
+}
+
+}  // namespace rootcanal
@@ -0,0 +1,152 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "model/controller/link_layer_controller.h"
+#include "test_helpers.h"
+
+namespace rootcanal {
+
+using namespace bluetooth::hci;
+
+class LeAddressResolutionCacheTest : public ::testing::Test {
+ public:
+  LeAddressResolutionCacheTest() = default;
+  ~LeAddressResolutionCacheTest() override = default;
+
+ protected:
+  Address address_{0};
+  ControllerProperties properties_{};
+  LinkLayerController controller_{address_, properties_};
+
+  AddressWithType const identity_{Address{{1, 2, 3, 4, 5, 6}},
+                                  AddressType::PUBLIC_DEVICE_ADDRESS};
+  AddressWithType const resolved_identity_{
+      identity_.GetAddress(), AddressType::PUBLIC_IDENTITY_ADDRESS};
+  std::array<uint8_t, 16> const peer_irk_{1};
+  std::array<uint8_t, 16> const local_irk_{2};
+};
+
+TEST_F(LeAddressResolutionCacheTest, ResolvesFromCache) {
+  ASSERT_EQ(controller_.LeAddDeviceToResolvingList(
+                PeerAddressType::PUBLIC_DEVICE_OR_IDENTITY_ADDRESS,
+                identity_.GetAddress(), peer_irk_, local_irk_),
+            ErrorCode::SUCCESS);
+  ASSERT_EQ(controller_.LeSetAddressResolutionEnable(true), ErrorCode::SUCCESS);
+
+  auto rpa = controller_.GenerateResolvablePrivateAddress(
+      identity_, LinkLayerController::IrkSelection::Peer);
+  ASSERT_TRUE(rpa.has_value());
+
+  for (int i = 0; i < 3; i++) {
+    ASSERT_EQ(controller_.ResolvePrivateAddress(
+                  rpa.value(), LinkLayerController::IrkSelection::Peer),
+              resolved_identity_);
+  }
+
+  auto const& stats = controller_.GetAddressResolutionStats();
+  EXPECT_EQ(stats.resolutions, 3u);
+  EXPECT_EQ(stats.rpa_cache_hits, 2u);
+  EXPECT_EQ(stats.irk_checks, 1u);
+
+  // The local IRK does not resolve the address, and is cached separately.
+  ASSERT_EQ(controller_.ResolvePrivateAddress(
+                rpa.value(), LinkLayerController::IrkSelection::Local),
+            std::nullopt);
+  EXPECT_EQ(stats.rpa_cache_hits, 2u);
+  EXPECT_EQ(stats.irk_checks, 2u);
+}
+
+TEST_F(LeAddressResolutionCacheTest, InvalidatedByResolvingListChanges) {
+  ASSERT_EQ(controller_.LeAddDeviceToResolvingList(
+                PeerAddressType::PUBLIC_DEVICE_OR_IDENTITY_ADDRESS,
+                identity_.GetAddress(), peer_irk_, local_irk_),
+            ErrorCode::SUCCESS);
+  ASSERT_EQ(controller_.LeSetAddressResolutionEnable(true), ErrorCode::SUCCESS);
+  auto rpa = controller_.GenerateResolvablePrivateAddress(
+      identity_, LinkLayerController::IrkSelection::Peer);
+  ASSERT_TRUE(rpa.has_value());
+
+  ASSERT_EQ(controller_.ResolvePrivateAddress(
+                rpa.value(), LinkLayerController::IrkSelection::Peer),
+            resolved_identity_);
+  ASSERT_EQ(controller_.LeRemoveDeviceFromResolvingList(
+                PeerAddressType::PUBLIC_DEVICE_OR_IDENTITY_ADDRESS,
+                identity_.GetAddress()),
+            ErrorCode::SUCCESS);
+  ASSERT_EQ(controller_.ResolvePrivateAddress(
+                rpa.value(), LinkLayerController::IrkSelection::Peer),
+            std::nullopt);
+
+  // The negative result is dropped when the device is added back.
+  ASSERT_EQ(controller_.LeAddDeviceToResolvingList(
+                PeerAddressType::PUBLIC_DEVICE_OR_IDENTITY_ADDRESS,
+                identity_.GetAddress(), peer_irk_, local_irk_),
+            ErrorCode::SUCCESS);
+  ASSERT_EQ(controller_.ResolvePrivateAddress(
+                rpa.value(), LinkLayerController::IrkSelection::Peer),
+            resolved_identity_);
+
+  ASSERT_EQ(controller_.LeClearResolvingList(), ErrorCode::SUCCESS);
+  ASSERT_EQ(controller_.ResolvePrivateAddress(
+                rpa.value(), LinkLayerController::IrkSelection::Peer),
+            std::nullopt);
+  EXPECT_EQ(controller_.GetAddressResolutionStats().rpa_cache_hits, 0u);
+}
+
+TEST_F(LeAddressResolutionCacheTest, FilterAcceptListIndex) {
+  Address peer{{1, 2, 3, 4, 5, 6}};
+  ASSERT_EQ(controller_.LeAddDeviceToFilterAcceptList(
+                FilterAcceptListAddressType::PUBLIC, peer),
+            ErrorCode::SUCCESS);
+  ASSERT_EQ(controller_.LeAddDeviceToFilterAcceptList(
+                FilterAcceptListAddressType::PUBLIC, peer),
+            ErrorCode::SUCCESS);
+
+  EXPECT_TRUE(controller_.LeFilterAcceptListContainsDevice(
+      FilterAcceptListAddressType::PUBLIC, peer));
+  EXPECT_FALSE(controller_.LeFilterAcceptListContainsDevice(
+      FilterAcceptListAddressType::RANDOM, peer));
+  EXPECT_FALSE(controller_.LeFilterAcceptListContainsDevice(
+      FilterAcceptListAddressType::ANONYMOUS_ADVERTISERS, Address::kEmpty));
+
+  // The duplicate entry keeps the device in the list.
+  ASSERT_EQ(controller_.LeRemoveDeviceFromFilterAcceptList(
+                FilterAcceptListAddressType::PUBLIC, peer),
+            ErrorCode::SUCCESS);
+  EXPECT_TRUE(controller_.LeFilterAcceptListContainsDevice(
+      FilterAcceptListAddressType::PUBLIC, peer));
+  ASSERT_EQ(controller_.LeRemoveDeviceFromFilterAcceptList(
+                FilterAcceptListAddressType::PUBLIC, peer),
+            ErrorCode::SUCCESS);
+  EXPECT_FALSE(controller_.LeFilterAcceptListContainsDevice(
+      FilterAcceptListAddressType::PUBLIC, peer));
+
+  ASSERT_EQ(controller_.LeAddDeviceToFilterAcceptList(
+                FilterAcceptListAddressType::ANONYMOUS_ADVERTISERS,
+                Address::kEmpty),
+            ErrorCode::SUCCESS);
+  EXPECT_TRUE(controller_.LeFilterAcceptListContainsDevice(
+      FilterAcceptListAddressType::ANONYMOUS_ADVERTISERS, peer));
+  ASSERT_EQ(controller_.LeClearFilterAcceptList(), ErrorCode::SUCCESS);
+  EXPECT_FALSE(controller_.LeFilterAcceptListContainsDevice(
+      FilterAcceptListAddressType::ANONYMOUS_ADVERTISERS, peer));
+  EXPECT_EQ(controller_.GetAddressResolutionStats().filter_accept_list_lookups,
+            7u);
+}
+
+}  // namespace rootcanal
@@ -0,0 +1,118 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#include "model/hci/h4_parser.h"
+#include "model/hci/hci_sniffer.h"
+
+namespace rootcanal {
+namespace {
+
+constexpr size_t kAclPayloadSize = 1021;
+constexpr size_t kAclPacketsPerStream = 256;
+
+// H4 stream of ACL packets as sent by a host at full throughput.
+std::vector<uint8_t> AclStream() {
+  std::vector<uint8_t> stream;
+  for (size_t i = 0; i < kAclPacketsPerStream; i++) {
+    stream.push_back(static_cast<uint8_t>(PacketType::ACL));
+    stream.push_back(0x01);
+    stream.push_back(0x00);
+    stream.push_back(kAclPayloadSize & 0xff);
+    stream.push_back(kAclPayloadSize >> 8);
+    stream.insert(stream.end(), kAclPayloadSize, static_cast<uint8_t>(i));
+  }
+  return stream;
+}
+
+// Parse the ACL stream from reads of the size given as argument, or of
+// the size requested by the parser when the argument is 0, which is how
+// the host data was read before.
+void BM_H4ParserAclStream(benchmark::State& state) {
+  std::vector<uint8_t> stream = AclStream();
+  size_t read_size = state.range(0);
+  size_t received = 0;
+  H4Parser parser([](auto) {}, [](auto) {},
+                  [&received](auto const& packet) { received += packet.size(); },
+                  [](auto) {}, [](auto) {});
+
+  for (auto _ : state) {
+    size_t offset = 0;
+    while (offset < stream.size()) {
+      if (read_size == 0) {
+        size_t chunk = parser.BytesRequested();
+        std::vector<uint8_t> buffer(stream.begin() + offset,
+                                    stream.begin() + offset + chunk);
+        parser.Consume(buffer.data(), chunk);
+        offset += chunk;
+      } else {
+        size_t chunk = std::min(read_size, stream.size() - offset);
+        parser.ConsumeStream(stream.data() + offset, chunk);
+        offset += chunk;
+      }
+    }
+  }
+
+  benchmark::DoNotOptimize(received);
+  state.SetBytesProcessed(state.iterations() * stream.size());
+  state.SetItemsProcessed(state.iterations() * kAclPacketsPerStream);
+}
+
+BENCHMARK(BM_H4ParserAclStream)->Arg(0)->Arg(1024)->Arg(16384);
+
+class NullTransport : public HciTransport {
+ public:
+  void SendEvent(const std::vector<uint8_t>&) override {}
+  void SendAcl(const std::vector<uint8_t>&) override {}
+  void SendSco(const std::vector<uint8_t>&) override {}
+  void SendIso(const std::vector<uint8_t>&) override {}
+  void RegisterCallbacks(PacketCallback, PacketCallback, PacketCallback,
+                         PacketCallback, CloseCallback) override {}
+  void TimerTick() override {}
+  void Close() override {}
+};
+
+// Capture of ACL packets sent to the host, with a timer tick every
+// |state.range(0)| packets.
+void BM_HciSnifferAcl(benchmark::State& state) {
+  auto output = std::make_shared<std::ostringstream>();
+  HciSniffer sniffer(std::make_shared<NullTransport>(), output);
+  std::vector<uint8_t> packet(4 + kAclPayloadSize);
+  size_t packets_per_tick = state.range(0);
+
+  size_t sent = 0;
+  for (auto _ : state) {
+    sniffer.SendAcl(packet);
+    if (++sent % packets_per_tick == 0) {
+      sniffer.TimerTick();
+      output->str("");
+    }
+  }
+
+  state.SetBytesProcessed(state.iterations() * packet.size());
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_HciSnifferAcl)->Arg(1)->Arg(16)->Arg(256);
+
+}  // namespace
+}  // namespace rootcanal
@@ -143,6 +143,31 @@ TEST_F(H4ParserTest, CallsTheRightCallbacks) {
   }
 }
 
+TEST_F(H4ParserTest, ConsumeStream) {
+  // Two ACL packets and the start of a third, in a single chunk.
+  PacketData stream({0x02, 0x01, 0x00, 0x02, 0x00, 0xaa, 0xbb,  // ACL
+                     0x02, 0x02, 0x00, 0x01, 0x00, 0xcc,        // ACL
+                     0x04, 0x0e});                              // Event
+  std::vector<PacketData> packets;
+  H4Parser parser{
+      [](auto) {}, [&](auto p) { packets.push_back(p); },
+      [&](auto p) { packets.push_back(p); }, [](auto) {}, [](auto) {},
+  };
+
+  ASSERT_TRUE(parser.ConsumeStream(stream.data(), stream.size()));
+  ASSERT_EQ(packets.size(), 2u);
+  ASSERT_EQ(packets[0], PacketData({0x01, 0x00, 0x02, 0x00, 0xaa, 0xbb}));
+  ASSERT_EQ(packets[1], PacketData({0x02, 0x00, 0x01, 0x00, 0xcc}));
+  ASSERT_EQ(parser.CurrentState(), H4Parser::State::HCI_PREAMBLE);
+
+  // The rest of the event arrives in the next chunk.
+  PacketData rest({0x01, 0x42});
+  ASSERT_TRUE(parser.ConsumeStream(rest.data(), rest.size()));
+  ASSERT_EQ(packets.size(), 3u);
+  ASSERT_EQ(packets[2], PacketData({0x0e, 0x01, 0x42}));
+  ASSERT_EQ(parser.CurrentState(), H4Parser::State::HCI_TYPE);
+}
+
 TEST_F(H4ParserTest, Recovery) {
   // Validate that the recovery state is exited only after receiving the
   // HCI Reset command.
@@ -0,0 +1,90 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <vector>
+
+#include "model/setup/phy_layer_factory.h"
+
+namespace rootcanal {
+namespace {
+
+using namespace model::packets;
+
+// One device in ten is a scanning host, the others are beacons.
+constexpr size_t kDevicesPerScanner = 10;
+
+LinkLayerPacketView Serialize(std::shared_ptr<LinkLayerPacketBuilder> packet) {
+  auto bytes = std::make_shared<std::vector<uint8_t>>();
+  bluetooth::packet::BitInserter inserter(*bytes);
+  packet->Serialize(inserter);
+  return LinkLayerPacketView::Create(
+      bluetooth::packet::PacketView<bluetooth::packet::kLittleEndian>(bytes));
+}
+
+// Every beacon sends one advertising PDU and every scanner one scan request
+// to a beacon per iteration. Reports simulated packets per second; with
+// |route| false every phy receives every packet, as before the routing.
+void BM_PhyLayerFactorySend(benchmark::State& state, bool route) {
+  const size_t num_devices = state.range(0);
+  PhyLayerFactory factory(Phy::Type::LOW_ENERGY, 0);
+  uint64_t received = 0;
+
+  std::vector<std::shared_ptr<PhyLayer>> phys;
+  std::vector<LinkLayerPacketView> packets;
+  for (size_t i = 0; i < num_devices; i++) {
+    phys.push_back(factory.GetPhyLayer(
+        [&received](LinkLayerPacketView) { received++; }, i));
+    Address address{{uint8_t(i), uint8_t(i >> 8), 0, 0, 0, 0xc0}};
+    bool scanner = i % kDevicesPerScanner == 0;
+    if (route) {
+      phys.back()->SetReceiveFilter(
+          scanner ? PhyLayer::ReceiveFilter::ADDRESSED_AND_ADVERTISING
+                  : PhyLayer::ReceiveFilter::ADDRESSED);
+    }
+    if (scanner) {
+      Address beacon{{uint8_t(i + 1), uint8_t((i + 1) >> 8), 0, 0, 0, 0xc0}};
+      packets.push_back(Serialize(LeScanBuilder::Create(
+          address, beacon, AddressType::PUBLIC, AddressType::PUBLIC)));
+    } else {
+      packets.push_back(Serialize(LeLegacyAdvertisingPduBuilder::Create(
+          address, Address::kEmpty, AddressType::PUBLIC, AddressType::PUBLIC,
+          LegacyAdvertisingType::ADV_SCAN_IND, std::vector<uint8_t>(31))));
+    }
+  }
+
+  for (auto _ : state) {
+    for (size_t i = 0; i < num_devices; i++) {
+      phys[i]->Send(packets[i]);
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_devices);
+  state.counters["deliveries_per_packet"] =
+      static_cast<double>(received) / (state.iterations() * num_devices);
+}
+
+BENCHMARK_CAPTURE(BM_PhyLayerFactorySend, broadcast, false)
+    ->RangeMultiplier(10)
+    ->Range(10, 1000);
+BENCHMARK_CAPTURE(BM_PhyLayerFactorySend, routed, true)
+    ->RangeMultiplier(10)
+    ->Range(10, 1000);
+
+}  // namespace
+}  // namespace rootcanal
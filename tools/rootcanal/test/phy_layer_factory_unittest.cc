@@ -0,0 +1,175 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "model/setup/phy_layer_factory.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace rootcanal {
+
+using namespace model::packets;
+
+namespace {
+const Address kAddress1{{0x01, 0x00, 0x00, 0x00, 0x00, 0x00}};
+const Address kAddress2{{0x02, 0x00, 0x00, 0x00, 0x00, 0x00}};
+const Address kAddress3{{0x03, 0x00, 0x00, 0x00, 0x00, 0x00}};
+const Address kUnknownAddress{{0x0f, 0x00, 0x00, 0x00, 0x00, 0x00}};
+}  // namespace
+
+class PhyLayerFactoryTest : public ::testing::Test {
+ public:
+  PhyLayerFactoryTest() : factory_(Phy::Type::LOW_ENERGY, 0) {}
+
+ protected:
+  std::shared_ptr<PhyLayer> AddPhy(PhyLayer::ReceiveFilter filter) {
+    size_t index = received_.size();
+    received_.push_back({});
+    auto phy = factory_.GetPhyLayer(
+        [this, index](LinkLayerPacketView packet) {
+          received_[index].push_back(packet.GetType());
+        },
+        index);
+    phy->SetReceiveFilter(filter);
+    return phy;
+  }
+
+  static std::shared_ptr<LinkLayerPacketBuilder> Advertising(Address source) {
+    return LeLegacyAdvertisingPduBuilder::Create(
+        source, Address::kEmpty, AddressType::PUBLIC, AddressType::PUBLIC,
+        LegacyAdvertisingType::ADV_IND, {});
+  }
+
+  static std::shared_ptr<LinkLayerPacketBuilder> Scan(Address source,
+                                                      Address destination) {
+    return LeScanBuilder::Create(source, destination, AddressType::PUBLIC,
+                                 AddressType::PUBLIC);
+  }
+
+  PhyLayerFactory factory_;
+  std::vector<std::vector<PacketType>> received_;
+};
+
+TEST_F(PhyLayerFactoryTest, AdvertisingOnlyReachesListeners) {
+  auto advertiser = AddPhy(PhyLayer::ReceiveFilter::ADDRESSED);
+  auto scanner = AddPhy(PhyLayer::ReceiveFilter::ADDRESSED_AND_ADVERTISING);
+  auto beacon = AddPhy(PhyLayer::ReceiveFilter::ADDRESSED);
+  auto sniffer = AddPhy(PhyLayer::ReceiveFilter::ALL);
+
+  advertiser->Send(Advertising(kAddress1));
+
+  EXPECT_TRUE(received_[0].empty());
+  EXPECT_EQ(received_[1].size(), 1u);
+  EXPECT_TRUE(received_[2].empty());
+  EXPECT_EQ(received_[3].size(), 1u);
+
+  // Stop scanning.
+  scanner->SetReceiveFilter(PhyLayer::ReceiveFilter::ADDRESSED);
+  advertiser->Send(Advertising(kAddress1));
+  EXPECT_EQ(received_[1].size(), 1u);
+  EXPECT_EQ(received_[3].size(), 2u);
+}
+
+TEST_F(PhyLayerFactoryTest, UnicastRoutedToSourceAddressOwner) {
+  auto advertiser = AddPhy(PhyLayer::ReceiveFilter::ADDRESSED);
+  auto scanner = AddPhy(PhyLayer::ReceiveFilter::ADDRESSED_AND_ADVERTISING);
+  auto other = AddPhy(PhyLayer::ReceiveFilter::ADDRESSED);
+  auto sniffer = AddPhy(PhyLayer::ReceiveFilter::ALL);
+
+  // The destination was never seen: delivered to every phy.
+  scanner->Send(Scan(kAddress2, kAddress1));
+  EXPECT_EQ(received_[0].size(), 1u);
+  EXPECT_EQ(received_[2].size(), 1u);
+  EXPECT_EQ(received_[3].size(), 1u);
+
+  // Once the advertiser sent from its address, only it and the sniffer
+  // receive packets sent to that address.
+  advertiser->Send(Advertising(kAddress1));
+  scanner->Send(Scan(kAddress2, kAddress1));
+  EXPECT_EQ(received_[0].size(), 2u);
+  EXPECT_EQ(received_[2].size(), 1u);
+  EXPECT_EQ(received_[3].size(), 3u);
+
+  // Broadcasts still reach every phy.
+  advertiser->Send(DisconnectBuilder::Create(kAddress1, Address::kEmpty, 0));
+  EXPECT_EQ(received_[1].size(), 2u);
+  EXPECT_EQ(received_[2].size(), 2u);
+  EXPECT_EQ(received_[3].size(), 4u);
+
+  EXPECT_GT(factory_.GetFilteredPacketCount(), 0u);
+}
+
+TEST_F(PhyLayerFactoryTest, UnregisteredPhyIsForgotten) {
+  auto advertiser = AddPhy(PhyLayer::ReceiveFilter::ADDRESSED);
+  auto scanner = AddPhy(PhyLayer::ReceiveFilter::ADDRESSED_AND_ADVERTISING);
+  auto other = AddPhy(PhyLayer::ReceiveFilter::ADDRESSED);
+
+  advertiser->Send(Advertising(kAddress1));
+  advertiser->Unregister();
+
+  // The address owner is gone, fall back to delivering to every phy.
+  scanner->Send(Scan(kAddress2, kAddress1));
+  EXPECT_TRUE(received_[0].empty());
+  EXPECT_EQ(received_[2].size(), 1u);
+}
+
+TEST_F(PhyLayerFactoryTest, RangeDropsFarAwayReceivers) {
+  auto advertiser = AddPhy(PhyLayer::ReceiveFilter::ADDRESSED);
+  auto near_scanner = AddPhy(PhyLayer::ReceiveFilter::ALL);
+  auto far_scanner = AddPhy(PhyLayer::ReceiveFilter::ALL);
+  auto unplaced_scanner = AddPhy(PhyLayer::ReceiveFilter::ALL);
+
+  advertiser->SetPosition(PhyLayer::Position{0, 0, 0});
+  near_scanner->SetPosition(PhyLayer::Position{3, 4, 0});
+  far_scanner->SetPosition(PhyLayer::Position{30, 40, 0});
+
+  advertiser->Send(Advertising(kAddress3));
+  EXPECT_EQ(received_[1].size(), 1u);
+  EXPECT_EQ(received_[2].size(), 1u);
+  EXPECT_EQ(received_[3].size(), 1u);
+
+  factory_.SetRange(10);
+  advertiser->Send(Advertising(kAddress3));
+  EXPECT_EQ(received_[1].size(), 2u);
+  EXPECT_EQ(received_[2].size(), 1u);
+  EXPECT_EQ(received_[3].size(), 2u);
+}
+
+TEST_F(PhyLayerFactoryTest, ReceiveCanSendAndUnregister) {
+  std::shared_ptr<PhyLayer> responder;
+  bool unregister = false;
+  auto scanner = AddPhy(PhyLayer::ReceiveFilter::ADDRESSED);
+  responder = factory_.GetPhyLayer(
+      [&](LinkLayerPacketView packet) {
+        if (packet.GetType() == PacketType::LE_SCAN) {
+          responder->Send(Advertising(kAddress1));
+          if (unregister) {
+            responder->Unregister();
+          }
+        }
+      },
+      1);
+  responder->SetReceiveFilter(PhyLayer::ReceiveFilter::ADDRESSED);
+
+  scanner->Send(Scan(kAddress2, kUnknownAddress));
+  unregister = true;
+  scanner->Send(Scan(kAddress2, kAddress1));
+  scanner->Send(Scan(kAddress2, kAddress1));
+  EXPECT_TRUE(received_[0].empty());
+}
+
+}  // namespace rootcanal
@@ -0,0 +1,187 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "model/setup/simulation_worker_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "model/devices/hci_device.h"
+#include "model/setup/phy_layer_factory.h"
+#include "model/setup/test_model.h"
+
+namespace rootcanal {
+
+using namespace model::packets;
+
+namespace {
+constexpr size_t kNumDevices = 16;
+
+Address DeviceAddress(size_t index) {
+  return Address{{uint8_t(index), 0x00, 0x00, 0x00, 0x00, 0xc0}};
+}
+
+// Tick |kNumDevices| advertisers split in |num_shards| shards on a pool
+// of |num_workers| threads, and return the advertisers heard by a scanner.
+std::vector<Address> TickAdvertisers(size_t num_workers, size_t num_shards) {
+  PhyLayerFactory factory(Phy::Type::LOW_ENERGY, 0);
+  std::vector<Address> heard;
+  auto scanner = factory.GetPhyLayer(
+      [&heard](LinkLayerPacketView packet) {
+        heard.push_back(packet.GetSourceAddress());
+      },
+      kNumDevices);
+
+  std::vector<std::shared_ptr<PhyLayer>> advertisers;
+  for (size_t i = 0; i < kNumDevices; i++) {
+    advertisers.push_back(
+        factory.GetPhyLayer([](LinkLayerPacketView) {}, i));
+  }
+
+  SimulationWorkerPool pool(num_workers);
+  std::vector<DeferredOperations> shards(num_shards);
+  pool.RunAndWait(num_shards, [&](size_t shard) {
+    DeferredOperations::Scope scope(shards[shard]);
+    size_t end = kNumDevices * (shard + 1) / num_shards;
+    for (size_t i = kNumDevices * shard / num_shards; i < end; i++) {
+      advertisers[i]->Send(LeLegacyAdvertisingPduBuilder::Create(
+          DeviceAddress(i), Address::kEmpty,
+          model::packets::AddressType::PUBLIC,
+          model::packets::AddressType::PUBLIC, LegacyAdvertisingType::ADV_IND,
+          {}));
+    }
+  });
+
+  // Nothing is delivered before the end of the tick.
+  EXPECT_TRUE(heard.empty());
+  for (auto& shard : shards) {
+    shard.Run();
+  }
+  return heard;
+}
+
+class NullTransport : public HciTransport {
+ public:
+  void SendEvent(const std::vector<uint8_t>&) override {}
+  void SendAcl(const std::vector<uint8_t>&) override {}
+  void SendSco(const std::vector<uint8_t>&) override {}
+  void SendIso(const std::vector<uint8_t>&) override {}
+  void RegisterCallbacks(PacketCallback, PacketCallback, PacketCallback,
+                         PacketCallback, CloseCallback) override {}
+  void TimerTick() override {}
+  void Close() override {}
+};
+
+// A controller scheduling a delayed task on every tick, and another one that
+// it cancels right away.
+class TaskSchedulingDevice : public HciDevice {
+ public:
+  TaskSchedulingDevice() : HciDevice(std::make_shared<NullTransport>(), "") {}
+
+  void TimerTick() override {
+    link_layer_controller_.ScheduleTask(std::chrono::milliseconds(10), [] {});
+    link_layer_controller_.CancelScheduledTask(link_layer_controller_.ScheduleTask(
+        std::chrono::milliseconds(10), [] {}));
+  }
+};
+
+// Tick |kNumDevices| controllers on |num_threads| threads, and return the
+// users of the tasks queued at the end of the tick, in queue order.
+std::vector<AsyncUserId> TickTaskSchedulers(size_t num_threads) {
+  AsyncUserId next_user_id = 1;
+  std::vector<AsyncUserId> queued;
+  std::vector<TaskCallback> model_tasks;
+  size_t cancelled = 0;
+  TestModel model(
+      [&next_user_id] { return next_user_id++; },
+      [&](AsyncUserId user_id, std::chrono::milliseconds,
+          const TaskCallback& task) {
+        queued.push_back(user_id);
+        model_tasks.push_back(task);
+        return static_cast<AsyncTaskId>(queued.size());
+      },
+      [](AsyncUserId, std::chrono::milliseconds, std::chrono::milliseconds,
+         const TaskCallback&) { return kInvalidTaskId; },
+      [](AsyncUserId) {}, [&cancelled](AsyncTaskId) { cancelled++; },
+      [](const std::string&, int, Phy::Type) { return nullptr; });
+
+  for (size_t i = 0; i < kNumDevices; i++) {
+    model.AddHciConnection(std::make_shared<TaskSchedulingDevice>());
+  }
+  model.SetSimulationThreads(num_threads);
+  model_tasks.back()();
+  queued.clear();
+
+  model.TimerTick();
+
+  // Tasks cancelled before the end of the tick never reach the queue.
+  EXPECT_EQ(cancelled, 0u);
+  return queued;
+}
+}  // namespace
+
+TEST(SimulationWorkerPoolTest, DeferredOperationsScope) {
+  DeferredOperations outer;
+  DeferredOperations inner;
+  std::vector<int> order;
+
+  EXPECT_EQ(DeferredOperations::Current(), nullptr);
+  {
+    DeferredOperations::Scope outer_scope(outer);
+    EXPECT_EQ(DeferredOperations::Current(), &outer);
+    {
+      DeferredOperations::Scope inner_scope(inner);
+      EXPECT_EQ(DeferredOperations::Current(), &inner);
+    }
+    EXPECT_EQ(DeferredOperations::Current(), &outer);
+    outer.Defer([&order] { order.push_back(1); });
+    outer.Defer([&order] { order.push_back(2); });
+  }
+  EXPECT_EQ(DeferredOperations::Current(), nullptr);
+
+  EXPECT_TRUE(order.empty());
+  outer.Run();
+  EXPECT_EQ(order, (std::vector<int>{1, 2}));
+  EXPECT_TRUE(outer.IsEmpty());
+}
+
+TEST(SimulationWorkerPoolTest, ShardedTicksAreReproducible) {
+  std::vector<Address> expected;
+  for (size_t i = 0; i < kNumDevices; i++) {
+    expected.push_back(DeviceAddress(i));
+  }
+
+  // Packets are exchanged in device order, whatever the number of threads
+  // and shards.
+  EXPECT_EQ(TickAdvertisers(0, 1), expected);
+  EXPECT_EQ(TickAdvertisers(1, 4), expected);
+  EXPECT_EQ(TickAdvertisers(3, 5), expected);
+  EXPECT_EQ(TickAdvertisers(3, kNumDevices), expected);
+}
+
+TEST(SimulationWorkerPoolTest, ShardedTicksQueueTasksInDeviceOrder) {
+  // The model takes the first user id, the devices the next ones.
+  std::vector<AsyncUserId> expected;
+  for (size_t i = 0; i < kNumDevices; i++) {
+    expected.push_back(AsyncUserId(i + 2));
+  }
+
+  EXPECT_EQ(TickTaskSchedulers(2), expected);
+  EXPECT_EQ(TickTaskSchedulers(4), expected);
+}
+
+}  // namespace rootcanal
@@ -0,0 +1,124 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <vector>
+
+#include "crypto_toolbox/crypto_toolbox.h"
+#include "model/devices/device.h"
+#include "model/setup/test_model.h"
+
+namespace rootcanal {
+namespace {
+
+using namespace model::packets;
+
+constexpr size_t kNumControllers = 500;
+// One controller in fifty is scanning, the others are advertising.
+constexpr size_t kControllersPerScanner = 50;
+
+// A controller advertising from a fresh resolvable private address on every
+// tick, or scanning.
+class SimulatedController : public Device {
+ public:
+  SimulatedController(size_t index, bool scanner)
+      : index_(index), scanner_(scanner) {
+    SetReceiveFilter(scanner
+                         ? PhyLayer::ReceiveFilter::ADDRESSED_AND_ADVERTISING
+                         : PhyLayer::ReceiveFilter::ADDRESSED);
+  }
+
+  std::string GetTypeString() const override { return "simulated_controller"; }
+
+  void TimerTick() override {
+    if (scanner_) {
+      return;
+    }
+    // Generate the RPA the way the link layer does.
+    bluetooth::crypto_toolbox::Octet16 irk{};
+    irk[0] = index_;
+    uint8_t prand[3] = {uint8_t(tick_), uint8_t(tick_ >> 8), 0x40};
+    auto hash = bluetooth::crypto_toolbox::aes_128(irk, prand, 3);
+    tick_++;
+
+    Address rpa{{hash[0], hash[1], hash[2], prand[0], prand[1], prand[2]}};
+    SendLinkLayerPacket(LeLegacyAdvertisingPduBuilder::Create(
+                            rpa, Address::kEmpty, AddressType::RANDOM,
+                            AddressType::PUBLIC, LegacyAdvertisingType::ADV_IND,
+                            std::vector<uint8_t>(31)),
+                        Phy::Type::LOW_ENERGY);
+  }
+
+  void IncomingPacket(LinkLayerPacketView) override { received_++; }
+
+  uint64_t GetReceived() const { return received_; }
+
+ private:
+  size_t index_;
+  bool scanner_;
+  uint32_t tick_{0};
+  uint64_t received_{0};
+};
+
+// Ticks per second of a model of |kNumControllers| controllers, on the
+// number of threads given as argument.
+void BM_TestModelTimerTick(benchmark::State& state) {
+  AsyncUserId next_user_id = 1;
+  TestModel model(
+      [&next_user_id] { return next_user_id++; },
+      [](AsyncUserId, std::chrono::milliseconds, const TaskCallback& task) {
+        task();
+        return kInvalidTaskId;
+      },
+      [](AsyncUserId, std::chrono::milliseconds, std::chrono::milliseconds,
+         const TaskCallback&) { return kInvalidTaskId; },
+      [](AsyncUserId) {}, [](AsyncTaskId) {},
+      [](const std::string&, int, Phy::Type) { return nullptr; });
+
+  size_t phy = model.AddPhy(Phy::Type::LOW_ENERGY);
+  std::vector<std::shared_ptr<SimulatedController>> controllers;
+  for (size_t i = 0; i < kNumControllers; i++) {
+    controllers.push_back(std::make_shared<SimulatedController>(
+        i, i % kControllersPerScanner == 0));
+    model.AddDeviceToPhy(model.Add(controllers.back()), phy);
+  }
+  model.SetSimulationThreads(state.range(0));
+
+  for (auto _ : state) {
+    model.TimerTick();
+  }
+
+  uint64_t received = 0;
+  for (auto const& controller : controllers) {
+    received += controller->GetReceived();
+  }
+  state.counters["ticks_per_second"] =
+      benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+  state.counters["received_per_tick"] =
+      static_cast<double>(received) / state.iterations();
+}
+
+BENCHMARK(BM_TestModelTimerTick)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace rootcanal